@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCHMARKCHUNKER_H
+#define BENCHMARKCHUNKER_H
+
+/**
+ * @file BenchmarkChunker.h
+ */
+
+#include "server/AbstractUdpChunker.h"
+
+#include <QtCore/QMutex>
+
+namespace pelican {
+
+class ConfigNode;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class BenchmarkChunker
+ *
+ * @brief
+ * UDP chunker used by the end-to-end benchmark.
+ *
+ * @details
+ * Assembles fixed-size packets into chunks, with the packet and header
+ * sizes given by
+ * @code
+ * <packet size="8208" headerSize="16"/>
+ * @endcode
+ * in addition to the options of AbstractUdpChunker. The receive statistics
+ * are kept when the chunker is destroyed, so that the benchmark can report
+ * them once the server has shut down (see lastStatistics()).
+ */
+class BenchmarkChunker : public AbstractUdpChunker
+{
+    public:
+        /// Constructs the chunker.
+        BenchmarkChunker(const ConfigNode& config);
+
+        /// Destroys the chunker, keeping its statistics.
+        ~BenchmarkChunker();
+
+        /// Returns the statistics of the last chunker destroyed.
+        static Statistics lastStatistics();
+
+    private:
+        static QMutex _mutex;
+        static Statistics _last;
+};
+
+PELICAN_DECLARE_CHUNKER(BenchmarkChunker)
+
+} // namespace pelican
+
+#endif // BENCHMARKCHUNKER_H
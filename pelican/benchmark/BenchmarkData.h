@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCHMARKDATA_H
+#define BENCHMARKDATA_H
+
+/**
+ * @file BenchmarkData.h
+ */
+
+#include "data/ArrayData.h"
+
+#include <QtCore/QtEndian>
+
+namespace pelican {
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class BenchmarkData
+ *
+ * @brief
+ * Raw chunk data passed through the end-to-end benchmark.
+ *
+ * @details
+ * Holds the bytes of one chunk. The ingest timestamp is serialised with the
+ * data, so that clients of the blob server can measure the end-to-end
+ * latency.
+ */
+class BenchmarkData : public AlignedArrayData<char>
+{
+    public:
+        /// Constructs an empty blob.
+        BenchmarkData() : AlignedArrayData<char>("BenchmarkData") {}
+
+        /// Serialises the timestamp and the data.
+        void serialise(QIODevice& out) const
+        {
+            qint64 t = qToLittleEndian(timestamp());
+            out.write((const char*)&t, sizeof(t));
+            AlignedArrayData<char>::serialise(out);
+        }
+
+        /// Returns the number of serialised bytes.
+        quint64 serialisedBytes() const
+        { return sizeof(qint64) + AlignedArrayData<char>::serialisedBytes(); }
+
+        /// Deserialises the timestamp and the data.
+        void deserialise(QIODevice& in, QSysInfo::Endian endianness)
+        {
+            qint64 t = 0;
+            in.read((char*)&t, sizeof(t));
+            setTimestamp(qFromLittleEndian(t));
+            AlignedArrayData<char>::deserialise(in, endianness);
+        }
+};
+
+PELICAN_DECLARE_DATABLOB(BenchmarkData)
+
+} // namespace pelican
+
+#endif // BENCHMARKDATA_H
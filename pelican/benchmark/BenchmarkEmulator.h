@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCHMARKEMULATOR_H
+#define BENCHMARKEMULATOR_H
+
+/**
+ * @file BenchmarkEmulator.h
+ */
+
+#include "emulator/AbstractUdpEmulator.h"
+
+#include <QtCore/QByteArray>
+
+namespace pelican {
+
+class ConfigNode;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class BenchmarkEmulator
+ *
+ * @brief
+ * UDP emulator used by the end-to-end benchmark.
+ *
+ * @details
+ * Sends a fixed number of packets of a fixed size, as fast as allowed by the
+ * pacing options, with the packet index written into the sequence field of
+ * the header:
+ * @code
+ * <packet size="8208" count="100000"/>
+ * @endcode
+ * in addition to the options of AbstractUdpEmulator.
+ */
+class BenchmarkEmulator : public AbstractUdpEmulator
+{
+    public:
+        /// Constructs the emulator.
+        BenchmarkEmulator(const ConfigNode& config);
+
+        /// Returns the next packet.
+        void getPacketData(char*& ptr, unsigned long& size);
+
+        /// Sends without a fixed interval unless a rate is configured.
+        unsigned long interval() { return 0; }
+
+        /// Returns the number of packets to send.
+        int nPackets() { return _packets; }
+
+    private:
+        QByteArray _packet;
+        int _packets;
+        quint64 _counter;
+};
+
+} // namespace pelican
+
+#endif // BENCHMARKEMULATOR_H
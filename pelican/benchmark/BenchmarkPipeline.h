@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCHMARKPIPELINE_H
+#define BENCHMARKPIPELINE_H
+
+/**
+ * @file BenchmarkPipeline.h
+ */
+
+#include "core/AbstractPipeline.h"
+#include "utility/TimingHistogram.h"
+
+#include <QtCore/QMutex>
+
+#include <iostream>
+
+namespace pelican {
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class BenchmarkPipeline
+ *
+ * @brief
+ * Pipeline used by the end-to-end benchmark.
+ *
+ * @details
+ * Counts the chunks, bytes and lost packets it receives, and records the
+ * latency of each chunk from its ingest time in the server. If enabled in
+ * the pipeline configuration,
+ * @code
+ * <BenchmarkPipeline>
+ *     <output enabled="true"/>
+ * </BenchmarkPipeline>
+ * @endcode
+ * each chunk is passed on to the output streamers on the @c benchmark
+ * stream. The counters can be read from another thread with report().
+ */
+class BenchmarkPipeline : public AbstractPipeline
+{
+    public:
+        /// Constructs the pipeline.
+        BenchmarkPipeline();
+
+        /// Requests the benchmark data.
+        void init();
+
+        /// Records one chunk.
+        void run(QHash<QString, DataBlob*>& data);
+
+        /// Writes the counters as a single @c BENCHMARK line.
+        void report(std::ostream& stream) const;
+
+    private:
+        mutable QMutex _mutex;
+        bool _output;
+        quint64 _chunks;
+        quint64 _bytes;
+        quint64 _lost;
+        quint64 _first;
+        quint64 _last;
+        TimingHistogram _latency;
+};
+
+} // namespace pelican
+
+#endif // BENCHMARKPIPELINE_H
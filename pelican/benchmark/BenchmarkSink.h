@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BENCHMARKSINK_H
+#define BENCHMARKSINK_H
+
+/**
+ * @file BenchmarkSink.h
+ */
+
+#include "output/DataBlobClient.h"
+#include "benchmark/BenchmarkData.h"
+#include "utility/TimingHistogram.h"
+
+namespace pelican {
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class BenchmarkSink
+ *
+ * @brief
+ * Blob server client used by the end-to-end benchmark.
+ *
+ * @details
+ * Subscribes to the @c benchmark stream of a pipeline blob server and
+ * counts the blobs and bytes received, recording the latency of each blob
+ * from its ingest time in the server. The sink lives in the thread that
+ * creates it and needs its event loop to be running.
+ */
+class BenchmarkSink : public DataBlobClient
+{
+    public:
+        /// Constructs a sink connected to the blob server at @p port.
+        BenchmarkSink(quint16 port);
+
+        /// Returns the number of blobs received.
+        quint64 blobs() const { return _blobs; }
+
+        /// Returns the number of serialised bytes received.
+        quint64 bytes() const { return _bytes; }
+
+        /// Returns the latencies of the blobs received, in nanoseconds.
+        const TimingHistogram& latency() const { return _latency; }
+
+    protected:
+        /// Reads and records a blob.
+        void dataReceived(DataBlobResponse* response);
+
+    private:
+        BenchmarkData _blob;
+        quint64 _blobs;
+        quint64 _bytes;
+        TimingHistogram _latency;
+};
+
+} // namespace pelican
+
+#endif // BENCHMARKSINK_H
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BLOBSERIALISEBENCHMARK_H
+#define BLOBSERIALISEBENCHMARK_H
+
+/**
+ * @file BlobSerialiseBenchmark.h
+ */
+
+#include "benchmark/MicroBenchmark.h"
+
+#include <QtCore/QByteArray>
+
+namespace pelican {
+
+class DataBlob;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class BlobSerialiseBenchmark
+ *
+ * @brief
+ * Times the serialisation or deserialisation of a data blob.
+ *
+ * @details
+ * Serialises the blob into (or deserialises it from) an in-memory device,
+ * as the output streamers and blob clients do. An operation is one blob.
+ */
+class BlobSerialiseBenchmark : public MicroBenchmark
+{
+    public:
+        /// Constructs the benchmark for the given blob, which must already
+        /// hold its data, taking ownership of it.
+        BlobSerialiseBenchmark(DataBlob* blob, bool deserialise = false);
+
+        /// Destroys the data blob.
+        ~BlobSerialiseBenchmark();
+
+        /// Serialises or deserialises the blob @p operations times.
+        quint64 run(quint64 operations);
+
+    private:
+        DataBlob* _blob;
+        bool _deserialise;
+        QByteArray _serialised;
+};
+
+} // namespace pelican
+
+#endif // BLOBSERIALISEBENCHMARK_H
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ENDTOENDBENCHMARK_H
+#define ENDTOENDBENCHMARK_H
+
+/**
+ * @file EndToEndBenchmark.h
+ */
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+namespace pelican {
+
+class ConfigNode;
+class JsonWriter;
+class TimingHistogram;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class EndToEndBenchmark
+ *
+ * @brief
+ * Measures the throughput, drops and latency of a complete Pelican system.
+ *
+ * @details
+ * For each point of the sweep, the benchmark starts a PelicanServer with a
+ * BenchmarkChunker, a number of pipeline processes running the
+ * BenchmarkPipeline (each with its own PelicanTCPBlobServer), a
+ * BenchmarkSink for each blob server and an EmulatorDriver sending a fixed
+ * number of packets at the given rate. The server, sinks and emulator run in
+ * this process; the pipelines run as child processes of the current
+ * executable, which must call runPipeline() when given the
+ * @c --pipeline option. Once the emulator has finished and the data has had
+ * time to drain, the pipelines are stopped by closing their standard input,
+ * and the counters of every stage are written to the report.
+ *
+ * Configuration:
+ * @code
+ * <EndToEndBenchmark>
+ *     <sweep chunkPackets="16,64,256" clients="1,2" rates="0,200000"/>
+ *     <packet size="8208" headerSize="16" count="200000"/>
+ *     <emulator threads="0" batch="64"/>
+ *     <server host="127.0.0.1" port="2100" buffer="268435456"
+ *             receiver="qt" reorder="64"/>
+ *     <output enabled="true"/>
+ *     <timing startup="2" settle="2" stop="10"/>
+ * </EndToEndBenchmark>
+ * @endcode
+ * where @c rates are in packets per second (0 sends as fast as possible),
+ * @c threads is the number of emulator sender threads (0 sends from the
+ * driver thread), @c buffer the size of the server stream buffer in bytes,
+ * @c receiver the chunker receiver type (@c qt or @c uring) and the timing
+ * values are in seconds. Each point of the sweep uses its own block of 100
+ * ports starting at @c port.
+ */
+class EndToEndBenchmark
+{
+    public:
+        /// Constructs the benchmark from its configuration.
+        EndToEndBenchmark(const ConfigNode& config);
+
+        /// Runs every point of the sweep, writing the results to @p json.
+        void run(JsonWriter& json);
+
+        /// Runs a benchmark pipeline with the given configuration file
+        /// until its standard input is closed.
+        static int runPipeline(const QString& configFile);
+
+    private:
+        /// Runs one point of the sweep.
+        void _runPoint(int index, int chunkPackets, int clients, double rate,
+                JsonWriter& json);
+
+        /// Returns the server configuration for the point.
+        QString _serverXml(quint16 port, int chunkPackets) const;
+
+        /// Returns the pipeline configuration for the point.
+        QString _pipelineXml(quint16 serverPort, quint16 blobPort) const;
+
+        /// Returns the emulator configuration for the point.
+        QString _emulatorXml(quint16 port, double rate) const;
+
+        /// Processes events for the given number of seconds.
+        static void _wait(double seconds);
+
+        /// Parses the @c BENCHMARK line written by a pipeline.
+        static QHash<QString, QString> _parseReport(const QString& output);
+
+        /// Writes the percentiles of @p latency in milliseconds.
+        static void _writeLatency(JsonWriter& json,
+                const TimingHistogram& latency);
+
+        /// Splits a comma-separated list of numbers.
+        static QList<double> _numbers(const QString& list);
+
+    private:
+        QList<double> _chunkPackets;
+        QList<double> _clients;
+        QList<double> _rates;
+        int _packetSize;
+        int _headerSize;
+        int _packets;
+        int _senderThreads;
+        int _senderBatch;
+        QString _host;
+        quint16 _port;
+        qint64 _buffer;
+        QString _receiver;
+        int _reorder;
+        bool _output;
+        double _startup;
+        double _settle;
+        double _stop;
+};
+
+} // namespace pelican
+
+#endif // ENDTOENDBENCHMARK_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef FANOUTBENCHMARK_H
+#define FANOUTBENCHMARK_H
+
+/**
+ * @file FanOutBenchmark.h
+ */
+
+#include "benchmark/MicroBenchmark.h"
+
+namespace pelican {
+
+class DoubleData;
+class TCPConnectionManager;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class FanOutBenchmark
+ *
+ * @brief
+ * Times the TCPConnectionManager fan-out of blobs to several clients.
+ *
+ * @details
+ * Each run connects the given number of client threads, subscribed to a
+ * new stream, to a TCPConnectionManager in the calling thread, then sends
+ * blobs to the stream until every client has received and deserialised all
+ * of them. An operation is one blob sent to all the clients.
+ */
+class FanOutBenchmark : public MicroBenchmark
+{
+    public:
+        /// Constructs the benchmark for blobs of @p size bytes sent to
+        /// @p clients clients.
+        FanOutBenchmark(size_t size, int clients);
+
+        /// Destroys the benchmark.
+        ~FanOutBenchmark();
+
+        /// Creates the connection manager.
+        void setUp();
+
+        /// Destroys the connection manager.
+        void tearDown();
+
+        /// Sends @p operations blobs to the clients.
+        quint64 run(quint64 operations);
+
+    private:
+        int _clients;
+        int _runs;
+        DoubleData* _blob;
+        TCPConnectionManager* _manager;
+};
+
+} // namespace pelican
+
+#endif // FANOUTBENCHMARK_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+/**
+ * @file JsonWriter.h
+ */
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+namespace pelican {
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class JsonWriter
+ *
+ * @brief
+ * Writes machine-readable benchmark reports in JSON.
+ *
+ * @details
+ * Values are appended in order; objects and arrays are opened and closed
+ * explicitly. Keys are ignored for values written directly into an array.
+ *
+ * @code
+ * JsonWriter json;
+ * json.beginObject();
+ * json.addString("benchmark", "endToEnd");
+ * json.beginArray("runs");
+ * json.beginObject();
+ * json.addInteger("clients", 2);
+ * json.endObject();
+ * json.endArray();
+ * json.endObject();
+ * @endcode
+ */
+class JsonWriter
+{
+    public:
+        /// Constructs an empty document.
+        JsonWriter() {}
+
+        /// Opens an object (with the given key, inside an object).
+        void beginObject(const QString& key = QString());
+
+        /// Closes the current object.
+        void endObject();
+
+        /// Opens an array (with the given key, inside an object).
+        void beginArray(const QString& key = QString());
+
+        /// Closes the current array.
+        void endArray();
+
+        /// Adds a floating point value (non-finite values are written as null).
+        void addNumber(const QString& key, double value);
+
+        /// Adds an integer value.
+        void addInteger(const QString& key, qint64 value);
+
+        /// Adds a string value.
+        void addString(const QString& key, const QString& value);
+
+        /// Adds a boolean value.
+        void addBool(const QString& key, bool value);
+
+        /// Returns the document written so far.
+        const QString& toString() const { return _text; }
+
+        /// Returns the string quoted and escaped for JSON.
+        static QString quote(const QString& value);
+
+    private:
+        /// Starts a new value, writing the separator and key if required.
+        void _next(const QString& key);
+
+    private:
+        QString _text;
+        QList<bool> _empty;  // For each open container, true if empty.
+        QList<bool> _object; // For each open container, true if an object.
+};
+
+} // namespace pelican
+
+#endif // JSONWRITER_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+/**
+ * @file MicroBenchmark.h
+ */
+
+#include <QtCore/QString>
+
+namespace pelican {
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class MicroBenchmark
+ *
+ * @brief
+ * Base class for component microbenchmarks.
+ *
+ * @details
+ * A microbenchmark times a number of repetitions of one operation on a hot
+ * path. Derived classes implement run(), which performs the requested number
+ * of operations and returns the time they took, so that any per-run set-up
+ * (such as starting threads or connecting sockets) can be left out of the
+ * measurement. The benchmarks are run by the MicroBenchmarkRunner.
+ */
+class MicroBenchmark
+{
+    public:
+        /// Constructs a benchmark with the given name, processing @p bytes
+        /// bytes per operation (0 if not applicable).
+        MicroBenchmark(const QString& name, quint64 bytes = 0)
+        : _name(name), _bytes(bytes) {}
+
+        /// Destroys the benchmark.
+        virtual ~MicroBenchmark() {}
+
+        /// Returns the name of the benchmark.
+        const QString& name() const { return _name; }
+
+        /// Returns the number of bytes processed by each operation.
+        quint64 bytesPerOperation() const { return _bytes; }
+
+        /// Prepares the benchmark before the first run.
+        virtual void setUp() {}
+
+        /// Cleans up after the last run.
+        virtual void tearDown() {}
+
+        /// Performs @p operations operations, returning the time taken in
+        /// nanoseconds.
+        virtual quint64 run(quint64 operations) = 0;
+
+    private:
+        QString _name;
+        quint64 _bytes;
+};
+
+} // namespace pelican
+
+#endif // MICROBENCHMARK_H
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef MICROBENCHMARKRUNNER_H
+#define MICROBENCHMARKRUNNER_H
+
+/**
+ * @file MicroBenchmarkRunner.h
+ */
+
+#include <QtCore/QList>
+#include <QtCore/QRegExp>
+#include <QtCore/QString>
+
+#include <iostream>
+
+namespace pelican {
+
+class JsonWriter;
+class MicroBenchmark;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class MicroBenchmarkRunner
+ *
+ * @brief
+ * Runs microbenchmarks and compares their results with a baseline.
+ *
+ * @details
+ * Each benchmark is first calibrated, by increasing the number of operations
+ * until one run takes at least the sample time, then run once more to warm
+ * up and finally run for the given number of samples. The result of a
+ * benchmark is the median time per operation over the samples, with the
+ * median absolute deviation relative to the median as a measure of its
+ * spread; both are robust to the occasional slow sample caused by other
+ * activity on the host.
+ *
+ * Results can be saved as a baseline, a text file with one line per
+ * benchmark giving its name, median time per operation and spread. A later
+ * run can then be compared with it: a benchmark is flagged as a regression
+ * if its median is slower than the baseline by more than the threshold
+ * and by more than twice the combined spread of the two measurements.
+ */
+class MicroBenchmarkRunner
+{
+    public:
+        /// The result of one benchmark.
+        struct Result
+        {
+            Result() : operations(0), bytes(0), median(0.0), min(0.0),
+                    spread(0.0) {}
+
+            QString name;        ///< Benchmark name.
+            quint64 operations;  ///< Operations per sample.
+            quint64 bytes;       ///< Bytes per operation.
+            QList<double> samples; ///< Time per operation of each sample (ns).
+            double median;       ///< Median time per operation (ns).
+            double min;          ///< Fastest time per operation (ns).
+            double spread;       ///< Relative median absolute deviation.
+        };
+
+    public:
+        /// Constructs a runner with no benchmarks.
+        MicroBenchmarkRunner();
+
+        /// Destroys the runner and its benchmarks.
+        ~MicroBenchmarkRunner();
+
+        /// Adds a benchmark, taking ownership of it.
+        void add(MicroBenchmark* benchmark);
+
+        /// Sets the number of samples taken for each benchmark.
+        void setSamples(int samples) { _samples = qMax(samples, 1); }
+
+        /// Sets the minimum duration of each sample in seconds.
+        void setSampleTime(double seconds) { _sampleTime = seconds; }
+
+        /// Only runs the benchmarks with names matching @p pattern.
+        void setFilter(const QString& pattern) { _filter = QRegExp(pattern); }
+
+        /// Returns the names of the benchmarks that would be run.
+        QList<QString> names() const;
+
+        /// Runs the benchmarks, reporting progress to @p log.
+        QList<Result> run(std::ostream& log = std::cout);
+
+        /// Writes the results to @p json.
+        static void write(JsonWriter& json, const QList<Result>& results);
+
+        /// Saves the results as a baseline file.
+        static void saveBaseline(const QString& fileName,
+                const QList<Result>& results);
+
+        /// Compares the results with a baseline file, returning the number
+        /// of regressions.
+        static int compare(const QString& fileName,
+                const QList<Result>& results, double threshold,
+                std::ostream& out = std::cout);
+
+    private:
+        /// Runs one benchmark.
+        Result _run(MicroBenchmark* benchmark, std::ostream& log);
+
+        /// Returns the median of the values.
+        static double _median(QList<double> values);
+
+    private:
+        QList<MicroBenchmark*> _benchmarks;
+        int _samples;
+        double _sampleTime;
+        QRegExp _filter;
+};
+
+} // namespace pelican
+
+#endif // MICROBENCHMARKRUNNER_H
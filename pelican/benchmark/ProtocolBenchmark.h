@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PROTOCOLBENCHMARK_H
+#define PROTOCOLBENCHMARK_H
+
+/**
+ * @file ProtocolBenchmark.h
+ */
+
+#include "benchmark/MicroBenchmark.h"
+
+#include <QtCore/QByteArray>
+
+namespace pelican {
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class ProtocolBenchmark
+ *
+ * @brief
+ * Times PelicanProtocol stream data frames sent through a socket pair.
+ *
+ * @details
+ * A sender thread writes stream data frames with PelicanProtocol to one end
+ * of a local socket pair, and the calling thread receives them with
+ * PelicanClientProtocol and reads their data from the other end, as the
+ * server sessions and the pipeline client do. An operation is one frame.
+ */
+class ProtocolBenchmark : public MicroBenchmark
+{
+    public:
+        /// Constructs the benchmark for frames holding @p size bytes of data.
+        ProtocolBenchmark(size_t size);
+
+        /// Sends and receives @p operations frames.
+        quint64 run(quint64 operations);
+
+    private:
+        QByteArray _data;
+};
+
+} // namespace pelican
+
+#endif // PROTOCOLBENCHMARK_H
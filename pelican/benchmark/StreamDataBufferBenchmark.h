@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef STREAMDATABUFFERBENCHMARK_H
+#define STREAMDATABUFFERBENCHMARK_H
+
+/**
+ * @file StreamDataBufferBenchmark.h
+ */
+
+#include "benchmark/MicroBenchmark.h"
+
+namespace pelican {
+
+class Config;
+class DataManager;
+class StreamDataBuffer;
+
+/**
+ * @ingroup c_benchmark
+ *
+ * @class StreamDataBufferBenchmark
+ *
+ * @brief
+ * Times the StreamDataBuffer hand-over of chunks under contention.
+ *
+ * @details
+ * One writer thread fills chunks with getWritable() while a number of reader
+ * threads take them with getNext() and release them, as sessions do in the
+ * server, and the calling thread processes the events that return released
+ * chunks to the buffer. An operation is one chunk written.
+ */
+class StreamDataBufferBenchmark : public MicroBenchmark
+{
+    public:
+        /// Constructs the benchmark for a buffer of @p chunks chunks of
+        /// @p chunkSize bytes and @p readers reader threads.
+        StreamDataBufferBenchmark(size_t chunkSize, int chunks, int readers);
+
+        /// Creates the buffer.
+        void setUp();
+
+        /// Destroys the buffer.
+        void tearDown();
+
+        /// Writes and reads @p operations chunks.
+        quint64 run(quint64 operations);
+
+    private:
+        size_t _chunkSize;
+        int _chunks;
+        int _readers;
+        Config* _config;
+        DataManager* _dataManager;
+        StreamDataBuffer* _buffer;
+};
+
+} // namespace pelican
+
+#endif // STREAMDATABUFFERBENCHMARK_H
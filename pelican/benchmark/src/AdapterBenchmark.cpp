@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/AdapterBenchmark.h"
+#include "core/AbstractAdapter.h"
+#include "data/DataBlob.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QBuffer>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs the benchmark.
+ */
+AdapterBenchmark::AdapterBenchmark(const QString& name,
+        AbstractAdapter* adapter, DataBlob* blob, size_t size)
+: MicroBenchmark(QString("Adapter/%1/%2B").arg(name).arg(size), size),
+  _adapter(adapter), _blob(blob), _chunk(int(size), 'a')
+{
+}
+
+/**
+ * @details
+ * Destroys the adapter and the data blob.
+ */
+AdapterBenchmark::~AdapterBenchmark()
+{
+    delete _adapter;
+    delete _blob;
+}
+
+/**
+ * @details
+ * Deserialises the chunk @p operations times.
+ */
+quint64 AdapterBenchmark::run(quint64 operations)
+{
+    QBuffer buffer(&_chunk);
+    buffer.open(QIODevice::ReadOnly);
+
+    quint64 start = TimingRecorder::now();
+    for (quint64 i = 0; i < operations; ++i) {
+        buffer.seek(0);
+        _adapter->config(_blob, _chunk.size());
+        _adapter->deserialise(&buffer);
+    }
+    return TimingRecorder::now() - start;
+}
+
+} // namespace pelican
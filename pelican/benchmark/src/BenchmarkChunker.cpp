@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/BenchmarkChunker.h"
+#include "utility/ConfigNode.h"
+
+namespace pelican {
+
+QMutex BenchmarkChunker::_mutex;
+AbstractUdpChunker::Statistics BenchmarkChunker::_last;
+
+/**
+ * @details
+ * Constructs the chunker, reading the packet size from the configuration.
+ */
+BenchmarkChunker::BenchmarkChunker(const ConfigNode& config)
+: AbstractUdpChunker(config)
+{
+    setPacketSize(config.getOption("packet", "size", "8208").toUInt(),
+            config.getOption("packet", "headerSize", "16").toUInt());
+}
+
+/**
+ * @details
+ * Destroys the chunker, keeping a copy of its statistics.
+ */
+BenchmarkChunker::~BenchmarkChunker()
+{
+    QMutexLocker locker(&_mutex);
+    _last = statistics();
+}
+
+/**
+ * @details
+ * Returns the statistics of the last benchmark chunker destroyed.
+ */
+AbstractUdpChunker::Statistics BenchmarkChunker::lastStatistics()
+{
+    QMutexLocker locker(&_mutex);
+    return _last;
+}
+
+} // namespace pelican
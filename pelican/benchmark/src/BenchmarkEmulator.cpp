@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/BenchmarkEmulator.h"
+#include "utility/ConfigNode.h"
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs the emulator and fills the packet payload with a pattern.
+ */
+BenchmarkEmulator::BenchmarkEmulator(const ConfigNode& config)
+: AbstractUdpEmulator(config), _counter(0)
+{
+    int size = config.getOption("packet", "size", "8208").toInt();
+    _packets = config.getOption("packet", "count", "100000").toInt();
+    if (size < 8)
+        throw QString("BenchmarkEmulator: Packet size too small.");
+    _packet.resize(size);
+    for (int i = 0; i < size; ++i)
+        _packet[i] = char(i);
+}
+
+/**
+ * @details
+ * Returns the packet with the sequence field set to the packet index.
+ */
+void BenchmarkEmulator::getPacketData(char*& ptr, unsigned long& size)
+{
+    ptr = _packet.data();
+    size = _packet.size();
+    setPacketSequence(ptr, _counter++);
+}
+
+} // namespace pelican
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/BenchmarkPipeline.h"
+#include "benchmark/BenchmarkData.h"
+#include "utility/ConfigNode.h"
+#include "utility/LatencyMonitor.h"
+#include "utility/TimingRecorder.h"
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs the pipeline.
+ */
+BenchmarkPipeline::BenchmarkPipeline()
+: AbstractPipeline(), _output(false), _chunks(0), _bytes(0), _lost(0),
+  _first(0), _last(0)
+{
+}
+
+/**
+ * @details
+ * Requests the benchmark data and reads the pipeline options.
+ */
+void BenchmarkPipeline::init()
+{
+    requestRemoteData("BenchmarkData");
+    _output = config("BenchmarkPipeline").getOption("output", "enabled",
+            "false") == "true";
+}
+
+/**
+ * @details
+ * Records the size, lost packets and latency of the chunk, and passes it on
+ * to the output streamers if enabled.
+ */
+void BenchmarkPipeline::run(QHash<QString, DataBlob*>& data)
+{
+    BenchmarkData* blob = static_cast<BenchmarkData*>(data["BenchmarkData"]);
+    quint64 now = TimingRecorder::now();
+    qint64 latency = blob->timestamp() ? LatencyMonitor::now() -
+            blob->timestamp() : -1;
+
+    if (_output)
+        dataOutput(blob, "benchmark");
+
+    QMutexLocker locker(&_mutex);
+    if (_chunks++ == 0)
+        _first = now;
+    _last = now;
+    _bytes += blob->size();
+    _lost += blob->lostPackets();
+    if (latency >= 0)
+        _latency.add(latency);
+}
+
+/**
+ * @details
+ * Writes the counters to @p stream as one line of @c key=value pairs,
+ * starting with @c BENCHMARK, with times in nanoseconds. The elapsed time
+ * runs from the first to the last chunk received.
+ */
+void BenchmarkPipeline::report(std::ostream& stream) const
+{
+    QMutexLocker locker(&_mutex);
+    stream << "BENCHMARK"
+           << " chunks=" << _chunks
+           << " bytes=" << _bytes
+           << " lost=" << _lost
+           << " elapsed=" << _last - _first
+           << " latencies=" << _latency.count()
+           << " p50=" << _latency.percentile(50.0)
+           << " p90=" << _latency.percentile(90.0)
+           << " p99=" << _latency.percentile(99.0)
+           << " max=" << _latency.max()
+           << std::endl;
+}
+
+} // namespace pelican
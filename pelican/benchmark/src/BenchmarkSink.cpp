@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/BenchmarkSink.h"
+#include "comms/DataBlobResponse.h"
+#include "utility/ConfigNode.h"
+#include "utility/LatencyMonitor.h"
+
+#include <QtNetwork/QTcpSocket>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a sink subscribed to the @c benchmark stream of the blob
+ * server on the local host at @p port.
+ */
+BenchmarkSink::BenchmarkSink(quint16 port)
+: DataBlobClient(ConfigNode(QString(
+        "<sink>"
+        "<connection host=\"127.0.0.1\" port=\"%1\"/>"
+        "<subscribe stream=\"benchmark\"/>"
+        "</sink>").arg(port))),
+  _blobs(0), _bytes(0)
+{
+}
+
+/**
+ * @details
+ * Reads the blob into the sink's own data blob, and records its size and
+ * latency.
+ */
+void BenchmarkSink::dataReceived(DataBlobResponse* response)
+{
+    _blob.setTimestamp(0);
+    response->readBlob(_blob, *_tcpSocket);
+    ++_blobs;
+    _bytes += response->dataSize();
+    if (_blob.timestamp())
+        _latency.add(qMax(LatencyMonitor::now() - _blob.timestamp(),
+                Q_INT64_C(0)));
+}
+
+} // namespace pelican
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/BlobSerialiseBenchmark.h"
+#include "data/DataBlob.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QBuffer>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs the benchmark, serialising the blob once for deserialisation.
+ */
+BlobSerialiseBenchmark::BlobSerialiseBenchmark(DataBlob* blob,
+        bool deserialise)
+: MicroBenchmark(QString("DataBlob/%1/%2/%3B").arg(blob->type())
+        .arg(deserialise ? "deserialise" : "serialise")
+        .arg(blob->serialisedBytes()), blob->serialisedBytes()),
+  _blob(blob), _deserialise(deserialise)
+{
+    QBuffer buffer(&_serialised);
+    buffer.open(QIODevice::WriteOnly);
+    _blob->serialise(buffer);
+}
+
+/**
+ * @details
+ * Destroys the data blob.
+ */
+BlobSerialiseBenchmark::~BlobSerialiseBenchmark()
+{
+    delete _blob;
+}
+
+/**
+ * @details
+ * Serialises or deserialises the blob @p operations times, reusing the
+ * device memory.
+ */
+quint64 BlobSerialiseBenchmark::run(quint64 operations)
+{
+    QBuffer buffer(&_serialised);
+    buffer.open(_deserialise ? QIODevice::ReadOnly : QIODevice::ReadWrite);
+
+    quint64 start = TimingRecorder::now();
+    for (quint64 i = 0; i < operations; ++i) {
+        buffer.seek(0);
+        if (_deserialise)
+            _blob->deserialise(buffer, QSysInfo::ByteOrder);
+        else
+            _blob->serialise(buffer);
+    }
+    return TimingRecorder::now() - start;
+}
+
+} // namespace pelican
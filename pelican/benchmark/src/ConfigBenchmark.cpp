@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/ConfigBenchmark.h"
+#include "utility/ConfigNode.h"
+#include "utility/TimingRecorder.h"
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs the benchmark and its configuration.
+ */
+ConfigBenchmark::ConfigBenchmark(int modules)
+: MicroBenchmark(QString("Config/get+getOption/%1modules").arg(modules)),
+  _modules(modules)
+{
+    QString xml = "<modules>";
+    for (int i = 0; i < _modules; ++i) {
+        xml += QString(
+                "<Module%1 name=\"module%1\">"
+                "<connection host=\"127.0.0.1\" port=\"%2\"/>"
+                "<data type=\"Data%1\" chunkSize=\"8192\"/>"
+                "<option value=\"%1\"/>"
+                "</Module%1>").arg(i).arg(2000 + i);
+    }
+    xml += "</modules>";
+    _config.setFromString(xml);
+
+    for (int i = 0; i < _modules; ++i) {
+        Config::TreeAddress address;
+        address << Config::NodeId("configuration", "");
+        address << Config::NodeId("pipeline", "");
+        address << Config::NodeId("modules", "");
+        address << Config::NodeId(QString("Module%1").arg(i),
+                QString("module%1").arg(i));
+        _addresses.append(address);
+    }
+}
+
+/**
+ * @details
+ * Looks up the node and an option of each module in turn, returning the
+ * time taken.
+ */
+quint64 ConfigBenchmark::run(quint64 operations)
+{
+    int found = 0;
+    quint64 start = TimingRecorder::now();
+    for (quint64 i = 0; i < operations; ++i) {
+        ConfigNode node = _config.get(_addresses[int(i % _modules)]);
+        found += node.getOption("option", "value").size();
+    }
+    quint64 elapsed = TimingRecorder::now() - start;
+    if (found == 0)
+        throw QString("ConfigBenchmark: Options not found.");
+    return elapsed;
+}
+
+} // namespace pelican
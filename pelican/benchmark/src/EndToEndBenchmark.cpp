@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/EndToEndBenchmark.h"
+#include "benchmark/BenchmarkChunker.h"
+#include "benchmark/BenchmarkEmulator.h"
+#include "benchmark/BenchmarkPipeline.h"
+#include "benchmark/BenchmarkSink.h"
+#include "benchmark/JsonWriter.h"
+#include "comms/PelicanProtocol.h"
+#include "core/PipelineApplication.h"
+#include "emulator/EmulatorDriver.h"
+#include "server/PelicanServer.h"
+#include "utility/Config.h"
+#include "utility/ConfigNode.h"
+#include "utility/TimingHistogram.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QProcess>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+
+#include <iostream>
+#include <unistd.h>
+
+namespace pelican {
+
+namespace {
+
+/**
+ * @details
+ * Waits for the standard input of a pipeline process to be closed, then
+ * writes the pipeline report and exits the process. The pipeline driver
+ * may be blocked waiting for data, so the process is not shut down cleanly.
+ */
+class StdinWatcher : public QThread
+{
+    public:
+        StdinWatcher(const BenchmarkPipeline* pipeline)
+        : QThread(), _pipeline(pipeline) {}
+
+    protected:
+        void run()
+        {
+            char buffer[256];
+            while (::read(STDIN_FILENO, buffer, sizeof(buffer)) > 0) {}
+            _pipeline->report(std::cout);
+            std::cout.flush();
+            _exit(0);
+        }
+
+    private:
+        const BenchmarkPipeline* _pipeline;
+};
+
+} // namespace
+
+/**
+ * @details
+ * Constructs the benchmark, reading the sweep and the settings of each
+ * stage from the configuration node (see the class description).
+ */
+EndToEndBenchmark::EndToEndBenchmark(const ConfigNode& config)
+{
+    _chunkPackets = _numbers(config.getOption("sweep", "chunkPackets", "64"));
+    _clients = _numbers(config.getOption("sweep", "clients", "1"));
+    _rates = _numbers(config.getOption("sweep", "rates", "0"));
+    _packetSize = config.getOption("packet", "size", "8208").toInt();
+    _headerSize = config.getOption("packet", "headerSize", "16").toInt();
+    _packets = config.getOption("packet", "count", "200000").toInt();
+    _senderThreads = config.getOption("emulator", "threads", "0").toInt();
+    _senderBatch = config.getOption("emulator", "batch", "64").toInt();
+    _host = config.getOption("server", "host", "127.0.0.1");
+    _port = config.getOption("server", "port", "2100").toUShort();
+    _buffer = config.getOption("server", "buffer", "268435456").toLongLong();
+    _receiver = config.getOption("server", "receiver", "qt");
+    _reorder = config.getOption("server", "reorder", "64").toInt();
+    _output = config.getOption("output", "enabled", "true") == "true";
+    _startup = config.getOption("timing", "startup", "2").toDouble();
+    _settle = config.getOption("timing", "settle", "2").toDouble();
+    _stop = config.getOption("timing", "stop", "10").toDouble();
+
+    if (_chunkPackets.isEmpty() || _clients.isEmpty() || _rates.isEmpty())
+        throw QString("EndToEndBenchmark: Empty sweep.");
+    if (_packetSize < 8 || _headerSize < 8 || _headerSize > _packetSize)
+        throw QString("EndToEndBenchmark: Invalid packet size.");
+    foreach (double clients, _clients) {
+        if (clients < 1 || clients > 90)
+            throw QString("EndToEndBenchmark: Clients must be 1 to 90.");
+    }
+}
+
+/**
+ * @details
+ * Runs every combination of chunk size, client count and rate, and writes
+ * an object for each to the @c runs array of the report.
+ */
+void EndToEndBenchmark::run(JsonWriter& json)
+{
+    json.beginObject();
+    json.addString("benchmark", "endToEnd");
+    json.addInteger("packetSize", _packetSize);
+    json.addInteger("packets", _packets);
+    json.addInteger("senderThreads", _senderThreads);
+    json.addString("receiver", _receiver);
+    json.addInteger("serverBuffer", _buffer);
+    json.addBool("output", _output);
+    json.beginArray("runs");
+    int index = 0;
+    foreach (double chunkPackets, _chunkPackets) {
+        foreach (double clients, _clients) {
+            foreach (double rate, _rates) {
+                std::cout << "EndToEndBenchmark: chunk=" << chunkPackets
+                          << " packets, clients=" << clients
+                          << ", rate=" << rate << " packets/s" << std::endl;
+                _runPoint(index++, int(chunkPackets), int(clients), rate,
+                        json);
+            }
+        }
+    }
+    json.endArray();
+    json.endObject();
+}
+
+/**
+ * @details
+ * Runs a benchmark pipeline process: creates the pipeline application from
+ * @p configFile, and runs the pipeline until the standard input is closed,
+ * when the pipeline counters are written to the standard output.
+ */
+int EndToEndBenchmark::runPipeline(const QString& configFile)
+{
+    Config config(configFile);
+    PipelineApplication application(config);
+    BenchmarkPipeline* pipeline = new BenchmarkPipeline;
+    application.registerPipeline(pipeline);
+    application.setDataClient("PelicanServerClient");
+
+    StdinWatcher watcher(pipeline);
+    watcher.start();
+    application.start();
+    watcher.wait();
+    return 0;
+}
+
+/**
+ * @details
+ * Runs one point of the sweep. The point uses the ports from
+ * <tt>port + 100 * index</tt>: the server listens on the first, the
+ * chunker on the next and the blob servers of the pipelines from the
+ * tenth onwards.
+ */
+void EndToEndBenchmark::_runPoint(int index, int chunkPackets, int clients,
+        double rate, JsonWriter& json)
+{
+    quint16 serverPort = _port + 100 * index;
+    quint16 udpPort = serverPort + 1;
+
+    // Start the server.
+    Config serverConfig;
+    serverConfig.setFromString("", _serverXml(udpPort, chunkPackets));
+    PelicanServer* server = new PelicanServer(&serverConfig);
+    server->addStreamChunker("BenchmarkChunker");
+    server->addProtocol(new PelicanProtocol, serverPort);
+    server->start();
+    for (int i = 0; !server->isReady(); ++i) {
+        if (i == 1000) {
+            delete server;
+            throw QString("EndToEndBenchmark: Server did not start.");
+        }
+        _wait(0.01);
+    }
+
+    // Start the pipeline processes.
+    QList<QTemporaryFile*> files;
+    QList<QProcess*> pipelines;
+    for (int i = 0; i < clients; ++i) {
+        QTemporaryFile* file = new QTemporaryFile;
+        files.append(file);
+        if (!file->open())
+            throw QString("EndToEndBenchmark: Cannot write configuration.");
+        QTextStream(file) << _pipelineXml(serverPort, serverPort + 10 + i);
+        file->flush();
+
+        QProcess* process = new QProcess;
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        process->start(QCoreApplication::applicationFilePath(),
+                QStringList() << "--pipeline" << file->fileName());
+        pipelines.append(process);
+    }
+    _wait(_startup);
+
+    // Connect to the blob servers.
+    QList<BenchmarkSink*> sinks;
+    if (_output) {
+        for (int i = 0; i < clients; ++i)
+            sinks.append(new BenchmarkSink(serverPort + 10 + i));
+    }
+
+    // Send the packets.
+    quint64 start = TimingRecorder::now();
+    EmulatorDriver* emulator = new EmulatorDriver(new BenchmarkEmulator(
+            ConfigNode(_emulatorXml(udpPort, rate))));
+    while (!emulator->wait(10))
+        QCoreApplication::processEvents();
+    double sendTime = (TimingRecorder::now() - start) * 1e-9;
+    quint64 sentPackets = emulator->packetCount();
+    quint64 sentBytes = emulator->dataCount();
+    delete emulator;
+    _wait(_settle);
+
+    // Stop the pipelines and collect their reports.
+    QList<QHash<QString, QString> > reports;
+    foreach (QProcess* process, pipelines) {
+        process->closeWriteChannel();
+        if (!process->waitForFinished(int(_stop * 1000))) {
+            std::cerr << "EndToEndBenchmark: Pipeline did not stop."
+                      << std::endl;
+            process->kill();
+            process->waitForFinished();
+        }
+        reports.append(_parseReport(process->readAll()));
+    }
+    qDeleteAll(pipelines);
+    qDeleteAll(files);
+
+    // Stop the server.
+    delete server;
+    AbstractUdpChunker::Statistics stats = BenchmarkChunker::lastStatistics();
+
+    // Write the results.
+    json.beginObject();
+    json.addInteger("chunkPackets", chunkPackets);
+    json.addInteger("chunkBytes", qint64(chunkPackets) * _packetSize);
+    json.addInteger("clients", clients);
+    json.addNumber("rate", rate);
+
+    json.beginObject("emulator");
+    json.addInteger("packets", sentPackets);
+    json.addInteger("bytes", sentBytes);
+    json.addNumber("seconds", sendTime);
+    json.addNumber("packetRate", sentPackets / sendTime);
+    json.addNumber("gbps", sentBytes * 8e-9 / sendTime);
+    json.endObject();
+
+    json.beginObject("server");
+    json.addInteger("chunks", stats.chunks);
+    json.addInteger("packets", stats.packets);
+    json.addInteger("lost", stats.lost);
+    json.addInteger("invalid", stats.invalid);
+    json.addInteger("discarded", stats.discarded);
+    json.addInteger("late", stats.late);
+    json.addInteger("dropped", qMax(qint64(sentPackets) -
+            qint64(stats.packets - stats.lost), Q_INT64_C(0)));
+    json.addNumber("packetsPerRead", stats.packetsPerRead());
+    json.endObject();
+
+    json.beginArray("pipelines");
+    qint64 totalChunks = 0;
+    for (int i = 0; i < reports.size(); ++i) {
+        const QHash<QString, QString>& report = reports[i];
+        qint64 chunks = report.value("chunks").toLongLong();
+        qint64 bytes = report.value("bytes").toLongLong();
+        double seconds = report.value("elapsed").toLongLong() * 1e-9;
+        totalChunks += chunks;
+        json.beginObject();
+        json.addBool("reported", !report.isEmpty());
+        json.addInteger("chunks", chunks);
+        json.addInteger("bytes", bytes);
+        json.addInteger("lostPackets", report.value("lost").toLongLong());
+        json.addNumber("seconds", seconds);
+        json.addNumber("gbps", bytes * 8e-9 / seconds);
+        json.beginObject("latency");
+        json.addInteger("count", report.value("latencies").toLongLong());
+        json.addNumber("p50", report.value("p50").toLongLong() * 1e-6);
+        json.addNumber("p90", report.value("p90").toLongLong() * 1e-6);
+        json.addNumber("p99", report.value("p99").toLongLong() * 1e-6);
+        json.addNumber("max", report.value("max").toLongLong() * 1e-6);
+        json.endObject();
+        json.endObject();
+    }
+    json.endArray();
+    json.addInteger("pipelineChunks", totalChunks);
+    json.addInteger("unservedChunks", qMax(qint64(stats.chunks) - totalChunks,
+            Q_INT64_C(0)));
+
+    json.beginArray("output");
+    foreach (BenchmarkSink* sink, sinks) {
+        json.beginObject();
+        json.addInteger("blobs", sink->blobs());
+        json.addInteger("bytes", sink->bytes());
+        json.beginObject("latency");
+        _writeLatency(json, sink->latency());
+        json.endObject();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    qDeleteAll(sinks);
+}
+
+/**
+ * @details
+ * Returns the server configuration, with a stream buffer for the benchmark
+ * data and a sequenced BenchmarkChunker listening on @p port.
+ */
+QString EndToEndBenchmark::_serverXml(quint16 port, int chunkPackets) const
+{
+    qint64 chunkSize = qint64(chunkPackets) * _packetSize;
+    return QString(
+            "<buffers>"
+            "<BenchmarkData>"
+            "<buffer maxSize=\"%1\" maxChunkSize=\"%2\"/>"
+            "</BenchmarkData>"
+            "</buffers>"
+            "<chunkers>"
+            "<BenchmarkChunker>"
+            "<connection host=\"%3\" port=\"%4\"/>"
+            "<data type=\"BenchmarkData\"/>"
+            "<packet size=\"%5\" headerSize=\"%6\"/>"
+            "<chunk packets=\"%7\"/>"
+            "<sequence offset=\"0\" bytes=\"8\" reorder=\"%8\"/>"
+            "<receiver type=\"%9\"/>"
+            "</BenchmarkChunker>"
+            "</chunkers>")
+            .arg(qMax(_buffer, chunkSize)).arg(chunkSize).arg(_host)
+            .arg(port).arg(_packetSize).arg(_headerSize).arg(chunkPackets)
+            .arg(_reorder).arg(_receiver);
+}
+
+/**
+ * @details
+ * Returns the configuration document of a pipeline process that reads
+ * from the server at @p serverPort and serves its output on @p blobPort.
+ */
+QString EndToEndBenchmark::_pipelineXml(quint16 serverPort,
+        quint16 blobPort) const
+{
+    return QString(
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE pelican>\n"
+            "<configuration version=\"1.0\">\n"
+            "  <pipeline>\n"
+            "    <pipelineConfig>\n"
+            "      <BenchmarkPipeline>\n"
+            "        <output enabled=\"%1\"/>\n"
+            "      </BenchmarkPipeline>\n"
+            "    </pipelineConfig>\n"
+            "    <clients>\n"
+            "      <PelicanServerClient>\n"
+            "        <server host=\"%2\" port=\"%3\"/>\n"
+            "        <data type=\"BenchmarkData\" adapter=\"BenchmarkAdapter\"/>\n"
+            "      </PelicanServerClient>\n"
+            "    </clients>\n"
+            "    <adapters>\n"
+            "      <BenchmarkAdapter/>\n"
+            "    </adapters>\n"
+            "    <output>\n"
+            "      <streamers>\n"
+            "        <PelicanTCPBlobServer active=\"%1\">\n"
+            "          <connection port=\"%4\"/>\n"
+            "        </PelicanTCPBlobServer>\n"
+            "      </streamers>\n"
+            "      <dataStreams>\n"
+            "        <stream name=\"benchmark\" listeners=\"PelicanTCPBlobServer\"/>\n"
+            "      </dataStreams>\n"
+            "    </output>\n"
+            "  </pipeline>\n"
+            "</configuration>\n")
+            .arg(_output ? "true" : "false").arg(_host).arg(serverPort)
+            .arg(blobPort);
+}
+
+/**
+ * @details
+ * Returns the emulator configuration for sending to @p port at @p rate
+ * packets per second (0 for no pacing).
+ */
+QString EndToEndBenchmark::_emulatorXml(quint16 port, double rate) const
+{
+    QString pacing;
+    if (rate > 0.0)
+        pacing = QString("<pacing rate=\"%1\" unit=\"packets\"/>").arg(rate);
+    return QString(
+            "<BenchmarkEmulator>"
+            "<connection host=\"%1\" port=\"%2\"/>"
+            "<packet size=\"%3\" count=\"%4\"/>"
+            "<sequence offset=\"0\" bytes=\"8\"/>"
+            "<senders threads=\"%5\" batch=\"%6\"/>"
+            "%7"
+            "</BenchmarkEmulator>")
+            .arg(_host).arg(port).arg(_packetSize).arg(_packets)
+            .arg(_senderThreads).arg(_senderBatch).arg(pacing);
+}
+
+/**
+ * @details
+ * Processes events in the calling thread for @p seconds.
+ */
+void EndToEndBenchmark::_wait(double seconds)
+{
+    quint64 end = TimingRecorder::now() + quint64(seconds * 1e9);
+    while (TimingRecorder::now() < end) {
+        QCoreApplication::processEvents();
+        usleep(1000);
+    }
+}
+
+/**
+ * @details
+ * Returns the @c key=value pairs of the @c BENCHMARK line in the output of
+ * a pipeline process (empty if there is none).
+ */
+QHash<QString, QString> EndToEndBenchmark::_parseReport(const QString& output)
+{
+    QHash<QString, QString> values;
+    foreach (const QString& line, output.split('\n')) {
+        QStringList fields = line.trimmed().split(' ', QString::SkipEmptyParts);
+        if (fields.isEmpty() || fields[0] != "BENCHMARK")
+            continue;
+        for (int i = 1; i < fields.size(); ++i) {
+            int equals = fields[i].indexOf('=');
+            if (equals > 0)
+                values[fields[i].left(equals)] = fields[i].mid(equals + 1);
+        }
+    }
+    return values;
+}
+
+/**
+ * @details
+ * Writes the count and percentiles of @p latency, in milliseconds.
+ */
+void EndToEndBenchmark::_writeLatency(JsonWriter& json,
+        const TimingHistogram& latency)
+{
+    json.addInteger("count", latency.count());
+    json.addNumber("p50", latency.percentile(50.0) * 1e-6);
+    json.addNumber("p90", latency.percentile(90.0) * 1e-6);
+    json.addNumber("p99", latency.percentile(99.0) * 1e-6);
+    json.addNumber("max", latency.max() * 1e-6);
+}
+
+/**
+ * @details
+ * Returns the numbers in the comma-separated @p list.
+ */
+QList<double> EndToEndBenchmark::_numbers(const QString& list)
+{
+    QList<double> numbers;
+    foreach (const QString& item, list.split(',', QString::SkipEmptyParts))
+        numbers.append(item.trimmed().toDouble());
+    return numbers;
+}
+
+} // namespace pelican
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/FanOutBenchmark.h"
+#include "comms/DataBlobResponse.h"
+#include "comms/PelicanClientProtocol.h"
+#include "comms/ServerResponse.h"
+#include "comms/StreamDataRequest.h"
+#include "data/ArrayData.h"
+#include "data/DataSpec.h"
+#include "output/TCPConnectionManager.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QTcpSocket>
+
+#include <boost/shared_ptr.hpp>
+
+namespace pelican {
+
+namespace {
+
+// Subscribes to a stream and receives a number of blobs.
+class Client : public QThread
+{
+    public:
+        Client(quint16 port, const QString& stream, quint64 blobs)
+        : _port(port), _stream(stream), _blobs(blobs), _failed(false) {}
+
+        bool failed() const { return _failed; }
+
+    protected:
+        void run()
+        {
+            QTcpSocket socket;
+            socket.connectToHost(QHostAddress::LocalHost, _port);
+            if (!socket.waitForConnected(5000)) {
+                _failed = true;
+                return;
+            }
+            PelicanClientProtocol protocol;
+            protocol.setTimeout(10000);
+            StreamDataRequest request;
+            DataSpec spec;
+            spec.addStreamData(_stream);
+            request.addDataOption(spec);
+            socket.write(protocol.serialise(request));
+            while (socket.bytesToWrite() > 0)
+                socket.waitForBytesWritten(-1);
+
+            DoubleData blob;
+            for (quint64 i = 0; i < _blobs; ) {
+                boost::shared_ptr<ServerResponse> response =
+                        protocol.receive(socket);
+                if (response->type() == ServerResponse::Error) {
+                    _failed = true;
+                    return;
+                }
+                if (response->type() == ServerResponse::Blob) {
+                    static_cast<DataBlobResponse*>(response.get())->readBlob(
+                            blob, socket);
+                    ++i;
+                }
+            }
+        }
+
+    private:
+        quint16 _port;
+        QString _stream;
+        quint64 _blobs;
+        bool _failed;
+};
+
+} // namespace
+
+/**
+ * @details
+ * Constructs the benchmark.
+ */
+FanOutBenchmark::FanOutBenchmark(size_t size, int clients)
+: MicroBenchmark(QString("TCPConnectionManager/fanOut/%1B/%2clients")
+        .arg(size).arg(clients), size * clients),
+  _clients(clients), _runs(0), _blob(new DoubleData), _manager(0)
+{
+    _blob->resize(size / sizeof(double));
+}
+
+/**
+ * @details
+ * Destroys the benchmark.
+ */
+FanOutBenchmark::~FanOutBenchmark()
+{
+    delete _manager;
+    delete _blob;
+}
+
+/**
+ * @details
+ * Creates the connection manager, listening on a free port.
+ */
+void FanOutBenchmark::setUp()
+{
+    _manager = new TCPConnectionManager(0);
+}
+
+/**
+ * @details
+ * Destroys the connection manager.
+ */
+void FanOutBenchmark::tearDown()
+{
+    delete _manager;
+    _manager = 0;
+}
+
+/**
+ * @details
+ * Connects the clients to a new stream, then returns the time taken to send
+ * @p operations blobs to the stream and for every client to receive them.
+ */
+quint64 FanOutBenchmark::run(quint64 operations)
+{
+    QString stream = QString("FanOutBenchmark%1").arg(_runs++);
+    QList<Client*> clients;
+    for (int i = 0; i < _clients; ++i) {
+        clients.append(new Client(_manager->serverPort(), stream, operations));
+        clients.last()->start();
+    }
+
+    // Wait for the subscriptions.
+    quint64 timeout = TimingRecorder::now() + Q_UINT64_C(10000000000);
+    while (_manager->clientsForStream(stream) < _clients) {
+        QCoreApplication::processEvents();
+        if (TimingRecorder::now() > timeout) {
+            foreach (Client* client, clients)
+                client->wait();
+            qDeleteAll(clients);
+            throw QString("FanOutBenchmark: Clients did not subscribe.");
+        }
+    }
+
+    quint64 start = TimingRecorder::now();
+    for (quint64 i = 0; i < operations; ++i) {
+        _manager->send(stream, _blob);
+        QCoreApplication::processEvents();
+    }
+    bool failed = false;
+    foreach (Client* client, clients) {
+        while (!client->wait(1))
+            QCoreApplication::processEvents();
+        failed = failed || client->failed();
+    }
+    quint64 elapsed = TimingRecorder::now() - start;
+    qDeleteAll(clients);
+    if (failed)
+        throw QString("FanOutBenchmark: Client failed.");
+    return elapsed;
+}
+
+} // namespace pelican
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/JsonWriter.h"
+
+#include <cmath>
+
+namespace pelican {
+
+/**
+ * @details
+ * Opens an object, as the value of @p key if the current container is an
+ * object.
+ */
+void JsonWriter::beginObject(const QString& key)
+{
+    _next(key);
+    _text += "{";
+    _empty.append(true);
+    _object.append(true);
+}
+
+/**
+ * @details
+ * Closes the current object.
+ */
+void JsonWriter::endObject()
+{
+    if (_object.isEmpty() || !_object.last())
+        throw QString("JsonWriter: No object to close.");
+    bool empty = _empty.takeLast();
+    _object.removeLast();
+    if (!empty)
+        _text += "\n" + QString(2 * _object.size(), ' ');
+    _text += "}";
+    if (_object.isEmpty())
+        _text += "\n";
+}
+
+/**
+ * @details
+ * Opens an array, as the value of @p key if the current container is an
+ * object.
+ */
+void JsonWriter::beginArray(const QString& key)
+{
+    _next(key);
+    _text += "[";
+    _empty.append(true);
+    _object.append(false);
+}
+
+/**
+ * @details
+ * Closes the current array.
+ */
+void JsonWriter::endArray()
+{
+    if (_object.isEmpty() || _object.last())
+        throw QString("JsonWriter: No array to close.");
+    bool empty = _empty.takeLast();
+    _object.removeLast();
+    if (!empty)
+        _text += "\n" + QString(2 * _object.size(), ' ');
+    _text += "]";
+}
+
+/**
+ * @details
+ * Adds a floating point value, written as null if it is not finite.
+ */
+void JsonWriter::addNumber(const QString& key, double value)
+{
+    _next(key);
+    // NaN and infinity (e.g. rates over no time) are not valid JSON.
+    if (value != value || std::fabs(value) > 1e308)
+        _text += "null";
+    else
+        _text += QString::number(value, 'g', 10);
+}
+
+/**
+ * @details
+ * Adds an integer value.
+ */
+void JsonWriter::addInteger(const QString& key, qint64 value)
+{
+    _next(key);
+    _text += QString::number(value);
+}
+
+/**
+ * @details
+ * Adds a string value.
+ */
+void JsonWriter::addString(const QString& key, const QString& value)
+{
+    _next(key);
+    _text += quote(value);
+}
+
+/**
+ * @details
+ * Adds a boolean value.
+ */
+void JsonWriter::addBool(const QString& key, bool value)
+{
+    _next(key);
+    _text += value ? "true" : "false";
+}
+
+
+/**
+ * @details
+ * Escapes quotes, backslashes and control characters.
+ */
+QString JsonWriter::quote(const QString& value)
+{
+    QString s("\"");
+    for (int i = 0; i < value.size(); ++i) {
+        QChar c = value[i];
+        if (c == '"') s += "\\\"";
+        else if (c == '\\') s += "\\\\";
+        else if (c == '\n') s += "\\n";
+        else if (c == '\t') s += "\\t";
+        else if (c.unicode() < 0x20)
+            s += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+        else s += c;
+    }
+    return s + "\"";
+}
+
+/**
+ * @details
+ * Writes the separator, indentation and key (inside an object) that
+ * precede the next value.
+ */
+void JsonWriter::_next(const QString& key)
+{
+    if (_object.isEmpty()) {
+        if (!_text.isEmpty())
+            throw QString("JsonWriter: Document already complete.");
+        return;
+    }
+    if (!_empty.last())
+        _text += ",";
+    _empty.last() = false;
+    _text += "\n" + QString(2 * _object.size(), ' ');
+    if (_object.last())
+        _text += quote(key) + ": ";
+}
+
+} // namespace pelican
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/MicroBenchmarkRunner.h"
+#include "benchmark/MicroBenchmark.h"
+#include "benchmark/JsonWriter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QtAlgorithms>
+
+#include <cmath>
+#include <iomanip>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a runner taking 7 samples of at least 0.2 s per benchmark.
+ */
+MicroBenchmarkRunner::MicroBenchmarkRunner()
+: _samples(7), _sampleTime(0.2)
+{
+}
+
+/**
+ * @details
+ * Destroys the runner and the benchmarks added to it.
+ */
+MicroBenchmarkRunner::~MicroBenchmarkRunner()
+{
+    qDeleteAll(_benchmarks);
+}
+
+/**
+ * @details
+ * Adds a benchmark to the end of the list. The runner takes ownership of
+ * it.
+ */
+void MicroBenchmarkRunner::add(MicroBenchmark* benchmark)
+{
+    _benchmarks.append(benchmark);
+}
+
+/**
+ * @details
+ * Returns the names of the benchmarks that match the filter.
+ */
+QList<QString> MicroBenchmarkRunner::names() const
+{
+    QList<QString> names;
+    foreach (MicroBenchmark* benchmark, _benchmarks) {
+        if (_filter.isEmpty() || benchmark->name().contains(_filter))
+            names.append(benchmark->name());
+    }
+    return names;
+}
+
+/**
+ * @details
+ * Runs the benchmarks that match the filter, in the order they were added.
+ */
+QList<MicroBenchmarkRunner::Result> MicroBenchmarkRunner::run(std::ostream& log)
+{
+    QList<Result> results;
+    foreach (MicroBenchmark* benchmark, _benchmarks) {
+        if (!_filter.isEmpty() && !benchmark->name().contains(_filter))
+            continue;
+        benchmark->setUp();
+        try {
+            results.append(_run(benchmark, log));
+        }
+        catch (...) {
+            benchmark->tearDown();
+            throw;
+        }
+        benchmark->tearDown();
+    }
+    return results;
+}
+
+/**
+ * @details
+ * Calibrates, warms up and samples one benchmark.
+ */
+MicroBenchmarkRunner::Result MicroBenchmarkRunner::_run(
+        MicroBenchmark* benchmark, std::ostream& log)
+{
+    // Find the number of operations that take at least the sample time.
+    double target = _sampleTime * 1e9;
+    quint64 operations = 1;
+    for (;;) {
+        quint64 elapsed = benchmark->run(operations);
+        if (elapsed >= target)
+            break;
+        double scale = elapsed > 0 ? 1.2 * target / elapsed : 100.0;
+        operations = qMax(operations + 1,
+                quint64(operations * qMin(scale, 100.0)));
+    }
+
+    // Warm up, then take the samples.
+    benchmark->run(operations);
+    Result result;
+    result.name = benchmark->name();
+    result.operations = operations;
+    result.bytes = benchmark->bytesPerOperation();
+    for (int i = 0; i < _samples; ++i)
+        result.samples.append(double(benchmark->run(operations)) / operations);
+
+    // Summarise the samples.
+    result.median = _median(result.samples);
+    result.min = result.samples.first();
+    QList<double> deviations;
+    foreach (double sample, result.samples) {
+        result.min = qMin(result.min, sample);
+        deviations.append(std::fabs(sample - result.median));
+    }
+    result.spread = result.median > 0.0 ?
+            _median(deviations) / result.median : 0.0;
+
+    log << std::left << std::setw(48) << result.name.toStdString()
+        << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+        << result.median << " ns/op  +/-" << std::setw(5)
+        << std::setprecision(1) << 100.0 * result.spread << "%";
+    if (result.bytes > 0)
+        log << std::setw(10) << std::setprecision(2)
+            << result.bytes / result.median << " GB/s";
+    log << std::endl;
+    return result;
+}
+
+/**
+ * @details
+ * Writes the results as the @c benchmarks array of a JSON object.
+ */
+void MicroBenchmarkRunner::write(JsonWriter& json,
+        const QList<Result>& results)
+{
+    json.beginObject();
+    json.addString("benchmark", "micro");
+    json.beginArray("benchmarks");
+    foreach (const Result& result, results) {
+        json.beginObject();
+        json.addString("name", result.name);
+        json.addInteger("operations", result.operations);
+        json.addInteger("bytesPerOperation", result.bytes);
+        json.addNumber("median", result.median);
+        json.addNumber("min", result.min);
+        json.addNumber("spread", result.spread);
+        if (result.bytes > 0)
+            json.addNumber("gbps", result.bytes * 8.0 / result.median);
+        json.beginArray("samples");
+        foreach (double sample, result.samples)
+            json.addNumber(QString(), sample);
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+}
+
+/**
+ * @details
+ * Writes the name, median time per operation (ns) and spread of each
+ * result, separated by tabs, to the baseline file.
+ */
+void MicroBenchmarkRunner::saveBaseline(const QString& fileName,
+        const QList<Result>& results)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        throw QString("MicroBenchmarkRunner: Cannot write %1.").arg(fileName);
+    QTextStream out(&file);
+    out << "# name\tmedian (ns/op)\tspread\n";
+    foreach (const Result& result, results) {
+        out << result.name << '\t' << QString::number(result.median, 'g', 8)
+            << '\t' << QString::number(result.spread, 'g', 4) << '\n';
+    }
+}
+
+/**
+ * @details
+ * Compares the results with the baseline file, writing a table of the
+ * changes to @p out. A benchmark regresses if its median time per operation
+ * is more than a fraction @p threshold above the baseline, and the change
+ * is more than twice the sum of the spreads of the two measurements.
+ * Benchmarks missing from the baseline are listed but not compared.
+ */
+int MicroBenchmarkRunner::compare(const QString& fileName,
+        const QList<Result>& results, double threshold, std::ostream& out)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        throw QString("MicroBenchmarkRunner: Cannot read %1.").arg(fileName);
+    QHash<QString, QPair<double, double> > baseline;
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.startsWith('#'))
+            continue;
+        QStringList fields = line.split('\t');
+        if (fields.size() >= 3) {
+            baseline[fields[0]] = qMakePair(fields[1].toDouble(),
+                    fields[2].toDouble());
+        }
+    }
+
+    int regressions = 0;
+    out << std::left << std::setw(48) << "benchmark" << std::right
+        << std::setw(14) << "baseline" << std::setw(14) << "current"
+        << std::setw(10) << "change" << std::endl;
+    foreach (const Result& result, results) {
+        out << std::left << std::setw(48) << result.name.toStdString()
+            << std::right << std::fixed << std::setprecision(1);
+        if (!baseline.contains(result.name) || baseline[result.name].first <= 0) {
+            out << std::setw(14) << "-" << std::setw(14) << result.median
+                << std::endl;
+            continue;
+        }
+        double base = baseline[result.name].first;
+        double change = result.median / base - 1.0;
+        double noise = 2.0 * (baseline[result.name].second + result.spread);
+        out << std::setw(14) << base << std::setw(14) << result.median
+            << std::setw(9) << std::showpos << 100.0 * change << std::noshowpos
+            << "%";
+        if (change > threshold && change > noise) {
+            out << "  REGRESSION";
+            ++regressions;
+        }
+        else if (-change > threshold && -change > noise) {
+            out << "  improved";
+        }
+        out << std::endl;
+    }
+    return regressions;
+}
+
+/**
+ * @details
+ * Returns the median of the values (0 if there are none).
+ */
+double MicroBenchmarkRunner::_median(QList<double> values)
+{
+    if (values.isEmpty())
+        return 0.0;
+    qSort(values);
+    int n = values.size();
+    return n % 2 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+} // namespace pelican
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/ProtocolBenchmark.h"
+#include "comms/PelicanClientProtocol.h"
+#include "comms/PelicanProtocol.h"
+#include "comms/ServerResponse.h"
+#include "comms/StreamData.h"
+#include "comms/StreamDataResponse.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QThread>
+#include <QtNetwork/QTcpSocket>
+
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace pelican {
+
+namespace {
+
+// Sends stream data frames to a socket descriptor.
+class Sender : public QThread
+{
+    public:
+        Sender(int fd, QByteArray& data, quint64 frames)
+        : _fd(fd), _data(data), _frames(frames) {}
+
+    protected:
+        void run()
+        {
+            QTcpSocket socket;
+            if (!socket.setSocketDescriptor(_fd)) {
+                ::close(_fd);
+                return;
+            }
+            PelicanProtocol protocol;
+            StreamData streamData("ProtocolBenchmark", _data.data(),
+                    _data.size());
+            AbstractProtocol::StreamData_t frame;
+            frame.append(&streamData);
+            for (quint64 i = 0; i < _frames; ++i)
+                protocol.send(socket, frame);
+            socket.disconnectFromHost();
+        }
+
+    private:
+        int _fd;
+        QByteArray& _data;
+        quint64 _frames;
+};
+
+} // namespace
+
+/**
+ * @details
+ * Constructs the benchmark.
+ */
+ProtocolBenchmark::ProtocolBenchmark(size_t size)
+: MicroBenchmark(QString("PelicanProtocol/streamData/%1B").arg(size), size),
+  _data(int(size), 'p')
+{
+}
+
+/**
+ * @details
+ * Sends @p operations frames through a new socket pair, returning the time
+ * taken to receive them all.
+ */
+quint64 ProtocolBenchmark::run(quint64 operations)
+{
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        throw QString("ProtocolBenchmark: Cannot create socket pair.");
+    QTcpSocket socket;
+    if (!socket.setSocketDescriptor(fds[1])) {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        throw QString("ProtocolBenchmark: Cannot use socket pair.");
+    }
+    PelicanClientProtocol protocol;
+    std::vector<char> buffer(_data.size());
+    Sender sender(fds[0], _data, operations);
+
+    quint64 start = TimingRecorder::now();
+    sender.start();
+    for (quint64 i = 0; i < operations; ++i) {
+        boost::shared_ptr<ServerResponse> response = protocol.receive(socket);
+        if (response->type() != ServerResponse::StreamData) {
+            sender.wait();
+            throw QString("ProtocolBenchmark: Unexpected response: %1")
+                    .arg(response->message());
+        }
+        StreamData* streamData = static_cast<StreamDataResponse*>(
+                response.get())->streamData();
+        qint64 size = streamData->size();
+        for (qint64 read = 0; read < size; ) {
+            if (socket.bytesAvailable() == 0 && !socket.waitForReadyRead(5000)) {
+                sender.wait();
+                throw QString("ProtocolBenchmark: Timed out.");
+            }
+            read += socket.read(&buffer[0] + read, size - read);
+        }
+    }
+    quint64 elapsed = TimingRecorder::now() - start;
+    sender.wait();
+    return elapsed;
+}
+
+} // namespace pelican
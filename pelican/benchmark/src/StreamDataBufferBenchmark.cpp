@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "benchmark/StreamDataBufferBenchmark.h"
+#include "server/DataManager.h"
+#include "server/LockableStreamData.h"
+#include "server/LockedData.h"
+#include "server/StreamDataBuffer.h"
+#include "server/WritableData.h"
+#include "utility/Config.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+
+namespace pelican {
+
+namespace {
+
+// Writes chunks into the buffer.
+class Writer : public QThread
+{
+    public:
+        Writer(StreamDataBuffer* buffer, size_t size, quint64 chunks)
+        : _buffer(buffer), _size(size), _chunks(chunks) {}
+
+    protected:
+        void run()
+        {
+            for (quint64 i = 0; i < _chunks; ) {
+                WritableData data = _buffer->getWritable(_size);
+                if (!data.isValid()) {
+                    yieldCurrentThread();
+                    continue;
+                }
+                data.write(&i, sizeof(i));
+                ++i;
+            }
+        }
+
+    private:
+        StreamDataBuffer* _buffer;
+        size_t _size;
+        quint64 _chunks;
+};
+
+// Takes chunks from the buffer until the writer has finished.
+class Reader : public QThread
+{
+    public:
+        Reader(StreamDataBuffer* buffer, const QAtomicInt& writing)
+        : _buffer(buffer), _writing(writing), _chunks(0) {}
+
+        quint64 chunks() const { return _chunks; }
+
+    protected:
+        void run()
+        {
+            for (;;) {
+                bool writing = _writing != 0;
+                LockedData data("StreamDataBufferBenchmark");
+                _buffer->getNext(data);
+                if (data.isValid()) {
+                    static_cast<LockableStreamData*>(data.object())->served() = true;
+                    ++_chunks;
+                }
+                else if (!writing)
+                    break;
+                else
+                    yieldCurrentThread();
+            }
+        }
+
+    private:
+        StreamDataBuffer* _buffer;
+        const QAtomicInt& _writing;
+        quint64 _chunks;
+};
+
+} // namespace
+
+/**
+ * @details
+ * Constructs the benchmark.
+ */
+StreamDataBufferBenchmark::StreamDataBufferBenchmark(size_t chunkSize,
+        int chunks, int readers)
+: MicroBenchmark(QString("StreamDataBuffer/%1B/%2chunks/%3readers")
+        .arg(chunkSize).arg(chunks).arg(readers)),
+  _chunkSize(chunkSize), _chunks(chunks), _readers(readers),
+  _config(0), _dataManager(0), _buffer(0)
+{
+}
+
+/**
+ * @details
+ * Creates the data manager and the buffer.
+ */
+void StreamDataBufferBenchmark::setUp()
+{
+    _config = new Config;
+    _dataManager = new DataManager(_config);
+    _buffer = new StreamDataBuffer("StreamDataBufferBenchmark",
+            _chunkSize * _chunks, _chunkSize);
+    _buffer->setDataManager(_dataManager);
+}
+
+/**
+ * @details
+ * Destroys the buffer and the data manager.
+ */
+void StreamDataBufferBenchmark::tearDown()
+{
+    delete _buffer;
+    delete _dataManager;
+    delete _config;
+    _buffer = 0;
+    _dataManager = 0;
+    _config = 0;
+}
+
+/**
+ * @details
+ * Writes @p operations chunks from the writer thread while the readers take
+ * them, returning the time until the buffer has been drained. Chunks that
+ * are overwritten before a reader takes them are not counted separately.
+ */
+quint64 StreamDataBufferBenchmark::run(quint64 operations)
+{
+    QAtomicInt writing(1);
+    QList<Reader*> readers;
+    for (int i = 0; i < _readers; ++i)
+        readers.append(new Reader(_buffer, writing));
+    Writer writer(_buffer, _chunkSize, operations);
+
+    quint64 start = TimingRecorder::now();
+    foreach (Reader* reader, readers)
+        reader->start();
+    writer.start();
+    while (!writer.isFinished()) {
+        QCoreApplication::processEvents();
+        QThread::yieldCurrentThread();
+    }
+    writing.fetchAndStoreOrdered(0);
+    foreach (Reader* reader, readers) {
+        while (!reader->wait(1))
+            QCoreApplication::processEvents();
+    }
+    quint64 elapsed = TimingRecorder::now() - start;
+
+    // Return the released chunks to the buffer.
+    QCoreApplication::processEvents();
+    qDeleteAll(readers);
+    return elapsed;
+}
+
+} // namespace pelican
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Runs the end-to-end benchmark, writing a JSON report.
+ */
+#include "benchmark/EndToEndBenchmark.h"
+#include "benchmark/JsonWriter.h"
+#include "utility/Config.h"
+
+// Include the headers of the types that are referenced by name.
+#include "benchmark/BenchmarkAdapter.h"
+#include "benchmark/BenchmarkChunker.h"
+#include "benchmark/BenchmarkData.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+namespace opts = boost::program_options;
+using namespace pelican;
+
+opts::variables_map process_options(int argc, char** argv);
+
+int main(int argc, char** argv)
+{
+    int rv = 0;
+    try {
+        opts::variables_map options = process_options(argc, argv);
+        QCoreApplication app(argc, argv);
+
+        // Run as a pipeline process of the benchmark.
+        if (options.count("pipeline")) {
+            return EndToEndBenchmark::runPipeline(
+                    QString::fromStdString(options["pipeline"].as<std::string>()));
+        }
+
+        Config config(QString::fromStdString(
+                options["config"].as<std::string>()));
+        Config::TreeAddress address;
+        address << Config::NodeId("EndToEndBenchmark", "");
+        EndToEndBenchmark benchmark(config.get(address));
+
+        JsonWriter json;
+        benchmark.run(json);
+
+        QString fileName = QString::fromStdString(
+                options["output"].as<std::string>());
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            throw QString("Cannot write report to %1").arg(fileName);
+        QTextStream(&file) << json.toString();
+        std::cout << "pelicanEndToEnd: Report written to "
+                  << fileName.toStdString() << std::endl;
+    }
+    catch (const boost::program_options::error& err) {
+        std::cerr << "pelicanEndToEnd ERROR: " << err.what() << std::endl;
+        rv = 1;
+    }
+    catch (const QString& err) {
+        std::cerr << "pelicanEndToEnd ERROR: " << err.toStdString() << std::endl;
+        rv = 1;
+    }
+    return rv;
+}
+
+/**
+ * @details
+ * Parses the command line options.
+ */
+opts::variables_map process_options(int argc, char** argv)
+{
+    // Declare the supported options.
+    opts::options_description desc("Allowed options");
+    desc.add_options()
+        ("help,h", "Produce help message.")
+        ("config,c", opts::value<std::string>()->default_value("endToEnd.xml"),
+                "Set benchmark configuration file.")
+        ("output,o", opts::value<std::string>()->default_value("endToEnd.json"),
+                "Set JSON report file.");
+    opts::options_description hidden;
+    hidden.add_options()
+        ("pipeline", opts::value<std::string>(),
+                "Run a pipeline process with the given configuration file.");
+    opts::options_description all;
+    all.add(desc).add(hidden);
+
+    // Parse the command line arguments.
+    opts::variables_map varMap;
+    opts::store(opts::command_line_parser(argc, argv).options(all)
+            .run(), varMap);
+    opts::notify(varMap);
+
+    // Check for help message.
+    if (varMap.count("help")) {
+        std::cout << desc << std::endl;
+        exit(0);
+    }
+    return varMap;
+}
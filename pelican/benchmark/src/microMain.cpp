@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * Runs the component microbenchmarks, writing a JSON report and optionally
+ * comparing the results with a baseline.
+ */
+#include "benchmark/AdapterBenchmark.h"
+#include "benchmark/BenchmarkAdapter.h"
+#include "benchmark/BenchmarkData.h"
+#include "benchmark/BlobSerialiseBenchmark.h"
+#include "benchmark/ConfigBenchmark.h"
+#include "benchmark/FanOutBenchmark.h"
+#include "benchmark/JsonWriter.h"
+#include "benchmark/MicroBenchmarkRunner.h"
+#include "benchmark/ProtocolBenchmark.h"
+#include "benchmark/StreamDataBufferBenchmark.h"
+#include "core/AdapterRealData.h"
+#include "data/ArrayData.h"
+#include "utility/ConfigNode.h"
+#include "utility/ThreadPlacement.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+namespace opts = boost::program_options;
+using namespace pelican;
+
+opts::variables_map process_options(int argc, char** argv);
+void addBenchmarks(MicroBenchmarkRunner& runner);
+
+int main(int argc, char** argv)
+{
+    int rv = 0;
+    try {
+        opts::variables_map options = process_options(argc, argv);
+        QCoreApplication app(argc, argv);
+
+        MicroBenchmarkRunner runner;
+        addBenchmarks(runner);
+        runner.setSamples(options["samples"].as<int>());
+        runner.setSampleTime(options["time"].as<double>());
+        if (options.count("filter"))
+            runner.setFilter(QString::fromStdString(
+                    options["filter"].as<std::string>()));
+        if (options.count("list")) {
+            foreach (const QString& name, runner.names())
+                std::cout << name.toStdString() << std::endl;
+            return 0;
+        }
+
+        // Pin the benchmarks to the given cores for stable timings.
+        if (options.count("cores")) {
+            ThreadPlacement placement;
+            placement.setCores(ThreadPlacement::parseCpuList(
+                    QString::fromStdString(options["cores"].as<std::string>())));
+            placement.apply("pelicanMicroBenchmarks");
+        }
+
+        QList<MicroBenchmarkRunner::Result> results = runner.run();
+
+        JsonWriter json;
+        MicroBenchmarkRunner::write(json, results);
+        QString fileName = QString::fromStdString(
+                options["output"].as<std::string>());
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            throw QString("Cannot write report to %1").arg(fileName);
+        QTextStream(&file) << json.toString();
+
+        if (options.count("save-baseline")) {
+            MicroBenchmarkRunner::saveBaseline(QString::fromStdString(
+                    options["save-baseline"].as<std::string>()), results);
+        }
+        if (options.count("baseline")) {
+            std::cout << std::endl;
+            int regressions = MicroBenchmarkRunner::compare(
+                    QString::fromStdString(options["baseline"].as<std::string>()),
+                    results, options["threshold"].as<double>());
+            if (regressions > 0) {
+                std::cout << regressions << " regression(s)." << std::endl;
+                rv = 2;
+            }
+        }
+    }
+    catch (const boost::program_options::error& err) {
+        std::cerr << "pelicanMicroBenchmarks ERROR: " << err.what() << std::endl;
+        rv = 1;
+    }
+    catch (const QString& err) {
+        std::cerr << "pelicanMicroBenchmarks ERROR: " << err.toStdString()
+                  << std::endl;
+        rv = 1;
+    }
+    return rv;
+}
+
+/**
+ * @details
+ * Adds the benchmarks of the suite to the runner.
+ */
+void addBenchmarks(MicroBenchmarkRunner& runner)
+{
+    // Server stream buffer.
+    runner.add(new StreamDataBufferBenchmark(65536, 16, 1));
+    runner.add(new StreamDataBufferBenchmark(65536, 16, 4));
+
+    // Server to pipeline protocol.
+    runner.add(new ProtocolBenchmark(8192));
+    runner.add(new ProtocolBenchmark(1048576));
+
+    // Stream adapters.
+    ConfigNode config;
+    runner.add(new AdapterBenchmark("AdapterRealData",
+            new AdapterRealData(config), new DoubleData, 1048576));
+    runner.add(new AdapterBenchmark("BenchmarkAdapter",
+            new BenchmarkAdapter(config), new BenchmarkData, 1048576));
+
+    // Data blob serialisation.
+    for (int i = 0; i < 2; ++i) {
+        DoubleData* blob = new DoubleData;
+        blob->resize(131072);
+        runner.add(new BlobSerialiseBenchmark(blob, i == 1));
+    }
+
+    // Output stream fan-out.
+    runner.add(new FanOutBenchmark(65536, 1));
+    runner.add(new FanOutBenchmark(65536, 4));
+
+    // Configuration lookups.
+    runner.add(new ConfigBenchmark(10));
+    runner.add(new ConfigBenchmark(100));
+}
+
+/**
+ * @details
+ * Parses the command line options.
+ */
+opts::variables_map process_options(int argc, char** argv)
+{
+    // Declare the supported options.
+    opts::options_description desc("Allowed options");
+    desc.add_options()
+        ("help,h", "Produce help message.")
+        ("list,l", "List the benchmarks and exit.")
+        ("filter,f", opts::value<std::string>(),
+                "Only run benchmarks with names matching this pattern.")
+        ("samples,n", opts::value<int>()->default_value(7),
+                "Set the number of samples per benchmark.")
+        ("time,t", opts::value<double>()->default_value(0.2),
+                "Set the minimum duration of each sample in seconds.")
+        ("cores", opts::value<std::string>(),
+                "Run on the given cores (e.g. 2 or 2-3).")
+        ("output,o", opts::value<std::string>()->default_value("micro.json"),
+                "Set JSON report file.")
+        ("save-baseline", opts::value<std::string>(),
+                "Save the results as a baseline file.")
+        ("baseline,b", opts::value<std::string>(),
+                "Compare the results with a baseline file.")
+        ("threshold", opts::value<double>()->default_value(0.1),
+                "Set the relative slow-down reported as a regression.");
+
+    // Parse the command line arguments.
+    opts::variables_map varMap;
+    opts::store(opts::command_line_parser(argc, argv).options(desc)
+            .run(), varMap);
+    opts::notify(varMap);
+
+    // Check for help message.
+    if (varMap.count("help")) {
+        std::cout << desc << std::endl;
+        exit(0);
+    }
+    return varMap;
+}
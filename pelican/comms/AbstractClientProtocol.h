@@ -30,6 +30,7 @@
 #define ABSTRACTCLIENTPROTOCOL_H
 
 #include <boost/shared_ptr.hpp>
+#include "comms/BlobCompression.h"
 class QByteArray;
 class QAbstractSocket;
 
@@ -69,6 +70,11 @@ class AbstractClientProtocol
         /// Translate incoming bit stream from a socket into
         //  appropriate ServerResponse objects
         virtual boost::shared_ptr<ServerResponse> receive(QAbstractSocket&) = 0;
+
+        /// Returns the statistics of compressed blobs received, or null if
+        /// the protocol does not support compression.
+        virtual const BlobCompression::Statistics* compressionStatistics() const
+        { return 0; }
 };
 
 } // namespace pelican
@@ -47,6 +47,8 @@ class StreamData;
 class DataChunk;
 class DataBlob;
 class DataSupportResponse;
+class BlobCompression;
+class SharedMemorySegment;
 
 /**
  * @ingroup c_comms
@@ -67,6 +69,7 @@ class AbstractProtocol
     public:
        typedef QList<StreamData*> StreamData_t;
        typedef QList<DataChunk*> ServiceData_t;
+       typedef QList<const SharedMemorySegment*> Segments_t;
 
     public:
         AbstractProtocol() {}
@@ -78,12 +81,24 @@ class AbstractProtocol
         /// Write stream data to an I/O device.
         virtual void send(QIODevice& device, const StreamData_t&) = 0;
 
+        /// Write the location of stream data held in shared memory (one
+        /// segment for each stream data object) to an I/O device, returning
+        /// false without writing anything if the protocol cannot do so.
+        virtual bool sendShared(QIODevice& /*device*/, const StreamData_t&,
+                const Segments_t&) { return false; }
+
         /// Write service data to an I/O device.
         virtual void send(QIODevice& device, const ServiceData_t&) = 0;
 
         /// Write out a DataBlob object to an I/O Device, as a stream of "name"
         virtual void send(QIODevice& device, const QString& name, const DataBlob& ) = 0;
 
+        /// Write out a DataBlob object compressed with the given codec.
+        /// Protocols without compression support send it uncompressed.
+        virtual void send(QIODevice& device, const QString& name,
+                const DataBlob& blob, const BlobCompression& /*codec*/)
+        { send(device, name, blob); }
+
         /// Write a non-error message to an I/O device.
         virtual void send(QIODevice& device, const QString& message) = 0;
 
@@ -93,6 +108,11 @@ class AbstractProtocol
         /// Send an error to an I/O device.
         virtual void sendError(QIODevice& device, const QString&) = 0;
 
+        /// Returns the protocol to use for the response to a request.
+        /// Protocols that accept several versions return the protocol
+        /// matching the version the request was received with.
+        virtual AbstractProtocol* protocolFor(const ServerRequest&) { return this; }
+
 };
 
 } // namespace pelican
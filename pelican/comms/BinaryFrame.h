@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BINARYFRAME_H
+#define BINARYFRAME_H
+
+/**
+ * @file BinaryFrame.h
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+class QIODevice;
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class BinaryFrame
+ *
+ * @brief
+ * Builds and parses the frames of the binary Pelican protocol (version 2).
+ *
+ * @details
+ * Each frame starts with a fixed-size header of HeaderBytes bytes:
+ *
+ * @verbatim
+ *   quint16 magic     (BinaryFrame::Magic)
+ *   quint8  version   (BinaryFrame::Version)
+ *   quint8  type      (ServerRequest::Request or ServerResponse::Response)
+ *   quint32 flags     (type specific)
+ *   quint64 length    (number of payload bytes that follow)
+ * @endverbatim
+ *
+ * so that a receiver can read the header and then the whole payload in
+ * one call each. The payload starts with a table of the strings used by
+ * the frame (quint16 count, then a quint16 length and UTF-8 bytes for each
+ * string); the records that follow refer to strings by their quint16
+ * index in the table, so each name or id is sent only once per frame.
+ * All integers are in network (big-endian) byte order.
+ *
+ * The magic number is never a valid version 1 request or response type,
+ * so the two protocol versions can be told apart from the first two bytes.
+ */
+class BinaryFrame
+{
+    public:
+        enum { Magic = 0x5043, Version = 2, HeaderBytes = 16 };
+
+        /// Frame flags for StreamData requests and responses: the data is
+        /// (to be) served in place from shared memory.
+        enum { SharedMemoryFlag = 0x1 };
+
+        /// The fixed-size frame header.
+        struct Header
+        {
+            Header() : version(0), type(0), flags(0), length(0) {}
+            quint8 version;
+            quint8 type;
+            quint32 flags;
+            quint64 length;
+        };
+
+    public:
+        /// Constructs an empty frame for writing.
+        BinaryFrame();
+
+        /// Constructs a frame for reading from a received payload.
+        BinaryFrame(const QByteArray& payload);
+
+        /// Returns the index of @p string in the string table, adding it
+        /// if required.
+        quint16 intern(const QString& string);
+
+        /// Appends records to the frame.
+        void putString(const QString& string) { put16(intern(string)); }
+        void putSet(const QSet<QString>& set);
+        void put8(quint8 value);
+        void put16(quint16 value);
+        void put32(quint32 value);
+        void put64(quint64 value);
+
+        /// Returns the complete frame (header and payload).
+        QByteArray frame(quint8 type, quint32 flags = 0) const;
+
+        /// Reads records from the frame, throwing a QString if the
+        /// payload is too short.
+        QString getString();
+        QSet<QString> getSet();
+        quint8 get8();
+        quint16 get16();
+        quint32 get32();
+        quint64 get64();
+
+    public:
+        /// Returns true if the next bytes on the device are a binary frame,
+        /// waiting up to @p timeout ms (-1 = no limit) for them to arrive.
+        static bool isFrame(QIODevice& device, int timeout = -1);
+
+        /// Reads a frame header, returning false if it cannot be read.
+        static bool readHeader(QIODevice& device, Header& header,
+                int timeout = -1);
+
+        /// Reads the payload described by @p header.
+        static BinaryFrame readPayload(QIODevice& device, const Header& header,
+                int timeout = -1);
+
+        /// Reads @p bytes bytes from the device, throwing a QString if they
+        /// do not arrive within @p timeout ms of each other.
+        static QByteArray readBytes(QIODevice& device, qint64 bytes,
+                int timeout = -1);
+
+    private:
+        /// Waits until @p bytes bytes are available on the device.
+        static bool _waitFor(QIODevice& device, qint64 bytes, int timeout);
+
+        const char* _get(int bytes);
+
+    private:
+        QHash<QString, quint16> _index;
+        QVector<QString> _strings;
+        QByteArray _records;
+        int _pos;
+};
+
+} // namespace pelican
+
+#endif // BINARYFRAME_H
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BLOBCOMPRESSION_H
+#define BLOBCOMPRESSION_H
+
+/**
+ * @file BlobCompression.h
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QtGlobal>
+
+#include <iostream>
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class BlobCompression
+ *
+ * @brief
+ * Compresses serialised DataBlobs for transport.
+ *
+ * @details
+ * The serialised bytes are first byte-shuffled: with a shuffle width of
+ * N bytes, the first byte of every N-byte word is written, then the second
+ * byte of every word, and so on. For arrays of floating point numbers this
+ * groups the slowly varying sign and exponent bytes together, which the
+ * codec (zlib, through qCompress()) then compresses much better. A shuffle
+ * width of 1 leaves the data unchanged.
+ *
+ * The compression level (1 to 9) trades CPU time against compression ratio;
+ * the low levels are fast enough for streaming use.
+ *
+ * The raw and compressed byte counts and the thread CPU time spent encoding
+ * and decoding are accumulated in a Statistics object, which may be shared
+ * by several codecs.
+ */
+class BlobCompression
+{
+    public:
+        /// Accumulated compression statistics.
+        struct Statistics
+        {
+            Statistics() : blobs(0), rawBytes(0), packedBytes(0),
+                    encodeTime(0), decodeTime(0) {}
+
+            /// Returns the ratio of raw to compressed bytes (0 if none).
+            double ratio() const
+            { return packedBytes ? double(rawBytes) / packedBytes : 0.0; }
+
+            /// Prints a summary of the statistics.
+            void report(std::ostream& stream) const;
+
+            quint64 blobs;       ///< Number of blobs (de)compressed.
+            quint64 rawBytes;    ///< Uncompressed bytes.
+            quint64 packedBytes; ///< Compressed bytes.
+            quint64 encodeTime;  ///< CPU time spent compressing (ns).
+            quint64 decodeTime;  ///< CPU time spent decompressing (ns).
+        };
+
+    public:
+        /// Constructs a codec with the given compression level and shuffle
+        /// width, accumulating statistics in @p stats (if not null).
+        BlobCompression(int level = 1, int shuffle = 1, Statistics* stats = 0);
+
+        /// Returns the compression level.
+        int level() const { return _level; }
+
+        /// Returns the shuffle width in bytes.
+        int shuffle() const { return _shuffle; }
+
+        /// Compresses @p size bytes of serialised data.
+        QByteArray compress(const char* data, qint64 size) const;
+
+        /// Decompresses data compressed with the shuffle width @p shuffle,
+        /// checking that it expands to @p size bytes.
+        QByteArray decompress(const QByteArray& packed, quint64 size,
+                int shuffle) const;
+
+        /// Byte-shuffles @p size bytes from @p in to @p out.
+        static void shuffle(const char* in, char* out, qint64 size, int width);
+
+        /// Reverses shuffle().
+        static void unshuffle(const char* in, char* out, qint64 size, int width);
+
+    private:
+        /// Returns the CPU time of the calling thread in nanoseconds.
+        static quint64 _cpuTime();
+
+    private:
+        int _level;
+        int _shuffle;
+        Statistics* _stats;
+};
+
+} // namespace pelican
+
+#endif // BLOBCOMPRESSION_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef COMPRESSIONREQUEST_H
+#define COMPRESSIONREQUEST_H
+
+/**
+ * @file CompressionRequest.h
+ */
+
+#include "comms/ServerRequest.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class CompressionRequest
+ *
+ * @brief
+ *    Request for DataBlob streams to be sent compressed.
+ *
+ * @details
+ *    Sets the compression level and byte-shuffle width (see BlobCompression)
+ *    to use for each named stream sent to the client. A level of 0 turns
+ *    compression off for the stream. Servers that do not understand the
+ *    request send the streams uncompressed.
+ */
+
+class CompressionRequest : public ServerRequest
+{
+    public:
+        CompressionRequest();
+        ~CompressionRequest();
+
+        /// Requests compression of @p stream at @p level (0 = off), with
+        /// a byte-shuffle width of @p shuffle bytes.
+        void setCompression(const QString& stream, int level, int shuffle = 1);
+
+        /// Returns the streams for which compression settings are requested.
+        QList<QString> streams() const { return _settings.keys(); }
+
+        /// Returns the requested compression level of the stream.
+        int level(const QString& stream) const;
+
+        /// Returns the requested shuffle width of the stream.
+        int shuffle(const QString& stream) const;
+
+        /// Returns true if no settings have been requested.
+        bool isEmpty() const { return _settings.isEmpty(); }
+
+        /// Test for equality between CompressionRequest objects.
+        virtual bool operator==(const ServerRequest&) const;
+
+    private:
+        QHash<QString, QPair<int, int> > _settings;
+};
+
+} // namespace pelican
+#endif // COMPRESSIONREQUEST_H
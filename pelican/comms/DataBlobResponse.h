@@ -33,11 +33,16 @@
  * @file DataBlobResponse.h
  */
 
+#include <QtCore/QByteArray>
 #include <QtCore/QSysInfo>
 #include "ServerResponse.h"
 
+class QIODevice;
+
 namespace pelican {
 
+class DataBlob;
+
 /**
  * @ingroup c_comms
  *
@@ -47,7 +52,10 @@ namespace pelican {
  * A response from the server that contains a DataBlob
  *
  * @details
- *
+ * The serialised blob normally follows the response on the socket. If the
+ * blob was sent compressed, the protocol decompresses it and stores the
+ * serialised bytes in the response (see hasData()). Use readBlob() or
+ * readData() to read the blob from whichever source holds it.
  */
 class DataBlobResponse : public ServerResponse
 {
@@ -61,6 +69,19 @@ class DataBlobResponse : public ServerResponse
         quint64 dataSize() const {return _dataSize;}
         QSysInfo::Endian byteOrder() const {return _endianness;}
 
+        /// Sets the (decompressed) serialised blob data.
+        void setData(const QByteArray& data) { _data = data; _hasData = true; }
+        /// Returns true if the serialised blob is held by the response.
+        bool hasData() const { return _hasData; }
+        /// Returns the serialised blob held by the response.
+        const QByteArray& data() const { return _data; }
+
+        /// Deserialises the blob from the response or the device.
+        void readBlob(DataBlob& blob, QIODevice& device) const;
+        /// Copies the dataSize() bytes of the serialised blob from the
+        /// response or the device.
+        void readData(char* buffer, QIODevice& device) const;
+
         // serialise and deserialise important data to/from a stream
         void serialise( QDataStream& stream );
         void deserialise( QDataStream& stream );
@@ -71,6 +92,8 @@ class DataBlobResponse : public ServerResponse
         QString _name;
         quint64 _dataSize;
         QSysInfo::Endian _endianness;
+        QByteArray _data;
+        bool _hasData;
 };
 
 } // namespace pelican
@@ -64,15 +64,15 @@ class DataChunk
     public:
         /// Constructs a new Data object.
         DataChunk(const QString& name = "", void* data = 0, size_t size = 0)
-        : _name(name), _data(data), _size(size) {}
+        : _name(name), _data(data), _size(size), _timestamp(0), _lostPackets(0) {}
 
         /// Constructs an empty Data object.
         DataChunk(const QString& name, const QString& id, size_t size = 0)
-        : _name(name), _id(id), _data(0), _size(size) {}
+        : _name(name), _id(id), _data(0), _size(size), _timestamp(0), _lostPackets(0) {}
 
         /// Constructs a new Data object from the given byte array.
         DataChunk(const QString& name, const QString& id, QByteArray& ba)
-        : _name(name), _id(id)
+        : _name(name), _id(id), _timestamp(0), _lostPackets(0)
         {
             _data = ba.data();
             _size = ba.size();
@@ -113,6 +113,19 @@ class DataChunk
         /// Sets the ID.
         void setId(const QString& id) { _id = id; }
 
+        /// Returns the ingest timestamp (ns since the epoch, 0 if unset).
+        qint64 timestamp() const { return _timestamp; }
+
+        /// Sets the ingest timestamp (ns since the epoch).
+        void setTimestamp(qint64 t) { _timestamp = t; }
+
+        /// Returns the number of packets missing from the data (filled in
+        /// by the chunker).
+        quint32 lostPackets() const { return _lostPackets; }
+
+        /// Sets the number of packets missing from the data.
+        void setLostPackets(quint32 n) { _lostPackets = n; }
+
         /// Returns true if any data exists.
         virtual bool isValid() const
         { return !( _data == 0 || _size == 0); }
@@ -126,6 +139,8 @@ class DataChunk
         QString _id;   // The ID of the object.
         void* _data;   // Pointer to the data.
         size_t _size;  // Size of the data in bytes.
+        qint64 _timestamp; // Ingest time, ns since the epoch.
+        quint32 _lostPackets; // Packets missing from the data.
 
     private:
         DataChunk(const DataChunk&); // Disallow the copy constructor.
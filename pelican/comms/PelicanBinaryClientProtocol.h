@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PELICANBINARYCLIENTPROTOCOL_H
+#define PELICANBINARYCLIENTPROTOCOL_H
+
+/**
+ * @file PelicanBinaryClientProtocol.h
+ */
+
+#include "AbstractClientProtocol.h"
+#include "comms/BlobCompression.h"
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class PelicanBinaryClientProtocol
+ *
+ * @brief
+ * Client side of version 2 of the Pelican protocol.
+ *
+ * @details
+ * Requests are sent as binary frames (see BinaryFrame) and responses are
+ * read with one call for the fixed-size header and one for the payload.
+ *
+ * A server that only supports version 1 of the protocol responds to a
+ * version 2 request with something other than a binary frame. The response
+ * is then returned as an error and rejected() returns true, so that the
+ * caller can fall back to PelicanClientProtocol.
+ */
+
+class PelicanBinaryClientProtocol : public AbstractClientProtocol
+{
+    public:
+        PelicanBinaryClientProtocol();
+        ~PelicanBinaryClientProtocol();
+        virtual QByteArray serialise(const ServerRequest&);
+        virtual boost::shared_ptr<ServerResponse> receive(QAbstractSocket&);
+        /// Returns true if the server has rejected version 2 of the protocol.
+        bool rejected() const { return _rejected; }
+        // Set the timeout, in milliseconds
+        void setTimeout(int value = 2000) { _timeout = value; }
+        int getTimeout() const { return _timeout; }
+        virtual const BlobCompression::Statistics* compressionStatistics() const
+        { return &_compressionStats; }
+    private:
+        int _timeout;
+        bool _rejected;
+        BlobCompression::Statistics _compressionStats;
+        BlobCompression _codec;
+};
+
+} // namespace pelican
+#endif // PELICANBINARYCLIENTPROTOCOL_H
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PELICANBINARYPROTOCOL_H
+#define PELICANBINARYPROTOCOL_H
+
+/**
+ * @file PelicanBinaryProtocol.h
+ */
+
+#include "AbstractProtocol.h"
+
+namespace pelican {
+
+class BinaryFrame;
+
+/**
+ * @ingroup c_comms
+ *
+ * @class PelicanBinaryProtocol
+ *
+ * @brief
+ * Server side of version 2 of the Pelican protocol.
+ *
+ * @details
+ * Requests and responses are sent as binary frames (see BinaryFrame),
+ * with a fixed-size header giving the payload length and an interned
+ * string table for stream names, ids and versions. Any stream, service or
+ * blob data follows the frame, with sizes given in the frame records.
+ * Stream data held in shared memory can instead be described by its
+ * location (see sendShared()), for clients on the same host.
+ *
+ * The protocol holds no state, so one object can serve several sessions.
+ * Servers normally use PelicanProtocol, which recognises version 2
+ * requests and hands the response over to this protocol.
+ */
+
+class PelicanBinaryProtocol : public AbstractProtocol
+{
+    public:
+        PelicanBinaryProtocol();
+        ~PelicanBinaryProtocol();
+
+    public:
+        /// Construct a server request object from reading the specified socket
+        virtual boost::shared_ptr<ServerRequest> request(QTcpSocket& socket);
+
+        /// Sends a list of supported stream and service data.
+        virtual void send(QIODevice& device, const DataSupportResponse&);
+
+        /// Send one or more stream data chunks with header information
+        /// containing a description of associated service data.
+        virtual void send(QIODevice& stream, const AbstractProtocol::StreamData_t&);
+
+        /// Send the shared memory location of one or more stream data
+        /// chunks in place of the data.
+        virtual bool sendShared(QIODevice& stream,
+                const AbstractProtocol::StreamData_t&,
+                const AbstractProtocol::Segments_t&);
+
+        /// Send a serialised data blob.
+        virtual void send(QIODevice& stream, const QString& name, const DataBlob&);
+
+        /// Send a serialised data blob compressed with the given codec.
+        virtual void send(QIODevice& stream, const QString& name,
+                const DataBlob&, const BlobCompression& codec);
+
+        /// Send one or more service data chunks.
+        virtual void send(QIODevice& stream, const AbstractProtocol::ServiceData_t&);
+
+        /// Send a message string.
+        virtual void send(QIODevice& stream, const QString&);
+
+        /// Send a error.
+        virtual void sendError(QIODevice& stream, const QString&);
+
+    private:
+        /// Appends the record describing a stream data object.
+        static void _putStreamData(BinaryFrame& frame, const StreamData* sd);
+
+        /// Writes the data to the device, waiting until it has been written.
+        static void _write(QIODevice& device, const char* data, qint64 size);
+};
+
+} // namespace pelican
+#endif // PELICANBINARYPROTOCOL_H
@@ -34,6 +34,7 @@
  */
 
 #include "AbstractClientProtocol.h"
+#include "comms/BlobCompression.h"
 
 class QDataStream;
 
@@ -62,10 +63,15 @@ class PelicanClientProtocol : public AbstractClientProtocol
         // Set the timeout, in milliseconds
         void setTimeout(int value = 2000) { _timeout = value; }
         int getTimeout() const { return _timeout; }
+        /// Returns the statistics of compressed blobs received.
+        virtual const BlobCompression::Statistics* compressionStatistics() const
+        { return &_compressionStats; }
     private:
         void _serializeDataRequirements(QDataStream& stream,
                 const DataSpec& req) const;
         int _timeout;
+        BlobCompression::Statistics _compressionStats;
+        BlobCompression _codec;
 };
 
 } // namespace pelican
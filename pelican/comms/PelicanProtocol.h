@@ -34,6 +34,7 @@
  */
 
 #include "AbstractProtocol.h"
+#include "PelicanBinaryProtocol.h"
 
 namespace pelican {
 
@@ -48,6 +49,10 @@ class DataBlob;
  * The primary protocol for communication between pipelines and the server.
  *
  * @details
+ * Implements version 1 of the protocol, in which headers are written with
+ * QDataStream. Requests made with version 2 (see PelicanBinaryProtocol)
+ * are also accepted; protocolFor() then returns the version 2 protocol,
+ * so that the response is sent in the version the client used.
  */
 
 class PelicanProtocol : public AbstractProtocol
@@ -70,6 +75,10 @@ class PelicanProtocol : public AbstractProtocol
         /// Send a serialised data blob.
         virtual void send(QIODevice& stream, const QString& name, const DataBlob&);
 
+        /// Send a serialised data blob compressed with the given codec.
+        virtual void send(QIODevice& stream, const QString& name,
+                const DataBlob&, const BlobCompression& codec);
+
         /// Send one or more service data chunks.
         virtual void send(QIODevice& stream, const AbstractProtocol::ServiceData_t&);
 
@@ -78,6 +87,12 @@ class PelicanProtocol : public AbstractProtocol
 
         /// Send a error.
         virtual void sendError(QIODevice& stream, const QString&);
+
+        /// Returns the protocol matching the version of the request.
+        virtual AbstractProtocol* protocolFor(const ServerRequest&);
+
+    private:
+        PelicanBinaryProtocol _binary;
 };
 
 } // namespace pelican
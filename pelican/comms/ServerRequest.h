@@ -53,17 +53,19 @@ class ServerRequest
 {
     public:
         typedef enum {
-            Error, Acknowledge, StreamData, ServiceData, DataSupport
+            Error, Acknowledge, StreamData, ServiceData, DataSupport,
+            Compression
         } Request;
 
     private:
         Request _type;
         QString _error;
+        int _version;
 
     public:
         /// Constructs a new ServerRequest object.
         ServerRequest(Request type = Error, const QString& msg = "")
-        : _type(type), _error(msg) {}
+        : _type(type), _error(msg), _version(1) {}
 
         /// Destroys the ServerRequest object.
         virtual ~ServerRequest() {}
@@ -77,6 +79,12 @@ class ServerRequest
         /// Returns the error message.
         const QString& message() const {return _error;}
 
+        /// Returns the version of the protocol the request was received with.
+        int version() const {return _version;}
+
+        /// Sets the version of the protocol the request was received with.
+        void setVersion(int version) {_version = version;}
+
         /// Tests whether this ServerRequest type is the same as another.
         virtual bool operator==(const ServerRequest& req) const
         { return _type == req._type; }
@@ -51,7 +51,8 @@ class ServerResponse
 {
     public:
         typedef enum {
-            Error, Acknowledge, StreamData, ServiceData, Blob, DataSupport
+            Error, Acknowledge, StreamData, ServiceData, Blob, DataSupport,
+            CompressedBlob
         } Response;
 
     private:
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SHAREDMEMORYSEGMENT_H
+#define SHAREDMEMORYSEGMENT_H
+
+/**
+ * @file SharedMemorySegment.h
+ */
+
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class SharedMemorySegment
+ *
+ * @brief
+ * A named POSIX shared memory segment mapped into the process.
+ *
+ * @details
+ * The server creates a segment to hold the chunks of a stream data buffer;
+ * clients on the same host attach to it by name (read-only) and read chunk
+ * data in place given its offset in the segment. The creator of a segment
+ * owns the name and removes it on destruction.
+ *
+ * Errors are reported by throwing a QString.
+ */
+
+class SharedMemorySegment
+{
+    public:
+        /// Creates and maps a new (zero-filled) segment of @p size bytes.
+        SharedMemorySegment(const QString& name, size_t size);
+
+        /// Maps an existing segment read-only.
+        SharedMemorySegment(const QString& name);
+
+        /// Unmaps the segment, removing the name if it was created here.
+        ~SharedMemorySegment();
+
+        /// Returns the name of the segment.
+        const QString& name() const { return _name; }
+
+        /// Returns the start of the mapped segment.
+        char* data() const { return _data; }
+
+        /// Returns the size of the segment in bytes.
+        size_t size() const { return _size; }
+
+        /// Returns true if @p size bytes at @p ptr lie within the segment.
+        bool contains(const void* ptr, size_t size = 0) const;
+
+        /// Returns the offset of @p ptr from the start of the segment.
+        quint64 offset(const void* ptr) const
+        { return (quint64)((const char*)ptr - _data); }
+
+        /// Returns a segment name, unique to this process, for @p tag.
+        static QString uniqueName(const QString& tag);
+
+    private:
+        void _map(int fd, bool writable);
+
+    private:
+        // Disallow copying.
+        SharedMemorySegment(const SharedMemorySegment&);
+        SharedMemorySegment& operator=(const SharedMemorySegment&);
+
+    private:
+        QString _name;
+        char* _data;
+        size_t _size;
+        bool _owner;
+};
+
+} // namespace pelican
+#endif // SHAREDMEMORYSEGMENT_H
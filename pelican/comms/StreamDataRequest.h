@@ -49,12 +49,17 @@ namespace pelican {
  * Specifications of a set of DataSpec.
  *
  * @details
+ * If sharedMemory() is set, a server on the same host may reply with the
+ * location of the data in its shared memory buffers instead of a copy of
+ * it (see PelicanBinaryProtocol). This is a transport hint, and is not
+ * considered when comparing requests.
  */
 
 class StreamDataRequest : public ServerRequest
 {
     private:
         QVector<DataSpec> _dataOptions;
+        bool _sharedMemory;
 
     public:
         typedef QVector<DataSpec>::const_iterator DataSpecIterator;
@@ -82,6 +87,12 @@ class StreamDataRequest : public ServerRequest
         /// The number of requirements.
         int size() const {return _dataOptions.size();}
 
+        /// Requests that the data be served in place from shared memory.
+        void setSharedMemory(bool enabled) { _sharedMemory = enabled; }
+
+        /// Returns true if the data should be served from shared memory.
+        bool sharedMemory() const { return _sharedMemory; }
+
         /// Test for equality between ServiceData objects.
         virtual bool operator==(const ServerRequest&) const;
 };
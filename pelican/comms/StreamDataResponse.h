@@ -53,6 +53,8 @@ class StreamDataResponse : public ServerResponse
 {
     private:
         pelican::StreamData* _data;
+        QString _segment;
+        quint64 _offset;
 
     public:
         /// Constructs a StreamDataResponse object.
@@ -66,6 +68,21 @@ class StreamDataResponse : public ServerResponse
 
         /// Returns the pointer to the StreamData object.
         pelican::StreamData* streamData() {return _data;}
+
+        /// Records that the stream data is held in the named shared memory
+        /// segment, at @p offset bytes from its start, rather than
+        /// following the response.
+        void setSharedMemory(const QString& segment, quint64 offset)
+        { _segment = segment; _offset = offset; }
+
+        /// Returns true if the stream data is held in shared memory.
+        bool isShared() const { return !_segment.isEmpty(); }
+
+        /// Returns the name of the shared memory segment holding the data.
+        const QString& sharedSegment() const { return _segment; }
+
+        /// Returns the offset of the data in the shared memory segment.
+        quint64 sharedOffset() const { return _offset; }
 };
 
 } // namespace pelican
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UNIXSOCKET_H
+#define UNIXSOCKET_H
+
+/**
+ * @file UnixSocket.h
+ */
+
+#include <QtCore/QString>
+
+class QAbstractSocket;
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class UnixSocket
+ *
+ * @brief
+ * Helpers for Unix domain (AF_UNIX) stream sockets.
+ *
+ * @details
+ * The Pelican servers and clients exchange requests over QTcpSocket
+ * objects. A connected Unix domain socket descriptor can be handed to a
+ * QTcpSocket with setSocketDescriptor(), so same-host connections can avoid
+ * the TCP/IP stack while still using the same protocols and code paths.
+ *
+ * sendDescriptor() and receiveDescriptor() pass an open file descriptor
+ * between processes (SCM_RIGHTS). They operate directly on the socket
+ * descriptor, so should only be used when no data is buffered in a
+ * QTcpSocket wrapping it.
+ */
+
+class UnixSocket
+{
+    public:
+        /// Connects @p socket to the Unix domain socket at @p path.
+        /// Returns false, with errno set, if no connection can be made.
+        static bool connectToPath(QAbstractSocket& socket, const QString& path);
+
+        /// Sends the file descriptor @p fd over the socket @p socket,
+        /// along with one byte of data, @p tag.
+        static bool sendDescriptor(int socket, int fd, char tag = 0);
+
+        /// Receives a file descriptor sent with sendDescriptor(), returning
+        /// -1 on failure.
+        static int receiveDescriptor(int socket, char* tag = 0);
+
+    private:
+        UnixSocket();
+};
+
+} // namespace pelican
+#endif // UNIXSOCKET_H
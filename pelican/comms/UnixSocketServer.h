@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UNIXSOCKETSERVER_H
+#define UNIXSOCKETSERVER_H
+
+/**
+ * @file UnixSocketServer.h
+ */
+
+#include <QtNetwork/QLocalServer>
+#include <QtCore/QString>
+
+namespace pelican {
+
+/**
+ * @ingroup c_comms
+ *
+ * @class UnixSocketServer
+ *
+ * @brief
+ * Listens for connections on a Unix domain socket path.
+ *
+ * @details
+ * Unlike QLocalServer, the descriptor of each accepted connection is
+ * passed on with the incomingDescriptor() signal, so that it can be wrapped
+ * in a QTcpSocket (see UnixSocket) and served by the same code as TCP
+ * connections.
+ */
+
+class UnixSocketServer : public QLocalServer
+{
+    Q_OBJECT
+
+    public:
+        UnixSocketServer(QObject* parent = 0);
+        ~UnixSocketServer();
+
+        /// Listens on the socket at @p path, replacing any stale socket
+        /// file left there.
+        bool listen(const QString& path);
+
+    signals:
+        /// Emitted with the descriptor of each accepted connection, which
+        /// must be taken over by the receiver.
+        void incomingDescriptor(int socketDescriptor);
+
+    protected:
+        /// Reimplemented from QLocalServer.
+        void incomingConnection(quintptr socketDescriptor);
+};
+
+} // namespace pelican
+#endif // UNIXSOCKETSERVER_H
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "comms/BinaryFrame.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QtEndian>
+
+namespace pelican {
+
+/**
+ * @details
+ */
+BinaryFrame::BinaryFrame()
+    : _pos(0)
+{
+}
+
+/**
+ * @details
+ * Parses the string table at the start of @p payload.
+ */
+BinaryFrame::BinaryFrame(const QByteArray& payload)
+    : _records(payload), _pos(0)
+{
+    quint16 count = get16();
+    _strings.reserve(count);
+    for (quint16 i = 0; i < count; ++i) {
+        quint16 length = get16();
+        _strings.append(QString::fromUtf8(_get(length), length));
+    }
+}
+
+quint16 BinaryFrame::intern(const QString& string)
+{
+    QHash<QString, quint16>::const_iterator it = _index.find(string);
+    if (it != _index.end())
+        return it.value();
+    if (_strings.size() >= 0xffff)
+        throw QString("BinaryFrame: Too many strings in frame.");
+    quint16 index = _strings.size();
+    _strings.append(string);
+    _index.insert(string, index);
+    return index;
+}
+
+/**
+ * @details
+ * Writes a set of strings as a count followed by the string indices.
+ */
+void BinaryFrame::putSet(const QSet<QString>& set)
+{
+    put16((quint16)set.size());
+    foreach (const QString& s, set) putString(s);
+}
+
+void BinaryFrame::put8(quint8 value)
+{
+    _records.append((char)value);
+}
+
+void BinaryFrame::put16(quint16 value)
+{
+    uchar buf[2];
+    qToBigEndian(value, buf);
+    _records.append((const char*)buf, 2);
+}
+
+void BinaryFrame::put32(quint32 value)
+{
+    uchar buf[4];
+    qToBigEndian(value, buf);
+    _records.append((const char*)buf, 4);
+}
+
+void BinaryFrame::put64(quint64 value)
+{
+    uchar buf[8];
+    qToBigEndian(value, buf);
+    _records.append((const char*)buf, 8);
+}
+
+/**
+ * @details
+ * Assembles the header, the string table and the records.
+ */
+QByteArray BinaryFrame::frame(quint8 type, quint32 flags) const
+{
+    QByteArray strings;
+    uchar buf[8];
+    qToBigEndian((quint16)_strings.size(), buf);
+    strings.append((const char*)buf, 2);
+    for (int i = 0; i < _strings.size(); ++i) {
+        QByteArray utf8 = _strings[i].toUtf8();
+        if (utf8.size() > 0xffff)
+            throw QString("BinaryFrame: String too long.");
+        qToBigEndian((quint16)utf8.size(), buf);
+        strings.append((const char*)buf, 2);
+        strings.append(utf8);
+    }
+
+    QByteArray out;
+    out.reserve(HeaderBytes + strings.size() + _records.size());
+    qToBigEndian((quint16)Magic, buf);
+    out.append((const char*)buf, 2);
+    out.append((char)Version);
+    out.append((char)type);
+    qToBigEndian(flags, buf);
+    out.append((const char*)buf, 4);
+    qToBigEndian((quint64)(strings.size() + _records.size()), buf);
+    out.append((const char*)buf, 8);
+    out.append(strings);
+    out.append(_records);
+    return out;
+}
+
+QString BinaryFrame::getString()
+{
+    quint16 index = get16();
+    if (index >= _strings.size())
+        throw QString("BinaryFrame: Invalid string index %1.").arg(index);
+    return _strings[index];
+}
+
+QSet<QString> BinaryFrame::getSet()
+{
+    QSet<QString> set;
+    quint16 n = get16();
+    for (quint16 i = 0; i < n; ++i) set.insert(getString());
+    return set;
+}
+
+quint8 BinaryFrame::get8()
+{
+    return (quint8)*_get(1);
+}
+
+quint16 BinaryFrame::get16()
+{
+    return qFromBigEndian<quint16>((const uchar*)_get(2));
+}
+
+quint32 BinaryFrame::get32()
+{
+    return qFromBigEndian<quint32>((const uchar*)_get(4));
+}
+
+quint64 BinaryFrame::get64()
+{
+    return qFromBigEndian<quint64>((const uchar*)_get(8));
+}
+
+const char* BinaryFrame::_get(int bytes)
+{
+    if (_pos + bytes > _records.size())
+        throw QString("BinaryFrame: Truncated frame.");
+    const char* p = _records.constData() + _pos;
+    _pos += bytes;
+    return p;
+}
+
+/**
+ * @details
+ * Peeks at the first two bytes on the device without consuming them.
+ */
+bool BinaryFrame::isFrame(QIODevice& device, int timeout)
+{
+    if (!_waitFor(device, 2, timeout))
+        return false;
+    uchar buf[2];
+    if (device.peek((char*)buf, 2) != 2)
+        return false;
+    return qFromBigEndian<quint16>(buf) == Magic;
+}
+
+bool BinaryFrame::readHeader(QIODevice& device, Header& header, int timeout)
+{
+    if (!_waitFor(device, HeaderBytes, timeout))
+        return false;
+    uchar buf[HeaderBytes];
+    if (device.read((char*)buf, HeaderBytes) != HeaderBytes)
+        return false;
+    if (qFromBigEndian<quint16>(buf) != Magic)
+        return false;
+    header.version = buf[2];
+    header.type = buf[3];
+    header.flags = qFromBigEndian<quint32>(buf + 4);
+    header.length = qFromBigEndian<quint64>(buf + 8);
+    return true;
+}
+
+/**
+ * @details
+ * Waits for the whole payload to arrive and reads it in one call. Throws a
+ * QString if it cannot be read.
+ */
+BinaryFrame BinaryFrame::readPayload(QIODevice& device, const Header& header,
+        int timeout)
+{
+    if (header.length > 0x7fffffff)
+        throw QString("BinaryFrame: Payload too large.");
+    return BinaryFrame(readBytes(device, header.length, timeout));
+}
+
+/**
+ * @details
+ * Reads a block of data following a frame (such as a compressed blob),
+ * throwing if the connection is closed or times out before it arrives.
+ */
+QByteArray BinaryFrame::readBytes(QIODevice& device, qint64 bytes, int timeout)
+{
+    if (!_waitFor(device, bytes, timeout))
+        throw QString("BinaryFrame: Timed out reading payload: %1")
+                .arg(device.errorString());
+    return device.read(bytes);
+}
+
+bool BinaryFrame::_waitFor(QIODevice& device, qint64 bytes, int timeout)
+{
+    while (device.bytesAvailable() < bytes) {
+        if (!device.waitForReadyRead(timeout))
+            return device.bytesAvailable() >= bytes;
+    }
+    return true;
+}
+
+} // namespace pelican
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "comms/BlobCompression.h"
+
+#include <QtCore/QString>
+
+#include <cstring>
+#include <ctime>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a codec. The level is clamped to the range 1 to 9, and a
+ * shuffle width less than 1 is treated as 1 (no shuffle).
+ */
+BlobCompression::BlobCompression(int level, int shuffle, Statistics* stats)
+    : _level(qBound(1, level, 9)), _shuffle(qMax(1, shuffle)), _stats(stats)
+{
+}
+
+/**
+ * @details
+ * Returns the shuffled and compressed data. The result carries the size of
+ * the data it expands to, as written by qCompress().
+ */
+QByteArray BlobCompression::compress(const char* data, qint64 size) const
+{
+    if (size > 0x7fffffff)
+        throw QString("BlobCompression: Data too large to compress.");
+
+    quint64 start = _cpuTime();
+    QByteArray packed;
+    if (_shuffle > 1) {
+        QByteArray shuffled;
+        shuffled.resize(int(size));
+        shuffle(data, shuffled.data(), size, _shuffle);
+        packed = qCompress((const uchar*)shuffled.constData(), int(size), _level);
+    }
+    else {
+        packed = qCompress((const uchar*)data, int(size), _level);
+    }
+
+    if (_stats) {
+        _stats->encodeTime += _cpuTime() - start;
+        _stats->rawBytes += size;
+        _stats->packedBytes += packed.size();
+        ++_stats->blobs;
+    }
+    return packed;
+}
+
+/**
+ * @details
+ * Returns the decompressed data, throwing a QString if the data is
+ * corrupt or does not expand to the expected size.
+ */
+QByteArray BlobCompression::decompress(const QByteArray& packed, quint64 size,
+        int shuffle) const
+{
+    quint64 start = _cpuTime();
+    QByteArray data = qUncompress(packed);
+    if ((quint64)data.size() != size)
+        throw QString("BlobCompression: Expected %1 bytes, decompressed %2.")
+                .arg(size).arg(data.size());
+
+    if (shuffle > 1) {
+        QByteArray raw;
+        raw.resize(data.size());
+        unshuffle(data.constData(), raw.data(), data.size(), shuffle);
+        data = raw;
+    }
+
+    if (_stats) {
+        _stats->decodeTime += _cpuTime() - start;
+        _stats->rawBytes += size;
+        _stats->packedBytes += packed.size();
+        ++_stats->blobs;
+    }
+    return data;
+}
+
+/**
+ * @details
+ * Any trailing bytes that do not make up a whole word are copied unchanged.
+ */
+void BlobCompression::shuffle(const char* in, char* out, qint64 size, int width)
+{
+    qint64 words = size / width;
+    for (int b = 0; b < width; ++b) {
+        const char* src = in + b;
+        char* dst = out + b * words;
+        for (qint64 w = 0; w < words; ++w)
+            dst[w] = src[w * width];
+    }
+    qint64 done = words * width;
+    std::memcpy(out + done, in + done, size - done);
+}
+
+void BlobCompression::unshuffle(const char* in, char* out, qint64 size, int width)
+{
+    qint64 words = size / width;
+    for (int b = 0; b < width; ++b) {
+        const char* src = in + b * words;
+        char* dst = out + b;
+        for (qint64 w = 0; w < words; ++w)
+            dst[w * width] = src[w];
+    }
+    qint64 done = words * width;
+    std::memcpy(out + done, in + done, size - done);
+}
+
+quint64 BlobCompression::_cpuTime()
+{
+    timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return quint64(t.tv_sec) * Q_UINT64_C(1000000000) + t.tv_nsec;
+}
+
+/**
+ * @details
+ * Prints the number of blobs, the compression ratio and the CPU cost in
+ * nanoseconds per raw byte.
+ */
+void BlobCompression::Statistics::report(std::ostream& stream) const
+{
+    stream << "Compression: " << blobs << " blobs, "
+           << rawBytes << " -> " << packedBytes << " bytes (ratio "
+           << ratio() << ")";
+    if (rawBytes) {
+        stream << ", encode " << double(encodeTime) / rawBytes << " ns/byte"
+               << ", decode " << double(decodeTime) / rawBytes << " ns/byte";
+    }
+    stream << std::endl;
+}
+
+} // namespace pelican
@@ -27,8 +27,12 @@
  */
 
 #include "comms/DataBlobResponse.h"
+#include "data/DataBlob.h"
+#include <QtCore/QBuffer>
 #include <QtCore/QDataStream>
 
+#include <cstring>
+
 namespace pelican {
 
 /**
@@ -41,12 +45,12 @@ DataBlobResponse::DataBlobResponse(const QString& blobType,
       _type(blobType),
       _name(streamName),
       _dataSize(dataSize),
-      _endianness(endianness)
+      _endianness(endianness), _hasData(false)
 {
 }
 
 DataBlobResponse::DataBlobResponse( QDataStream& stream )
-    : ServerResponse( ServerResponse::Blob )
+    : ServerResponse( ServerResponse::Blob ), _hasData(false)
 {
     deserialise(stream);
 }
@@ -72,6 +76,36 @@ void DataBlobResponse::deserialise( QDataStream& stream ) {
     _endianness = (QSysInfo::Endian)tmp;
 }
 
+/**
+ * @details
+ * Deserialises the blob from the data held by the response if it has any,
+ * otherwise from @p device once all of the blob is available.
+ */
+void DataBlobResponse::readBlob( DataBlob& blob, QIODevice& device ) const {
+    if( _hasData ) {
+        QBuffer buffer;
+        buffer.setData( _data );
+        buffer.open( QBuffer::ReadOnly );
+        blob.deserialise( buffer, _endianness );
+    }
+    else {
+        while (device.bytesAvailable() < (qint64)_dataSize)
+            device.waitForReadyRead(-1);
+        blob.deserialise( device, _endianness );
+    }
+}
+
+void DataBlobResponse::readData( char* buffer, QIODevice& device ) const {
+    if( _hasData ) {
+        std::memcpy( buffer, _data.constData(), _dataSize );
+    }
+    else {
+        while (device.bytesAvailable() < (qint64)_dataSize)
+            device.waitForReadyRead(-1);
+        device.read( buffer, _dataSize );
+    }
+}
+
 size_t DataBlobResponse::serialisedSize() {
     return sizeof(_type) + sizeof(_name) + sizeof(_dataSize) + sizeof(_endianness);
 }
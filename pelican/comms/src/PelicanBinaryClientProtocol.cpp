@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "comms/PelicanBinaryClientProtocol.h"
+#include "comms/BinaryFrame.h"
+#include "comms/CompressionRequest.h"
+#include "comms/DataBlobResponse.h"
+#include "comms/DataChunk.h"
+#include "comms/DataSupportResponse.h"
+#include "comms/ServerRequest.h"
+#include "comms/ServerResponse.h"
+#include "comms/ServiceDataRequest.h"
+#include "comms/ServiceDataResponse.h"
+#include "comms/StreamData.h"
+#include "comms/StreamDataRequest.h"
+#include "comms/StreamDataResponse.h"
+#include "data/DataSpec.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSet>
+#include <QtNetwork/QAbstractSocket>
+
+#include <iostream>
+
+namespace pelican {
+
+PelicanBinaryClientProtocol::PelicanBinaryClientProtocol()
+    : AbstractClientProtocol(), _timeout(2000), _rejected(false),
+      _codec(1, 1, &_compressionStats)
+{
+}
+
+PelicanBinaryClientProtocol::~PelicanBinaryClientProtocol()
+{
+}
+
+QByteArray PelicanBinaryClientProtocol::serialise(const ServerRequest& req)
+{
+    BinaryFrame frame;
+    quint32 flags = 0;
+    switch(req.type())
+    {
+        case ServerRequest::StreamData:
+        {
+            const StreamDataRequest& r = static_cast<const StreamDataRequest&>(req);
+            if (r.sharedMemory())
+                flags |= BinaryFrame::SharedMemoryFlag;
+            frame.put16((quint16)r.size());
+            for (DataSpecIterator it = r.begin(); it != r.end(); ++it) {
+                frame.putSet(it->serviceData());
+                frame.putSet(it->streamData());
+            }
+            break;
+        }
+        case ServerRequest::ServiceData:
+        {
+            const ServiceDataRequest& r = static_cast<const ServiceDataRequest&>(req);
+            frame.put16((quint16)r.types().size());
+            foreach( const QString& type, r.types() ) {
+                frame.putString(type);
+                frame.putString(r.version(type));
+            }
+            break;
+        }
+        case ServerRequest::Compression:
+        {
+            const CompressionRequest& r = static_cast<const CompressionRequest&>(req);
+            QList<QString> streams = r.streams();
+            frame.put16((quint16)streams.size());
+            foreach( const QString& stream, streams ) {
+                frame.putString(stream);
+                frame.put8((quint8)r.level(stream));
+                frame.put8((quint8)r.shuffle(stream));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return frame.frame(req.type(), flags);
+}
+
+
+boost::shared_ptr<ServerResponse> PelicanBinaryClientProtocol::receive(
+        QAbstractSocket& socket)
+{
+    typedef boost::shared_ptr<ServerResponse> Response_t;
+
+    if (!BinaryFrame::isFrame(socket, _timeout)) {
+        QString msg = socket.errorString();
+        if (socket.bytesAvailable() >= 2) {
+            // Not a binary frame: the server only speaks version 1.
+            _rejected = true;
+            socket.readAll();
+            msg = "PelicanBinaryClientProtocol: Server does not support"
+                  " protocol version 2";
+        }
+        std::cerr << "PelicanBinaryClientProtocol: Receive error: "
+                  << msg.toStdString() << std::endl;
+        return Response_t(new ServerResponse(ServerResponse::Error, msg));
+    }
+
+    try {
+        BinaryFrame::Header header;
+        if (!BinaryFrame::readHeader(socket, header, _timeout))
+            throw socket.errorString();
+        BinaryFrame frame = BinaryFrame::readPayload(socket, header, _timeout);
+
+        switch(header.type)
+        {
+            case ServerResponse::Acknowledge:
+            case ServerResponse::Error:
+                return Response_t(new ServerResponse(
+                        (ServerResponse::Response)header.type, frame.getString()));
+
+            case ServerResponse::DataSupport:
+            {
+                DataSpec spec;
+                spec.addStreamData( frame.getSet() );
+                spec.addServiceData( frame.getSet() );
+                QHash<QString, QString> adapters;
+                quint16 n = frame.get16();
+                for (quint16 i = 0; i < n; ++i) {
+                    QString key = frame.getString();
+                    adapters.insert(key, frame.getString());
+                }
+                spec.addAdapterTypes( adapters );
+                return Response_t(new DataSupportResponse(spec));
+            }
+
+            case ServerResponse::StreamData:
+            {
+                boost::shared_ptr<StreamDataResponse> s(new StreamDataResponse);
+                quint16 streams = frame.get16();
+                for (quint16 i = 0; i < streams; ++i) {
+                    QString name = frame.getString();
+                    QString id = frame.getString();
+                    quint64 size = frame.get64();
+                    qint64 timestamp = (qint64)frame.get64();
+                    quint32 lostPackets = frame.get32();
+                    StreamData* sd = new StreamData(name, 0, (unsigned long)size);
+                    s->setStreamData(sd);
+                    sd->setId(id);
+                    sd->setTimestamp(timestamp);
+                    sd->setLostPackets(lostPackets);
+
+                    quint16 associates = frame.get16();
+                    for (quint16 j = 0; j < associates; ++j) {
+                        name = frame.getString();
+                        id = frame.getString();
+                        size = frame.get64();
+                        sd->addAssociatedData( boost::shared_ptr<DataChunk>(
+                                new DataChunk(name, id, size)));
+                    }
+                    if (header.flags & BinaryFrame::SharedMemoryFlag) {
+                        QString segment = frame.getString();
+                        s->setSharedMemory(segment, frame.get64());
+                    }
+                }
+                return s;
+            }
+
+            case ServerResponse::ServiceData:
+            {
+                boost::shared_ptr<ServiceDataResponse> s(new ServiceDataResponse);
+                quint16 sets = frame.get16();
+                for (quint16 i = 0; i < sets; ++i) {
+                    QString name = frame.getString();
+                    QString id = frame.getString();
+                    s->addData(new DataChunk(name, id, frame.get64()));
+                }
+                return s;
+            }
+
+            case ServerResponse::Blob:
+            case ServerResponse::CompressedBlob:
+            {
+                QString type = frame.getString();
+                QString name = frame.getString();
+                quint64 dataSize = frame.get64();
+                boost::shared_ptr<DataBlobResponse> s(new DataBlobResponse(type,
+                        name, dataSize, (QSysInfo::Endian)header.flags));
+                if (header.type == ServerResponse::CompressedBlob) {
+                    quint8 shuffle = frame.get8();
+                    quint64 packedSize = frame.get64();
+                    s->setData(_codec.decompress(BinaryFrame::readBytes(
+                            socket, packedSize, _timeout), dataSize, shuffle));
+                }
+                return s;
+            }
+
+            default:
+                break;
+        }
+        return Response_t(new ServerResponse(ServerResponse::Error,
+                QString("PelicanBinaryClientProtocol: Unknown type"
+                        " passed: %1").arg(header.type)));
+    }
+    catch (const QString& e) {
+        return Response_t(new ServerResponse(ServerResponse::Error, e));
+    }
+}
+
+} // namespace pelican
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "comms/PelicanBinaryProtocol.h"
+#include "comms/BinaryFrame.h"
+#include "comms/BlobCompression.h"
+#include "comms/AcknowledgementRequest.h"
+#include "comms/CompressionRequest.h"
+#include "comms/DataChunk.h"
+#include "comms/DataSupportRequest.h"
+#include "comms/DataSupportResponse.h"
+#include "comms/ServerResponse.h"
+#include "comms/ServiceDataRequest.h"
+#include "comms/SharedMemorySegment.h"
+#include "comms/StreamData.h"
+#include "comms/StreamDataRequest.h"
+#include "data/DataBlob.h"
+#include "data/DataSpec.h"
+
+#include <QtNetwork/QTcpSocket>
+#include <QtCore/QBuffer>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QSysInfo>
+
+namespace pelican {
+
+PelicanBinaryProtocol::PelicanBinaryProtocol()
+    : AbstractProtocol()
+{
+}
+
+PelicanBinaryProtocol::~PelicanBinaryProtocol()
+{
+}
+
+
+/**
+ * @details
+ * Reads a request frame and returns the corresponding server request
+ * object, or an error request if the frame cannot be read.
+ */
+boost::shared_ptr<ServerRequest> PelicanBinaryProtocol::request(QTcpSocket& socket)
+{
+    typedef boost::shared_ptr<ServerRequest> Request_t;
+    int timeout = 1000;
+    BinaryFrame::Header header;
+    if (!BinaryFrame::readHeader(socket, header, timeout))
+        return Request_t(new ServerRequest(ServerRequest::Error,
+                socket.errorString()));
+    if (header.version != BinaryFrame::Version)
+        return Request_t(new ServerRequest(ServerRequest::Error,
+                QString("PelicanBinaryProtocol: Unsupported version %1")
+                .arg(header.version)));
+
+    Request_t req;
+    try {
+        BinaryFrame frame = BinaryFrame::readPayload(socket, header, timeout);
+        switch (header.type)
+        {
+            case ServerRequest::Acknowledge:
+                req.reset(new AcknowledgementRequest);
+                break;
+
+            case ServerRequest::DataSupport:
+                req.reset(new DataSupportRequest);
+                break;
+
+            case ServerRequest::ServiceData:
+            {
+                ServiceDataRequest* s = new ServiceDataRequest;
+                req.reset(s);
+                quint16 num = frame.get16();
+                for (quint16 i = 0; i < num; ++i) {
+                    QString type = frame.getString();
+                    s->request(type, frame.getString());
+                }
+                break;
+            }
+
+            case ServerRequest::StreamData:
+            {
+                StreamDataRequest* s = new StreamDataRequest;
+                req.reset(s);
+                s->setSharedMemory(header.flags & BinaryFrame::SharedMemoryFlag);
+                quint16 num = frame.get16();
+                for (quint16 i = 0; i < num; ++i) {
+                    DataSpec spec;
+                    spec.addServiceData(frame.getSet());
+                    spec.addStreamData(frame.getSet());
+                    s->addDataOption(spec);
+                }
+                break;
+            }
+
+            case ServerRequest::Compression:
+            {
+                CompressionRequest* s = new CompressionRequest;
+                req.reset(s);
+                quint16 num = frame.get16();
+                for (quint16 i = 0; i < num; ++i) {
+                    QString stream = frame.getString();
+                    quint8 level = frame.get8();
+                    s->setCompression(stream, level, frame.get8());
+                }
+                break;
+            }
+
+            default:
+                req.reset(new ServerRequest(ServerRequest::Error,
+                        "PelicanBinaryProtocol: Unknown type passed"));
+                break;
+        }
+    }
+    catch (const QString& e) {
+        req.reset(new ServerRequest(ServerRequest::Error, e));
+    }
+    req->setVersion(BinaryFrame::Version);
+    return req;
+}
+
+
+/**
+ * @details
+ */
+void PelicanBinaryProtocol::send(QIODevice& device,
+        const DataSupportResponse& supported)
+{
+    BinaryFrame frame;
+    frame.putSet(supported.streamData());
+    frame.putSet(supported.serviceData());
+    const QHash<QString, QString>& adapters = supported.defaultAdapters();
+    frame.put16((quint16)adapters.size());
+    QHash<QString, QString>::const_iterator it;
+    for (it = adapters.begin(); it != adapters.end(); ++it) {
+        frame.putString(it.key());
+        frame.putString(it.value());
+    }
+    QByteArray array = frame.frame(ServerResponse::DataSupport);
+    _write(device, array.constData(), array.size());
+}
+
+
+/**
+ * @details
+ * Sends a frame describing each stream data object (name, id, size, ingest
+ * timestamp and associated service data) followed by the stream data.
+ */
+void PelicanBinaryProtocol::send(QIODevice& stream,
+        const AbstractProtocol::StreamData_t& data)
+{
+    BinaryFrame frame;
+    frame.put16((quint16)data.size());
+    foreach (StreamData* sd, data)
+        _putStreamData(frame, sd);
+    QByteArray array = frame.frame(ServerResponse::StreamData);
+    _write(stream, array.constData(), array.size());
+
+    foreach (StreamData* sd, data)
+        _write(stream, (const char*)sd->ptr(), sd->size());
+}
+
+
+/**
+ * @details
+ * Sends a StreamData frame, flagged BinaryFrame::SharedMemoryFlag, in which
+ * the record of each stream data object is followed by the name of the
+ * shared memory segment holding it and its offset in the segment. No data
+ * follows the frame.
+ */
+bool PelicanBinaryProtocol::sendShared(QIODevice& stream,
+        const AbstractProtocol::StreamData_t& data,
+        const AbstractProtocol::Segments_t& segments)
+{
+    Q_ASSERT(segments.size() == data.size());
+    BinaryFrame frame;
+    frame.put16((quint16)data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        const StreamData* sd = data[i];
+        if (!segments[i]->contains(sd->ptr(), sd->size()))
+            throw QString("PelicanBinaryProtocol::sendShared: Stream data %1"
+                    " is not in shared memory.").arg(sd->name());
+        _putStreamData(frame, sd);
+        frame.putString(segments[i]->name());
+        frame.put64(segments[i]->offset(sd->ptr()));
+    }
+    QByteArray array = frame.frame(ServerResponse::StreamData,
+            BinaryFrame::SharedMemoryFlag);
+    _write(stream, array.constData(), array.size());
+    return true;
+}
+
+
+/**
+ * @details
+ */
+void PelicanBinaryProtocol::send(QIODevice& stream,
+        const AbstractProtocol::ServiceData_t& data)
+{
+    BinaryFrame frame;
+    frame.put16((quint16)data.size());
+    foreach (DataChunk* d, data) {
+        frame.putString(d->name());
+        frame.putString(d->id());
+        frame.put64(d->size());
+    }
+    QByteArray array = frame.frame(ServerResponse::ServiceData);
+    _write(stream, array.constData(), array.size());
+
+    foreach (DataChunk* d, data)
+        _write(stream, (const char*)d->ptr(), d->size());
+}
+
+
+/**
+ * @details
+ * The frame flags carry the byte order of the serialised blob.
+ */
+void PelicanBinaryProtocol::send(QIODevice& device, const QString& name,
+        const DataBlob& data)
+{
+    BinaryFrame frame;
+    frame.putString(data.type());
+    frame.putString(name);
+    frame.put64(data.serialisedBytes());
+    QByteArray array = frame.frame(ServerResponse::Blob, QSysInfo::ByteOrder);
+    _write(device, array.constData(), array.size());
+    data.serialise(device);
+    while (device.bytesToWrite() > 0)
+        device.waitForBytesWritten(-1);
+}
+
+
+/**
+ * @details
+ * As PelicanProtocol, the blob is sent uncompressed if compression does
+ * not reduce its size.
+ */
+void PelicanBinaryProtocol::send(QIODevice& device, const QString& name,
+        const DataBlob& data, const BlobCompression& codec)
+{
+    QBuffer raw;
+    raw.open(QBuffer::WriteOnly);
+    data.serialise(raw);
+    const QByteArray& bytes = raw.buffer();
+    QByteArray packed;
+    if (bytes.size() > 0)
+        packed = codec.compress(bytes.constData(), bytes.size());
+    bool compressed = packed.size() > 0 && packed.size() < bytes.size();
+
+    BinaryFrame frame;
+    frame.putString(data.type());
+    frame.putString(name);
+    frame.put64(bytes.size());
+    if (compressed) {
+        frame.put8((quint8)codec.shuffle());
+        frame.put64(packed.size());
+    }
+    QByteArray array = frame.frame(compressed ? ServerResponse::CompressedBlob
+            : ServerResponse::Blob, QSysInfo::ByteOrder);
+    array.append(compressed ? packed : bytes);
+    _write(device, array.constData(), array.size());
+}
+
+
+/**
+ * @details
+ */
+void PelicanBinaryProtocol::send(QIODevice& device, const QString& msg)
+{
+    BinaryFrame frame;
+    frame.putString(msg);
+    QByteArray array = frame.frame(ServerResponse::Acknowledge);
+    _write(device, array.constData(), array.size());
+}
+
+
+/**
+ * @details
+ */
+void PelicanBinaryProtocol::sendError(QIODevice& device, const QString& msg)
+{
+    BinaryFrame frame;
+    frame.putString(msg);
+    QByteArray array = frame.frame(ServerResponse::Error);
+    _write(device, array.constData(), array.size());
+}
+
+
+/**
+ * @details
+ * Appends the record describing a stream data object (name, id, size,
+ * ingest timestamp, lost packets and associated service data) to the frame.
+ */
+void PelicanBinaryProtocol::_putStreamData(BinaryFrame& frame,
+        const StreamData* sd)
+{
+    frame.putString(sd->name());
+    frame.putString(sd->id());
+    frame.put64(sd->size());
+    frame.put64((quint64)sd->timestamp());
+    frame.put32(sd->lostPackets());
+    frame.put16((quint16)sd->associateData().size());
+    foreach (const boost::shared_ptr<DataChunk>& dat, sd->associateData()) {
+        frame.putString(dat->name());
+        frame.putString(dat->id());
+        frame.put64(dat->size());
+    }
+}
+
+
+void PelicanBinaryProtocol::_write(QIODevice& device, const char* data,
+        qint64 size)
+{
+    if (device.write(data, size) < 0)
+        throw QString("PelicanBinaryProtocol::send: Unable to write.");
+    while (device.bytesToWrite() > 0)
+        device.waitForBytesWritten(-1);
+}
+
+} // namespace pelican
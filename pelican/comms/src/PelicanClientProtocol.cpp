@@ -27,7 +27,9 @@
  */
 
 #include "comms/PelicanClientProtocol.h"
+#include "comms/BinaryFrame.h"
 #include "comms/DataChunk.h"
+#include "comms/CompressionRequest.h"
 #include "comms/StreamData.h"
 #include "comms/ServerRequest.h"
 #include "comms/ServerResponse.h"
@@ -50,7 +52,8 @@
 namespace pelican {
 
 PelicanClientProtocol::PelicanClientProtocol()
-    : AbstractClientProtocol(), _timeout(2000)
+    : AbstractClientProtocol(), _timeout(2000),
+      _codec(1, 1, &_compressionStats)
 {
 }
 
@@ -92,6 +95,16 @@ QByteArray PelicanClientProtocol::serialise(const ServerRequest& req)
             }
             break;
         }
+        case ServerRequest::Compression:
+        {
+            const CompressionRequest& r = static_cast<const CompressionRequest&>(req);
+            QList<QString> streams = r.streams();
+            ds << (quint16)streams.size();
+            foreach( const QString& stream, streams ) {
+                ds << stream << (quint8)r.level(stream) << (quint8)r.shuffle(stream);
+            }
+            break;
+        }
         default:
             break;
     }
@@ -123,7 +136,13 @@ boost::shared_ptr<ServerResponse> PelicanClientProtocol::receive(
     switch(type)
     {
         case ServerResponse::Acknowledge: // 0
+        {
+            QString msg;
+            in >> msg;
+            return boost::shared_ptr<ServerResponse>(new ServerResponse(type,
+                    msg));
             break;
+        }
 
         case ServerResponse::DataSupport: // 1
         {
@@ -201,8 +220,40 @@ boost::shared_ptr<ServerResponse> PelicanClientProtocol::receive(
             in >> dataSize;
             while (socket.bytesAvailable() < (qint64)dataSize)
                 socket.waitForReadyRead(10);
+            // Version 1 does not carry the byte order of the sender, so
+            // this is that of the stream (big endian). Blobs serialised in
+            // native byte order (see ArraySerialiser) carry their own.
+            boost::shared_ptr<DataBlobResponse> s(new DataBlobResponse(type,
+                    name, dataSize, (QSysInfo::Endian)in.byteOrder()));
+            return s;
+            break;
+        }
+
+        case ServerResponse::CompressedBlob: // 6
+        {
+            // Decompressed here, and returned as an ordinary blob
+            // response carrying the serialised data.
+            QString type;
+            in >> type;
+            QString name;
+            in >> name;
+            quint64 dataSize;
+            in >> dataSize;
+            quint8 shuffle;
+            in >> shuffle;
+            quint64 packedSize;
+            in >> packedSize;
+            QByteArray packed;
+            try {
+                packed = BinaryFrame::readBytes(socket, packedSize, _timeout);
+            }
+            catch (const QString& e) {
+                return boost::shared_ptr<ServerResponse>(new ServerResponse(
+                        ServerResponse::Error, e));
+            }
             boost::shared_ptr<DataBlobResponse> s(new DataBlobResponse(type,
                     name, dataSize, (QSysInfo::Endian)in.byteOrder()));
+            s->setData(_codec.decompress(packed, dataSize, shuffle));
             return s;
             break;
         }
@@ -31,6 +31,9 @@
 #include "comms/ServerRequest.h"
 #include "comms/ServerResponse.h"
 #include "comms/AcknowledgementRequest.h"
+#include "comms/BinaryFrame.h"
+#include "comms/BlobCompression.h"
+#include "comms/CompressionRequest.h"
 #include "comms/DataSupportResponse.h"
 #include "comms/DataSupportRequest.h"
 #include "comms/ServiceDataRequest.h"
@@ -41,6 +44,7 @@
 #include "data/DataBlobVerify.h"
 
 #include <QtNetwork/QTcpSocket>
+#include <QtCore/QBuffer>
 #include <QtCore/QDataStream>
 #include <QtCore/QByteArray>
 #include <QtCore/QString>
@@ -75,6 +79,10 @@ boost::shared_ptr<ServerRequest> PelicanProtocol::request(QTcpSocket& socket)
     int timeout = 1000;
     ServerRequest::Request type = ServerRequest::Error;
 
+    // Version 2 (binary) requests are handled by the binary protocol.
+    if (BinaryFrame::isFrame(socket, timeout))
+        return _binary.request(socket);
+
     // If there are not enough bytes in the socket to hold the request type
     // return a error (bad) request.
     while (socket.bytesAvailable() < (int)sizeof(quint16))
@@ -141,6 +149,21 @@ boost::shared_ptr<ServerRequest> PelicanProtocol::request(QTcpSocket& socket)
             return s;
         }
 
+        case ServerRequest::Compression:
+        {
+            boost::shared_ptr<CompressionRequest> s(new CompressionRequest);
+            quint16 num;
+            in >> num;
+            for(int i = 0; i < num; ++i )
+            {
+                QString stream;
+                quint8 level, shuffle;
+                in >> stream >> level >> shuffle;
+                s->setCompression(stream, level, shuffle);
+            }
+            return s;
+        }
+
         default:
             break;
     }
@@ -148,6 +171,19 @@ boost::shared_ptr<ServerRequest> PelicanProtocol::request(QTcpSocket& socket)
 }
 
 
+/**
+ * @details
+ * Returns the binary protocol for requests received with version 2 of the
+ * protocol, and this protocol otherwise.
+ */
+AbstractProtocol* PelicanProtocol::protocolFor(const ServerRequest& req)
+{
+    if (req.version() == BinaryFrame::Version)
+        return &_binary;
+    return this;
+}
+
+
 /**
  * @details
  */
@@ -290,6 +326,51 @@ void PelicanProtocol::send(QIODevice& device, const QString& name, const DataBlo
 }
 
 
+/**
+ * @details
+ * Sends a data blob compressed with @p codec. The blob is serialised into
+ * memory and compressed; the header carries the uncompressed size, the
+ * shuffle width and the compressed size. If compression does not reduce
+ * the size of the blob, it is sent uncompressed as a normal blob.
+ */
+void PelicanProtocol::send(QIODevice& device, const QString& name,
+        const DataBlob& data, const BlobCompression& codec)
+{
+    QBuffer raw;
+    raw.open(QBuffer::WriteOnly);
+    data.serialise(raw);
+    const QByteArray& bytes = raw.buffer();
+    QByteArray packed;
+    if (bytes.size() > 0)
+        packed = codec.compress(bytes.constData(), bytes.size());
+
+    QByteArray array;
+    QDataStream out(&array, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_0);
+    bool compressed = packed.size() > 0 && packed.size() < bytes.size();
+    if (compressed) {
+        out << (quint16)ServerResponse::CompressedBlob;
+        out << data.type();
+        out << name;
+        out << (quint64)bytes.size();
+        out << (quint8)codec.shuffle();
+        out << (quint64)packed.size();
+    }
+    else {
+        out << (quint16)ServerResponse::Blob;
+        out << data.type();
+        out << name;
+        out << (quint64)bytes.size();
+    }
+    array.append(compressed ? packed : bytes);
+    qint64 bytesWritten = device.write(array);
+    while (device.bytesToWrite() > 0)
+        device.waitForBytesWritten(-1);
+    if (bytesWritten < 0)
+        throw QString("PelicanProtocol::send: Unable to write.");
+}
+
+
 /**
  * @details
  */
@@ -298,10 +379,8 @@ void PelicanProtocol::send(QIODevice& device, const QString& msg)
     QByteArray array;
     QDataStream out(&array, QIODevice::WriteOnly);
     out.setVersion(QDataStream::Qt_4_0);
-    out << (quint16)0;
+    out << (quint16)ServerResponse::Acknowledge;
     out << msg;
-    out.device()->seek(0);
-    out << (quint16)(array.size() - sizeof(quint16));
     device.write(array);
     while (device.bytesToWrite() > 0)
         device.waitForBytesWritten(-1);
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "comms/SharedMemorySegment.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QByteArray>
+#include <QtCore/QRegExp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pelican {
+
+/**
+ * @details
+ * Creates a new shared memory segment. Throws if a segment of the same name
+ * already exists.
+ *
+ * @param[in] name The name of the segment (see uniqueName()).
+ * @param[in] size The size of the segment in bytes.
+ */
+SharedMemorySegment::SharedMemorySegment(const QString& name, size_t size)
+    : _name(name), _data(0), _size(size), _owner(true)
+{
+    QByteArray n = name.toLatin1();
+    int fd = shm_open(n.constData(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+        throw QString("SharedMemorySegment: Unable to create %1: %2")
+                .arg(name).arg(strerror(errno));
+    if (ftruncate(fd, (off_t)size) != 0) {
+        QString err = strerror(errno);
+        ::close(fd);
+        shm_unlink(n.constData());
+        throw QString("SharedMemorySegment: Unable to size %1: %2")
+                .arg(name).arg(err);
+    }
+    try {
+        _map(fd, true);
+    }
+    catch (const QString&) {
+        shm_unlink(n.constData());
+        throw;
+    }
+}
+
+
+/**
+ * @details
+ * Attaches (read-only) to an existing shared memory segment.
+ *
+ * @param[in] name The name of the segment.
+ */
+SharedMemorySegment::SharedMemorySegment(const QString& name)
+    : _name(name), _data(0), _size(0), _owner(false)
+{
+    int fd = shm_open(name.toLatin1().constData(), O_RDONLY, 0);
+    if (fd < 0)
+        throw QString("SharedMemorySegment: Unable to open %1: %2")
+                .arg(name).arg(strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        QString err = strerror(errno);
+        ::close(fd);
+        throw QString("SharedMemorySegment: Unable to stat %1: %2")
+                .arg(name).arg(err);
+    }
+    _size = (size_t)st.st_size;
+    _map(fd, false);
+}
+
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+    if (_data)
+        munmap(_data, _size);
+    if (_owner)
+        shm_unlink(_name.toLatin1().constData());
+}
+
+
+bool SharedMemorySegment::contains(const void* ptr, size_t size) const
+{
+    const char* p = (const char*)ptr;
+    return p >= _data && p <= _data + _size && size <= (size_t)(_data + _size - p);
+}
+
+
+/**
+ * @details
+ * Returns a name of the form /pelican-<pid>-<n>-<tag>, with any characters
+ * that are not valid in a segment name removed from the tag.
+ */
+QString SharedMemorySegment::uniqueName(const QString& tag)
+{
+    static QAtomicInt count(0);
+    QString t = tag;
+    t.remove(QRegExp("[^A-Za-z0-9_.-]"));
+    return QString("/pelican-%1-%2-%3").arg(getpid())
+            .arg(count.fetchAndAddRelaxed(1)).arg(t.left(200));
+}
+
+
+/**
+ * @details
+ * Maps the open file descriptor, which is closed on return.
+ */
+void SharedMemorySegment::_map(int fd, bool writable)
+{
+    // mmap() fails for empty mappings.
+    if (_size > 0) {
+        int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* p = mmap(0, _size, prot, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            QString err = strerror(errno);
+            ::close(fd);
+            throw QString("SharedMemorySegment: Unable to map %1: %2")
+                    .arg(_name).arg(err);
+        }
+        _data = (char*)p;
+    }
+    ::close(fd);
+}
+
+} // namespace pelican
@@ -35,7 +35,7 @@ namespace pelican {
 
 // class StreamDataRequest
 StreamDataRequest::StreamDataRequest()
-    : ServerRequest(ServerRequest::StreamData)
+    : ServerRequest(ServerRequest::StreamData), _sharedMemory(false)
 {
     _dataOptions.clear();
     _dataOptions.end();
@@ -35,7 +35,8 @@ namespace pelican {
  * Creates a new StreamDataResponse object.
  */
 StreamDataResponse::StreamDataResponse()
-    : ServerResponse( ServerResponse::StreamData ), _data(0)
+    : ServerResponse( ServerResponse::StreamData ), _data(0),
+      _offset(0)
 {
 }
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PELICANBINARYPROTOCOLTEST_H
+#define PELICANBINARYPROTOCOLTEST_H
+
+/**
+ * @file PelicanBinaryProtocolTest.h
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "comms/PelicanBinaryClientProtocol.h"
+
+class QTcpSocket;
+
+namespace pelican {
+
+namespace test {
+class SocketTester;
+}
+class ServerRequest;
+
+/**
+ * @ingroup t_comms
+ *
+ * @class PelicanBinaryProtocolTest
+ *
+ * @brief
+ * Unit test for version 2 (binary) of the Pelican protocol.
+ *
+ * @details
+ *
+ */
+
+class PelicanBinaryProtocolTest : public CppUnit::TestFixture
+{
+    protected:
+        typedef QTcpSocket Socket_t;
+        Socket_t& _send(ServerRequest*);
+
+    public:
+        CPPUNIT_TEST_SUITE( PelicanBinaryProtocolTest );
+        CPPUNIT_TEST( test_frame );
+        CPPUNIT_TEST( test_request );
+        CPPUNIT_TEST( test_sendStreamData );
+        CPPUNIT_TEST( test_sendSharedStreamData );
+        CPPUNIT_TEST( test_sendServiceData );
+        CPPUNIT_TEST( test_sendDataBlob );
+        CPPUNIT_TEST( test_sendDataSupport );
+        CPPUNIT_TEST( test_negotiation );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp();
+        void tearDown();
+
+        // Test Methods
+        void test_frame();
+        void test_request();
+        void test_sendStreamData();
+        void test_sendSharedStreamData();
+        void test_sendServiceData();
+        void test_sendDataBlob();
+        void test_sendDataSupport();
+        void test_negotiation();
+
+    public:
+        PelicanBinaryProtocolTest();
+        ~PelicanBinaryProtocolTest();
+        test::SocketTester* _st;
+        PelicanBinaryClientProtocol _protocol;
+};
+
+} // namespace pelican
+#endif // PELICANBINARYPROTOCOLTEST_H
@@ -70,6 +70,8 @@ class PelicanProtocolTest : public CppUnit::TestFixture
         CPPUNIT_TEST( test_sendStreamData );
         CPPUNIT_TEST( test_sendServiceData );
         CPPUNIT_TEST( test_sendDataBlob );
+        CPPUNIT_TEST( test_sendCompressedDataBlob );
+        CPPUNIT_TEST( test_sendArrayDataBlob );
         CPPUNIT_TEST( test_sendDataSupport );
         CPPUNIT_TEST( test_sendChunk );
         CPPUNIT_TEST_SUITE_END();
@@ -83,6 +85,8 @@ class PelicanProtocolTest : public CppUnit::TestFixture
         void test_sendStreamData();
         void test_sendServiceData();
         void test_sendDataBlob();
+        void test_sendCompressedDataBlob();
+        void test_sendArrayDataBlob();
         void test_sendDataSupport();
         void test_sendChunk();
 
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BlobCompressionTest.h"
+#include "comms/BlobCompression.h"
+
+#include <QtCore/QString>
+
+#include <vector>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( BlobCompressionTest );
+
+BlobCompressionTest::BlobCompressionTest()
+    : CppUnit::TestFixture()
+{
+}
+
+BlobCompressionTest::~BlobCompressionTest()
+{
+}
+
+void BlobCompressionTest::test_shuffle()
+{
+    {
+        // Use Case:
+        // Shuffle 2 words of 4 bytes.
+        const char in[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        const char expect[8] = { 1, 5, 2, 6, 3, 7, 4, 8 };
+        char out[8];
+        BlobCompression::shuffle(in, out, 8, 4);
+        for (int i = 0; i < 8; ++i)
+            CPPUNIT_ASSERT_EQUAL( expect[i], out[i] );
+    }
+    {
+        // Use Case:
+        // Round trip, including sizes that are not a multiple of the width.
+        for (int size = 0; size < 40; ++size) {
+            for (int width = 1; width <= 8; ++width) {
+                std::vector<char> in(size + 1), out(size + 1), back(size + 1);
+                for (int i = 0; i < size; ++i) in[i] = char(i * 7 + 1);
+                BlobCompression::shuffle(&in[0], &out[0], size, width);
+                BlobCompression::unshuffle(&out[0], &back[0], size, width);
+                CPPUNIT_ASSERT( in == back );
+            }
+        }
+    }
+}
+
+void BlobCompressionTest::test_compress()
+{
+    // Slowly varying floats, as in a spectrum.
+    std::vector<float> data(4096);
+    for (unsigned i = 0; i < data.size(); ++i)
+        data[i] = 1000.0f + (i % 64);
+    const char* raw = reinterpret_cast<const char*>(&data[0]);
+    qint64 size = data.size() * sizeof(float);
+
+    BlobCompression::Statistics stats;
+    BlobCompression plain(1, 1, &stats);
+    BlobCompression shuffled(1, 4, &stats);
+    {
+        // Use Case:
+        // Round trip with and without shuffle; shuffling compresses better.
+        QByteArray a = plain.compress(raw, size);
+        QByteArray b = shuffled.compress(raw, size);
+        CPPUNIT_ASSERT( b.size() < a.size() );
+        CPPUNIT_ASSERT( a.size() < size );
+        CPPUNIT_ASSERT_EQUAL( (quint64)2, stats.blobs );
+        CPPUNIT_ASSERT_EQUAL( (quint64)(2 * size), stats.rawBytes );
+        CPPUNIT_ASSERT_EQUAL( (quint64)(a.size() + b.size()), stats.packedBytes );
+        CPPUNIT_ASSERT( stats.ratio() > 1.0 );
+
+        QByteArray out = plain.decompress(a, size, 1);
+        CPPUNIT_ASSERT( out == QByteArray(raw, size) );
+        out = plain.decompress(b, size, 4);
+        CPPUNIT_ASSERT( out == QByteArray(raw, size) );
+    }
+    {
+        // Use Case:
+        // Unexpected size or corrupt data.
+        QByteArray a = shuffled.compress(raw, size);
+        CPPUNIT_ASSERT_THROW( shuffled.decompress(a, size - 1, 4), QString );
+        CPPUNIT_ASSERT_THROW( shuffled.decompress(QByteArray("corrupt"), size, 4),
+                QString );
+    }
+}
+
+} // namespace pelican
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PelicanBinaryProtocolTest.h"
+#include "comms/BinaryFrame.h"
+#include "comms/CompressionRequest.h"
+#include "comms/DataBlobResponse.h"
+#include "comms/DataChunk.h"
+#include "comms/DataSupportRequest.h"
+#include "comms/DataSupportResponse.h"
+#include "comms/PelicanBinaryProtocol.h"
+#include "comms/PelicanClientProtocol.h"
+#include "comms/PelicanProtocol.h"
+#include "comms/ServiceDataRequest.h"
+#include "comms/ServiceDataResponse.h"
+#include "comms/SharedMemorySegment.h"
+#include "comms/StreamData.h"
+#include "comms/StreamDataRequest.h"
+#include "comms/StreamDataResponse.h"
+#include "utility/test/SocketTester.h"
+#include "data/test/TestDataBlob.h"
+
+#include <QtCore/QBuffer>
+#include <QtNetwork/QTcpSocket>
+
+#include <cstring>
+#include <vector>
+
+namespace pelican {
+
+using test::TestDataBlob;
+using test::SocketTester;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PelicanBinaryProtocolTest );
+
+PelicanBinaryProtocolTest::PelicanBinaryProtocolTest()
+    : CppUnit::TestFixture()
+{
+}
+
+PelicanBinaryProtocolTest::~PelicanBinaryProtocolTest()
+{
+}
+
+void PelicanBinaryProtocolTest::setUp()
+{
+    _st = new SocketTester;
+}
+
+void PelicanBinaryProtocolTest::tearDown()
+{
+    delete _st;
+}
+
+void PelicanBinaryProtocolTest::test_frame()
+{
+    // Use Case:
+    // Build a frame and read it back.
+    // Expect a fixed-size header giving the payload length, and repeated
+    // strings to be sent once.
+    BinaryFrame out;
+    out.putString("stream");
+    out.put64(Q_UINT64_C(0x0102030405060708));
+    out.putString("stream");
+    out.put8(7);
+    QByteArray bytes = out.frame(5, 42);
+
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    CPPUNIT_ASSERT( BinaryFrame::isFrame(buffer, 0) );
+    BinaryFrame::Header header;
+    CPPUNIT_ASSERT( BinaryFrame::readHeader(buffer, header, 0) );
+    CPPUNIT_ASSERT_EQUAL( (int)BinaryFrame::Version, (int)header.version );
+    CPPUNIT_ASSERT_EQUAL( 5, (int)header.type );
+    CPPUNIT_ASSERT_EQUAL( (quint32)42, header.flags );
+    CPPUNIT_ASSERT_EQUAL( (quint64)(bytes.size() - BinaryFrame::HeaderBytes),
+            header.length );
+    // string table (2 + 2 + 6 bytes) and records (2 + 8 + 2 + 1 bytes)
+    CPPUNIT_ASSERT_EQUAL( (quint64)23, header.length );
+
+    BinaryFrame in = BinaryFrame::readPayload(buffer, header, 0);
+    CPPUNIT_ASSERT( in.getString() == "stream" );
+    CPPUNIT_ASSERT_EQUAL( Q_UINT64_C(0x0102030405060708), in.get64() );
+    CPPUNIT_ASSERT( in.getString() == "stream" );
+    CPPUNIT_ASSERT_EQUAL( 7, (int)in.get8() );
+    CPPUNIT_ASSERT_THROW( in.get8(), QString );
+}
+
+void PelicanBinaryProtocolTest::test_request()
+{
+    {
+        // Use Case:
+        // A DataSupportRequest read by the version 1 server protocol
+        // Expect the version 2 protocol to be used for the response
+        DataSupportRequest req;
+        PelicanProtocol proto;
+        boost::shared_ptr<ServerRequest> req2 = proto.request(_send(&req));
+        CPPUNIT_ASSERT( req == *req2 );
+        CPPUNIT_ASSERT_EQUAL( 2, req2->version() );
+        CPPUNIT_ASSERT( proto.protocolFor(*req2) != &proto );
+        CPPUNIT_ASSERT( dynamic_cast<PelicanBinaryProtocol*>(proto.protocolFor(*req2)) );
+    }
+    {
+        // Use Case:
+        // A ServiceData request with 2 objects
+        PelicanBinaryProtocol proto;
+        ServiceDataRequest req;
+        req.request("testa","versiona");
+        req.request("testb","versionb");
+        CPPUNIT_ASSERT( req == *(proto.request(_send(&req))) );
+    }
+    {
+        // Use Case:
+        // A StreamData request with 2 options
+        PelicanBinaryProtocol proto;
+        StreamDataRequest req;
+        DataSpec spec1;
+        spec1.addStreamData("stream1");
+        spec1.addServiceData("service1");
+        DataSpec spec2;
+        spec2.addStreamData("stream2");
+        spec2.addStreamData("stream1");
+        req.addDataOption(spec1);
+        req.addDataOption(spec2);
+        CPPUNIT_ASSERT( req == *(proto.request(_send(&req))) );
+    }
+    {
+        // Use Case:
+        // A Compression request
+        PelicanBinaryProtocol proto;
+        CompressionRequest req;
+        req.setCompression("streamA", 1, 4);
+        CPPUNIT_ASSERT( req == *(proto.request(_send(&req))) );
+    }
+}
+
+void PelicanBinaryProtocolTest::test_sendStreamData()
+{
+    // Use Case:
+    // Single stream data with one associated service data
+    // Expect header information followed by the stream data
+    PelicanBinaryProtocol proto;
+    QByteArray data1("data1");
+    StreamData streamData("d1", data1.data(), data1.size());
+    streamData.setId("testid");
+    streamData.setTimestamp(Q_INT64_C(1234567890123456789));
+    streamData.setLostPackets(3);
+    QByteArray service("service");
+    boost::shared_ptr<DataChunk> chunk(new DataChunk("s1", service.data(),
+            service.size()));
+    chunk->setId("s1id");
+    streamData.addAssociatedData(chunk);
+    AbstractProtocol::StreamData_t data;
+    data.append(&streamData);
+
+    QByteArray block;
+    QBuffer stream(&block);
+    stream.open(QIODevice::WriteOnly);
+    proto.send(stream, data);
+
+    QTcpSocket& socket = _st->send(block);
+    boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+    CPPUNIT_ASSERT( resp->type() == ServerResponse::StreamData );
+    StreamData* sd = static_cast<StreamDataResponse*>(resp.get())->streamData();
+    CPPUNIT_ASSERT( sd->name() == "d1" );
+    CPPUNIT_ASSERT( sd->id() == "testid" );
+    CPPUNIT_ASSERT_EQUAL( (long)data1.size(), (long)sd->size() );
+    CPPUNIT_ASSERT_EQUAL( Q_INT64_C(1234567890123456789), sd->timestamp() );
+    CPPUNIT_ASSERT_EQUAL( quint32(3), sd->lostPackets() );
+    CPPUNIT_ASSERT_EQUAL( 1, sd->associateData().size() );
+    CPPUNIT_ASSERT( *chunk == *sd->associateData()[0] );
+
+    std::vector<char> buf(data1.size());
+    CPPUNIT_ASSERT_EQUAL( (long)data1.size(),
+            (long)socket.read(&buf[0], data1.size()) );
+    CPPUNIT_ASSERT( QByteArray(&buf[0], buf.size()) == data1 );
+}
+
+void PelicanBinaryProtocolTest::test_sendSharedStreamData()
+{
+    {
+        // Use Case:
+        // A StreamData request for data in shared memory
+        // Expect the flag to be passed to the server.
+        PelicanBinaryProtocol proto;
+        StreamDataRequest req;
+        DataSpec spec;
+        spec.addStreamData("stream1");
+        req.addDataOption(spec);
+        req.setSharedMemory(true);
+        boost::shared_ptr<ServerRequest> req2 = proto.request(_send(&req));
+        CPPUNIT_ASSERT( req == *req2 );
+        CPPUNIT_ASSERT( static_cast<StreamDataRequest&>(*req2).sharedMemory() );
+    }
+    {
+        // Use Case:
+        // Stream data held in a shared memory segment
+        // Expect the location of the data to be sent instead of the data.
+        SharedMemorySegment segment(SharedMemorySegment::uniqueName("d1"), 256);
+        memcpy(segment.data() + 64, "data1", 5);
+        StreamData streamData("d1", segment.data() + 64, 5);
+        streamData.setId("testid");
+        AbstractProtocol::StreamData_t data;
+        data.append(&streamData);
+        AbstractProtocol::Segments_t segments;
+        segments.append(&segment);
+
+        PelicanBinaryProtocol proto;
+        QByteArray block;
+        QBuffer stream(&block);
+        stream.open(QIODevice::WriteOnly);
+        CPPUNIT_ASSERT( proto.sendShared(stream, data, segments) );
+
+        QTcpSocket& socket = _st->send(block);
+        boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+        CPPUNIT_ASSERT( resp->type() == ServerResponse::StreamData );
+        StreamDataResponse* r = static_cast<StreamDataResponse*>(resp.get());
+        CPPUNIT_ASSERT( r->isShared() );
+        CPPUNIT_ASSERT( r->sharedSegment() == segment.name() );
+        CPPUNIT_ASSERT_EQUAL( (quint64)64, r->sharedOffset() );
+        CPPUNIT_ASSERT( r->streamData()->id() == "testid" );
+        CPPUNIT_ASSERT_EQUAL( (long)5, (long)r->streamData()->size() );
+        CPPUNIT_ASSERT_EQUAL( (qint64)0, socket.bytesAvailable() );
+
+        // Data outside the segment is rejected.
+        QByteArray heap("data2");
+        StreamData other("d2", heap.data(), heap.size());
+        data[0] = &other;
+        CPPUNIT_ASSERT_THROW( proto.sendShared(stream, data, segments), QString );
+
+        // Protocol version 1 does not support shared memory.
+        PelicanProtocol v1;
+        CPPUNIT_ASSERT( ! v1.sendShared(stream, data, segments) );
+    }
+}
+
+void PelicanBinaryProtocolTest::test_sendServiceData()
+{
+    // Use Case:
+    // Two service data objects
+    PelicanBinaryProtocol proto;
+    QByteArray data1("data1");
+    DataChunk d1("d1", data1.data(), data1.size());
+    d1.setId("d1id");
+    QByteArray data2("data2");
+    DataChunk d2("d2", data2.data(), data2.size());
+    d2.setId("d2id");
+    AbstractProtocol::ServiceData_t data;
+    data.append(&d1);
+    data.append(&d2);
+
+    QByteArray block;
+    QBuffer stream(&block);
+    stream.open(QIODevice::WriteOnly);
+    proto.send(stream, data);
+
+    QTcpSocket& socket = _st->send(block);
+    boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+    CPPUNIT_ASSERT( resp->type() == ServerResponse::ServiceData );
+    ServiceDataResponse* sd = static_cast<ServiceDataResponse*>(resp.get());
+    CPPUNIT_ASSERT_EQUAL( 2, sd->data().size() );
+    CPPUNIT_ASSERT( d1 == *(sd->data()[0]) );
+    CPPUNIT_ASSERT( d2 == *(sd->data()[1]) );
+    CPPUNIT_ASSERT( socket.read(data1.size() + data2.size()) == data1 + data2 );
+}
+
+void PelicanBinaryProtocolTest::test_sendDataBlob()
+{
+    PelicanBinaryProtocol proto;
+    {
+        // Use Case:
+        // Uncompressed blob
+        TestDataBlob blob;
+        blob.setData("testdata");
+        QByteArray block;
+        QBuffer stream(&block);
+        stream.open(QIODevice::WriteOnly);
+        proto.send(stream, "teststream", blob);
+
+        QTcpSocket& socket = _st->send(block);
+        boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+        CPPUNIT_ASSERT( resp->type() == ServerResponse::Blob );
+        DataBlobResponse* db = static_cast<DataBlobResponse*>(resp.get());
+        CPPUNIT_ASSERT( db->blobClass() == blob.type() );
+        CPPUNIT_ASSERT( db->dataName() == "teststream" );
+        CPPUNIT_ASSERT( db->byteOrder() == QSysInfo::ByteOrder );
+        CPPUNIT_ASSERT( ! db->hasData() );
+        TestDataBlob copy;
+        db->readBlob(copy, socket);
+        CPPUNIT_ASSERT( copy == blob );
+    }
+    {
+        // Use Case:
+        // Compressed blob
+        TestDataBlob blob;
+        blob.resize(16384);
+        blob.data().fill(0);
+        BlobCompression codec(1, 4);
+        QByteArray block;
+        QBuffer stream(&block);
+        stream.open(QIODevice::WriteOnly);
+        proto.send(stream, "teststream", blob, codec);
+        CPPUNIT_ASSERT( block.size() < blob.data().size() );
+
+        QTcpSocket& socket = _st->send(block);
+        boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+        CPPUNIT_ASSERT( resp->type() == ServerResponse::Blob );
+        DataBlobResponse* db = static_cast<DataBlobResponse*>(resp.get());
+        CPPUNIT_ASSERT( db->hasData() );
+        TestDataBlob copy;
+        db->readBlob(copy, socket);
+        CPPUNIT_ASSERT( copy == blob );
+    }
+}
+
+void PelicanBinaryProtocolTest::test_sendDataSupport()
+{
+    // Use Case:
+    // Stream and service data with default adapters
+    PelicanBinaryProtocol proto;
+    DataSpec spec;
+    spec.addStreamData("stream1");
+    spec.addStreamData("stream2");
+    spec.addServiceData("service1");
+    QHash<QString, QString> adapters;
+    adapters.insert("stream1", "Adapter1");
+    spec.addAdapterTypes(adapters);
+    DataSupportResponse data(spec);
+
+    QByteArray block;
+    QBuffer stream(&block);
+    stream.open(QIODevice::WriteOnly);
+    proto.send(stream, data);
+
+    boost::shared_ptr<ServerResponse> resp = _protocol.receive(_st->send(block));
+    CPPUNIT_ASSERT( resp->type() == ServerResponse::DataSupport );
+    DataSupportResponse* d = static_cast<DataSupportResponse*>(resp.get());
+    CPPUNIT_ASSERT( d->streamData() == data.streamData() );
+    CPPUNIT_ASSERT( d->serviceData() == data.serviceData() );
+    CPPUNIT_ASSERT( d->defaultAdapters() == adapters );
+}
+
+void PelicanBinaryProtocolTest::test_negotiation()
+{
+    {
+        // Use Case:
+        // Error messages are returned in the version 2 format.
+        PelicanBinaryProtocol proto;
+        QByteArray block;
+        QBuffer stream(&block);
+        stream.open(QIODevice::WriteOnly);
+        proto.sendError(stream, "error message");
+        PelicanBinaryClientProtocol client;
+        boost::shared_ptr<ServerResponse> resp = client.receive(_st->send(block));
+        CPPUNIT_ASSERT( resp->type() == ServerResponse::Error );
+        CPPUNIT_ASSERT( resp->message() == "error message" );
+        CPPUNIT_ASSERT( ! client.rejected() );
+    }
+    {
+        // Use Case:
+        // A version 1 response to a version 2 request
+        // Expect the client to report that version 2 was rejected.
+        PelicanProtocol proto;
+        QByteArray block;
+        QBuffer stream(&block);
+        stream.open(QIODevice::WriteOnly);
+        proto.send(stream, DataSupportResponse(QSet<QString>()));
+        PelicanBinaryClientProtocol client;
+        boost::shared_ptr<ServerResponse> resp = client.receive(_st->send(block));
+        CPPUNIT_ASSERT( resp->type() == ServerResponse::Error );
+        CPPUNIT_ASSERT( client.rejected() );
+    }
+    {
+        // Use Case:
+        // Version 1 requests are still accepted by PelicanProtocol.
+        PelicanProtocol proto;
+        PelicanClientProtocol client;
+        DataSupportRequest req;
+        boost::shared_ptr<ServerRequest> req2 =
+                proto.request(_st->send(client.serialise(req)));
+        CPPUNIT_ASSERT( req == *req2 );
+        CPPUNIT_ASSERT_EQUAL( 1, req2->version() );
+        CPPUNIT_ASSERT( proto.protocolFor(*req2) == &proto );
+    }
+}
+
+PelicanBinaryProtocolTest::Socket_t& PelicanBinaryProtocolTest::_send(ServerRequest* req)
+{
+    return _st->send( _protocol.serialise(*req) );
+}
+
+} // namespace pelican
@@ -38,8 +38,11 @@
 #include "ServiceDataResponse.h"
 #include "StreamData.h"
 
+#include "comms/BlobCompression.h"
+#include "comms/CompressionRequest.h"
 #include "comms/DataSupportRequest.h"
 #include "comms/DataSupportResponse.h"
+#include "data/ArrayData.h"
 #include "data/DataRequirements.h"
 #include "utility/test/SocketTester.h"
 #include "data/test/TestDataBlob.h"
@@ -209,6 +212,99 @@ void PelicanProtocolTest::test_sendDataBlob()
     }
 }
 
+void PelicanProtocolTest::test_sendCompressedDataBlob()
+{
+    try {
+        PelicanProtocol proto;
+        QString streamName("teststream");
+        BlobCompression::Statistics stats;
+        BlobCompression codec(1, 4, &stats);
+        {
+            // Use Case
+            // Compressible blob
+            // expect a blob response with the decompressed data
+            TestDataBlob blob;
+            blob.resize(65536);
+            for (int i = 0; i < blob.data().size(); ++i)
+                blob.data()[i] = (char)(i % 4 == 3 ? i / 256 : 0);
+            QByteArray block;
+            QBuffer stream(&block);
+            stream.open(QIODevice::WriteOnly);
+            proto.send(stream, streamName, blob, codec);
+            CPPUNIT_ASSERT( block.size() < blob.data().size() / 4 );
+            CPPUNIT_ASSERT_EQUAL( (quint64)1, stats.blobs );
+            CPPUNIT_ASSERT( stats.ratio() > 4.0 );
+
+            QTcpSocket& socket = _st->send(block);
+            boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+            CPPUNIT_ASSERT( resp->type() == ServerResponse::Blob );
+            DataBlobResponse* db = static_cast<DataBlobResponse*>(resp.get());
+            CPPUNIT_ASSERT( db->hasData() );
+            CPPUNIT_ASSERT_EQUAL( blob.serialisedBytes(), db->dataSize() );
+            TestDataBlob copy;
+            db->readBlob(copy, socket);
+            CPPUNIT_ASSERT( copy == blob );
+            CPPUNIT_ASSERT_EQUAL( (quint64)1,
+                    _protocol.compressionStatistics()->blobs );
+        }
+        {
+            // Use Case
+            // Blob that does not compress
+            // expect it to be sent uncompressed
+            TestDataBlob blob;
+            blob.setData("testdata");
+            QByteArray block;
+            QBuffer stream(&block);
+            stream.open(QIODevice::WriteOnly);
+            proto.send(stream, streamName, blob, codec);
+
+            QTcpSocket& socket = _st->send(block);
+            boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+            CPPUNIT_ASSERT( resp->type() == ServerResponse::Blob );
+            DataBlobResponse* db = static_cast<DataBlobResponse*>(resp.get());
+            CPPUNIT_ASSERT( ! db->hasData() );
+            TestDataBlob copy;
+            db->readBlob(copy, socket);
+            CPPUNIT_ASSERT( copy == blob );
+        }
+    } catch (const QString& e) {
+        CPPUNIT_FAIL("Caught exception: " + e.toStdString());
+    }
+}
+
+void PelicanProtocolTest::test_sendArrayDataBlob()
+{
+    try {
+        // Use Case
+        // Array data blob, serialised in native byte order, sent with
+        // version 1 of the protocol (which reports big endian data)
+        // expect the array to be read back unchanged
+        DoubleData blob;
+        blob.resize(1000);
+        for (unsigned i = 0; i < blob.size(); ++i)
+            blob.ptr()[i] = 0.25 * i - 100.0;
+        QByteArray block;
+        QBuffer stream(&block);
+        stream.open(QIODevice::WriteOnly);
+        PelicanProtocol proto;
+        proto.send(stream, "teststream", blob);
+
+        QTcpSocket& socket = _st->send(block);
+        boost::shared_ptr<ServerResponse> resp = _protocol.receive(socket);
+        CPPUNIT_ASSERT( resp->type() == ServerResponse::Blob );
+        DataBlobResponse* db = static_cast<DataBlobResponse*>(resp.get());
+        CPPUNIT_ASSERT( blob.type() == db->blobClass() );
+        CPPUNIT_ASSERT_EQUAL( blob.serialisedBytes(), db->dataSize() );
+        DoubleData copy;
+        db->readBlob(copy, socket);
+        CPPUNIT_ASSERT_EQUAL( blob.size(), copy.size() );
+        for (unsigned i = 0; i < blob.size(); ++i)
+            CPPUNIT_ASSERT_EQUAL( blob.ptr()[i], copy.ptr()[i] );
+    } catch (const QString& e) {
+        CPPUNIT_FAIL("Caught exception: " + e.toStdString());
+    }
+}
+
 void PelicanProtocolTest::test_sendStreamData()
 {
     {
@@ -322,6 +418,18 @@ void PelicanProtocolTest::test_request()
         Socket_t& socket = _send(&req);
         CPPUNIT_ASSERT( req == *(proto.request(socket)) );
     }
+    {
+        // Use Case:
+        // A Compression Request for 2 streams
+        PelicanProtocol proto;
+        CompressionRequest req;
+        req.setCompression("streamA", 1, 4);
+        req.setCompression("streamB", 0);
+        Socket_t& socket = _send(&req);
+        boost::shared_ptr<ServerRequest> req2 = proto.request(socket);
+        CPPUNIT_ASSERT( req2->type() == ServerRequest::Compression );
+        CPPUNIT_ASSERT( req == *req2 );
+    }
     {
         // Use Case:
         // An empty StreamData Request
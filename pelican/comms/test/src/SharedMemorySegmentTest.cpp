@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "SharedMemorySegmentTest.h"
+#include "comms/SharedMemorySegment.h"
+
+#include <cstring>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SharedMemorySegmentTest );
+
+SharedMemorySegmentTest::SharedMemorySegmentTest()
+    : CppUnit::TestFixture()
+{
+}
+
+SharedMemorySegmentTest::~SharedMemorySegmentTest()
+{
+}
+
+void SharedMemorySegmentTest::test_attach()
+{
+    // Use Case:
+    // Create a segment, write to it and attach to it by name.
+    // Expect the data written to be visible through the second mapping.
+    QString name = SharedMemorySegment::uniqueName("test/stream");
+    CPPUNIT_ASSERT( name.startsWith("/pelican-") );
+    CPPUNIT_ASSERT( name.endsWith("teststream") );
+    CPPUNIT_ASSERT( name != SharedMemorySegment::uniqueName("test/stream") );
+
+    SharedMemorySegment owner(name, 4096);
+    CPPUNIT_ASSERT_EQUAL( (size_t)4096, owner.size() );
+    CPPUNIT_ASSERT_EQUAL( (char)0, owner.data()[100] );
+    strcpy(owner.data() + 100, "shared");
+
+    SharedMemorySegment reader(name);
+    CPPUNIT_ASSERT( reader.name() == name );
+    CPPUNIT_ASSERT_EQUAL( (size_t)4096, reader.size() );
+    CPPUNIT_ASSERT( strcmp(reader.data() + 100, "shared") == 0 );
+
+    CPPUNIT_ASSERT( owner.contains(owner.data() + 100, 3996) );
+    CPPUNIT_ASSERT( ! owner.contains(owner.data() + 100, 3997) );
+    CPPUNIT_ASSERT( ! owner.contains(reader.data()) );
+    CPPUNIT_ASSERT_EQUAL( (quint64)100, owner.offset(owner.data() + 100) );
+
+    // A second segment of the same name cannot be created.
+    CPPUNIT_ASSERT_THROW( SharedMemorySegment(name, 10), QString );
+}
+
+void SharedMemorySegmentTest::test_lifetime()
+{
+    // Use Case:
+    // Destroy the creator of a segment.
+    // Expect existing mappings to remain valid, but the name to be removed.
+    QString name = SharedMemorySegment::uniqueName("lifetime");
+    SharedMemorySegment* owner = new SharedMemorySegment(name, 64);
+    owner->data()[0] = 'x';
+    SharedMemorySegment reader(name);
+    delete owner;
+    CPPUNIT_ASSERT_EQUAL( 'x', reader.data()[0] );
+    CPPUNIT_ASSERT_THROW( SharedMemorySegment s(name), QString );
+}
+
+} // namespace pelican
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "UnixSocketTest.h"
+#include "comms/UnixSocket.h"
+#include "comms/UnixSocketServer.h"
+
+#include <QtCore/QDir>
+#include <QtNetwork/QTcpSocket>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( UnixSocketTest );
+
+namespace {
+// Records the descriptor of the last accepted connection.
+class TestSocketServer : public UnixSocketServer
+{
+    public:
+        TestSocketServer() : UnixSocketServer(), descriptor(-1) {}
+        int descriptor;
+    protected:
+        void incomingConnection(quintptr socketDescriptor)
+        { descriptor = (int)socketDescriptor; }
+};
+} // namespace
+
+UnixSocketTest::UnixSocketTest()
+    : CppUnit::TestFixture()
+{
+}
+
+UnixSocketTest::~UnixSocketTest()
+{
+}
+
+void UnixSocketTest::test_connect()
+{
+    // Use Case:
+    // Connect a QTcpSocket to a UnixSocketServer by path.
+    // Expect the accepted descriptor to be usable as a QTcpSocket and
+    // data to be exchanged in both directions.
+    QString path = QDir::tempPath() + "/pelicanUnixSocketTest";
+    TestSocketServer server;
+    CPPUNIT_ASSERT( server.listen(path) );
+    CPPUNIT_ASSERT_EQUAL( path.toStdString(),
+            server.fullServerName().toStdString() );
+
+    QTcpSocket client;
+    CPPUNIT_ASSERT( UnixSocket::connectToPath(client, path) );
+    CPPUNIT_ASSERT( server.waitForNewConnection(1000) );
+    CPPUNIT_ASSERT( server.descriptor >= 0 );
+
+    QTcpSocket peer;
+    CPPUNIT_ASSERT( peer.setSocketDescriptor(server.descriptor) );
+    client.write("ping", 4);
+    CPPUNIT_ASSERT( client.waitForBytesWritten(1000) );
+    CPPUNIT_ASSERT( peer.bytesAvailable() || peer.waitForReadyRead(1000) );
+    CPPUNIT_ASSERT( peer.readAll() == QByteArray("ping") );
+
+    peer.write("pong", 4);
+    CPPUNIT_ASSERT( peer.waitForBytesWritten(1000) );
+    CPPUNIT_ASSERT( client.bytesAvailable() || client.waitForReadyRead(1000) );
+    CPPUNIT_ASSERT( client.readAll() == QByteArray("pong") );
+
+    // Use Case:
+    // Connect to a path with no server.
+    // Expect failure.
+    server.close();
+    QTcpSocket orphan;
+    CPPUNIT_ASSERT( ! UnixSocket::connectToPath(orphan, path) );
+}
+
+void UnixSocketTest::test_descriptor()
+{
+    // Use Case:
+    // Pass one end of a pipe over a Unix domain socket pair.
+    // Expect the received descriptor to refer to the same pipe.
+    int sockets[2];
+    CPPUNIT_ASSERT_EQUAL( 0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) );
+    int pipes[2];
+    CPPUNIT_ASSERT_EQUAL( 0, ::pipe(pipes) );
+
+    CPPUNIT_ASSERT( UnixSocket::sendDescriptor(sockets[0], pipes[1], 'x') );
+    char tag = 0;
+    int fd = UnixSocket::receiveDescriptor(sockets[1], &tag);
+    CPPUNIT_ASSERT( fd >= 0 );
+    CPPUNIT_ASSERT( fd != pipes[1] );
+    CPPUNIT_ASSERT_EQUAL( 'x', tag );
+
+    CPPUNIT_ASSERT_EQUAL( (ssize_t)3, ::write(fd, "abc", 3) );
+    char buf[4] = { 0, 0, 0, 0 };
+    CPPUNIT_ASSERT_EQUAL( (ssize_t)3, ::read(pipes[0], buf, 3) );
+    CPPUNIT_ASSERT_EQUAL( std::string("abc"), std::string(buf) );
+
+    ::close(fd);
+    ::close(pipes[0]);
+    ::close(pipes[1]);
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+}
+
+} // namespace pelican
@@ -53,6 +53,7 @@ namespace pelican {
 
 class AbstractAdapter;
 class DataBlob;
+class TimingRecorder;
 class StreamData;
 class DataChunk;
 
@@ -117,6 +118,18 @@ class AbstractDataClient
         /// Returns the list of data requirements for each pipeline.
         const QList<DataSpec>& dataRequirements() { return _dataRequirements; }
 
+        /// Sets the recorder used to time adapter calls (null to disable).
+        void setTimingRecorder(TimingRecorder* recorder)
+        { _timingRecorder = recorder; }
+
+        /// Sets the time, in milliseconds, that getData() may wait for data
+        /// before returning an empty hash (-1 = wait indefinitely). Clients
+        /// that never wait for data may ignore it.
+        void setDataTimeout(int msec) { _dataTimeout = msec; }
+
+        /// Returns the time limit for getData() to wait for data.
+        int dataTimeout() const { return _dataTimeout; }
+
 
     protected:
         /// Writes a message to the log.
@@ -148,6 +161,8 @@ class AbstractDataClient
         ConfigNode _configNode; ///< The configuration node for the data client.
         const Config* _config;
         QSet<QString> _requireSet;
+        TimingRecorder* _timingRecorder; ///< Optional timing instrumentation.
+        int _dataTimeout; ///< Time limit for getData() to wait (ms, -1 = none).
 
     private:
         QList<DataSpec> _dataRequirements;
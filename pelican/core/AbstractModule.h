@@ -47,6 +47,7 @@ using std::vector;
 
 namespace pelican {
 class AbstractPipeline;
+class TimingRecorder;
 
 
 /**
@@ -71,6 +72,12 @@ class AbstractModule
         // reference to the pipeline the module is running in
         AbstractPipeline* _pipeline;
 
+        // tag used to identify the module in timing reports
+        QString _timingTag;
+
+        // identifier of the module in event traces
+        int _traceName;
+
     public:
         /// Creates a new abstract Pelican module with the given configuration.
         PELICAN_CONSTRUCT_TYPES(ConfigNode)
@@ -95,6 +102,16 @@ class AbstractModule
         void dataOutput( const DataBlob*, const QString& stream = "" ) const;
 
     protected:
+        /// Returns the timing recorder of the pipeline, or null if timing
+        /// is disabled.
+        TimingRecorder* timingRecorder() const;
+
+        /// Returns the tag identifying the module in timing reports.
+        const QString& timingTag() const { return _timingTag; }
+
+        /// Returns the name identifying the module in event traces.
+        int traceName() const { return _traceName; }
+
         /// Returns the index of the first occurrence of value in the data.
         template <typename T>
         unsigned findIndex(T value, vector<T> const& data) const;
@@ -52,6 +52,8 @@ class DataBlob;
 class PipelineDriver;
 class OutputStreamManager;
 class DataBlobBuffer;
+class TimingRecorder;
+class LatencyMonitor;
 
 /**
  * @ingroup c_core
@@ -121,6 +123,10 @@ class DataBlobBuffer;
  */
 class AbstractPipeline
 {
+    public:
+        /// A batch of data hashes from consecutive iterations.
+        typedef QList<QHash<QString, DataBlob*> > DataBatch;
+
     public:
         /// Constructs a new abstract pipeline.
         AbstractPipeline();
@@ -143,6 +149,12 @@ class AbstractPipeline
         void requestRemoteData(const QString& type,
                                unsigned int history = 1);
 
+        /// Enables batch mode, in which up to @p size consecutive iterations
+        /// are passed to runBatch() together. The batch is passed on early
+        /// if it is not filled within @p timeout milliseconds (0 = no limit).
+        /// This should be called from init().
+        void setBatchSize(unsigned int size, unsigned int timeout = 0);
+
         /// History size, returns the number of DataBlobs from the
         /// specified stream to keep in memory (for access by the history()
         /// method
@@ -170,6 +182,33 @@ class AbstractPipeline
         ///                     which may be modified by the pipeline.
         virtual void run(QHash<QString, DataBlob*>& data) = 0;
 
+        /// exec the pipeline over a batch of data hashes
+        //  the function called by the pipeline driver in batch mode
+        //  will do some internal housekeeping before calling
+        //  the virtual runBatch() method
+        void execBatch(DataBatch& batch);
+
+        /// Defines the processing of a batch of consecutive iterations.
+        /// This method is called by the pipeline driver in batch mode (see
+        /// setBatchSize()) with the data hashes of up to batchSize()
+        /// consecutive iterations, oldest first. Reimplement it to amortise
+        /// per-call overheads over several chunks; the default implementation
+        /// calls run() for each data hash in turn.
+        ///
+        /// The stream history is not updated before the call: a
+        /// reimplementation should call advanceHistory() for each entry, in
+        /// order, before it accesses the history of that entry.
+        ///
+        /// @param[in,out] batch The list of data hashes to process.
+        virtual void runBatch(DataBatch& batch);
+
+        /// Returns the maximum number of iterations in a batch (1 = no batching).
+        unsigned int batchSize() const { return _batchSize; }
+
+        /// Returns the time limit, in milliseconds, for filling a batch
+        /// (0 = no limit).
+        unsigned int batchTimeout() const { return _batchTimeout; }
+
         /// Sets the data blob factory.
         void setBlobFactory(FactoryGeneric<DataBlob>* factory);
 
@@ -182,6 +221,22 @@ class AbstractPipeline
         /// Sets the output stream manager
         void setOutputStreamManager(OutputStreamManager* osmanager);
 
+        /// Sets the timing recorder (null to disable timing).
+        void setTimingRecorder(TimingRecorder* recorder) { _timingRecorder = recorder; }
+
+        /// Returns the timing recorder, or null if timing is disabled.
+        TimingRecorder* timingRecorder() const { return _timingRecorder; }
+
+        /// Sets the latency monitor (null to disable latency monitoring).
+        void setLatencyMonitor(LatencyMonitor* monitor) { _latencyMonitor = monitor; }
+
+        /// Returns the latency monitor, or null if monitoring is disabled.
+        LatencyMonitor* latencyMonitor() const { return _latencyMonitor; }
+
+        /// Returns the ingest time of the oldest data in the current
+        /// iteration (ns since the epoch, 0 if unknown).
+        qint64 ingestTime() const { return _ingestTime; }
+
         /// disable this pipeline from being called by the pipeline Driver
         void deactivate();
 
@@ -217,6 +272,19 @@ class AbstractPipeline
         /// copy pipeline configuration details to the provided pipeline
         void copyConfig( AbstractPipeline* pipeline ) const;
 
+        /// Makes the data hash the newest entry of the stream history
+        /// (for runBatch(), once per entry of the batch).
+        void advanceHistory(QHash<QString, DataBlob*>& data)
+        { _updateHistory(data); }
+
+    private:
+        /// update the stream history with the data hash
+        void _updateHistory(QHash<QString, DataBlob*>& data);
+
+        /// return the oldest ingest timestamp in the data hash
+        static qint64 _oldestTimestamp(const QHash<QString, DataBlob*>& data,
+                qint64 oldest = 0);
+
     private:
         /// The data required by the pipeline.
         DataRequirements _requiredDataRemote;
@@ -236,6 +304,15 @@ class AbstractPipeline
         /// Pointer to the output stream manager.
         OutputStreamManager* _osmanager;
 
+        /// Pointer to the timing recorder (null if disabled).
+        TimingRecorder* _timingRecorder;
+
+        /// Pointer to the latency monitor (null if disabled).
+        LatencyMonitor* _latencyMonitor;
+
+        /// Ingest time of the oldest data in the current iteration.
+        qint64 _ingestTime;
+
         /// Buffer Sizes required for each stream
         QHash<QString,unsigned int> _history;
 
@@ -243,6 +320,10 @@ class AbstractPipeline
         //  in reverse order (latest at the front)
         QHash<QString, QList<DataBlob*>* > _streamHistory;
 
+        /// Batch mode settings.
+        unsigned int _batchSize;
+        unsigned int _batchTimeout;
+
 
     private:
         /// \todo fix me (horrible use of friend class)!
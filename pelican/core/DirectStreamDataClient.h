@@ -57,6 +57,18 @@ class Config;
  *
  * Add the chunkers using the addChunker() method in a derived class
  * constructor.
+ *
+ * When no data is available, getData() blocks until a chunker activates a
+ * new chunk in one of the stream buffers rather than polling. As a safety
+ * net against missed service data updates, the wait is bounded by a
+ * timeout (in milliseconds) which can be set in the configuration:
+ *
+ * @verbatim
+ *      <wait timeout="100"/>
+ * @endverbatim
+ *
+ * If a data timeout is set (see setDataTimeout()), getData() returns an
+ * empty hash once it has waited that long without data.
  */
 class DirectStreamDataClient : public AbstractAdaptingDataClient
 {
@@ -92,6 +104,7 @@ class DirectStreamDataClient : public AbstractAdaptingDataClient
     private:
         bool _started;
         int _nPipelines;
+        unsigned long _waitTimeout;
         ChunkerManager* _chunkerManager;
         DataManager* _dataManager;
 };
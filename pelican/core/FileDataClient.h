@@ -37,7 +37,10 @@
 #include "data/DataSpec.h"
 #include <QtCore/QHash>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
+class QBuffer;
 class QFile;
+class QIODevice;
 
 namespace pelican {
 
@@ -51,12 +54,31 @@ class DataTypes;
  * @class FileDataClient
  *
  * @brief
- * Data client used by the pipeline for accessing data directly from files
+ * A data client that reads data from files on disk,
  * rather than using the data server.
  *
  * @details
- * This data client fetches data directly from one or more data files and
+ * The FileDataClient reads data from files for each data type and
  * makes it available to the pipelines via the pipeline driver.
+ *
+ * Each call to getData() passes the whole of the next file for each data
+ * type to its adapter. The file attribute holds a file name or wildcard
+ * pattern; repeating the data tag for a type adds further files. The files
+ * are iterated over in sequence (restarting at the first file after the
+ * last).
+ *
+ * While a file is being adapted, the operating system is advised to start
+ * reading the next file in the sequence in the background. Setting
+ * @p mmap="true" memory maps each file so the adapter reads it directly
+ * from the page cache rather than through buffered reads (files of 2 GiB
+ * or more are always read through the file).
+ *
+ * @verbatim
+ *      <FileDataClient>
+ *          <data type="VisibilityData" adapter="AdapterVisibilities"
+ *              file="/archive/visibilities_*.dat" mmap="true"/>
+ *      </FileDataClient>
+ * @endverbatim
  */
 
 class FileDataClient : public AbstractAdaptingDataClient
@@ -74,15 +96,26 @@ class FileDataClient : public AbstractAdaptingDataClient
         virtual DataBlobHash getData(DataBlobHash&);
         virtual const DataSpec& dataSpec() const;
 
+        /// Returns the list of files read for the specified data type.
+        QStringList fileNames(const QString& type) const
+        { return _fileNames.value(type); }
+
     private:
         /// Reads the configuration options.
         void _getConfig();
+        QIODevice* _device(const QString& type);
         bool _openFile(const QString& type);
+        void _closeFile(const QString& type);
+        void _readAhead(const QString& filename);
+        static QStringList _expandFileNames(const QString& file);
 
     private:
         // Hash of filenames for each data type.
-        QHash<QString, QString> _fileNames;
+        QHash<QString, QStringList> _fileNames;
+        QHash<QString, int> _fileIndex;
         QHash<QString, QFile*> _openFiles;
+        QHash<QString, QBuffer*> _mappedFiles;
+        QHash<QString, bool> _mmap;
         DataSpec _dataSpec;
 };
 
@@ -36,6 +36,7 @@
 #include "AbstractAdaptingDataClient.h"
 #include <boost/shared_ptr.hpp>
 #include "data/DataSpec.h"
+#include <QtCore/QHash>
 
 using boost::shared_ptr;
 class QTcpSocket;
@@ -48,6 +49,7 @@ class ServerRequest;
 class ServerResponse;
 class StreamData;
 class ServiceDataRequest;
+class SharedMemorySegment;
 
 /**
  * @ingroup c_core
@@ -58,6 +60,39 @@ class ServiceDataRequest;
  * Implements the data client interface for attaching to a Pelican Server.
  *
  * @details
+ * Version 2 (binary) of the Pelican protocol is used by default. If the
+ * server rejects it, the client falls back to version 1 for the rest of
+ * its lifetime. The version can be fixed in the configuration:
+ *
+ * @verbatim
+ * <server host="127.0.0.1" port="2000"/>
+ * <protocol version="1"/>
+ * @endverbatim
+ *
+ * A server on the same host may also be reached through a Unix domain
+ * socket (see PelicanServer::addProtocol()), given by a path attribute on
+ * the server tag in place of the host and port:
+ *
+ * @verbatim
+ * <server path="/tmp/pelican.sock"/>
+ * @endverbatim
+ *
+ * A client on the same host as the server can read stream data in place
+ * from the server's buffers, for streams whose buffers are configured with
+ * sharedMemory="true" on the server, by enabling shared memory:
+ *
+ * @verbatim
+ * <sharedMemory enabled="true"/>
+ * @endverbatim
+ *
+ * The server then sends only the location of each chunk, which stays
+ * locked until the client has adapted it. Other streams, and servers that
+ * do not support it, are served over the connection as usual.
+ *
+ * If a data timeout is set (see setDataTimeout()), getData() returns an
+ * empty hash once it has waited that long for the server. The request
+ * stays outstanding, and the next call to getData() carries on waiting for
+ * its response.
  */
 
 class PelicanServerClient : public AbstractAdaptingDataClient
@@ -81,6 +116,10 @@ class PelicanServerClient : public AbstractAdaptingDataClient
         /// Sets the IP address used of the Pelican server being connected to.
         void setIP_Address (const QString& ipaddress);
 
+        /// Sets the path of a Unix domain socket to connect to the server
+        /// with, in place of the address and port (empty to use TCP).
+        void setSocketPath (const QString& path);
+
     protected: /// \todo why protected not private?
         /// Send a request to a PelicanServer for required data.
         DataBlobHash _sendRequest(const ServerRequest& request,
@@ -93,6 +132,11 @@ class PelicanServerClient : public AbstractAdaptingDataClient
         DataBlobHash _response(QIODevice&, shared_ptr<ServerResponse> r,
                 DataBlobHash&);
 
+        /// Sends a request for stream data, or carries on waiting for the
+        /// response to the outstanding request.
+        DataBlobHash _requestStreamData(const ServerRequest& request,
+                DataBlobHash& dataHash);
+
         /// Sends a request for service data.
         DataBlobHash _getServiceData(const ServiceDataRequest& requirements,
                 DataBlobHash& dataHash);
@@ -102,11 +146,36 @@ class PelicanServerClient : public AbstractAdaptingDataClient
                 DataBlobHash& dataHash);
 
     private:
-        AbstractClientProtocol* _protocol;
+        /// writes a request and reads the response on a connected socket
+        boost::shared_ptr<ServerResponse> _exchange( QTcpSocket& sock, const ServerRequest& request ) const;
+
+        /// writes a request to a connected socket
+        void _write( QTcpSocket& sock, const ServerRequest& request ) const;
+
+        /// reads the response to a request, falling back to version 1 of
+        /// the protocol if the server rejects version 2
+        boost::shared_ptr<ServerResponse> _receive( QTcpSocket& sock, const ServerRequest& request ) const;
+
+        /// connects the socket to the server
+        void _connect( QTcpSocket& sock ) const;
+
+        /// returns the address of shared memory stream data
+        const char* _sharedData(const QString& segment, quint64 offset,
+                quint64 size);
+
+        /// tells the server that shared memory data is no longer needed
+        void _release(QIODevice& device) const;
+
+    private:
+        mutable AbstractClientProtocol* _protocol;
         QString _server;
         unsigned _port;
+        QString _path;
         mutable bool _specRecieved;
         mutable DataSpec _dataSpec;
+        bool _sharedMemory;
+        QHash<QString, SharedMemorySegment*> _segments;
+        QTcpSocket* _pending; // Connection with an outstanding stream request.
 
     private:
         /// Unit testing class.
@@ -42,6 +42,7 @@
 #include "utility/TypeCounter.h"
 #include "utility/FactoryGeneric.h"
 #include <QtCore/QList>
+#include <QtCore/QTime>
 #include <QtCore/QVector>
 
 namespace pelican {
@@ -54,6 +55,8 @@ class OutputStreamManager;
 class PipelineSwitcher;
 class DataBlobBuffer;
 class Config;
+class TimingRecorder;
+class LatencyMonitor;
 
 /**
  * @ingroup c_core
@@ -133,6 +136,21 @@ class PipelineDriver
         /// The adapter names required for each data type.
         QHash<QString, QString> _adapterNames;
 
+        /// Timing instrumentation (null if disabled).
+        TimingRecorder* _timing;
+
+        /// Latency monitor (null if disabled).
+        LatencyMonitor* _latency;
+
+        /// Data hashes accumulated for pipelines running in batch mode.
+        QHash<AbstractPipeline*, QList<QHash<QString, DataBlob*> > > _batches;
+
+        /// Time at which the first entry of each pending batch arrived.
+        QHash<AbstractPipeline*, QTime> _batchTimers;
+
+        /// True if the driver started event tracing.
+        bool _tracing;
+
     public:
         /// Constructs a new pipeline driver.
         PipelineDriver(FactoryGeneric<DataBlob>* blobFactory,
@@ -172,6 +190,12 @@ class PipelineDriver
         // return the named configuration node, relative to the base adress
         ConfigNode config( const QString& pipeline, const QString& name="") const;
 
+        /// Returns the timing recorder, or null if timing is disabled.
+        const TimingRecorder* timingRecorder() const { return _timing; }
+
+        /// Returns the latency monitor, or null if monitoring is disabled.
+        const LatencyMonitor* latencyMonitor() const { return _latency; }
+
     private:
         /// deactivate a registered pipeline
         void _deactivatePipeline(AbstractPipeline*);
@@ -194,6 +218,31 @@ class PipelineDriver
         /// check and update the pipeline requirements to match that
         //  provided by the data client
         void _checkPipelineRequirements( AbstractPipeline* p, AbstractDataClient*  );
+
+        /// apply the thread placement given in the configuration
+        void _setupPlacement();
+
+        /// create the timing recorder if enabled in the configuration
+        void _setupTiming();
+
+        /// create the latency monitor if enabled in the configuration
+        void _setupLatency();
+
+        /// start event tracing if enabled in the configuration
+        void _setupTracing();
+
+        /// execute the pipeline on the current data, batching if required
+        void _execPipeline(AbstractPipeline*);
+
+        /// execute and clear any pending batch for the pipeline
+        void _flushBatch(AbstractPipeline*);
+
+        /// execute the pending batches that have reached their time limit
+        void _flushExpiredBatches();
+
+        /// time until the next pending batch reaches its time limit (ms),
+        /// or -1 if there is none
+        int _batchWait() const;
 };
 
 } // namespace pelican
@@ -31,6 +31,8 @@
 #include "core/AbstractServiceAdapter.h"
 #include "comms/StreamData.h"
 #include "data/DataBlob.h"
+#include "utility/TimingRecorder.h"
+#include "utility/Tracer.h"
 
 
 namespace pelican {
@@ -83,10 +85,18 @@ void AbstractAdaptingDataClient::reset( const QList<DataSpec>& requirements  ) {
 AbstractDataClient::DataBlobHash AbstractAdaptingDataClient::adaptStream(
         QIODevice& device, const StreamData* sd, DataBlobHash& dataHash)
 {
+    static const QString timingTag("adapt");
+    static const int traceName = Tracer::intern("AbstractStreamAdapter::deserialise");
+    TimingRecorder::Scope timer(_timingRecorder, timingTag);
+    Tracer::Scope trace(traceName);
+    trace.flow(sd->timestamp());
+
     QHash<QString, DataBlob*> validData;
 
     const QString& type = sd->name();
     dataHash[type]->setVersion(sd->id());
+    dataHash[type]->setTimestamp(sd->timestamp());
+    dataHash[type]->setLostPackets(sd->lostPackets());
     AbstractStreamAdapter* adapter = streamAdapter(type);
     Q_ASSERT( adapter != 0 );
     adapter->config( dataHash[type], sd->size(), dataHash );
@@ -109,6 +119,11 @@ AbstractDataClient::DataBlobHash AbstractAdaptingDataClient::adaptStream(
 AbstractDataClient::DataBlobHash AbstractAdaptingDataClient::adaptService(
         QIODevice& device, const DataChunk* d, DataBlobHash& dataHash)
 {
+    static const QString timingTag("adapt");
+    static const int traceName = Tracer::intern("AbstractServiceAdapter::deserialise");
+    TimingRecorder::Scope timer(_timingRecorder, timingTag);
+    Tracer::Scope trace(traceName);
+
     QHash<QString, DataBlob*> validData;
     QString type = d->name();
     AbstractServiceAdapter* adapter = serviceAdapter(type);
@@ -54,7 +54,8 @@ namespace pelican {
  */
 AbstractDataClient::AbstractDataClient(const ConfigNode& configNode,
         const DataTypes& types, const Config* config )
-: _configNode(configNode),  _config(config)
+: _configNode(configNode),  _config(config), _timingRecorder(0),
+  _dataTimeout(-1)
 {
     _dataRequirements = types.dataSpec();
 
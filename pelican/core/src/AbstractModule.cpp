@@ -28,6 +28,7 @@
 
 #include "AbstractModule.h"
 #include "core/AbstractPipeline.h"
+#include "utility/Tracer.h"
 
 
 namespace pelican {
@@ -37,8 +38,12 @@ namespace pelican {
  *@details AbstractModule
  */
 AbstractModule::AbstractModule( const ConfigNode& config )
-    : _config(config)
+    : _config(config), _pipeline(0)
 {
+    _timingTag = "module:" + config.type();
+    if (!config.name().isEmpty())
+        _timingTag += "[" + config.name() + "]";
+    _traceName = Tracer::intern(_timingTag);
 }
 
 /**
@@ -52,6 +57,22 @@ DataBlob* AbstractModule::createBlob(const QString& type) const {
     return _pipeline->createBlob(type);
 }
 
+/**
+ * @details
+ * Returns the timing recorder of the pipeline the module is running in, or
+ * null if timing is disabled. Modules can time (and trace) each invocation
+ * with:
+ *
+ * @code
+ * TimingRecorder::Scope timer(timingRecorder(), timingTag());
+ * Tracer::Scope trace(traceName());
+ * @endcode
+ */
+TimingRecorder* AbstractModule::timingRecorder() const
+{
+    return _pipeline ? _pipeline->timingRecorder() : 0;
+}
+
 void AbstractModule::dataOutput( const DataBlob* d,
                                  const QString& stream ) const
 {
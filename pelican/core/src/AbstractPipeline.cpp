@@ -33,6 +33,8 @@
 #include "core/PipelineDriver.h"
 #include "data/DataBlobBuffer.h"
 #include "output/OutputStreamManager.h"
+#include "utility/TimingRecorder.h"
+#include "utility/LatencyMonitor.h"
 
 namespace pelican {
 
@@ -41,7 +43,9 @@ namespace pelican {
  * AbstractPipeline constructor.
  */
 AbstractPipeline::AbstractPipeline()
-: _blobFactory(0), _moduleFactory(0), _pipelineDriver(0), _osmanager(0)
+: _blobFactory(0), _moduleFactory(0), _pipelineDriver(0), _osmanager(0),
+  _timingRecorder(0), _latencyMonitor(0), _ingestTime(0), _batchSize(1),
+  _batchTimeout(0)
 {
 }
 
@@ -122,9 +126,65 @@ void AbstractPipeline::copyConfig( AbstractPipeline* pipeline ) const
     pipeline->setModuleFactory(_moduleFactory);
     pipeline->setPipelineDriver(_pipelineDriver);
     pipeline->setOutputStreamManager(_osmanager);
+    pipeline->setTimingRecorder(_timingRecorder);
+    pipeline->setLatencyMonitor(_latencyMonitor);
 }
 
 void AbstractPipeline::exec( QHash<QString,DataBlob*>& data )
+{
+      _updateHistory(data);
+      _ingestTime = _oldestTimestamp(data);
+      run(data);
+}
+
+/**
+ * @details
+ * Executes the pipeline over a batch of data hashes from consecutive
+ * iterations (oldest first) by calling runBatch(). The stream history is
+ * advanced entry by entry by runBatch(), so that each entry sees the
+ * history as it was at its own iteration.
+ */
+void AbstractPipeline::execBatch(DataBatch& batch)
+{
+      _ingestTime = 0;
+      for (int i = 0; i < batch.size(); ++i)
+          _ingestTime = _oldestTimestamp(batch[i], _ingestTime);
+      runBatch(batch);
+}
+
+/**
+ * @details
+ * Default batch processing: advances the stream history and calls run() for
+ * each data hash in the batch.
+ */
+void AbstractPipeline::runBatch(DataBatch& batch)
+{
+      for (int i = 0; i < batch.size(); ++i) {
+          advanceHistory(batch[i]);
+          run(batch[i]);
+      }
+}
+
+/**
+ * @details
+ * Enables batch mode. The pipeline driver accumulates the data hashes of up
+ * to @p size consecutive iterations before calling runBatch(). If @p timeout
+ * is non-zero, a partially filled batch is passed on once it has been
+ * accumulating for @p timeout milliseconds, even if no more data arrives
+ * (with data clients that support a data timeout, see
+ * AbstractDataClient::setDataTimeout()).
+ *
+ * The data blob history of each requested stream is extended by @p size - 1
+ * so that each entry of a batch refers to a different blob, and the history
+ * of each entry is still available while the batch is processed.
+ */
+void AbstractPipeline::setBatchSize(unsigned int size, unsigned int timeout)
+{
+      _batchSize = size > 0 ? size : 1;
+      _batchTimeout = timeout;
+}
+
+void AbstractPipeline::_updateHistory( QHash<QString,DataBlob*>& data )
 {
       // update the history information
       // ensure latest is at the front of the list
@@ -140,7 +200,22 @@ void AbstractPipeline::exec( QHash<QString,DataBlob*>& data )
               h.push_front(blob);
           }
       }
-      run(data);
+}
+
+/**
+ * @details
+ * Returns the earliest non-zero ingest timestamp of the blobs in @p data,
+ * or of @p oldest if that is earlier.
+ */
+qint64 AbstractPipeline::_oldestTimestamp(const QHash<QString,DataBlob*>& data,
+        qint64 oldest)
+{
+      foreach( const DataBlob* blob, data ) {
+          qint64 t = blob ? blob->timestamp() : 0;
+          if( t > 0 && ( oldest == 0 || t < oldest ) )
+              oldest = t;
+      }
+      return oldest;
 }
 
 /**
@@ -159,9 +234,11 @@ void AbstractPipeline::requestRemoteData(const QString& type,
 
 unsigned int AbstractPipeline::historySize(const QString& type) const {
     if( _requiredDataRemote.contains(type) ) {
+        // the history of each entry of a batch must still be held when the
+        // newest entry is received
         if( _history.contains(type) )
-            return _history[type];
-        return 1; // defaults to one (no history required)
+            return _history[type] + _batchSize - 1;
+        return _batchSize; // defaults to one (no history required)
     }
     return 0; // unknown stream
 }
@@ -217,12 +294,22 @@ void AbstractPipeline::deactivate()
  * @details
  * Sends data to the output streams managed by the OutputStreamManger
  *
+ * If latency monitoring is enabled, the age of the data is recorded against
+ * the stream name. The ingest time of the blob itself is used if it has one,
+ * otherwise that of the oldest input data of the current iteration.
+ *
  * @param[in] DataBlob to be sent.
  * @param[in] name of the output stream (defaults to DataBlob->type()).
  */
 void AbstractPipeline::dataOutput( const DataBlob* data, const QString& stream ) const
 {
-     _osmanager->send(data, stream);
+     static const QString timingTag("output");
+     TimingRecorder::Scope timer(_timingRecorder, timingTag);
+     qint64 ingestTime = data->timestamp() > 0 ? data->timestamp() : _ingestTime;
+     if( _latencyMonitor )
+         _latencyMonitor->record( stream.isEmpty() ? data->type() : stream,
+                                  ingestTime );
+     _osmanager->send(data, stream, ingestTime);
 }
 
 /**
@@ -40,6 +40,7 @@
 
 #include <QtCore/QBuffer>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QTime>
 
 #include <iostream>
 #include <string>
@@ -59,6 +60,7 @@ DirectStreamDataClient::DirectStreamDataClient(const ConfigNode& configNode,
 {
     // Initialise members.
     _started = false;
+    _waitTimeout = configNode.getOption("wait", "timeout", "100").toULong();
 
     // Create the managers.
     _dataManager = new DataManager(config, QString("pipeline"));
@@ -155,12 +157,15 @@ AbstractDataClient::DataBlobHash DirectStreamDataClient::getData(
         _started = true;
     }
 
-    // Keep polling the data manager until we can match a suitable request.
+    // Wait on the data manager until we can match a suitable request.
     DataBlobHash validData;
     QList<LockedData> dataList; // Will contain the list of valid StreamDataObjects
+    QTime waited;
+    waited.start();
     do {
-        //std::cout << "DirectStreamDataClient::getData() ASKING FOR DATA" << std::endl;
-        // Must cycle the event loop for unlocked signals to be processed.
+        // Note: The activation count must be read before querying the
+        // buffers so that a chunk activated during the query is not missed.
+        quint64 activations = _dataManager->activationCount();
         for (int i = 0; i < _nPipelines; ++i)
         {
             dataList = _dataManager->getDataRequirements(dataRequirements().at(i));
@@ -169,7 +174,17 @@ AbstractDataClient::DataBlobHash DirectStreamDataClient::getData(
         }
         if (dataList.size() == 0)
         {
-            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+            // Process any pending events (e.g. service data activation) and
+            // then sleep until the next stream chunk is activated.
+            QCoreApplication::processEvents();
+            unsigned long wait = _waitTimeout;
+            if (_dataTimeout >= 0) {
+                int remaining = _dataTimeout - waited.elapsed();
+                if (remaining <= 0)
+                    return validData; // Timed out: no data.
+                wait = qMin(wait, (unsigned long)remaining);
+            }
+            _dataManager->waitForData(activations, wait);
         }
     }
     while (dataList.size() == 0);
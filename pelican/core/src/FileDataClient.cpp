@@ -32,10 +32,19 @@
 #include "data/DataRequirements.h"
 #include "utility/ConfigNode.h"
 
+#include <QtCore/QBuffer>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRegExp>
 #include <QtCore/QSet>
 #include <QtCore/QtGlobal>
 
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace pelican {
 
 /**
@@ -56,8 +65,8 @@ FileDataClient::FileDataClient(const ConfigNode& configNode,
  */
 FileDataClient::~FileDataClient()
 {
-     foreach(QFile* file, _openFiles) {
-        delete file;
+     foreach(const QString& type, _openFiles.keys()) {
+        _closeFile(type);
      }
 }
 
@@ -79,23 +88,13 @@ AbstractDataClient::DataBlobHash FileDataClient::getData(DataBlobHash& dataHash)
         {
             if( ! dataHash.contains(type) )
                 throw( QString("FileDataClient: getData() called without DataBlob %1").arg(type) );
-            if( ! _openFiles.contains(type) || _openFiles[type]->atEnd() ) {
-                if( ! _openFile(type) ) continue;
-            }
-
-            /* -------
-            QString filename = _fileNames.value(type);
-            if (!filename.isEmpty()) {
-                QFile file(filename);
-                if (!file.open(QIODevice::ReadOnly))
-                    throw QString("FileDataClient::getData(): "
-                            "Cannot open file %1").arg(filename);
-             */
-            QFile* file = _openFiles[type];
+            QIODevice* device = _device(type);
+            if( ! device ) continue;
+
             AbstractServiceAdapter* adapter = serviceAdapter(type);
             Q_ASSERT( adapter != 0 );
-            adapter->config(dataHash[type], file->size());
-            adapter->deserialise(file);
+            adapter->config(dataHash[type], device->size());
+            adapter->deserialise(device);
             validHash.insert(type, dataHash.value(type));
         }
 
@@ -104,23 +103,14 @@ AbstractDataClient::DataBlobHash FileDataClient::getData(DataBlobHash& dataHash)
         {
             if( ! dataHash.contains(type) )
                 throw( QString("FileDataClient: getData() called without DataBlob %1").arg(type) );
-            if( ! _openFiles.contains(type) || _openFiles[type]->atEnd() ) {
-                if( ! _openFile(type) ) continue;
-            }
-            /* -------
-            QString filename = _fileNames.value(type);
-            if (!filename.isEmpty()) {
-                QFile file(filename);
-                if (!file.open(QIODevice::ReadOnly))
-                    throw QString("FileDataClient::getData(): "
-                            "Cannot open file %1").arg(filename);
-             */
-            QFile* file = _openFiles[type];
+            QIODevice* device = _device(type);
+            if( ! device ) continue;
+
             AbstractStreamAdapter* adapter = streamAdapter(type);
             Q_ASSERT( adapter != 0 );
             QHash<QString, DataBlob*> serviceHash;
-            adapter->config(dataHash[type], file->size(), serviceHash);
-            adapter->deserialise(file);
+            adapter->config(dataHash[type], device->size(), serviceHash);
+            adapter->deserialise(device);
             validHash.insert(type, dataHash.value(type));
         }
     }
@@ -128,40 +118,140 @@ AbstractDataClient::DataBlobHash FileDataClient::getData(DataBlobHash& dataHash)
     return validHash;
 }
 
+/**
+ * @details
+ * Returns the device to read the current file of the specified type from,
+ * opening the next file in the sequence if there is no open file or the
+ * current file has been read. Returns null if no file is configured.
+ */
+QIODevice* FileDataClient::_device(const QString& type)
+{
+    QIODevice* device = _mappedFiles.value(type, 0);
+    if( ! device ) device = _openFiles.value(type, 0);
+    if( ! device || device->atEnd() ) {
+        if( ! _openFile(type) ) return 0;
+        device = _mappedFiles.value(type, 0);
+        if( ! device ) device = _openFiles.value(type, 0);
+    }
+    return device;
+}
+
+/**
+ * @details
+ * Opens the next file in the sequence for the specified type, replacing any
+ * file currently open, and starts reading ahead the file after it.
+ */
 bool FileDataClient::_openFile( const QString& type )
 {
-    QString filename = _fileNames.value(type);
-    if (!filename.isEmpty()) {
-        QFile* file = new QFile(filename);
-        log(QString("Opening file %1").arg(filename));
-        if (!file->open(QIODevice::ReadOnly)) {
-            delete file;
-            throw QString("FileDataClient::getData(): "
-                    "Cannot open file %1").arg(filename);
+    const QStringList& files = _fileNames[type];
+    if (files.isEmpty())
+        return false;
+
+    int index = _fileIndex.value(type, 0);
+    QString filename = files[index];
+    _fileIndex[type] = (index + 1) % files.size();
+
+    _closeFile(type);
+    QFile* file = new QFile(filename);
+    log(QString("Opening file %1").arg(filename));
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        throw QString("FileDataClient::getData(): "
+                "Cannot open file %1").arg(filename);
+    }
+    _openFiles.insert(type, file);
+
+    // Map the file into memory if requested. Empty files cannot be mapped,
+    // and files of INT_MAX bytes or more do not fit in a QBuffer, in which
+    // case the file is read as normal.
+    if (_mmap.value(type) && file->size() > 0 && file->size() <= INT_MAX) {
+        uchar* memory = file->map(0, file->size());
+        if (memory) {
+            madvise(memory, file->size(), MADV_SEQUENTIAL);
+            QBuffer* buffer = new QBuffer;
+            buffer->setData(QByteArray::fromRawData((const char*)memory,
+                    (int)file->size()));
+            buffer->open(QIODevice::ReadOnly);
+            _mappedFiles.insert(type, buffer);
         }
-        if( _openFiles.contains(type) )
-            delete _openFiles[type];
-        _openFiles.insert(type, file);
-        return true;
     }
-    return false;
+
+    // Start reading the next file while this one is being processed.
+    if (files.size() > 1)
+        _readAhead(files[_fileIndex[type]]);
+
+    return true;
+}
+
+/**
+ * @details
+ * Closes the current file of the specified type, unmapping it if required.
+ */
+void FileDataClient::_closeFile(const QString& type)
+{
+    // Note: The buffer must be deleted before the memory it wraps is
+    // unmapped when the file is destroyed.
+    delete _mappedFiles.take(type);
+    delete _openFiles.take(type);
+}
+
+/**
+ * @details
+ * Advises the operating system that the named file will be read soon, so
+ * that it is read into the page cache asynchronously.
+ */
+void FileDataClient::_readAhead(const QString& filename)
+{
+    int fd = ::open(QFile::encodeName(filename).constData(), O_RDONLY);
+    if (fd < 0) return;
+#ifdef POSIX_FADV_WILLNEED
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+    ::close(fd);
 }
 
 const DataSpec& FileDataClient::dataSpec() const {
     return _dataSpec;
 }
 
+/**
+ * @details
+ * Expands a file name or wildcard pattern into a list of file names.
+ * Matches for a pattern are sorted by name.
+ */
+QStringList FileDataClient::_expandFileNames(const QString& file)
+{
+    if (!file.contains(QRegExp("[*?\\[]")))
+        return QStringList(file);
+
+    QFileInfo info(file);
+    QDir dir = info.dir();
+    QStringList matches = dir.entryList(QStringList(info.fileName()),
+            QDir::Files, QDir::Name);
+    if (matches.isEmpty())
+        throw QString("FileDataClient: No files match %1").arg(file);
+    QStringList names;
+    foreach (const QString& match, matches) {
+        names.append(dir.filePath(match));
+    }
+    return names;
+}
+
 /**
  * @details
  * Gets the configuration options from the XML configuration node.
  */
 void FileDataClient::_getConfig()
 {
-    // Get all the filenames for each data type.
-    _fileNames = configNode().getOptionHash("data", "type", "file");
+    // Get all the filenames for each data type. Repeated data tags for a
+    // type add to its list of files.
     foreach (ConfigNode const & node, configNode().getNodes("data")) {
         QString type=node.getAttribute("type");
         if( type == "" ) throw QString("type attribute must be specified for every data tag"); // shouldn't throw a string
+        if( node.hasAttribute("file") )
+            _fileNames[type] += _expandFileNames(node.getAttribute("file"));
+        if (node.getAttribute("mmap").toLower() == "true")
+            _mmap.insert(type, true);
         if(node.hasAttribute("service") && node.getAttribute("service") == "true") {
             _dataSpec.addServiceData(type);
         }
@@ -39,8 +39,13 @@
 #include "comms/StreamDataResponse.h"
 #include "comms/ServiceDataResponse.h"
 #include "comms/PelicanClientProtocol.h"
+#include "comms/PelicanBinaryClientProtocol.h"
 #include "comms/DataSupportRequest.h"
 #include "comms/DataSupportResponse.h"
+#include "comms/AcknowledgementRequest.h"
+#include "comms/SharedMemorySegment.h"
+#include "comms/UnixSocket.h"
+#include "utility/Tracer.h"
 
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QAbstractSocket>
@@ -49,6 +54,8 @@
 #include <QtCore/QByteArray>
 #include <QtCore/QDebug>
 
+#include <cerrno>
+#include <cstring>
 #include <vector>
 #include <iostream>
 using std::cout;
@@ -69,12 +76,19 @@ PelicanServerClient::PelicanServerClient(const ConfigNode& configNode,
         const DataTypes& types, const Config* config
         )
     : AbstractAdaptingDataClient(configNode, types, config)
-        , _protocol(0), _specRecieved(false)
+        , _protocol(0), _specRecieved(false), _sharedMemory(false),
+        _pending(0)
 {
-    _protocol = new PelicanClientProtocol;
+    if (configNode.getOption("protocol", "version", "2") == "1")
+        _protocol = new PelicanClientProtocol;
+    else
+        _protocol = new PelicanBinaryClientProtocol;
 
     setIP_Address(configNode.getOption("server", "host"));
     setPort(configNode.getOption("server", "port").toUInt());
+    setSocketPath(configNode.getOption("server", "path"));
+    _sharedMemory = configNode.getOption("sharedMemory", "enabled",
+            "false").toLower() == "true";
 }
 
 
@@ -83,7 +97,9 @@ PelicanServerClient::PelicanServerClient(const ConfigNode& configNode,
  */
 PelicanServerClient::~PelicanServerClient()
 {
+    delete _pending;
     delete _protocol;
+    qDeleteAll(_segments);
 }
 
 /**
@@ -102,11 +118,24 @@ void PelicanServerClient::setIP_Address(const QString& ipaddress)
     _server = ipaddress;
 }
 
+/**
+ * @details
+ * If a path is set, the client connects to the server through the Unix
+ * domain socket at that path instead of the host and port.
+ */
+void PelicanServerClient::setSocketPath(const QString& path)
+{
+    _path = path;
+}
+
 /**
  * @details
  */
 AbstractDataClient::DataBlobHash PelicanServerClient::getData(DataBlobHash& dataHash)
 {
+    static const int traceName = Tracer::intern("PelicanServerClient::getData");
+    Tracer::Scope trace(traceName);
+
     QSet<QString> reqs = _requireSet;
     if (!reqs.subtract(QSet<QString>::fromList(dataHash.keys())).isEmpty()) {
         throw(QString("PelicanServerClient::getData() data hash does not "
@@ -115,6 +144,7 @@ AbstractDataClient::DataBlobHash PelicanServerClient::getData(DataBlobHash& data
 
     // Construct the request
     StreamDataRequest sr;
+    sr.setSharedMemory(_sharedMemory);
     foreach(const DataSpec& d, dataRequirements())
     {
         sr.addDataOption(d);
@@ -126,7 +156,7 @@ AbstractDataClient::DataBlobHash PelicanServerClient::getData(DataBlobHash& data
     // response only returning after adapting valid data.
     // \todo why is this all done in a single _sendRequest call?!
     if(!sr.isEmpty())
-        validData.unite(_sendRequest(sr, dataHash));
+        validData.unite(_requestStreamData(sr, dataHash));
     else
         throw QString("PelicanServerClient::getData(): Request for non-stream data");
 
@@ -152,7 +182,94 @@ AbstractDataClient::DataBlobHash PelicanServerClient::_sendRequest(
     return validData;
 }
 
+/**
+ * @details
+ * Sends a stream data request on a new connection and adapts the response.
+ * If the data timeout expires before the server responds, an empty hash is
+ * returned and the connection is kept, so that the next call waits for the
+ * response to the same request rather than sending another.
+ */
+AbstractDataClient::DataBlobHash PelicanServerClient::_requestStreamData(
+        const ServerRequest& request, DataBlobHash& dataHash)
+{
+    if (!_pending) {
+        _pending = new QTcpSocket;
+        try {
+            _connect(*_pending);
+        }
+        catch (...) {
+            delete _pending;
+            _pending = 0;
+            throw;
+        }
+        _write(*_pending, request);
+    }
+
+    if (_pending->bytesAvailable() == 0) {
+        if (!_pending->waitForReadyRead(_dataTimeout)
+                && _pending->state() == QAbstractSocket::ConnectedState
+                && _dataTimeout >= 0)
+            return DataBlobHash();
+    }
+
+    // The request is no longer outstanding once its response is read.
+    QTcpSocket* sock = _pending;
+    _pending = 0;
+    try {
+        DataBlobHash validData = _response(*sock, _receive(*sock, request),
+                dataHash);
+        delete sock;
+        return validData;
+    }
+    catch (...) {
+        delete sock;
+        throw;
+    }
+}
+
+/**
+ * @details
+ * Connects the socket, sends the request and returns the response (see
+ * _receive()).
+ */
 boost::shared_ptr<ServerResponse> PelicanServerClient::_sendRequest( QTcpSocket& sock, const ServerRequest& request ) const {
+    _connect(sock);
+    return _exchange(sock, request);
+}
+
+/**
+ * @details
+ * Reads the response to the request written to the socket. If the server
+ * rejects version 2 of the protocol, the request is repeated on a new
+ * connection with version 1, which is then used for all further requests.
+ */
+boost::shared_ptr<ServerResponse> PelicanServerClient::_receive( QTcpSocket& sock, const ServerRequest& request ) const {
+    boost::shared_ptr<ServerResponse> r = _protocol->receive(sock);
+
+    PelicanBinaryClientProtocol* binary =
+            dynamic_cast<PelicanBinaryClientProtocol*>(_protocol);
+    if (binary && binary->rejected()) {
+        std::cerr << "PelicanServerClient: Server does not support protocol"
+                     " version 2, using version 1" << std::endl;
+        delete _protocol;
+        _protocol = new PelicanClientProtocol;
+        sock.abort();
+        _connect(sock);
+        r = _exchange(sock, request);
+    }
+    return r;
+}
+
+void PelicanServerClient::_connect( QTcpSocket& sock ) const {
+    if (!_path.isEmpty()) {
+        while (!UnixSocket::connectToPath(sock, _path)) {
+            if (errno != ECONNREFUSED && errno != ENOENT)
+                throw QString("PelicanServerClient: unable to connect to "
+                        "socket %1 : %2").arg(_path).arg(strerror(errno));
+            sleep(4); // wait before trying again
+        }
+        return;
+    }
     Q_ASSERT(_server != "");
     sock.connectToHost(_server, _port , QIODevice::ReadWrite);
     while(! sock.waitForConnected(-1))
@@ -167,16 +284,22 @@ boost::shared_ptr<ServerResponse> PelicanServerClient::_sendRequest( QTcpSocket&
         sleep(4); // wait before trying again
         sock.connectToHost(_server, _port , QIODevice::ReadWrite);
     }
+}
+
+boost::shared_ptr<ServerResponse> PelicanServerClient::_exchange( QTcpSocket& sock, const ServerRequest& request ) const {
+    _write(sock, request);
 
-    // Write the request to the open TCP socket with the PelicanClientProtocol.
+    // Receive the response from the server and process it.
+    sock.waitForReadyRead(-1); // Need to supply -1 so this doesn't time out.
+    return _receive(sock, request);
+}
+
+void PelicanServerClient::_write( QTcpSocket& sock, const ServerRequest& request ) const {
+    // Write the request to the open TCP socket with the client protocol.
     sock.write(_protocol->serialise(request));
     sock.flush();
     while (sock.bytesToWrite() > 0)
         sock.waitForBytesWritten(-1);
-
-    // Receive the response from the server and process it.
-    sock.waitForReadyRead(-1); // Need to supply -1 so this doesn't time out.
-    return _protocol->receive(sock);
 }
 
 /**
@@ -246,7 +369,21 @@ PelicanServerClient::_response(QIODevice& device, shared_ptr<ServerResponse> r,
             }
 
             // Retrieve the stream data.
-            if(req.isEmpty()) {
+            if (resp->isShared()) {
+                // The stream data is read in place from the server's shared
+                // memory buffer, which stays locked until released, so any
+                // service data can be fetched first without copying it.
+                const char* data = _sharedData(resp->sharedSegment(),
+                        resp->sharedOffset(), sd->size());
+                if (!req.isEmpty())
+                    validData.unite(_getServiceData(req, dataHash));
+                QByteArray array = QByteArray::fromRawData(data, sd->size());
+                QBuffer buf(&array);
+                buf.open(QIODevice::ReadOnly);
+                validData.unite(_adaptStream(buf, sd, dataHash));
+                _release(device);
+            }
+            else if(req.isEmpty()) {
                 // If there is no service data to fetch so we can adapt the
                 // stream data immediately.
                 validData.unite(_adaptStream(device, sd, dataHash));
@@ -322,11 +459,7 @@ PelicanServerClient::_response(QIODevice& device, shared_ptr<ServerResponse> r,
             validData[resp->dataName()] = dataHash[resp->dataName()];
 
             // Deserialise the data blob into the data hash.
-            while (device.bytesAvailable() < (qint64)resp->dataSize()) {
-                device.waitForReadyRead(-1);
-            }
-
-            validData[resp->dataName()]->deserialise(device, resp->byteOrder());
+            resp->readBlob(*validData[resp->dataName()], device);
 
             Q_ASSERT(resp->blobClass() == validData[resp->dataName()]->type());
             break;
@@ -353,6 +486,32 @@ AbstractDataClient::DataBlobHash PelicanServerClient::_adaptStream(
     return adaptStream(device, sd, dataHash);
 }
 
+/**
+ * @details
+ * Returns a pointer to @p size bytes at @p offset in the named shared
+ * memory segment, attaching to the segment the first time it is used.
+ */
+const char* PelicanServerClient::_sharedData(const QString& segment,
+        quint64 offset, quint64 size)
+{
+    SharedMemorySegment* s = _segments.value(segment);
+    if (!s) {
+        s = new SharedMemorySegment(segment);
+        _segments.insert(segment, s);
+    }
+    if (offset > s->size() || size > s->size() - offset)
+        throw QString("PelicanServerClient: Stream data outside shared"
+                " memory segment %1").arg(segment);
+    return s->data() + offset;
+}
+
+void PelicanServerClient::_release(QIODevice& device) const
+{
+    device.write(_protocol->serialise(AcknowledgementRequest()));
+    while (device.bytesToWrite() > 0)
+        device.waitForBytesWritten(-1);
+}
+
 const DataSpec& PelicanServerClient::dataSpec() const {
     if( ! _specRecieved ) {
         // send a request to the server for the types of data
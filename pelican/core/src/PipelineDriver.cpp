@@ -37,6 +37,10 @@
 #include "utility/Config.h"
 #include "utility/ConfigNode.h"
 #include "core/PipelineSwitcher.h"
+#include "utility/TimingRecorder.h"
+#include "utility/LatencyMonitor.h"
+#include "utility/ThreadPlacement.h"
+#include "utility/Tracer.h"
 
 #include <QtCore/QString>
 #include <QtCore/QtGlobal>
@@ -60,6 +64,9 @@ PipelineDriver::PipelineDriver(FactoryGeneric<DataBlob>* blobFactory,
     // Initialise member variables.
     _run = false;
     _dataClient = NULL;
+    _timing = NULL;
+    _latency = NULL;
+    _tracing = false;
 
     // Store pointers to factories.
     _blobFactory = blobFactory;
@@ -86,6 +93,22 @@ PipelineDriver::~PipelineDriver()
         delete buffer;
     }
     _dataBuffers.clear();
+
+    // Print a final timing summary.
+    if (_timing) {
+        _timing->report();
+        delete _timing;
+    }
+
+    // Print a final latency summary.
+    if (_latency) {
+        if (_osmanager) _osmanager->setLatencyMonitor(0);
+        _latency->report();
+        delete _latency;
+    }
+
+    // Write out any remaining trace events.
+    if (_tracing) Tracer::stop();
 }
 
 /**
@@ -129,9 +152,7 @@ void PipelineDriver::_registerPipeline(AbstractPipeline *pipeline)
 
 ConfigNode PipelineDriver::config( const QString& tag, const QString& name ) const {
     if (!_config) throw QString("PipelineDriver configuration not set");
-    Config::TreeAddress address(_base);
-    address << Config::NodeId(tag, name);
-    return _config->get(address);
+    return _config->get(_base, tag, name);
 }
 
 void PipelineDriver::_activatePipeline(AbstractPipeline *pipeline) {
@@ -161,9 +182,8 @@ void PipelineDriver::_activatePipelineBuffers(AbstractPipeline *pipeline)
             }
             unsigned int max=_history[type].max();
             if( max > (unsigned int)_dataBuffers[type]->size() ) { // scale up to required size
-                for(unsigned int i=_dataBuffers[type]->size(); i<max; ++i ) {
-                    _dataBuffers[type]->addDataBlob(_blobFactory->create(type));
-                }
+                _dataBuffers[type]->addDataBlobs(_blobFactory, type,
+                        max - _dataBuffers[type]->size());
             }
             else if( max < (unsigned int)_dataBuffers[type]->size() ) {
                 // shrink the history buffer
@@ -185,6 +205,9 @@ void PipelineDriver::deactivatePipeline(AbstractPipeline *pipeline)
 void PipelineDriver::_deactivatePipeline(AbstractPipeline *pipeline)
 {
     if( pipeline ) {
+        // run any data already accumulated for the pipeline
+        _flushBatch(pipeline);
+
         // put reqs in a temporary to work around broken QMultiHash headers
         // in Qt 4.2 which don't accept a const key
         //DataRequirements reqs = pipeline->dataRequirements();
@@ -280,17 +303,37 @@ void PipelineDriver::start()
     // prepare the dataclient
     _dataClient->reset( _dataSpecs.values() );
 
+    // set up the (optional) timing instrumentation and thread placement
+    _setupTracing();
+    _setupPlacement();
+    _setupTiming();
+    _setupLatency();
+    static const QString getDataTag("getData");
+    static const QString execTag("exec");
+    static const int getDataTrace = Tracer::intern("PipelineDriver::getData");
+    static const int execTrace = Tracer::intern("PipelineDriver::exec");
+
     // Enter main program loop.
     _run = true;
     QString lastError;
+    bool nextBlobs = true;
     while (_run) {
-        // Get the data from the client.
+        // Get the data from the client. The blobs are only advanced once
+        // the previous ones have been filled, so that a wait that timed out
+        // does not use up a slot in the history.
         QHash<QString, DataBlob*> validData;
-        foreach( const QString& type, _dataHash.keys() ) {
-            _dataHash[type]=_dataBuffers[type]->next();
+        if (nextBlobs) {
+            foreach( const QString& type, _dataHash.keys() ) {
+                _dataHash[type]=_dataBuffers[type]->next();
+            }
         }
+        nextBlobs = true;
+        int wait = _batchWait();
         try {
             if (_dataClient) {
+                TimingRecorder::Scope timer(_timing, getDataTag);
+                Tracer::Scope trace(getDataTrace);
+                _dataClient->setDataTimeout(wait);
                 validData = _dataClient->getData(_dataHash);
             }
         }
@@ -304,14 +347,29 @@ void PipelineDriver::start()
         }
         lastError = "";
 
+        // If the client timed out waiting for data, pass on the partially
+        // filled batches that have reached their time limit.
+        if (wait >= 0 && validData.isEmpty()) {
+            nextBlobs = false;
+            _flushExpiredBatches();
+            while( _deactivateQueue.size() > 0 ) {
+                 _deactivatePipeline(_deactivateQueue[0]);
+                 _deactivateQueue.pop_front();
+            }
+            continue;
+        }
+
         // Run all the pipelines compatible with this data hash.
         bool ranPipeline = false;
         foreach(AbstractPipeline* p, _activePipelines ) {
             if( _dataSpecs[p].isCompatible(validData) ) {
                 ranPipeline = true;
-                p->exec(_dataHash);
+                TimingRecorder::Scope timer(_timing, execTag);
+                Tracer::Scope trace(execTrace);
+                _execPipeline(p);
             }
         }
+        _flushExpiredBatches();
 
         // deactivate any pipelines
         while( _deactivateQueue.size() > 0 ) {
@@ -328,7 +386,96 @@ void PipelineDriver::start()
             throw QString("PipelineDriver::start(): received data incompatible with the pipelines:"
                                 + msg );
         }
+
+        if (_timing) _timing->tick();
+        if (_latency) _latency->tick();
+    }
+
+    // Run any partially filled batches.
+    foreach (AbstractPipeline* p, _batches.keys()) {
+        _flushBatch(p);
+    }
+}
+
+/**
+ * @details
+ * Executes the pipeline on the current data hash. For pipelines in batch
+ * mode the data hash is appended to the pipeline's pending batch, which is
+ * executed once it is full or has exceeded the pipeline's batch time limit.
+ *
+ * While a batch is pending the data client is asked to wait no longer than
+ * its time limit for data (see _batchWait()), so a partially filled batch
+ * is also passed on if the stream pauses.
+ */
+void PipelineDriver::_execPipeline(AbstractPipeline* pipeline)
+{
+    if (pipeline->batchSize() <= 1) {
+        pipeline->exec(_dataHash);
+        return;
+    }
+
+    QList<QHash<QString, DataBlob*> >& batch = _batches[pipeline];
+    if (batch.isEmpty())
+        _batchTimers[pipeline].start();
+    batch.append(_dataHash);
+
+    unsigned int timeout = pipeline->batchTimeout();
+    if ((unsigned int)batch.size() >= pipeline->batchSize() ||
+            (timeout && _batchTimers[pipeline].elapsed() >= (int)timeout)) {
+        _flushBatch(pipeline);
+    }
+}
+
+/**
+ * @details
+ * Executes and clears any pending batch of data hashes for the pipeline.
+ */
+void PipelineDriver::_flushBatch(AbstractPipeline* pipeline)
+{
+    if (!_batches.contains(pipeline))
+        return;
+
+    // Take the batch first so the pipeline may safely call back into
+    // the driver (e.g. to deactivate itself).
+    QList<QHash<QString, DataBlob*> > batch = _batches.take(pipeline);
+    _batchTimers.remove(pipeline);
+    if (!batch.isEmpty())
+        pipeline->execBatch(batch);
+}
+
+/**
+ * @details
+ * Executes the pending batches that have been accumulating for at least
+ * their pipeline's batch time limit.
+ */
+void PipelineDriver::_flushExpiredBatches()
+{
+    foreach (AbstractPipeline* p, _batches.keys()) {
+        unsigned int timeout = p->batchTimeout();
+        if (timeout && _batchTimers.value(p).elapsed() >= (int)timeout)
+            _flushBatch(p);
+    }
+}
+
+/**
+ * @details
+ * Returns the time in milliseconds until the first pending batch reaches
+ * its time limit (0 if one already has), or -1 if no pending batch has a
+ * time limit.
+ */
+int PipelineDriver::_batchWait() const
+{
+    int wait = -1;
+    QHash<AbstractPipeline*, QTime>::const_iterator i = _batchTimers.begin();
+    for (; i != _batchTimers.end(); ++i) {
+        int timeout = (int)i.key()->batchTimeout();
+        if (timeout == 0)
+            continue;
+        int remaining = qMax(timeout - i.value().elapsed(), 0);
+        if (wait < 0 || remaining < wait)
+            wait = remaining;
     }
+    return wait;
 }
 
 /**
@@ -400,4 +547,112 @@ void PipelineDriver::_checkPipelineRequirements( AbstractPipeline* p, AbstractDa
     _dataSpecs[p].addAdapterTypes( avail.getAdapterTypes() );
 }
 
+/**
+ * @details
+ * Applies the thread placement given in the pipeline configuration to the
+ * calling thread, which runs the driver loop (see ThreadPlacement):
+ *
+ * @verbatim
+ *      <pipelineConfig>
+ *          <thread cores="4" priority="20" numaNode="0"/>
+ *      </pipelineConfig>
+ * @endverbatim
+ */
+void PipelineDriver::_setupPlacement()
+{
+    if (!_config) return;
+    ThreadPlacement(_config->get(_base)).apply("PipelineDriver");
+}
+
+/**
+ * @details
+ * Creates the timing recorder if enabled in the pipeline configuration, and
+ * attaches it to the data clients and registered pipelines.
+ *
+ * When enabled, the getData(), exec() and output phases of each iteration
+ * (and adapter calls made by data clients) are timed, and a summary of
+ * percentiles is printed every @p reportInterval iterations (0 = only on
+ * destruction of the driver):
+ *
+ * @verbatim
+ *      <pipelineConfig>
+ *          <timing enabled="true" reportInterval="1000"/>
+ *      </pipelineConfig>
+ * @endverbatim
+ *
+ * When disabled the instrumentation reduces to a null pointer test.
+ */
+void PipelineDriver::_setupTiming()
+{
+    ConfigNode node = config("timing");
+    if (node.getAttribute("enabled").toLower() != "true")
+        return;
+
+    if (!_timing)
+        _timing = new TimingRecorder("PipelineDriver");
+    _timing->setReportInterval(node.getAttribute("reportInterval").toInt());
+
+    if (_dataClient) _dataClient->setTimingRecorder(_timing);
+    foreach (AbstractDataClient* client, _dataClients) {
+        if (client) client->setTimingRecorder(_timing);
+    }
+    foreach (AbstractPipeline* pipeline, _registeredPipelines) {
+        pipeline->setTimingRecorder(_timing);
+    }
+}
+
+/**
+ * @details
+ * Creates the latency monitor if it is enabled in the pipeline
+ * configuration. Each pipeline then records the age of the data passed to
+ * dataOutput() against the output stream name, and the output stream
+ * manager records the age once the data has been passed to the streamers
+ * (against "<stream>:sent"). The optional alarm attribute sets the latency
+ * budget in milliseconds; a warning is printed whenever a stream starts or
+ * stops exceeding it. A summary of latency percentiles is printed every
+ * reportInterval iterations (if non-zero) and on destruction of the driver:
+ *
+ * @verbatim
+ *      <pipelineConfig>
+ *          <latency enabled="true" alarm="50" reportInterval="1000"/>
+ *      </pipelineConfig>
+ * @endverbatim
+ */
+void PipelineDriver::_setupLatency()
+{
+    ConfigNode node = config("latency");
+    if (node.getAttribute("enabled").toLower() != "true")
+        return;
+
+    if (!_latency)
+        _latency = new LatencyMonitor("PipelineDriver");
+    _latency->setAlarmThreshold(
+            quint64(node.getAttribute("alarm").toDouble() * 1e6));
+    _latency->setReportInterval(node.getAttribute("reportInterval").toInt());
+
+    if (_osmanager) _osmanager->setLatencyMonitor(_latency);
+    foreach (AbstractPipeline* pipeline, _registeredPipelines) {
+        pipeline->setLatencyMonitor(_latency);
+    }
+}
+
+/**
+ * @details
+ * Starts event tracing if it is enabled in the pipeline configuration. The
+ * spans of the pipeline driver loop, data client, adapters, modules and
+ * output streamers are then written to the trace file (pipeline.trace.json
+ * by default) as a Chrome trace:
+ *
+ * @verbatim
+ *      <pipelineConfig>
+ *          <trace enabled="true" file="pipeline.trace.json"/>
+ *      </pipelineConfig>
+ * @endverbatim
+ */
+void PipelineDriver::_setupTracing()
+{
+    if (_tracing || !_config) return;
+    _tracing = Tracer::configure(_config->get(_base), "pipeline.trace.json");
+}
+
 } // namespace pelican
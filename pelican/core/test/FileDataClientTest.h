@@ -51,6 +51,7 @@ class FileDataClientTest : public CppUnit::TestFixture
         CPPUNIT_TEST_SUITE( FileDataClientTest );
         CPPUNIT_TEST( test_method );
         CPPUNIT_TEST( test_factory );
+        CPPUNIT_TEST( test_fileSequence );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -60,6 +61,7 @@ class FileDataClientTest : public CppUnit::TestFixture
         // Test Methods
         void test_method();
         void test_factory();
+        void test_fileSequence();
 
     public:
         /// FileDataClientTest constructor.
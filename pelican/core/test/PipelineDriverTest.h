@@ -44,6 +44,7 @@ class QCoreApplication;
 
 namespace pelican {
 
+class Config;
 class PipelineDriver;
 class DataClientFactory;
 class OutputStreamManager;
@@ -67,6 +68,7 @@ class PipelineDriverTest : public CppUnit::TestFixture
         CPPUNIT_TEST( test_checkPipelineRequirements);
         CPPUNIT_TEST( test_registerPipeline );
         CPPUNIT_TEST( test_registerSwitcher );
+        CPPUNIT_TEST( test_start_pipelineBatch );
 /*
         CPPUNIT_TEST( test_registerSwitcherData );
         CPPUNIT_TEST( test_registerPipeline_null );
@@ -99,6 +101,7 @@ class PipelineDriverTest : public CppUnit::TestFixture
         void test_start_multiPipelineRunDifferentData();
         void test_start_multiPipelineRunOne();
         void test_start_pipelineWithHistory();
+        void test_start_pipelineBatch();
 
     public:
         PipelineDriverTest(  );
@@ -106,6 +109,7 @@ class PipelineDriverTest : public CppUnit::TestFixture
 
     private:
         QCoreApplication *_coreApp;
+        Config* _config;
         PipelineDriver *_pipelineDriver;
         FactoryGeneric<DataBlob>* _dataBlobFactory;
         FactoryConfig<AbstractModule>* _moduleFactory;
@@ -59,6 +59,9 @@ class TestPipeline : public AbstractPipeline
         int _iterations;
         int _counter;
         int _matchedCounter;
+        int _batchCounter;
+        int _distinctBatchCounter;
+        int _historyCounter;
         bool _deactivateStop;
         FactoryGeneric<DataBlob>* _blobFactory;
 
@@ -82,6 +85,17 @@ class TestPipeline : public AbstractPipeline
         /// expected data.
         int matchedCounter() const {return _matchedCounter;}
 
+        /// Reads the number of batches run.
+        int batchCount() const {return _batchCounter;}
+
+        /// Reads the number of batches run in which every data hash held
+        /// different data blobs.
+        int distinctBatchCount() const {return _distinctBatchCounter;}
+
+        /// Reads the number of iterations run in which the newest entry of
+        /// the history of each stream was the data blob of the iteration.
+        int historyCount() const {return _historyCounter;}
+
         /// return the deactivation setting
         bool deactivation() const;
 
@@ -94,6 +108,9 @@ class TestPipeline : public AbstractPipeline
 
         /// Runs the pipeline.
         void run(QHash<QString, DataBlob*>& dataHash);
+
+        /// Runs the pipeline over a batch of iterations.
+        void runBatch(DataBatch& batch);
 };
 
 } // namespace test
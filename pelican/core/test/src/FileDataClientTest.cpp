@@ -35,9 +35,15 @@
 #include "data/DataBlob.h"
 #include "core/DataTypes.h"
 #include "core/test/TestStreamAdapter.h"
+#include "data/test/TestDataBlob.h"
+#include "utility/test/TestFile.h"
+
+#include <QtCore/QFile>
 
 namespace pelican {
 using test::TestStreamAdapter;
+using test::TestDataBlob;
+using test::TestFile;
 
 CPPUNIT_TEST_SUITE_REGISTRATION( FileDataClientTest );
 /**
@@ -152,4 +158,63 @@ void FileDataClientTest::test_method()
     }
 }
 
+void FileDataClientTest::test_fileSequence()
+{
+    // Use Case:
+    // Specify a list of files, memory mapped, for a stream, one of which
+    // has a space in its name
+    // Expect:
+    // Each call to getData() to adapt the next file in the list, returning
+    // to the first after the last.
+    TestFile file1, file2;
+    QString name2 = file2.filename() + " 2";
+    try {
+        QByteArray data1("first file"), data2("second file data");
+        {
+            QFile f1(file1.filename()), f2(name2);
+            CPPUNIT_ASSERT(f1.open(QIODevice::WriteOnly));
+            CPPUNIT_ASSERT(f2.open(QIODevice::WriteOnly));
+            f1.write(data1);
+            f2.write(data2);
+        }
+
+        QString stream1("stream1");
+        Config config;
+        config.setFromString(QString(
+                "<testconfig>"
+                "   <data type=\"%1\" file=\"%2\" mmap=\"true\"/>"
+                "   <data type=\"%1\" file=\"%3\"/>"
+                "</testconfig>").arg(stream1).arg(file1.filename())
+                .arg(name2));
+        Config::TreeAddress address;
+        address << Config::NodeId("testconfig", "");
+        ConfigNode configNode = config.get(address);
+
+        TestStreamAdapter streamAdapter;
+        DataSpec req;
+        req.addStreamData(stream1);
+        DataTypes types;
+        types.setAdapter(stream1, &streamAdapter);
+        types.addData(req);
+        FileDataClient client(configNode, types, &config);
+        CPPUNIT_ASSERT_EQUAL(2, client.fileNames(stream1).size());
+
+        TestDataBlob blob;
+        QHash<QString, DataBlob*> dataHash;
+        dataHash.insert(stream1, &blob);
+
+        CPPUNIT_ASSERT_EQUAL(1, client.getData(dataHash).size());
+        CPPUNIT_ASSERT(blob.data() == data1);
+        client.getData(dataHash);
+        CPPUNIT_ASSERT(blob.data() == data2);
+        client.getData(dataHash);
+        CPPUNIT_ASSERT(blob.data() == data1);
+    }
+    catch( QString& e ) {
+        QFile::remove(name2);
+        CPPUNIT_FAIL(e.toStdString());
+    }
+    QFile::remove(name2);
+}
+
 } // namespace pelican
@@ -83,7 +83,7 @@ void PipelineDriverTest::setUp()
 
     // Create the factories.
     _dataBlobFactory = new FactoryGeneric<DataBlob>(false);
-    Config config;
+    _config = new Config;
     Config::TreeAddress address;
 
     _moduleFactory = new FactoryConfig<AbstractModule>(0, "", "");
@@ -94,7 +94,7 @@ void PipelineDriverTest::setUp()
 
     // Create the pipeline driver.
     _pipelineDriver = new PipelineDriver( _dataBlobFactory, _moduleFactory,
-                                          _clientFactory, _osmanager, &config, address);
+                                          _clientFactory, _osmanager, _config, address);
     _client = NULL; // will be set if required
 }
 
@@ -113,6 +113,7 @@ void PipelineDriverTest::tearDown()
     delete _clientFactory;
     delete _osmanager;
     delete _client;
+    delete _config;
 }
 
 void PipelineDriverTest::test_checkPipelineRequirements()
@@ -545,6 +546,44 @@ void PipelineDriverTest::test_start_pipelineWithHistory()
     }
 }
 
+void PipelineDriverTest::test_start_pipelineBatch()
+{
+    try {
+        { // Use Case:
+          // One data stream with the pipeline in batch mode
+          // Expect:
+          // Pipeline run in batches of distinct data blobs
+            int num = 8;
+            unsigned batchSize = 4;
+            DataRequirements pipelineReq;
+            QString type1 = "FloatData";
+            pipelineReq.addRequired(type1);
+            TestPipeline *pipeline1 = new TestPipeline(pipelineReq, num);
+            pipeline1->setBatchSize(batchSize);
+            _pipelineDriver->registerPipeline(pipeline1);
+            CPPUNIT_ASSERT_EQUAL(batchSize, pipeline1->historySize(type1));
+
+            // Create the data client.
+            ConfigNode config;
+            DataSpec clientTypes;
+            clientTypes.addStreamData(type1);
+            TestDataClient client(config, clientTypes);
+            _pipelineDriver->_dataClient = &client;
+
+            // Start the pipeline driver.
+            _pipelineDriver->start();
+            CPPUNIT_ASSERT_EQUAL(num, pipeline1->count());
+            CPPUNIT_ASSERT_EQUAL(pipeline1->count(), pipeline1->matchedCounter());
+            CPPUNIT_ASSERT_EQUAL(2, pipeline1->batchCount());
+            CPPUNIT_ASSERT_EQUAL(2, pipeline1->distinctBatchCount());
+            CPPUNIT_ASSERT_EQUAL(num, pipeline1->historyCount());
+        }
+    }
+    catch(const QString& e) {
+        CPPUNIT_FAIL("Unexpected exception: " + e.toStdString());
+    }
+}
+
 void PipelineDriverTest::_setTestClient() {
     if ( ! _client  ) {
         ConfigNode config;
@@ -29,6 +29,8 @@
 #include "core/test/TestPipeline.h"
 #include "core/test/EmptyModule.h"
 
+#include <QtCore/QSet>
+
 #include <iostream>
 using std::cout;
 using std::cerr;
@@ -94,6 +96,9 @@ void TestPipeline::reset()
     }
     _counter = 0;
     _matchedCounter = 0;
+    _batchCounter = 0;
+    _distinctBatchCounter = 0;
+    _historyCounter = 0;
 }
 
 /**
@@ -123,6 +128,16 @@ void TestPipeline::run(QHash<QString, DataBlob*>& dataHash)
     if (_requiredDataRemote == dataHash.keys())
         ++_matchedCounter;
 
+    // Check the history is that of this iteration.
+    bool current = true;
+    foreach (const QString& type, dataHash.keys()) {
+        const QList<DataBlob*>& h = streamHistory(type);
+        if (h.isEmpty() || h.first() != dataHash[type])
+            current = false;
+    }
+    if (current)
+        ++_historyCounter;
+
     // Increment counter and test for completion.
     if (++_counter >= _iterations)
     {
@@ -135,6 +150,28 @@ void TestPipeline::run(QHash<QString, DataBlob*>& dataHash)
     }
 }
 
+/**
+ * @details
+ * Pipeline batch run method (overridden virtual).
+ * Checks the data blobs in each entry of the batch are distinct before
+ * running each iteration.
+ */
+void TestPipeline::runBatch(DataBatch& batch)
+{
+    ++_batchCounter;
+    QSet<DataBlob*> blobs;
+    int total = 0;
+    for (int i = 0; i < batch.size(); ++i) {
+        foreach (DataBlob* blob, batch[i]) {
+            blobs.insert(blob);
+            ++total;
+        }
+    }
+    if (blobs.size() == total)
+        ++_distinctBatchCounter;
+    AbstractPipeline::runBatch(batch);
+}
+
 void TestPipeline::setHistory( const QString& stream, int size)
 {
      _history[stream]=size;
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ALIGNEDBUFFER_H
+#define ALIGNEDBUFFER_H
+
+/**
+ * @file AlignedBuffer.h
+ */
+
+#include <cstddef>
+#include <cstring>
+
+namespace pelican {
+
+/**
+ * @ingroup c_data
+ *
+ * @class AlignedMemory
+ *
+ * @brief
+ * Allocates cache-line aligned memory, optionally backed by huge pages.
+ *
+ * @details
+ * All allocations are aligned to AlignedMemory::Alignment (64) bytes,
+ * which is sufficient for any SIMD load and avoids false sharing of cache
+ * lines between buffers.
+ *
+ * If huge pages are requested and the allocation is at least one huge page
+ * in size, the memory is first requested from the kernel huge page pool
+ * (MAP_HUGETLB), falling back to huge-page aligned memory marked for
+ * transparent huge pages, and finally to ordinary aligned memory. The size
+ * of such allocations is rounded up to a whole number of huge pages.
+ */
+class AlignedMemory
+{
+    public:
+        enum { Alignment = 64 };
+        enum { HugePageSize = 2 * 1024 * 1024 };
+
+    public:
+        /// Allocates at least @p bytes of aligned memory.
+        static void* allocate(size_t& bytes, bool hugePages, bool& mapped);
+
+        /// Frees memory returned by allocate().
+        static void release(void* memory, size_t bytes, bool mapped);
+};
+
+
+/**
+ * @ingroup c_data
+ *
+ * @class AlignedBuffer
+ *
+ * @brief
+ * Array of plain data with aligned, non-zeroing storage.
+ *
+ * @details
+ * A minimal std::vector replacement for the payload of data blobs. The
+ * storage is aligned (see AlignedMemory) and, unlike std::vector,
+ * resize() leaves new elements uninitialised, so buffers that are about to
+ * be overwritten (e.g. by an adapter) do not pay for a memset. The
+ * capacity is never reduced by resize() or clear(), so a buffer reused for
+ * chunks of the same size is allocated only once.
+ *
+ * The element type must be a plain data type, as elements are neither
+ * constructed nor destroyed, and are copied with memcpy.
+ */
+template<typename T>
+class AlignedBuffer
+{
+    public:
+        /// Constructs an empty buffer.
+        explicit AlignedBuffer(bool hugePages = false)
+        : _data(0), _size(0), _capacity(0), _bytes(0),
+          _hugePages(hugePages), _mapped(false) {}
+
+        /// Copies the contents of another buffer.
+        AlignedBuffer(const AlignedBuffer& other)
+        : _data(0), _size(0), _capacity(0), _bytes(0),
+          _hugePages(other._hugePages), _mapped(false)
+        { *this = other; }
+
+        /// Frees the storage.
+        ~AlignedBuffer() { _release(); }
+
+        /// Copies the contents of another buffer.
+        AlignedBuffer& operator=(const AlignedBuffer& other)
+        {
+            if (this != &other) {
+                resize(other._size);
+                if (_size > 0)
+                    std::memcpy(_data, other._data, _size * sizeof(T));
+            }
+            return *this;
+        }
+
+    public:
+        /// Returns a pointer to the start of the data (null if empty).
+        T* data() { return _size > 0 ? _data : 0; }
+
+        /// Returns a pointer to the start of the data (null if empty).
+        const T* data() const { return _size > 0 ? _data : 0; }
+
+        /// Returns the element at index @p i.
+        T& operator[](size_t i) { return _data[i]; }
+
+        /// Returns the element at index @p i.
+        const T& operator[](size_t i) const { return _data[i]; }
+
+        /// Returns the number of elements.
+        size_t size() const { return _size; }
+
+        /// Returns true if the buffer holds no elements.
+        bool empty() const { return _size == 0; }
+
+        /// Returns the number of elements that fit in the allocated storage.
+        size_t capacity() const { return _capacity; }
+
+        /// Resizes the buffer, leaving any new elements uninitialised.
+        void resize(size_t size)
+        {
+            reserve(size);
+            _size = size;
+        }
+
+        /// Resizes the buffer, setting any new elements to @p value.
+        void resize(size_t size, const T& value)
+        {
+            size_t old = _size;
+            resize(size);
+            for (size_t i = old; i < size; ++i) _data[i] = value;
+        }
+
+        /// Ensures the storage can hold @p size elements, keeping the contents.
+        void reserve(size_t size)
+        {
+            if (size <= _capacity) return;
+            size_t bytes = size * sizeof(T);
+            bool mapped = false;
+            T* data = static_cast<T*>(
+                    AlignedMemory::allocate(bytes, _hugePages, mapped));
+            if (_size > 0) std::memcpy(data, _data, _size * sizeof(T));
+            _release();
+            _data = data;
+            _bytes = bytes;
+            _capacity = bytes / sizeof(T);
+            _mapped = mapped;
+        }
+
+        /// Removes all elements, keeping the storage.
+        void clear() { _size = 0; }
+
+        /// Frees the storage.
+        void release() { _release(); _size = 0; }
+
+        /// Sets whether huge pages are used for subsequent allocations.
+        void setHugePages(bool enable) { _hugePages = enable; }
+
+        /// Returns true if huge pages are used for allocations.
+        bool hugePages() const { return _hugePages; }
+
+    private:
+        void _release()
+        {
+            if (_data) AlignedMemory::release(_data, _bytes, _mapped);
+            _data = 0;
+            _capacity = 0;
+            _bytes = 0;
+            _mapped = false;
+        }
+
+    private:
+        T* _data;
+        size_t _size;
+        size_t _capacity;
+        size_t _bytes;
+        bool _hugePages;
+        bool _mapped;
+};
+
+} // namespace pelican
+
+#endif // ALIGNEDBUFFER_H
@@ -34,6 +34,8 @@
  */
 
 #include "data/DataBlob.h"
+#include "data/ArraySerialiser.h"
+#include "data/AlignedBuffer.h"
 #include <vector>
 
 namespace pelican {
@@ -47,7 +49,9 @@ namespace pelican {
  * Data blob to hold an array.
  *
  * @details
- * This data blob holds an array.
+ * This data blob holds an array. The array is serialised in bulk, as a
+ * raw copy of its memory (see ArraySerialiser), so the element type must
+ * be a plain data type.
  */
 template <class T>
 class ArrayData : public DataBlob
@@ -72,7 +76,96 @@ class ArrayData : public DataBlob
         void resize(unsigned length) { _data.resize(length); }
 
         /// Returns the size of the data.
-        unsigned size() { return _data.size(); }
+        unsigned size() const { return _data.size(); }
+
+        /// Serialises the array into the QIODevice.
+        virtual void serialise(QIODevice& out) const
+        { ArraySerialiser::serialise(out, _data); }
+
+        /// Returns the number of serialised bytes.
+        virtual quint64 serialisedBytes() const
+        { return ArraySerialiser::serialisedBytes(_data); }
+
+        /// Deserialises the array from the QIODevice.
+        virtual void deserialise(QIODevice& in, QSysInfo::Endian endianness)
+        { ArraySerialiser::deserialise(in, _data, endianness); }
+};
+
+
+
+/**
+ * @ingroup c_data
+ *
+ * @class AlignedArrayData
+ *
+ * @brief
+ * Data blob to hold an array in aligned, non-zeroing storage.
+ *
+ * @details
+ * A variant of ArrayData for large arrays that are overwritten on every
+ * iteration (e.g. by an adapter). The data is held in an AlignedBuffer, so
+ * it is aligned to 64 bytes, resize() does not initialise new elements and
+ * the storage is reused while the size does not grow. Storage can
+ * optionally be allocated from huge pages with setHugePages().
+ *
+ * The element type must be a plain data type.
+ */
+template <class T>
+class AlignedArrayData : public DataBlob
+{
+    private:
+        AlignedBuffer<T> _data;
+
+    public:
+        /// Constructor.
+        AlignedArrayData(const QString& type, bool hugePages = false)
+        : DataBlob(type), _data(hugePages) {}
+
+        /// Destructor.
+        virtual ~AlignedArrayData() {}
+
+        /// Returns a pointer to the start of the data.
+        T* ptr() { return _data.data(); }
+
+        /// Returns a pointer to the start of the data. (const. overload)
+        const T* ptr() const { return _data.data(); }
+
+        /// Resizes the data blob, leaving new elements uninitialised.
+        void resize(unsigned length) { _data.resize(length); }
+
+        /// Resizes the data blob, setting new elements to @p value.
+        void resize(unsigned length, const T& value)
+        { _data.resize(length, value); }
+
+        /// Reserves storage for @p length elements.
+        void reserve(unsigned length) { _data.reserve(length); }
+
+        /// Returns the size of the data.
+        unsigned size() const { return _data.size(); }
+
+        /// Returns the number of elements that fit in the allocated storage.
+        unsigned capacity() const { return _data.capacity(); }
+
+        /// Sets whether huge pages are used for subsequent allocations.
+        void setHugePages(bool enable) { _data.setHugePages(enable); }
+
+        /// Serialises the array into the QIODevice.
+        virtual void serialise(QIODevice& out) const
+        { ArraySerialiser::serialise(out, _data.data(), _data.size(), sizeof(T)); }
+
+        /// Returns the number of serialised bytes.
+        virtual quint64 serialisedBytes() const
+        { return ArraySerialiser::serialisedBytes(_data.size(), sizeof(T)); }
+
+        /// Deserialises the array from the QIODevice.
+        virtual void deserialise(QIODevice& in, QSysInfo::Endian endianness)
+        {
+            // The header sets endianness to the byte order of the writer.
+            _data.resize(ArraySerialiser::deserialiseHeader(in, sizeof(T),
+                    endianness));
+            ArraySerialiser::deserialiseData(in, _data.data(), _data.size(),
+                    sizeof(T), ArraySerialiser::WordSize<T>::value, endianness);
+        }
 };
 
 
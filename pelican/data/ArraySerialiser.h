@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARRAYSERIALISER_H
+#define ARRAYSERIALISER_H
+
+/**
+ * @file ArraySerialiser.h
+ */
+
+#include <QtCore/QSysInfo>
+#include <QtCore/QtGlobal>
+
+#include <complex>
+#include <vector>
+
+class QIODevice;
+
+namespace pelican {
+
+/**
+ * @ingroup c_data
+ *
+ * @class ArraySerialiser
+ *
+ * @brief
+ * Bulk binary serialisation of contiguous arrays for data blobs.
+ *
+ * @details
+ * Arrays are serialised as a small header, holding the number of elements
+ * and the size of each element, followed by a single raw write of the
+ * array memory. Everything is written in the native byte order of the
+ * serialising machine, so serialisation is a straight copy; byte swapping
+ * is only performed on deserialisation, if the data was written on a
+ * machine of the other byte order.
+ *
+ * The byte order of the writer is recovered from the element size in the
+ * header, rather than relying on the endianness passed to
+ * DataBlob::deserialise(), as not every transport reports it (version 1 of
+ * the Pelican protocol always reports big endian).
+ *
+ * Byte swapping is carried out in place on words of the given size (e.g.
+ * 4 bytes for each half of a std::complex<float>), using SSSE3 shuffles
+ * when the library is built with SSSE3 enabled.
+ *
+ * A data blob holding a std::vector can use the template helpers directly:
+ *
+ * @code
+ * void MyBlob::serialise(QIODevice& out) const
+ * { ArraySerialiser::serialise(out, _data); }
+ *
+ * quint64 MyBlob::serialisedBytes() const
+ * { return ArraySerialiser::serialisedBytes(_data); }
+ *
+ * void MyBlob::deserialise(QIODevice& in, QSysInfo::Endian endian)
+ * { ArraySerialiser::deserialise(in, _data, endian); }
+ * @endcode
+ */
+class ArraySerialiser
+{
+    public:
+        /// Size of the array header, in bytes.
+        enum { HeaderBytes = sizeof(quint64) + sizeof(quint32) };
+
+        /// Returns the word size used to byte swap elements of type T.
+        template<typename T> struct WordSize
+        { enum { value = sizeof(T) }; };
+
+        template<typename T> struct WordSize<std::complex<T> >
+        { enum { value = sizeof(T) }; };
+
+    public:
+        /// Returns the number of bytes written by serialise().
+        static quint64 serialisedBytes(quint64 count, quint32 elementSize)
+        { return HeaderBytes + count * elementSize; }
+
+        /// Writes the header and array memory to the device.
+        static void serialise(QIODevice& device, const void* data,
+                quint64 count, quint32 elementSize);
+
+        /// Reads the array header, returning the number of elements and
+        /// setting @p endian to the byte order of the writer.
+        static quint64 deserialiseHeader(QIODevice& device,
+                quint32 elementSize, QSysInfo::Endian& endian);
+
+        /// Reads the array memory, byte swapping if required.
+        static void deserialiseData(QIODevice& device, void* data,
+                quint64 count, quint32 elementSize, quint32 wordSize,
+                QSysInfo::Endian endian);
+
+        /// Reverses the byte order of @p count words of @p wordSize bytes.
+        static void byteSwap(void* data, quint64 count, quint32 wordSize);
+
+        /// Reads exactly @p size bytes from the device.
+        static void read(QIODevice& device, char* data, qint64 size);
+
+        /// Writes exactly @p size bytes to the device.
+        static void write(QIODevice& device, const char* data, qint64 size);
+
+    public:
+        /// Returns the number of bytes written by serialise() for a vector.
+        template<typename T>
+        static quint64 serialisedBytes(const std::vector<T>& v)
+        { return serialisedBytes(v.size(), sizeof(T)); }
+
+        /// Serialises a vector.
+        template<typename T>
+        static void serialise(QIODevice& device, const std::vector<T>& v)
+        { serialise(device, v.empty() ? 0 : &v[0], v.size(), sizeof(T)); }
+
+        /// Deserialises a vector, resizing it to the number of elements read.
+        template<typename T>
+        static void deserialise(QIODevice& device, std::vector<T>& v,
+                QSysInfo::Endian endian)
+        {
+            v.resize(deserialiseHeader(device, sizeof(T), endian));
+            // endian now holds the byte order of the writer.
+            deserialiseData(device, v.empty() ? 0 : &v[0], v.size(),
+                    sizeof(T), WordSize<T>::value, endian);
+        }
+};
+
+} // namespace pelican
+
+#endif // ARRAYSERIALISER_H
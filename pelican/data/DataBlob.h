@@ -82,6 +82,20 @@ class DataBlob
         /// Returns the version of the DataBlob.
         const QString& version() const { return _version; }
 
+        /// Sets the ingest timestamp of the data (ns since the epoch).
+        void setTimestamp(qint64 t) { _timestamp = t; }
+
+        /// Returns the ingest timestamp of the data (0 if unknown).
+        qint64 timestamp() const { return _timestamp; }
+
+        /// Sets the number of packets missing from the stream data
+        /// adapted into the blob.
+        void setLostPackets(quint32 n) { _lostPackets = n; }
+
+        /// Returns the number of packets missing from the stream data
+        /// adapted into the blob (see AbstractUdpChunker).
+        quint32 lostPackets() const { return _lostPackets; }
+
     public:
         /// Serialise the DataBlob into the QIODevice.
         virtual void serialise(QIODevice&) const;
@@ -89,12 +103,15 @@ class DataBlob
         /// Returns the number of serialised bytes.
         virtual quint64 serialisedBytes() const;
 
-        /// Deserialises the DataBlob from the QIODevice.
+        /// Deserialises the DataBlob from the QIODevice, overwriting all
+        /// of its state (blobs may be reused).
         virtual void deserialise(QIODevice&, QSysInfo::Endian endianness);
 
     private:
         QString _version;
         QString _type;
+        qint64 _timestamp;
+        quint32 _lostPackets;
 };
 
 } // namespace pelican
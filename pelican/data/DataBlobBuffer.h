@@ -29,7 +29,10 @@
 #ifndef DATABLOBBUFFER_H
 #define DATABLOBBUFFER_H
 
+#include "utility/FactoryGeneric.h"
+#include "utility/ContiguousMemory.hpp"
 #include <QtCore/QList>
+#include <QtCore/QString>
 
 
 /**
@@ -46,6 +49,11 @@ namespace pelican {
  * @details
  *    At least one DataBlob must be provided otherwise this
  *    is undefined
+ *
+ *    Blobs may be added individually (the buffer takes ownership), or
+ *    constructed in batches with addDataBlobs(), which places each batch
+ *    back to back in a single cache-aligned slab (see ContiguousMemory)
+ *    so that the history of a stream is compact in memory.
  */
 
 class ConfigNode;
@@ -60,6 +68,10 @@ class DataBlobBuffer
         /// add a new DataBlob for use in the buffer
         void addDataBlob(DataBlob*);
 
+        /// construct and add a number of DataBlobs in contiguous memory
+        void addDataBlobs(FactoryGeneric<DataBlob>* factory,
+                          const QString& type, unsigned int number);
+
         /// get the next DataBlob from the buffer
         DataBlob* next();
 
@@ -69,8 +81,13 @@ class DataBlobBuffer
         /// return the size (number of DataBlobs) held in the Buffer
         long int size() { return _size; }
 
+    private:
+        /// destroy a DataBlob, releasing its slab if empty
+        void _delete(DataBlob*);
+
     private:
         QList<DataBlob*> _data;
+        QList<ContiguousMemory<DataBlob>*> _slabs;
         long int _index;
         long int _size;
 };
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "data/AlignedBuffer.h"
+
+#include <QtCore/QString>
+
+#include <cstdlib>
+#include <sys/mman.h>
+
+namespace pelican {
+
+/**
+ * @details
+ * Allocates at least @p bytes of memory aligned to Alignment bytes.
+ *
+ * @param[in,out] bytes     The number of bytes required. On return, holds
+ *                          the number of bytes actually allocated.
+ * @param[in]     hugePages Use huge pages for large allocations.
+ * @param[out]    mapped    Set to true if the memory was mapped from the
+ *                          huge page pool.
+ *
+ * @throw QString if the memory could not be allocated.
+ */
+void* AlignedMemory::allocate(size_t& bytes, bool hugePages, bool& mapped)
+{
+    mapped = false;
+    void* memory = 0;
+
+    if (hugePages && bytes >= size_t(HugePageSize)) {
+        size_t length = (bytes + HugePageSize - 1) & ~size_t(HugePageSize - 1);
+#ifdef MAP_HUGETLB
+        // Try the reserved huge page pool first.
+        memory = mmap(0, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            mapped = true;
+            bytes = length;
+            return memory;
+        }
+        memory = 0;
+#endif
+        // Fall back to transparent huge pages.
+        if (posix_memalign(&memory, HugePageSize, length) == 0) {
+#ifdef MADV_HUGEPAGE
+            madvise(memory, length, MADV_HUGEPAGE);
+#endif
+            bytes = length;
+            return memory;
+        }
+        memory = 0;
+    }
+
+    if (posix_memalign(&memory, Alignment, bytes > 0 ? bytes : 1) != 0)
+        throw QString("AlignedMemory: Unable to allocate %1 bytes.").arg(bytes);
+    return memory;
+}
+
+
+/**
+ * @details
+ * Frees memory returned by allocate().
+ *
+ * @param[in] memory Pointer to the memory.
+ * @param[in] bytes  The number of bytes allocated, as returned by allocate().
+ * @param[in] mapped The value of the mapped flag returned by allocate().
+ */
+void AlignedMemory::release(void* memory, size_t bytes, bool mapped)
+{
+    if (!memory) return;
+    if (mapped)
+        munmap(memory, bytes);
+    else
+        free(memory);
+}
+
+} // namespace pelican
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "data/ArraySerialiser.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace pelican {
+
+namespace {
+
+// Time to wait for more data on sequential devices, in milliseconds.
+const int readTimeout = 30000;
+
+// Reverses the bytes of each of the count words of type T at p.
+template<typename T>
+void swapWords(char* p, quint64 count)
+{
+    quint64 i = 0;
+#ifdef __SSSE3__
+    // Shuffle 16 bytes at a time, reversing the bytes of each word.
+    const unsigned n = sizeof(T);
+    char m[16];
+    for (unsigned j = 0; j < 16; ++j)
+        m[j] = char((j / n) * n + (n - 1 - j % n));
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m));
+    for (; i + 16 / n <= count; i += 16 / n) {
+        __m128i* v = reinterpret_cast<__m128i*>(p + i * n);
+        _mm_storeu_si128(v, _mm_shuffle_epi8(_mm_loadu_si128(v), mask));
+    }
+#endif
+    for (; i < count; ++i) {
+        T w;
+        std::memcpy(&w, p + i * sizeof(T), sizeof(T));
+        w = qbswap(w);
+        std::memcpy(p + i * sizeof(T), &w, sizeof(T));
+    }
+}
+
+} // namespace
+
+
+/**
+ * @details
+ * Writes the array header (the number of elements and the element size)
+ * followed by the array memory to the device, in native byte order.
+ *
+ * @param[in] device      The device to write to.
+ * @param[in] data        Pointer to the start of the array.
+ * @param[in] count       The number of elements in the array.
+ * @param[in] elementSize The size of each element, in bytes.
+ */
+void ArraySerialiser::serialise(QIODevice& device, const void* data,
+        quint64 count, quint32 elementSize)
+{
+    char header[HeaderBytes];
+    std::memcpy(header, &count, sizeof(quint64));
+    std::memcpy(header + sizeof(quint64), &elementSize, sizeof(quint32));
+    write(device, header, HeaderBytes);
+    if (count > 0)
+        write(device, static_cast<const char*>(data), count * elementSize);
+}
+
+
+/**
+ * @details
+ * Reads the array header written by serialise(), checking that the element
+ * size matches @p elementSize.
+ *
+ * The element size is stored in the byte order of the writer, so it also
+ * identifies that byte order: if it only matches @p elementSize once byte
+ * swapped, the array was written on a machine of the other byte order.
+ *
+ * @param[in] device      The device to read from.
+ * @param[in] elementSize The expected size of each element, in bytes.
+ * @param[in,out] endian  The byte order reported for the data; set to the
+ *                        byte order of the machine that wrote the array.
+ *
+ * @return The number of elements in the array.
+ */
+quint64 ArraySerialiser::deserialiseHeader(QIODevice& device,
+        quint32 elementSize, QSysInfo::Endian& endian)
+{
+    char header[HeaderBytes];
+    read(device, header, HeaderBytes);
+
+    quint64 count;
+    quint32 size;
+    std::memcpy(&count, header, sizeof(quint64));
+    std::memcpy(&size, header + sizeof(quint64), sizeof(quint32));
+    if (size == elementSize && qbswap(size) != elementSize)
+        endian = QSysInfo::ByteOrder;
+    else if (qbswap(size) == elementSize && size != elementSize)
+        endian = QSysInfo::ByteOrder == QSysInfo::BigEndian ?
+                QSysInfo::LittleEndian : QSysInfo::BigEndian;
+
+    if (endian != QSysInfo::ByteOrder) {
+        count = qbswap(count);
+        size = qbswap(size);
+    }
+
+    if (size != elementSize)
+        throw QString("ArraySerialiser: Element size mismatch "
+                "(expected %1, found %2).").arg(elementSize).arg(size);
+    return count;
+}
+
+
+/**
+ * @details
+ * Reads @p count elements into the array memory at @p data, byte swapping
+ * words of @p wordSize bytes if @p endian differs from that of the host.
+ */
+void ArraySerialiser::deserialiseData(QIODevice& device, void* data,
+        quint64 count, quint32 elementSize, quint32 wordSize,
+        QSysInfo::Endian endian)
+{
+    if (count == 0)
+        return;
+
+    read(device, static_cast<char*>(data), count * elementSize);
+    if (endian != QSysInfo::ByteOrder && wordSize > 1)
+        byteSwap(data, count * (elementSize / wordSize), wordSize);
+}
+
+
+/**
+ * @details
+ * Reverses the byte order of each of the @p count words of @p wordSize
+ * bytes, in place.
+ */
+void ArraySerialiser::byteSwap(void* data, quint64 count, quint32 wordSize)
+{
+    char* p = static_cast<char*>(data);
+    switch (wordSize)
+    {
+        case 1:
+            break;
+        case 2:
+            swapWords<quint16>(p, count);
+            break;
+        case 4:
+            swapWords<quint32>(p, count);
+            break;
+        case 8:
+            swapWords<quint64>(p, count);
+            break;
+        default:
+            for (quint64 i = 0; i < count; ++i)
+                std::reverse(p + i * wordSize, p + (i + 1) * wordSize);
+            break;
+    }
+}
+
+
+/**
+ * @details
+ * Reads exactly @p size bytes from the device, waiting for more data to
+ * arrive on sequential devices if necessary.
+ *
+ * @throw QString if the data could not be read.
+ */
+void ArraySerialiser::read(QIODevice& device, char* data, qint64 size)
+{
+    while (size > 0) {
+        qint64 n = device.read(data, size);
+        if (n < 0)
+            throw QString("ArraySerialiser: Read error: %1")
+                    .arg(device.errorString());
+        if (n == 0 && !device.waitForReadyRead(readTimeout))
+            throw QString("ArraySerialiser: Unexpected end of data "
+                    "(%1 bytes missing).").arg(size);
+        data += n;
+        size -= n;
+    }
+}
+
+
+/**
+ * @details
+ * Writes exactly @p size bytes to the device.
+ *
+ * @throw QString if the data could not be written.
+ */
+void ArraySerialiser::write(QIODevice& device, const char* data, qint64 size)
+{
+    while (size > 0) {
+        qint64 n = device.write(data, size);
+        if (n <= 0)
+            throw QString("ArraySerialiser: Write error: %1")
+                    .arg(device.errorString());
+        data += n;
+        size -= n;
+    }
+}
+
+} // namespace pelican
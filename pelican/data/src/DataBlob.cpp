@@ -37,7 +37,8 @@ namespace pelican {
  *
  * @param[in] type The name of the data blob derived class.
  */
-DataBlob::DataBlob(const QString& type) : _type(type)
+DataBlob::DataBlob(const QString& type)
+    : _type(type), _timestamp(0), _lostPackets(0)
 {
 }
 
@@ -69,6 +70,13 @@ quint64 DataBlob::serialisedBytes() const
  * Deserialises the data blob.
  * This method should be re-implemented in a derived class if needed,
  * since the default implementation will throw an exception of type QString.
+ *
+ * Blobs may be recycled between messages (see DataBlobClient, which uses a
+ * FactoryPool), so a reimplementation must overwrite all the state of the
+ * derived class rather than assume a freshly constructed object: resize
+ * containers to the received size, and reset any members not present in
+ * the serialised data. The base class state (version, timestamp and lost
+ * packet count) is reset by the client before deserialise() is called.
  */
 void DataBlob::deserialise(QIODevice&, QSysInfo::Endian)
 {
@@ -46,7 +46,7 @@ DataBlobBuffer::DataBlobBuffer()
 DataBlobBuffer::~DataBlobBuffer()
 {
      foreach(DataBlob* blob, _data) {
-        delete blob;
+        _delete(blob);
      }
 }
 
@@ -56,6 +56,39 @@ void DataBlobBuffer::addDataBlob(DataBlob* blob)
      _size = _data.size();
 }
 
+/**
+ * @details
+ * Constructs @p number DataBlobs of the given @p type back to back in a
+ * single slab of memory, and adds them to the buffer.
+ */
+void DataBlobBuffer::addDataBlobs(FactoryGeneric<DataBlob>* factory,
+                                  const QString& type, unsigned int number)
+{
+     if( number == 0 ) return;
+     ContiguousMemory<DataBlob>* slab =
+             new ContiguousMemory<DataBlob>(number, factory->objectSize(type));
+     _slabs.append(slab);
+     for( unsigned int i = 0; i < number; ++i ) {
+         addDataBlob(slab->construct(*factory, type));
+     }
+}
+
+void DataBlobBuffer::_delete(DataBlob* blob)
+{
+     for( int i = 0; i < _slabs.size(); ++i ) {
+         ContiguousMemory<DataBlob>* slab = _slabs[i];
+         if( slab->contains(blob) ) {
+             slab->destroy(blob);
+             if( slab->available() == slab->size() ) {
+                 delete slab;
+                 _slabs.removeAt(i);
+             }
+             return;
+         }
+     }
+     delete blob;
+}
+
 DataBlob* DataBlobBuffer::next() {
     //_index=++_index%_size; // FIXME this line is a bit dodgy
     _index = (_index + 1) % _size; // NOTE this replacement for the line above needs checking.
@@ -66,7 +99,7 @@ void DataBlobBuffer::shrink(int newSize) {
     // remove oldest/unused data first
     while( _data.size() > newSize ) {
         unsigned int index = (_index+1) % _size;
-        delete _data[index];
+        _delete(_data[index]);
         _data.removeAt(index);
         if( index < _index && _index != (unsigned int)-1 ) { --_index; }
     }
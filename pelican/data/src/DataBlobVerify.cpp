@@ -29,6 +29,7 @@
 #include "DataBlobVerify.h"
 #include "data/DataBlob.h"
 #include "data/DataBlobFactory.h"
+#include "utility/FactoryPool.h"
 #include <QtCore/QDebug>
 
 
@@ -60,7 +61,8 @@ bool DataBlobVerify::verifySerialisedBytes() const {
 bool DataBlobVerify::verifyDeserialise() const {
     _serialise();
     static FactoryGeneric<DataBlob> factory(true);
-    DataBlob* copy = factory.create( _blob->type() );
+    static FactoryPool<DataBlob> pool(&factory, 4, FactoryPool<DataBlob>::Reconstruct);
+    boost::shared_ptr<DataBlob> copy = pool.create( _blob->type() );
     QByteArray tmp( _buffer.data() );
     QBuffer buffer2( &tmp );
     buffer2.open( QBuffer::ReadOnly );
@@ -54,6 +54,7 @@ class DataBlobBufferTest : public CppUnit::TestFixture
         CPPUNIT_TEST_SUITE( DataBlobBufferTest );
         CPPUNIT_TEST( test_nextMethod );
         CPPUNIT_TEST( test_shrink );
+        CPPUNIT_TEST( test_contiguous );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -63,6 +64,7 @@ class DataBlobBufferTest : public CppUnit::TestFixture
         // Test Methods
         void test_nextMethod();
         void test_shrink();
+        void test_contiguous();
 
     public:
         DataBlobBufferTest(  );
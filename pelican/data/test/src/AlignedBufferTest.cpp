@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "AlignedBufferTest.h"
+#include "data/AlignedBuffer.h"
+#include "data/ArrayData.h"
+#include "data/DataBlobVerify.h"
+
+namespace pelican {
+
+namespace test {
+class AlignedTestData : public AlignedArrayData<float>
+{
+    public:
+        AlignedTestData() : AlignedArrayData<float>("AlignedTestData") {}
+};
+PELICAN_DECLARE_DATABLOB(AlignedTestData)
+} // namespace test
+
+CPPUNIT_TEST_SUITE_REGISTRATION( AlignedBufferTest );
+
+void AlignedBufferTest::test_alignment()
+{
+    for (size_t n = 1; n < 2000; n = n * 3 + 1) {
+        AlignedBuffer<char> buffer;
+        buffer.resize(n);
+        CPPUNIT_ASSERT_EQUAL(size_t(0),
+                size_t(buffer.data()) % size_t(AlignedMemory::Alignment));
+    }
+
+    AlignedBuffer<double> empty;
+    CPPUNIT_ASSERT(empty.data() == 0);
+    CPPUNIT_ASSERT(empty.empty());
+}
+
+void AlignedBufferTest::test_resize()
+{
+    AlignedBuffer<int> buffer;
+    buffer.resize(100, 7);
+    CPPUNIT_ASSERT_EQUAL(size_t(100), buffer.size());
+    CPPUNIT_ASSERT(buffer.capacity() >= 100);
+    for (size_t i = 0; i < buffer.size(); ++i)
+        CPPUNIT_ASSERT_EQUAL(7, buffer[i]);
+
+    // Shrinking and regrowing within the capacity reuses the storage.
+    const int* p = buffer.data();
+    buffer.resize(10);
+    buffer.clear();
+    buffer.resize(100);
+    CPPUNIT_ASSERT(buffer.data() == p);
+
+    // Growing keeps the existing contents and initialises new elements.
+    buffer[99] = 3;
+    buffer.resize(200, 5);
+    CPPUNIT_ASSERT_EQUAL(7, buffer[0]);
+    CPPUNIT_ASSERT_EQUAL(3, buffer[99]);
+    CPPUNIT_ASSERT_EQUAL(5, buffer[199]);
+
+    // Copies are independent.
+    AlignedBuffer<int> copy(buffer);
+    copy[0] = 1;
+    CPPUNIT_ASSERT_EQUAL(size_t(200), copy.size());
+    CPPUNIT_ASSERT_EQUAL(7, buffer[0]);
+
+    buffer.release();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), buffer.capacity());
+    CPPUNIT_ASSERT(buffer.data() == 0);
+}
+
+void AlignedBufferTest::test_hugePages()
+{
+    // Huge pages are used if available; otherwise the allocation falls back
+    // to ordinary aligned memory.
+    AlignedBuffer<float> buffer(true);
+    size_t n = 3 * AlignedMemory::HugePageSize / sizeof(float) / 2;
+    buffer.resize(n, 1.0f);
+    CPPUNIT_ASSERT(buffer.capacity() >= n);
+    CPPUNIT_ASSERT_EQUAL(size_t(0),
+            size_t(buffer.data()) % size_t(AlignedMemory::Alignment));
+    CPPUNIT_ASSERT_EQUAL(1.0f, buffer[n - 1]);
+}
+
+void AlignedBufferTest::test_arrayData()
+{
+    test::AlignedTestData blob;
+    blob.resize(1000);
+    for (unsigned i = 0; i < blob.size(); ++i) blob.ptr()[i] = float(i) / 7;
+
+    DataBlobVerify verify(&blob);
+    CPPUNIT_ASSERT(verify.verifySerialisedBytes());
+    CPPUNIT_ASSERT(verify.verifyDeserialise());
+}
+
+} // namespace pelican
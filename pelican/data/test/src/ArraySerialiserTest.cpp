@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ArraySerialiserTest.h"
+#include "data/ArraySerialiser.h"
+#include "data/ArrayData.h"
+#include "data/DataBlobVerify.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QByteArray>
+
+#include <complex>
+#include <vector>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ArraySerialiserTest );
+
+namespace {
+// Returns the byte order opposite to that of the host.
+QSysInfo::Endian otherEndian()
+{
+    return QSysInfo::ByteOrder == QSysInfo::BigEndian ?
+            QSysInfo::LittleEndian : QSysInfo::BigEndian;
+}
+} // namespace
+
+void ArraySerialiserTest::test_roundTrip()
+{
+    std::vector<double> in(1001);
+    for (unsigned i = 0; i < in.size(); ++i) in[i] = 0.5 * i;
+
+    QByteArray array;
+    QBuffer buffer(&array);
+    buffer.open(QIODevice::WriteOnly);
+    ArraySerialiser::serialise(buffer, in);
+    CPPUNIT_ASSERT_EQUAL(ArraySerialiser::serialisedBytes(in),
+            quint64(array.size()));
+    CPPUNIT_ASSERT_EQUAL(quint64(ArraySerialiser::HeaderBytes
+            + in.size() * sizeof(double)), quint64(array.size()));
+    buffer.close();
+
+    std::vector<double> out(3, -1.0);
+    buffer.open(QIODevice::ReadOnly);
+    ArraySerialiser::deserialise(buffer, out, QSysInfo::ByteOrder);
+    CPPUNIT_ASSERT(in == out);
+    CPPUNIT_ASSERT(buffer.atEnd());
+
+    // Empty arrays.
+    std::vector<float> empty, result(5);
+    QByteArray array2;
+    QBuffer buffer2(&array2);
+    buffer2.open(QIODevice::WriteOnly);
+    ArraySerialiser::serialise(buffer2, empty);
+    buffer2.close();
+    buffer2.open(QIODevice::ReadOnly);
+    ArraySerialiser::deserialise(buffer2, result, QSysInfo::ByteOrder);
+    CPPUNIT_ASSERT(result.empty());
+}
+
+void ArraySerialiserTest::test_byteSwap()
+{
+    // Swap words of each supported size (with lengths that leave a tail
+    // after any vectorised loop).
+    {
+        std::vector<quint16> v(13);
+        for (unsigned i = 0; i < v.size(); ++i) v[i] = quint16(0x0102 + i);
+        ArraySerialiser::byteSwap(&v[0], v.size(), 2);
+        for (unsigned i = 0; i < v.size(); ++i) {
+            quint16 e = quint16(0x0102 + i);
+            CPPUNIT_ASSERT_EQUAL(quint16((e >> 8) | (e << 8)), v[i]);
+        }
+    }
+    {
+        std::vector<quint32> v(11, 0x01020304u);
+        ArraySerialiser::byteSwap(&v[0], v.size(), 4);
+        for (unsigned i = 0; i < v.size(); ++i)
+            CPPUNIT_ASSERT_EQUAL(quint32(0x04030201u), v[i]);
+    }
+    {
+        std::vector<quint64> v(5, Q_UINT64_C(0x0102030405060708));
+        ArraySerialiser::byteSwap(&v[0], v.size(), 8);
+        for (unsigned i = 0; i < v.size(); ++i)
+            CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(0x0807060504030201), v[i]);
+    }
+
+    // Data written on a machine of the other byte order: swap the payload
+    // and header to emulate it, then read it back.
+    std::vector<std::complex<float> > in(7);
+    for (unsigned i = 0; i < in.size(); ++i)
+        in[i] = std::complex<float>(float(i), -float(i));
+
+    QByteArray array;
+    QBuffer buffer(&array);
+    buffer.open(QIODevice::WriteOnly);
+    ArraySerialiser::serialise(buffer, in);
+    buffer.close();
+    char* d = array.data();
+    ArraySerialiser::byteSwap(d, 1, 8);
+    ArraySerialiser::byteSwap(d + 8, 1, 4);
+    ArraySerialiser::byteSwap(d + ArraySerialiser::HeaderBytes,
+            2 * in.size(), 4);
+
+    std::vector<std::complex<float> > out;
+    buffer.open(QIODevice::ReadOnly);
+    ArraySerialiser::deserialise(buffer, out, otherEndian());
+    CPPUNIT_ASSERT(in == out);
+    buffer.close();
+
+    // The byte order is taken from the header, so the same data is read
+    // correctly when the reported byte order is wrong.
+    out.clear();
+    buffer.open(QIODevice::ReadOnly);
+    ArraySerialiser::deserialise(buffer, out, QSysInfo::ByteOrder);
+    CPPUNIT_ASSERT(in == out);
+}
+
+void ArraySerialiserTest::test_errors()
+{
+    std::vector<float> in(10, 1.0f);
+    QByteArray array;
+    QBuffer buffer(&array);
+    buffer.open(QIODevice::WriteOnly);
+    ArraySerialiser::serialise(buffer, in);
+    buffer.close();
+
+    // Element size mismatch.
+    std::vector<double> wrongType;
+    buffer.open(QIODevice::ReadOnly);
+    CPPUNIT_ASSERT_THROW(ArraySerialiser::deserialise(buffer, wrongType,
+            QSysInfo::ByteOrder), QString);
+    buffer.close();
+
+    // Truncated data.
+    array.chop(4);
+    std::vector<float> out;
+    buffer.open(QIODevice::ReadOnly);
+    CPPUNIT_ASSERT_THROW(ArraySerialiser::deserialise(buffer, out,
+            QSysInfo::ByteOrder), QString);
+}
+
+void ArraySerialiserTest::test_arrayData()
+{
+    FloatData blob;
+    blob.resize(1000);
+    for (unsigned i = 0; i < blob.size(); ++i) blob.ptr()[i] = float(i) / 3;
+
+    DataBlobVerify verify(&blob);
+    CPPUNIT_ASSERT(verify.verifySerialisedBytes());
+    CPPUNIT_ASSERT(verify.verifyDeserialise());
+}
+
+} // namespace pelican
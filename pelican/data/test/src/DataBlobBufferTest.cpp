@@ -32,6 +32,7 @@
 #include "DataBlobBuffer.h"
 #include "TestDataBlob.h"
 #include "DataBlob.h"
+#include "utility/FactoryGeneric.h"
 
 
 namespace pelican {
@@ -130,6 +131,37 @@ void DataBlobBufferTest::test_shrink()
         }
 }
 
+void DataBlobBufferTest::test_contiguous()
+{
+       // Use Case:
+       // Blobs constructed in contiguous memory, mixed with a heap blob
+       // Expect:
+       // blobs in the same batch to be evenly spaced and cache aligned,
+       // and to be cycled and shrunk like any others
+       FactoryGeneric<DataBlob> factory(false);
+       DataBlobBuffer buffer;
+       buffer.addDataBlobs(&factory, "TestDataBlob", 4);
+       TestDataBlob* heapBlob = new TestDataBlob;
+       buffer.addDataBlob(heapBlob);
+       CPPUNIT_ASSERT_EQUAL((long int)5, buffer.size());
+
+       QVector<DataBlob*> blobs;
+       for(int i=0; i < 5; ++i ) blobs.append(buffer.next());
+       CPPUNIT_ASSERT( blobs[4] == heapBlob );
+       CPPUNIT_ASSERT_EQUAL( std::string("TestDataBlob"), blobs[0]->type().toStdString() );
+       long stride = (char*)blobs[1] - (char*)blobs[0];
+       CPPUNIT_ASSERT( stride >= (long)sizeof(TestDataBlob) );
+       CPPUNIT_ASSERT_EQUAL( 0L, stride % 64 );
+       for(int i=1; i < 4; ++i ) {
+           CPPUNIT_ASSERT_EQUAL( stride, (long)((char*)blobs[i] - (char*)blobs[i-1]) );
+       }
+       CPPUNIT_ASSERT( buffer.next() == blobs[0] );
+
+       // remove all but one of the contiguous blobs.
+       buffer.shrink(2);
+       CPPUNIT_ASSERT_EQUAL((long int)2, buffer.size());
+}
+
 void DataBlobBufferTest::dump(const QVector<TestDataBlob* >& blobs)
 {
         for( int i=0; i < blobs.size(); ++i ) {
@@ -33,6 +33,8 @@
  * @file AbstractEmulator.h
  */
 
+#include "emulator/PacketPacer.h"
+#include "utility/ThreadPlacement.h"
 #include <QtCore/QIODevice>
 
 namespace pelican {
@@ -65,7 +67,8 @@ class AbstractEmulator
         /// Gets one packet of data.
         virtual void getPacketData(char*& ptr, unsigned long& size) = 0;
 
-        /// Returns the interval in microseconds between packets.
+        /// Returns the interval in microseconds between packets
+        /// (used if no pacing rate is set).
         virtual unsigned long interval() { return 100000;}
 
         /// Returns the number of packets to send. If negative, run forever.
@@ -81,8 +84,23 @@ class AbstractEmulator
         /// Called just before the emulator driver exits.
         virtual void emulationFinished() {}
 
+        /// Returns the placement of the emulator driver thread.
+        const ThreadPlacement& threadPlacement() const { return _placement; }
+
+        /// Sets the placement of the emulator driver thread.
+        void setThreadPlacement(const ThreadPlacement& placement)
+        { _placement = placement; }
+
+        /// Returns the pacing settings used by the emulator driver.
+        const PacketPacer& pacing() const { return _pacing; }
+
+        /// Sets the pacing settings used by the emulator driver.
+        void setPacing(const PacketPacer& pacing) { _pacing = pacing; }
+
     private:
         QIODevice* _device; ///< The output device to use.
+        ThreadPlacement _placement; ///< Driver thread placement.
+        PacketPacer _pacing; ///< Driver pacing settings.
 };
 
 } // namespace pelican
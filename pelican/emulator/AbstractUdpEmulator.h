@@ -57,6 +57,27 @@ class ConfigNode;
  * The default values are:
  *
  * @verbatim <connection host="127.0.0.1" port="2001" /> @endverbatim
+ *
+ * The packet rate can be set with a pacing tag (see PacketPacer), e.g.
+ *
+ * @verbatim <pacing rate="1000000" unit="packets" burst="1"/> @endverbatim
+ *
+ * For packet rates beyond a single thread, the emulator driver can instead
+ * send from several threads, each with its own socket (see UdpSender):
+ *
+ * @verbatim
+ * <senders threads="4" batch="64" ring="256" sourcePort="0" sendBuffer="4194304"/>
+ * <sequence offset="0" bytes="8" byteOrder="big" step="1" start="0"/>
+ * @endverbatim
+ *
+ * The packets are taken from a ring of @c ring packets generated with
+ * getPacketData() before sending starts, and sent @c batch packets per
+ * system call. If @c sourcePort is non-zero, thread i sends from port
+ * @c sourcePort + i. If a sequence tag is given, the sequence number of
+ * each packet is written into the @c bytes bytes at @c offset in the
+ * packet, counting from @c start in steps of @c step (the same layout as
+ * read by AbstractUdpChunker). The pacing rate, if any, is shared between
+ * the threads.
  */
 class AbstractUdpEmulator : public AbstractEmulator
 {
@@ -70,9 +91,50 @@ class AbstractUdpEmulator : public AbstractEmulator
         /// Creates an open UDP socket.
         QIODevice* createDevice();
 
+        /// Returns the destination address.
+        const QHostAddress& host() const { return _host; }
+
+        /// Returns the destination port.
+        quint16 port() const { return _port; }
+
+        /// Returns the number of sender threads (0 to send from the driver).
+        int senderThreads() const { return _senderThreads; }
+
+        /// Returns the number of packets sent per system call.
+        int senderBatch() const { return _senderBatch; }
+
+        /// Returns the number of packets in the template ring.
+        int senderRing() const { return _senderRing; }
+
+        /// Returns the first source port of the sender threads (0 for any).
+        quint16 sourcePort() const { return _sourcePort; }
+
+        /// Returns the socket send buffer size (0 for the system default).
+        int sendBuffer() const { return _sendBuffer; }
+
+        /// Returns true if sequence numbers are written into the packets.
+        bool isSequenced() const { return _seqBytes > 0; }
+
+        /// Writes the sequence number of the packet with index @p index.
+        void setPacketSequence(char* packet, quint64 index) const;
+
     private:
         QHostAddress _host;
-        qint16 _port;
+        quint16 _port;
+
+        // Sender threads.
+        int _senderThreads;
+        int _senderBatch;
+        int _senderRing;
+        quint16 _sourcePort;
+        int _sendBuffer;
+
+        // Sequence field.
+        unsigned _seqOffset;
+        int _seqBytes;
+        bool _seqBigEndian;
+        quint64 _seqStart;
+        quint64 _seqStep;
 };
 
 } // namespace pelican
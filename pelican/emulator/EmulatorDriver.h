@@ -42,6 +42,7 @@ class QIODevice;
 namespace pelican {
 
 class AbstractEmulator;
+class AbstractUdpEmulator;
 
 /**
  * @ingroup c_emulator
@@ -56,7 +57,13 @@ class AbstractEmulator;
  * it on destruction.
  *
  * The thread created by this class repeatedly calls getPacketData() on the
- * emulator, and then sleeps for the specified interval.
+ * emulator and writes the packet to the device, pacing the packets with a
+ * PacketPacer. The pacing settings of the emulator are used if they give a
+ * rate; otherwise the packets are sent at the interval() of the emulator.
+ *
+ * If the emulator is an AbstractUdpEmulator with sender threads configured,
+ * the packets are instead sent by that number of UdpSender threads, from a
+ * ring of template packets generated before sending starts.
  */
 class EmulatorDriver : public QThread
 {
@@ -85,6 +92,10 @@ class EmulatorDriver : public QThread
         /// Runs the thread owned by the emulator driver.
         void run();
 
+    private:
+        /// Sends the packets from the sender threads of the emulator.
+        void _runSenders(AbstractUdpEmulator* emulator);
+
     private:
         bool _abort;
         QIODevice* _device;
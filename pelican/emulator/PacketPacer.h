@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PACKETPACER_H
+#define PACKETPACER_H
+
+/**
+ * @file PacketPacer.h
+ */
+
+#include <QtCore/QString>
+
+namespace pelican {
+
+class ConfigNode;
+
+/**
+ * @ingroup c_emulator
+ *
+ * @class PacketPacer
+ *
+ * @brief
+ * Paces the packets sent by an emulator to a target rate.
+ *
+ * @details
+ * The pacer is a token bucket, refilled at the target rate in packets or
+ * bytes per second and holding at most one burst. Before each burst, wait()
+ * blocks until the bucket holds enough tokens for the whole burst; the
+ * packets of the burst are then sent back to back. The time at which the
+ * bucket is full enough is an absolute deadline, so time spent generating
+ * and writing the packets does not add to the interval, and a late packet
+ * is followed by a short catch-up burst (no longer than one burst) rather
+ * than lowering the rate.
+ *
+ * Deadlines further away than the spin threshold are waited for with
+ * clock_nanosleep() on the monotonic clock, waking up one spin threshold
+ * early; the rest is busy-waited, so that intervals of a few microseconds
+ * (e.g. 1 Mpps) are kept without relying on the scheduler.
+ *
+ * The pacer is configured with a pacing tag:
+ * @code
+ * <pacing rate="1000000" unit="packets" burst="1" spin="10" report="0"/>
+ * @endcode
+ * where @c unit is @c packets or @c bytes (per second), @c burst the number
+ * of packets sent back to back, @c spin the busy-wait threshold in
+ * microseconds and @c report the interval in seconds between rate reports
+ * (0 = only at the end). A rate of 0 disables pacing.
+ */
+class PacketPacer
+{
+    public:
+        /// Units of the target rate.
+        enum Unit { Packets, Bytes };
+
+    public:
+        /// Constructs a disabled pacer.
+        PacketPacer();
+
+        /// Reads the pacer settings from the @p tag tag of the configuration.
+        PacketPacer(const ConfigNode& config, const QString& tag = "pacing");
+
+        /// Returns true if a target rate is set.
+        bool isEnabled() const { return _rate > 0.0; }
+
+        /// Sets the target rate in @p unit per second (0 to disable pacing).
+        void setRate(double rate, Unit unit = Packets);
+
+        /// Returns the target rate (in units per second).
+        double rate() const { return _rate; }
+
+        /// Returns the unit of the target rate.
+        Unit unit() const { return _unit; }
+
+        /// Sets the number of packets sent back to back.
+        void setBurst(unsigned burst);
+
+        /// Returns the number of packets sent back to back.
+        unsigned burst() const { return _burst; }
+
+        /// Sets the busy-wait threshold in nanoseconds.
+        void setSpin(quint64 ns) { _spin = ns; }
+
+        /// Returns the busy-wait threshold in nanoseconds.
+        quint64 spin() const { return _spin; }
+
+        /// Sets the interval between rate reports in seconds (0 = none).
+        void setReportInterval(double seconds) { _reportInterval = seconds; }
+
+        /// Resets the counters and starts pacing from now.
+        void start();
+
+        /// Waits until a packet of @p bytes may be sent, and counts it.
+        void wait(quint64 bytes);
+
+        /// Returns true (once per report interval) if a report is due.
+        bool reportDue();
+
+        /// Returns the number of packets counted since start().
+        quint64 packets() const { return _packets; }
+
+        /// Returns the number of bytes counted since start().
+        quint64 bytes() const { return _bytes; }
+
+        /// Returns the number of times the sender fell more than a burst
+        /// behind the target rate.
+        quint64 late() const { return _late; }
+
+        /// Returns the time in seconds from start() to the last packet.
+        double elapsed() const;
+
+        /// Returns the achieved rate, in packets per second.
+        double packetRate() const;
+
+        /// Returns the achieved rate, in bytes per second.
+        double byteRate() const;
+
+        /// Returns a report of the achieved rate against the target.
+        QString report() const;
+
+        /// Waits until the monotonic clock reaches @p deadline (ns),
+        /// sleeping until @p spin ns before it and busy-waiting the rest.
+        static void waitUntil(quint64 deadline, quint64 spin);
+
+    private:
+        double _rate;
+        Unit _unit;
+        unsigned _burst;
+        quint64 _spin;
+        double _reportInterval;
+
+        double _nsPerUnit;     ///< Token refill period in ns.
+        double _next;          ///< Time (ns) at which the bucket is empty.
+        quint64 _start;        ///< Start time (ns).
+        quint64 _now;          ///< Time (ns) of the last packet.
+        quint64 _lastReport;   ///< Time (ns) of the last report.
+        quint64 _packets;
+        quint64 _bytes;
+        quint64 _late;
+};
+
+} // namespace pelican
+
+#endif // PACKETPACER_H
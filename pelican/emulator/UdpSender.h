@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef UDPSENDER_H
+#define UDPSENDER_H
+
+/**
+ * @file UdpSender.h
+ */
+
+#include "emulator/PacketPacer.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+namespace pelican {
+
+class AbstractUdpEmulator;
+
+/**
+ * @ingroup c_emulator
+ *
+ * @class UdpSender
+ *
+ * @brief
+ * Sends UDP packets from a template ring in batches, from its own thread.
+ *
+ * @details
+ * The EmulatorDriver runs one UdpSender for each of the sender threads
+ * configured for an AbstractUdpEmulator. Each sender has its own socket
+ * (bound to its own source port if one is given), connected to the host
+ * and port of the emulator, and its own copy of the ring of template
+ * packets generated by the emulator, so that the sequence numbers can be
+ * written into the packets without locking.
+ *
+ * Packets are sent in blocks of the batch size with one sendmmsg() call
+ * (on Linux; one send() per packet elsewhere). Sender @c i of @c n sends
+ * the blocks @c i, @c i+n, @c i+2n, ... of the packet sequence, so that
+ * together the senders send each packet index exactly once, in roughly
+ * increasing order. Packet @c k is sent from template packet @c k modulo
+ * the ring size.
+ */
+class UdpSender : public QThread
+{
+    public:
+        /// Constructs sender @p index of @p count for the emulator, sending
+        /// the packets of @p ring, and @p packets packets in total between
+        /// all senders (negative to send forever).
+        UdpSender(const AbstractUdpEmulator* emulator, int index, int count,
+                const QList<QByteArray>& ring, qint64 packets,
+                const PacketPacer& pacer);
+
+        /// Stops the sender and waits for its thread to finish.
+        ~UdpSender();
+
+        /// Stops the sender.
+        void abort() { _abort = true; }
+
+        /// Returns the number of packets sent.
+        quint64 packetCount() const { return _packetCount; }
+
+        /// Returns the number of bytes sent.
+        quint64 dataCount() const { return _dataCount; }
+
+        /// Returns the time in seconds spent sending.
+        double elapsed() const { return _elapsed; }
+
+        /// Returns the number of send system calls.
+        quint64 calls() const { return _calls; }
+
+        /// Returns true if the sender stopped on an error.
+        bool failed() const { return _failed; }
+
+    protected:
+        /// Sends the packets.
+        void run();
+
+    private:
+        /// Creates the socket, connected to the emulator host and port.
+        int _socket();
+
+        /// Sends @p count packets starting at @p slot of the ring,
+        /// returning false on error.
+        bool _send(int socket, int slot, int count);
+
+    private:
+        const AbstractUdpEmulator* _emulator;
+        int _index;
+        int _count;
+        qint64 _packets;
+        PacketPacer _pacer;
+        QVector<QByteArray> _ring;
+        volatile bool _abort;
+        bool _failed;
+        volatile quint64 _packetCount;
+        volatile quint64 _dataCount;
+        quint64 _calls;
+        double _elapsed;
+#if defined(__linux__)
+        QVector<struct mmsghdr> _messages;
+        QVector<struct iovec> _iovecs;
+#endif
+};
+
+} // namespace pelican
+
+#endif // UDPSENDER_H
@@ -43,7 +43,46 @@ AbstractUdpEmulator::AbstractUdpEmulator(const ConfigNode& configNode)
 {
     _host = QHostAddress(configNode.getOption("connection", "host",
             "127.0.0.1"));
-    _port = configNode.getOption("connection", "port", "2001").toShort();
+    _port = configNode.getOption("connection", "port", "2001").toUShort();
+    setThreadPlacement(ThreadPlacement(configNode));
+    setPacing(PacketPacer(configNode));
+
+    // Sender threads.
+    _senderThreads = configNode.getOption("senders", "threads", "0").toInt();
+    _senderBatch = configNode.getOption("senders", "batch", "64").toInt();
+    _senderRing = configNode.getOption("senders", "ring", "256").toInt();
+    _sourcePort = configNode.getOption("senders", "sourcePort", "0").toUShort();
+    _sendBuffer = configNode.getOption("senders", "sendBuffer", "4194304").toInt();
+    if (_senderThreads < 0 || _senderBatch < 1 || _senderRing < 1)
+        throw QString("AbstractUdpEmulator: Invalid sender settings.");
+    _senderBatch = qMin(_senderBatch, 1024);
+    _senderRing = qMax(_senderRing, _senderBatch);
+
+    // Sequence field.
+    _seqOffset = configNode.getOption("sequence", "offset", "0").toUInt();
+    _seqBytes = configNode.getOption("sequence", "bytes", "0").toInt();
+    _seqBigEndian = configNode.getOption("sequence", "byteOrder",
+            "big").toLower() != "little";
+    _seqStart = configNode.getOption("sequence", "start", "0").toULongLong();
+    _seqStep = configNode.getOption("sequence", "step", "1").toULongLong();
+    if (_seqBytes < 0 || _seqBytes > 8)
+        throw QString("AbstractUdpEmulator: Invalid sequence field.");
+}
+
+/**
+ * @details
+ * Writes the sequence number of the packet with index @p index (counting
+ * from zero) into the sequence field of @p packet, truncated to the width
+ * of the field.
+ */
+void AbstractUdpEmulator::setPacketSequence(char* packet, quint64 index) const
+{
+    quint64 value = _seqStart + index * _seqStep;
+    uchar* p = (uchar*)packet + _seqOffset;
+    for (int i = 0; i < _seqBytes; ++i) {
+        p[_seqBigEndian ? _seqBytes - 1 - i : i] = uchar(value);
+        value >>= 8;
+    }
 }
 
 /**
@@ -28,12 +28,14 @@
 
 #include "emulator/EmulatorDriver.h"
 #include "emulator/AbstractEmulator.h"
+#include "emulator/AbstractUdpEmulator.h"
+#include "emulator/PacketPacer.h"
+#include "emulator/UdpSender.h"
 
 #include <QtCore/QIODevice>
 #include <QtCore/QCoreApplication>
 #include <QtNetwork/QAbstractSocket>
 #include <QtNetwork/QTcpSocket>
-#include <QtCore/QTime>
 
 #include <typeinfo>
 #include <iostream>
@@ -77,8 +79,19 @@ EmulatorDriver::~EmulatorDriver()
  */
 void EmulatorDriver::run()
 {
-//    QTime correctionTimer;
     try {
+        _emulator->threadPlacement().apply("EmulatorDriver");
+
+        // Send from several threads if configured.
+        AbstractUdpEmulator* udp = dynamic_cast<AbstractUdpEmulator*>(_emulator);
+        if (udp && udp->senderThreads() > 0) {
+            sleep(_emulator->startDelay());
+            _runSenders(udp);
+            if (!_abort)
+                _emulator->emulationFinished();
+            return;
+        }
+
         // Create the device.
         _device = _emulator->createDevice();
         _emulator->setDevice(_device); // The base class deletes the device.
@@ -89,11 +102,14 @@ void EmulatorDriver::run()
         _packetCount = 0;
         _dataCount = 0;
 
+        // Without a configured rate, pace by the emulator interval.
+        PacketPacer pacer = _emulator->pacing();
+        bool paced = pacer.isEnabled();
+        pacer.start();
+
         // Enter loop.
         while (!_abort && (_packetCount < _emulator->nPackets() || continuous))
         {
-//            correctionTimer.restart();
-
             // Get the data.
             char* ptr = 0;
             unsigned long size = 0;
@@ -101,13 +117,20 @@ void EmulatorDriver::run()
             if (ptr == 0 || size == 0)
                 break;
 
+            // Wait for the deadline of the packet.
+            if (!paced) {
+                unsigned long interval = _emulator->interval();
+                pacer.setRate(interval != 0 ? 1e6 / interval : 0.0);
+            }
+            pacer.wait(size);
+
             _dataCount += size;
 
             // Write to the device.
-//            std::cout << "Emulator driver write START. " << _device->bytesAvailable() << " size=" << size << std::endl;
             _device->write(ptr, size);
 
-            // Block until all data has been written to the device.
+            // Block until all data has been written to the device
+            // (UDP sockets are unbuffered, so this does not wait).
             if (typeid(*_device) == typeid(QTcpSocket)) {
                 while (_device->bytesToWrite() > 0) {
                     if (static_cast<QAbstractSocket*>(_device)->state()
@@ -123,25 +146,19 @@ void EmulatorDriver::run()
                 while (_device->bytesToWrite() > 0)
                     _device->waitForBytesWritten(-1);
             }
-
-            // Sleep for the specified interval, correcting for time taken
-            // in creating and sending the data.
-            unsigned long interval = _emulator->interval();
-            if (interval != 0) {
-                // Correct interval for time taken in sending the data.
-//                int correction = correctionTimer.elapsed()*1000;
-//                usleep(interval - correction);
-                usleep(interval);
-            }
             ++_packetCount;
 
-            //std::cout << "Emulator driver write DONE. " << _device->bytesAvailable() << std::endl;
-
+            if (pacer.reportDue())
+                cout << "EmulatorDriver: " << pacer.report().toStdString() << endl;
 
 #if QT_VERSION >= 0x040300
-            yieldCurrentThread();
+            // Paced threads give up the CPU while waiting for deadlines.
+            if (!pacer.isEnabled())
+                yieldCurrentThread();
 #endif
         }
+        if (paced)
+            cout << "EmulatorDriver: " << pacer.report().toStdString() << endl;
         if (!_abort)
             _emulator->emulationFinished();
     }
@@ -154,4 +171,76 @@ void EmulatorDriver::run()
     }
 }
 
+/**
+ * @details
+ * Sends the packets from the sender threads of the UDP emulator (see
+ * UdpSender). The template ring is generated first by calling
+ * getPacketData() once for each slot, and the pacing rate (or the rate
+ * given by the emulator interval) is divided between the threads.
+ */
+void EmulatorDriver::_runSenders(AbstractUdpEmulator* emulator)
+{
+    // Generate the template packets.
+    QList<QByteArray> ring;
+    for (int i = 0; i < emulator->senderRing(); ++i) {
+        char* ptr = 0;
+        unsigned long size = 0;
+        emulator->getPacketData(ptr, size);
+        if (ptr == 0 || size == 0)
+            break;
+        ring.append(QByteArray(ptr, int(size)));
+    }
+    if (ring.isEmpty())
+        return;
+
+    int threads = emulator->senderThreads();
+    PacketPacer pacer = emulator->pacing();
+    if (!pacer.isEnabled() && emulator->interval() != 0)
+        pacer.setRate(1e6 / emulator->interval());
+    if (pacer.isEnabled())
+        pacer.setRate(pacer.rate() / threads, pacer.unit());
+
+    QList<UdpSender*> senders;
+    for (int i = 0; i < threads; ++i) {
+        senders.append(new UdpSender(emulator, i, threads, ring,
+                emulator->nPackets(), pacer));
+        senders.last()->start();
+    }
+
+    // Wait for the senders, updating the counts.
+    bool failed = false;
+    double elapsed = 0.0;
+    for (int i = 0; i < senders.size(); ) {
+        if (senders[i]->wait(100)) {
+            failed = failed || senders[i]->failed();
+            elapsed = qMax(elapsed, senders[i]->elapsed());
+            ++i;
+        }
+        else if (_abort) {
+            foreach (UdpSender* sender, senders)
+                sender->abort();
+        }
+        _packetCount = 0;
+        _dataCount = 0;
+        foreach (UdpSender* sender, senders) {
+            _packetCount += sender->packetCount();
+            _dataCount += sender->dataCount();
+        }
+    }
+
+    quint64 calls = 0;
+    foreach (UdpSender* sender, senders)
+        calls += sender->calls();
+    qDeleteAll(senders);
+
+    cout << "EmulatorDriver: " << threads << " senders sent " << _packetCount
+         << " packets (" << _dataCount << " bytes) in " << elapsed << " s: "
+         << (elapsed > 0.0 ? _packetCount / elapsed : 0.0) << " packets/s, "
+         << (elapsed > 0.0 ? _dataCount * 8e-9 / elapsed : 0.0) << " Gbit/s, "
+         << (calls ? double(_packetCount) / calls : 0.0)
+         << " packets per call" << endl;
+    if (failed)
+        _abort = true;
+}
+
 } // namespace pelican
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "emulator/PacketPacer.h"
+#include "utility/ConfigNode.h"
+#include "utility/TimingRecorder.h"
+
+#include <cerrno>
+#include <ctime>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a disabled pacer, which only counts packets.
+ */
+PacketPacer::PacketPacer()
+: _rate(0.0), _unit(Packets), _burst(1), _spin(10000), _reportInterval(0.0),
+  _nsPerUnit(0.0), _next(0.0), _start(0), _now(0), _lastReport(0),
+  _packets(0), _bytes(0), _late(0)
+{
+}
+
+/**
+ * @details
+ * Reads the @c rate, @c unit, @c burst, @c spin and @c report attributes of
+ * the @p tag tag.
+ */
+PacketPacer::PacketPacer(const ConfigNode& config, const QString& tag)
+: _rate(0.0), _unit(Packets), _burst(1), _spin(10000), _reportInterval(0.0),
+  _nsPerUnit(0.0), _next(0.0), _start(0), _now(0), _lastReport(0),
+  _packets(0), _bytes(0), _late(0)
+{
+    QString unit = config.getOption(tag, "unit", "packets").toLower();
+    if (unit != "packets" && unit != "bytes")
+        throw QString("PacketPacer: Unknown rate unit '%1'.").arg(unit);
+    setRate(config.getOption(tag, "rate", "0").toDouble(),
+            unit == "bytes" ? Bytes : Packets);
+    setBurst(config.getOption(tag, "burst", "1").toUInt());
+    _spin = quint64(config.getOption(tag, "spin", "10").toDouble() * 1e3);
+    _reportInterval = config.getOption(tag, "report", "0").toDouble();
+}
+
+
+void PacketPacer::setRate(double rate, Unit unit)
+{
+    if (rate < 0.0)
+        throw QString("PacketPacer: Invalid rate %1.").arg(rate);
+    _rate = rate;
+    _unit = unit;
+    _nsPerUnit = rate > 0.0 ? 1e9 / rate : 0.0;
+}
+
+
+void PacketPacer::setBurst(unsigned burst)
+{
+    if (burst == 0)
+        throw QString("PacketPacer: Burst must be at least one packet.");
+    _burst = burst;
+}
+
+
+void PacketPacer::start()
+{
+    _start = _now = _lastReport = TimingRecorder::now();
+    _next = double(_start);
+    _packets = _bytes = _late = 0;
+}
+
+
+/**
+ * @details
+ * At the start of each burst, waits for the deadline at which the bucket
+ * holds enough tokens for the burst; the other packets of the burst are
+ * passed straight through. If the sender has fallen behind, the backlog is
+ * limited to one burst, so that the rate is never exceeded for longer than
+ * a burst.
+ */
+void PacketPacer::wait(quint64 bytes)
+{
+    quint64 now = TimingRecorder::now();
+    if (_nsPerUnit > 0.0) {
+        double cost = (_unit == Packets ? 1.0 : double(bytes)) * _nsPerUnit;
+        if (_packets % _burst == 0) {
+            double backlog = double(_burst) * cost;
+            if (double(now) > _next + backlog) {
+                ++_late;
+                _next = double(now) - backlog;
+            }
+            quint64 deadline = quint64(_next);
+            if (now < deadline) {
+                waitUntil(deadline, _spin);
+                now = deadline;
+            }
+        }
+        _next += cost;
+    }
+    _now = now;
+    ++_packets;
+    _bytes += bytes;
+}
+
+
+bool PacketPacer::reportDue()
+{
+    if (_reportInterval <= 0.0 ||
+            double(_now - _lastReport) < _reportInterval * 1e9)
+        return false;
+    _lastReport = _now;
+    return true;
+}
+
+
+double PacketPacer::elapsed() const
+{
+    return double(_now - _start) * 1e-9;
+}
+
+
+double PacketPacer::packetRate() const
+{
+    double t = elapsed();
+    return t > 0.0 ? double(_packets) / t : 0.0;
+}
+
+
+double PacketPacer::byteRate() const
+{
+    double t = elapsed();
+    return t > 0.0 ? double(_bytes) / t : 0.0;
+}
+
+
+/**
+ * @details
+ * Returns a report such as
+ * "1000000 packets (8208000000 bytes) in 1.000 s: 999998 packets/s,
+ * 65.66 Gbit/s; target 1000000 packets/s (100.0%), 0 late bursts".
+ */
+QString PacketPacer::report() const
+{
+    QString s = QString("%1 packets (%2 bytes) in %3 s: %4 packets/s, "
+            "%5 Gbit/s").arg(_packets).arg(_bytes).arg(elapsed(), 0, 'f', 3)
+            .arg(packetRate(), 0, 'f', 0).arg(byteRate() * 8e-9, 0, 'f', 3);
+    if (isEnabled()) {
+        double achieved = _unit == Packets ? packetRate() : byteRate();
+        s += QString("; target %1 %2/s (%3%), %4 late bursts").arg(_rate, 0,
+                'f', 0).arg(_unit == Packets ? "packets" : "bytes")
+                .arg(100.0 * achieved / _rate, 0, 'f', 1).arg(_late);
+    }
+    return s;
+}
+
+
+/**
+ * @details
+ * Sleeps on the monotonic clock with an absolute deadline (so that
+ * oversleeping does not accumulate) and busy-waits the last @p spin ns.
+ */
+void PacketPacer::waitUntil(quint64 deadline, quint64 spin)
+{
+    quint64 now = TimingRecorder::now();
+    if (now >= deadline)
+        return;
+
+    if (deadline - now > spin) {
+        quint64 wake = deadline - spin;
+        timespec t;
+#if defined(__linux__)
+        t.tv_sec = time_t(wake / Q_UINT64_C(1000000000));
+        t.tv_nsec = long(wake % Q_UINT64_C(1000000000));
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, 0) == EINTR)
+            ;
+#else
+        quint64 ns = wake - now;
+        t.tv_sec = time_t(ns / Q_UINT64_C(1000000000));
+        t.tv_nsec = long(ns % Q_UINT64_C(1000000000));
+        while (nanosleep(&t, &t) != 0 && errno == EINTR)
+            ;
+#endif
+    }
+
+    while (TimingRecorder::now() < deadline)
+        ;
+}
+
+} // namespace pelican
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "emulator/UdpSender.h"
+#include "emulator/AbstractUdpEmulator.h"
+#include "utility/TimingRecorder.h"
+
+#include <QtNetwork/QHostAddress>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs the sender. The template packets of @p ring are shared until
+ * the thread first writes to them. The @p pacer gives the rate of this sender alone.
+ */
+UdpSender::UdpSender(const AbstractUdpEmulator* emulator, int index,
+        int count, const QList<QByteArray>& ring, qint64 packets,
+        const PacketPacer& pacer)
+: QThread(), _emulator(emulator), _index(index), _count(count),
+  _packets(packets), _pacer(pacer), _ring(ring.toVector()), _abort(false),
+  _failed(false), _packetCount(0), _dataCount(0), _calls(0), _elapsed(0.0)
+{
+    if (_ring.isEmpty() || _count < 1)
+        throw QString("UdpSender: No packets to send.");
+}
+
+
+UdpSender::~UdpSender()
+{
+    _abort = true;
+    wait();
+}
+
+
+/**
+ * @details
+ * Sends blocks of packets until the packet count is reached, the sender
+ * is aborted or a send fails.
+ */
+void UdpSender::run()
+{
+    _emulator->threadPlacement().apply(QString("UdpSender %1").arg(_index));
+
+    int socket = -1;
+    try {
+        socket = _socket();
+    }
+    catch (const QString& e) {
+        std::cerr << "UdpSender: " << e.toStdString() << std::endl;
+        _failed = true;
+        return;
+    }
+
+    // A block must not use a ring slot twice, as each slot is patched
+    // with the sequence number of its packet.
+    const int ringSize = _ring.size();
+    const quint64 batch = qMin(_emulator->senderBatch(), ringSize);
+    const bool sequenced = _emulator->isSequenced();
+#if defined(__linux__)
+    _messages.resize(int(batch));
+    _iovecs.resize(int(batch));
+#endif
+
+    quint64 start = TimingRecorder::now();
+    _pacer.start();
+    for (quint64 block = _index; !_abort; block += _count) {
+        quint64 first = block * batch;
+        if (_packets >= 0 && first >= quint64(_packets))
+            break;
+        int n = int(batch);
+        if (_packets >= 0)
+            n = int(qMin(batch, quint64(_packets) - first));
+
+        // Packet k is sent from template k (modulo the ring size).
+        int slot = int(first % ringSize);
+        for (int i = 0, s = slot; i < n; ++i, s = (s + 1) % ringSize) {
+            if (sequenced)
+                _emulator->setPacketSequence(_ring[s].data(), first + i);
+            if (_pacer.isEnabled())
+                _pacer.wait(_ring[s].size());
+        }
+        if (!_send(socket, slot, n)) {
+            _failed = true;
+            break;
+        }
+    }
+    _elapsed = double(TimingRecorder::now() - start) * 1e-9;
+    ::close(socket);
+}
+
+
+/**
+ * @details
+ * Creates a UDP socket with the send buffer size of the emulator, bound to
+ * the source port of this sender if one is set, and connected to the host
+ * and port of the emulator.
+ */
+int UdpSender::_socket()
+{
+    int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket < 0)
+        throw QString("Unable to create socket: %1").arg(strerror(errno));
+
+    int sendBuffer = _emulator->sendBuffer();
+    if (sendBuffer > 0) {
+        ::setsockopt(socket, SOL_SOCKET, SO_SNDBUF, &sendBuffer,
+                sizeof(sendBuffer));
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    if (_emulator->sourcePort() != 0) {
+        quint16 port = quint16(_emulator->sourcePort() + _index);
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (::bind(socket, (struct sockaddr*)&address, sizeof(address)) < 0) {
+            QString error(strerror(errno));
+            ::close(socket);
+            throw QString("Unable to bind to port %1: %2").arg(port).arg(error);
+        }
+    }
+
+    address.sin_port = htons(_emulator->port());
+    address.sin_addr.s_addr = htonl(_emulator->host().toIPv4Address());
+    if (::connect(socket, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        QString error(strerror(errno));
+        ::close(socket);
+        throw QString("Unable to connect to %1:%2: %3")
+                .arg(_emulator->host().toString()).arg(_emulator->port())
+                .arg(error);
+    }
+    return socket;
+}
+
+
+/**
+ * @details
+ * Sends the @p count packets starting at ring slot @p slot. Errors caused
+ * by the receiver (a closed port reported by an earlier packet) or by a
+ * momentary lack of buffers are retried.
+ */
+bool UdpSender::_send(int socket, int slot, int count)
+{
+    const int ringSize = _ring.size();
+    quint64 bytes = 0;
+#if defined(__linux__)
+    struct mmsghdr* messages = _messages.data();
+    struct iovec* iovecs = _iovecs.data();
+    memset(messages, 0, count * sizeof(struct mmsghdr));
+    for (int i = 0, s = slot; i < count; ++i, s = (s + 1) % ringSize) {
+        iovecs[i].iov_base = _ring[s].data();
+        iovecs[i].iov_len = _ring[s].size();
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        bytes += _ring[s].size();
+    }
+    int sent = 0;
+    while (sent < count && !_abort) {
+        int n = ::sendmmsg(socket, messages + sent, count - sent, 0);
+        if (n < 0) {
+            if (errno == EINTR || errno == ECONNREFUSED || errno == ENOBUFS
+                    || errno == EAGAIN)
+                continue;
+            break;
+        }
+        ++_calls;
+        sent += n;
+    }
+#else
+    int sent = 0;
+    for (int s = slot; sent < count && !_abort; ) {
+        ssize_t n = ::send(socket, _ring[s].constData(), _ring[s].size(), 0);
+        if (n < 0) {
+            if (errno == EINTR || errno == ECONNREFUSED || errno == ENOBUFS
+                    || errno == EAGAIN)
+                continue;
+            break;
+        }
+        ++_calls;
+        bytes += _ring[s].size();
+        ++sent;
+        s = (s + 1) % ringSize;
+    }
+#endif
+    if (sent < count) {
+        if (_abort)
+            return true;
+        std::cerr << "UdpSender " << _index << ": Send failed: "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    _packetCount += count;
+    _dataCount += bytes;
+    return true;
+}
+
+} // namespace pelican
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PACKETPACERTEST_H
+#define PACKETPACERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+/**
+ * @file PacketPacerTest.h
+ */
+
+namespace pelican {
+
+/**
+ * @ingroup t_emulator
+ *
+ * @class PacketPacerTest
+ *
+ * @brief
+ * Unit testing class for the emulator packet pacer.
+ *
+ * @details
+ */
+class PacketPacerTest : public CppUnit::TestFixture
+{
+    public:
+        CPPUNIT_TEST_SUITE( PacketPacerTest );
+        CPPUNIT_TEST( test_configuration );
+        CPPUNIT_TEST( test_packetRate );
+        CPPUNIT_TEST( test_byteRate );
+        CPPUNIT_TEST( test_burst );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {}
+        void tearDown() {}
+
+        // Test Methods
+        void test_configuration();
+        void test_packetRate();
+        void test_byteRate();
+        void test_burst();
+
+    public:
+        PacketPacerTest() : CppUnit::TestFixture() {}
+        ~PacketPacerTest() {}
+};
+
+} // namespace pelican
+
+#endif // PACKETPACERTEST_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "emulator/test/PacketPacerTest.h"
+#include "emulator/PacketPacer.h"
+#include "utility/ConfigNode.h"
+#include "utility/TimingRecorder.h"
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PacketPacerTest );
+
+void PacketPacerTest::test_configuration()
+{
+    {
+        PacketPacer pacer(ConfigNode("<Emulator/>"));
+        CPPUNIT_ASSERT(!pacer.isEnabled());
+        CPPUNIT_ASSERT_EQUAL(1u, pacer.burst());
+        CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(10000), pacer.spin());
+    }
+    {
+        ConfigNode node("<Emulator><pacing rate=\"1e9\" unit=\"bytes\" "
+                "burst=\"8\" spin=\"2.5\"/></Emulator>");
+        PacketPacer pacer(node);
+        CPPUNIT_ASSERT(pacer.isEnabled());
+        CPPUNIT_ASSERT_EQUAL(1e9, pacer.rate());
+        CPPUNIT_ASSERT(pacer.unit() == PacketPacer::Bytes);
+        CPPUNIT_ASSERT_EQUAL(8u, pacer.burst());
+        CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(2500), pacer.spin());
+    }
+    CPPUNIT_ASSERT_THROW(PacketPacer(ConfigNode("<Emulator>"
+            "<pacing unit=\"frames\"/></Emulator>")), QString);
+    CPPUNIT_ASSERT_THROW(PacketPacer(ConfigNode("<Emulator>"
+            "<pacing burst=\"0\"/></Emulator>")), QString);
+}
+
+void PacketPacerTest::test_packetRate()
+{
+    // 20000 packets at 1 Mpps: 2 us intervals, all busy-waited.
+    PacketPacer pacer;
+    pacer.setRate(1e6);
+    pacer.start();
+    for (int i = 0; i < 20000; ++i)
+        pacer.wait(1024);
+    CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(20000), pacer.packets());
+    CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(20000) * 1024, pacer.bytes());
+    CPPUNIT_ASSERT(pacer.elapsed() >= 0.0198);
+    CPPUNIT_ASSERT(pacer.packetRate() <= 1.001e6);
+    CPPUNIT_ASSERT(pacer.packetRate() > 0.9e6);
+
+    // 200 packets at 10 kpps: 100 us intervals, mostly slept.
+    pacer.setRate(1e4);
+    pacer.start();
+    for (int i = 0; i < 200; ++i)
+        pacer.wait(1024);
+    CPPUNIT_ASSERT(pacer.elapsed() >= 0.0198);
+    CPPUNIT_ASSERT(pacer.packetRate() <= 1.01e4);
+    CPPUNIT_ASSERT(pacer.packetRate() > 0.9e4);
+    CPPUNIT_ASSERT(pacer.report().contains("target 10000 packets/s"));
+}
+
+void PacketPacerTest::test_byteRate()
+{
+    // 100 MB/s with 10 kB packets: 100 us intervals.
+    PacketPacer pacer;
+    pacer.setRate(1e8, PacketPacer::Bytes);
+    pacer.start();
+    for (int i = 0; i < 200; ++i)
+        pacer.wait(10000);
+    CPPUNIT_ASSERT(pacer.elapsed() >= 0.0198);
+    CPPUNIT_ASSERT(pacer.byteRate() <= 1.01e8);
+    CPPUNIT_ASSERT(pacer.byteRate() > 0.9e8);
+}
+
+void PacketPacerTest::test_burst()
+{
+    // Bursts of 10 packets every 1 ms.
+    PacketPacer pacer;
+    pacer.setRate(1e4);
+    pacer.setBurst(10);
+    quint64 start = TimingRecorder::now();
+    pacer.start();
+    for (int i = 0; i < 10; ++i)
+        pacer.wait(100);
+    // The first burst is sent without waiting.
+    CPPUNIT_ASSERT(TimingRecorder::now() - start < Q_UINT64_C(500000));
+
+    // The next burst starts 1 ms after the first.
+    pacer.wait(100);
+    CPPUNIT_ASSERT(TimingRecorder::now() - start >= Q_UINT64_C(1000000));
+    for (int i = 0; i < 89; ++i)
+        pacer.wait(100);
+    CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(100), pacer.packets());
+    CPPUNIT_ASSERT(pacer.elapsed() >= 0.0089);
+    CPPUNIT_ASSERT(pacer.packetRate() > 0.9e4);
+}
+
+} // namespace pelican
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "emulator/test/UdpSenderTest.h"
+#include "emulator/test/RealUdpEmulator.h"
+#include "emulator/EmulatorDriver.h"
+#include "utility/ConfigNode.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSet>
+#include <QtNetwork/QUdpSocket>
+
+namespace pelican {
+
+using test::RealUdpEmulator;
+
+CPPUNIT_TEST_SUITE_REGISTRATION( UdpSenderTest );
+
+void UdpSenderTest::test_sequence()
+{
+    ConfigNode config("<RealUdpEmulator>"
+            "<packet size=\"64\"/>"
+            "<sequence offset=\"2\" bytes=\"4\" byteOrder=\"little\" "
+            "start=\"5\" step=\"2\"/>"
+            "</RealUdpEmulator>");
+    RealUdpEmulator emulator(config);
+    CPPUNIT_ASSERT(emulator.isSequenced());
+    CPPUNIT_ASSERT_EQUAL(0, emulator.senderThreads());
+
+    // Packet 3: 5 + 3 * 2 = 11.
+    QByteArray packet(8, char(0xff));
+    emulator.setPacketSequence(packet.data(), 3);
+    CPPUNIT_ASSERT_EQUAL(char(0xff), packet[1]);
+    CPPUNIT_ASSERT_EQUAL(char(11), packet[2]);
+    CPPUNIT_ASSERT_EQUAL(char(0), packet[3]);
+    CPPUNIT_ASSERT_EQUAL(char(0), packet[5]);
+    CPPUNIT_ASSERT_EQUAL(char(0xff), packet[6]);
+
+    CPPUNIT_ASSERT_THROW(RealUdpEmulator(ConfigNode("<RealUdpEmulator>"
+            "<senders threads=\"-1\"/></RealUdpEmulator>")), QString);
+}
+
+void UdpSenderTest::test_send()
+{
+    QUdpSocket receiver;
+    CPPUNIT_ASSERT(receiver.bind(QHostAddress::LocalHost, 2007));
+
+    ConfigNode config("<RealUdpEmulator>"
+            "<connection host=\"127.0.0.1\" port=\"2007\"/>"
+            "<packet size=\"256\" interval=\"0\" number=\"100\"/>"
+            "<senders threads=\"3\" batch=\"8\" ring=\"16\"/>"
+            "<sequence offset=\"0\" bytes=\"8\"/>"
+            "</RealUdpEmulator>");
+    {
+        EmulatorDriver driver(new RealUdpEmulator(config));
+        CPPUNIT_ASSERT(driver.wait(10000));
+        CPPUNIT_ASSERT_EQUAL(100L, driver.packetCount());
+        CPPUNIT_ASSERT_EQUAL(100UL * 256, driver.dataCount());
+    }
+
+    // Each packet index is sent once, from the template packets.
+    QSet<quint64> received;
+    while (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(500)) {
+        QByteArray packet(int(receiver.pendingDatagramSize()), 0);
+        receiver.readDatagram(packet.data(), packet.size());
+        CPPUNIT_ASSERT_EQUAL(256, packet.size());
+        quint64 sequence = 0;
+        for (int i = 0; i < 8; ++i)
+            sequence = (sequence << 8) | uchar(packet[i]);
+        received.insert(sequence);
+        // The rest of the packet is the value of its template.
+        double value = reinterpret_cast<const double*>(packet.constData())[1];
+        CPPUNIT_ASSERT_EQUAL(double(sequence % 16), value);
+    }
+    CPPUNIT_ASSERT_EQUAL(100, received.size());
+    CPPUNIT_ASSERT(received.contains(0));
+    CPPUNIT_ASSERT(received.contains(99));
+}
+
+} // namespace pelican
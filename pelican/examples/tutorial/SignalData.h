@@ -30,6 +30,9 @@ class SignalData : public DataBlob
         // Serialises the data blob.
         void serialise(QIODevice& out) const;
 
+        // Returns the number of bytes written by serialise().
+        quint64 serialisedBytes() const;
+
         // Deserialises the data blob.
         void deserialise(QIODevice& in, QSysInfo::Endian);
 
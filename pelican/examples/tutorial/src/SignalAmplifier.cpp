@@ -1,6 +1,8 @@
 #include "tutorial/SignalAmplifier.h"
 #include "tutorial/SignalData.h"
 #include "utility/Config.h"
+#include "utility/TimingRecorder.h"
+#include "utility/Tracer.h"
 
 // Construct the example module.
 SignalAmplifier::SignalAmplifier(const ConfigNode& config)
@@ -13,6 +15,10 @@ SignalAmplifier::SignalAmplifier(const ConfigNode& config)
 // Runs the module.
 void SignalAmplifier::run(const SignalData* input, SignalData* output)
 {
+    // Time and trace the module (if enabled in the pipeline configuration).
+    TimingRecorder::Scope timer(timingRecorder(), timingTag());
+    Tracer::Scope trace(traceName());
+
     // Ensure the output storage data is big enough.
     unsigned nPts = input->size();
     if (output->size() != nPts)
@@ -1,31 +1,24 @@
 #include "tutorial/SignalData.h"
-#include <QtCore/QDataStream>
+#include "data/ArraySerialiser.h"
 
 // Serialises the data blob.
 void SignalData::serialise(QIODevice& out) const
 {
-    QDataStream stream(&out);
-
-    // Write the number of samples in the time series.
-    unsigned samples = size();
-    stream << samples;
+    // Write the number of samples in the time series, followed by
+    // the samples themselves in a single block of memory.
+    ArraySerialiser::serialise(out, _data);
+}
 
-    // Write the data to the output device.
-    const float* data = ptr();
-    for (unsigned i = 0; i < samples; ++i) stream << data[i];
+// Returns the number of bytes written by serialise().
+quint64 SignalData::serialisedBytes() const
+{
+    return ArraySerialiser::serialisedBytes(_data);
 }
 
 // Deserialises the data blob.
-void SignalData::deserialise(QIODevice& in, QSysInfo::Endian)
+void SignalData::deserialise(QIODevice& in, QSysInfo::Endian endian)
 {
-    QDataStream stream(&in);
-
-    // Read the number of samples in the time series.
-    unsigned samples = 0;
-    stream >> samples;
-
-    // Set the size of the blob and read the data into it.
-    resize(samples);
-    float* data = ptr();
-    for (unsigned i = 0; i < samples; ++i) stream >> data[i];
+    // Read the number of samples, resize the blob and read the data into it,
+    // swapping the byte order if it was written on a different architecture.
+    ArraySerialiser::deserialise(in, _data, endian);
 }
@@ -20,4 +20,7 @@ add_subdirectory(viewer)   # DEPS: output, comms, utility
 # Pelican examples
 add_subdirectory(examples) # DEPS: core, server, emulator
 
+# Pelican benchmarks
+add_subdirectory(benchmark) # DEPS: core, output, server, emulator
+
 #add_subdirectory(doc)
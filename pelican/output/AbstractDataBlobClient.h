@@ -33,6 +33,8 @@
 #include <QtCore/QString>
 #include <QtCore/QSet>
 #include "data/DataSpec.h"
+#include "comms/BlobCompression.h"
+#include "comms/CompressionRequest.h"
 class QTcpSocket;
 
 /**
@@ -85,12 +87,26 @@ class AbstractDataBlobClient : public QObject
         /// return the port of the host connected to
         quint16 port() const;
 
+        /// connect through the Unix domain socket at path instead of the
+        //  host and port (empty to use TCP)
+        void setSocketPath(const QString& path);
+
         /// returns the streams served by the blob server
         virtual QSet<QString> streams() { return _streams; };
 
         /// listen for the named streams
         virtual void subscribe( const QSet<QString>& streams );
         void subscribe( const QString& stream );
+
+        /// request that the named stream is sent compressed at the given
+        //  level (1-9, 0 = uncompressed), byte-shuffled in words of
+        //  shuffle bytes (see BlobCompression). Streams are received
+        //  uncompressed from servers that do not acknowledge the request.
+        void setCompression( const QString& stream, int level, int shuffle = 1 );
+
+        /// returns the statistics of the compressed blobs received
+        //  (null if the protocol does not support compression)
+        const BlobCompression::Statistics* compressionStatistics() const;
         QTcpSocket* socket() { return _tcpSocket; }
 
     protected:
@@ -120,6 +136,7 @@ class AbstractDataBlobClient : public QObject
 
     private: // methods
         bool _connect();
+        void _requestCompression(const CompressionRequest& req);
 
     private slots:
         void _response();
@@ -130,6 +147,7 @@ class AbstractDataBlobClient : public QObject
         int _verbose;
         QString       _server;
         quint16       _port;
+        QString       _path;
 
 
     private:
@@ -138,6 +156,9 @@ class AbstractDataBlobClient : public QObject
         DataSpec _currentSubscription;
         QSet<QString> _subscriptions;
         QSet<QString> _streams;
+        CompressionRequest _compression;
+        bool _compressionPending;   // waiting for the server to acknowledge
+        bool _compressionSupported; // false if the server did not acknowledge
 
 };
 
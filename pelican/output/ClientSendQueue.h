@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CLIENTSENDQUEUE_H
+#define CLIENTSENDQUEUE_H
+
+/**
+ * @file ClientSendQueue.h
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QTime>
+
+#include <iostream>
+
+class QIODevice;
+
+namespace pelican {
+
+/**
+ * @ingroup c_output
+ *
+ * @class ClientSendQueue
+ *
+ * @brief
+ * Bounded queue of messages waiting to be written to a client connection.
+ *
+ * @details
+ * Messages are serialised in full before they are queued, and are handed to
+ * the device one at a time with drain(), only while the device holds fewer
+ * than highWater() bytes that are still to be written. The caller never
+ * waits for a client to read its data, unless the queue is full and the
+ * policy is Block.
+ *
+ * When a message is pushed onto a full queue, the policy decides what
+ * happens:
+ * - Block waits for the device to accept queued messages (as before);
+ * - DropOldest discards the oldest messages not yet handed to the device;
+ * - Disconnect rejects the message, and the client should be dropped.
+ *
+ * Messages already passed to the device are never dropped, so a client
+ * always receives complete messages.
+ *
+ * The queue is used from the thread owning the device, but statistics()
+ * may be called from any thread.
+ */
+class ClientSendQueue
+{
+    public:
+        /// Policy applied when a message is pushed onto a full queue.
+        enum Policy { Block, DropOldest, Disconnect };
+
+        /// Queue statistics, for monitoring slow clients.
+        struct Statistics
+        {
+            Statistics() : sent(0), dropped(0), messages(0), bytes(0),
+                    lag(0), maxLag(0) {}
+
+            /// Prints a summary of the statistics.
+            void report(std::ostream& stream) const;
+
+            QString client;   ///< Description of the client.
+            quint64 sent;     ///< Messages handed to the device.
+            quint64 dropped;  ///< Messages discarded (DropOldest).
+            int messages;     ///< Messages currently queued.
+            qint64 bytes;     ///< Bytes currently queued.
+            int lag;          ///< Age of the oldest queued message (ms).
+            int maxLag;       ///< Largest time a message has been queued (ms).
+        };
+
+    public:
+        /// Constructs a queue writing to @p device, holding at most
+        /// @p maxMessages messages and @p maxBytes bytes (0 = no limit).
+        ClientSendQueue(QIODevice* device, Policy policy = Block,
+                int maxMessages = 16, qint64 maxBytes = 0);
+
+        /// Returns the device the queue writes to.
+        QIODevice* device() const { return _device; }
+
+        /// Returns the policy for a full queue.
+        Policy policy() const { return _policy; }
+
+        /// Sets the amount of unwritten data the device may hold before
+        /// drain() stops handing it messages.
+        void setHighWater(qint64 bytes) { _highWater = bytes; }
+
+        /// Returns the device high water mark in bytes.
+        qint64 highWater() const { return _highWater; }
+
+        /// Returns true if a message of @p size bytes would not fit.
+        bool isFull(qint64 size = 0) const;
+
+        /// Returns true if no messages are waiting.
+        bool isEmpty() const;
+
+        /// Queues a message and drains the queue. Returns false if the
+        /// message cannot be queued and the client should be disconnected.
+        bool push(const QByteArray& message);
+
+        /// Hands queued messages to the device up to the high water mark.
+        void drain();
+
+        /// Returns the statistics of the queue.
+        Statistics statistics() const;
+
+        /// Sets the description of the client used in the statistics.
+        void setName(const QString& name);
+
+        /// Returns the policy named @p name (block, dropOldest or
+        /// disconnect), throwing if it is not recognised.
+        static Policy policy(const QString& name);
+
+    private:
+        /// Returns true if a message of @p size bytes would not fit
+        /// (called with the mutex locked).
+        bool _isFull(qint64 size) const;
+
+        /// Hands queued messages to the device (called with the mutex
+        /// locked).
+        void _drain();
+
+        /// Removes the oldest message from the queue.
+        QByteArray _takeFirst();
+
+    private:
+        struct Message
+        {
+            QByteArray data;
+            QTime queued;
+        };
+
+    private:
+        QIODevice* _device;
+        Policy _policy;
+        int _maxMessages;
+        qint64 _maxBytes;
+        qint64 _highWater;
+        qint64 _bytes;
+        QList<Message> _messages;
+        Statistics _stats;
+        mutable QMutex _mutex; // Guards the messages and statistics.
+};
+
+} // namespace pelican
+#endif // CLIENTSENDQUEUE_H
@@ -48,6 +48,7 @@ class DataBlobFactory;
 class ServerRequest;
 class DataBlob;
 class Stream;
+template<class B> class FactoryPool;
 
 /**
  * @ingroup c_output
@@ -63,7 +64,15 @@ class Stream;
  * \code
  * <connection host="hostname" port="1234" >
  * <subscribe stream="streamName" />
+ * <compress stream="streamName" level="1" shuffle="4" />
  * \endcode
+ *
+ * The optional compress tags ask the server to send the named streams
+ * compressed (see BlobCompression); blobs are decompressed transparently.
+ *
+ * A path attribute on the connection tag (e.g. path="/tmp/blobs.sock")
+ * connects through the Unix domain socket the server listens on instead of
+ * the host and port.
  */
 
 class DataBlobClient : public AbstractDataBlobClient
@@ -93,6 +102,7 @@ class DataBlobClient : public AbstractDataBlobClient
     private:
         QHash<QString, Stream*> _streamMap;
         DataBlobFactory* _blobFactory;
+        FactoryPool<DataBlob>* _blobPool;
         mutable bool  _streamInfo; // marker to test if stream response has been received
         mutable bool  _streamInfoSubscription;
 
@@ -50,6 +50,7 @@
 namespace pelican {
 
 class DataBlob;
+class LatencyMonitor;
 
 /**
  * @ingroup c_output
@@ -90,7 +91,8 @@ class OutputStreamManager
         ~OutputStreamManager();
 
         /// send data to all relevant outputs on the specified stream
-        void send( const DataBlob* data, const QString& stream );
+        void send( const DataBlob* data, const QString& stream,
+                   qint64 ingestTime = 0 );
 
         /// associate an output streamer to a specific data stream
         void connectToStream( AbstractOutputStream* streamer, const QString& stream);
@@ -98,9 +100,13 @@ class OutputStreamManager
         /// show the number of
         QList<AbstractOutputStream*> connected(const QString& stream) const;
 
+        /// set the latency monitor to record output latency (null to disable)
+        void setLatencyMonitor( LatencyMonitor* monitor ) { _latencyMonitor = monitor; }
+
     private:
         FactoryConfig<AbstractOutputStream>* _factory;
         QMap< QString, QList<AbstractOutputStream*> > _streamers;
+        LatencyMonitor* _latencyMonitor;
 
 };
 
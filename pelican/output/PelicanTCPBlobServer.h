@@ -57,11 +57,33 @@ class ThreadedBlobServer;
  * <connection port="1234">
  * @endcode
  *
+ * Clients on the same host can also connect through a Unix domain socket,
+ * avoiding the TCP/IP stack, if a path is given:
+ * @code
+ * <connection port="1234" path="/tmp/pelican-blobs.sock">
+ * @endcode
+ *
+ * Each client has a queue of blobs waiting to be sent, so that a slow
+ * client does not hold up the others. The length of the queue, and what
+ * happens when a client falls so far behind that its queue is full, can be
+ * set with a sendQueue tag:
+ * @code
+ * <sendQueue policy="dropOldest" maxMessages="16" maxBytes="0"/>
+ * @endcode
+ * where policy is one of block (the default, wait for the client),
+ * dropOldest (discard the oldest blobs queued for the client) or
+ * disconnect (drop the client). maxBytes limits the size of the queue in
+ * bytes (0 = no limit).
+ *
  * The server has two modes : threaded (default) or non-threaded
  *
  * In Threaded node, the clients will be served by a separate thread. This
  * will give connecting clients a reasonable response time whatever other
- * components of the system are doing.
+ * components of the system are doing. The serving thread can be placed on
+ * particular cores with a thread tag (see ThreadPlacement):
+ * @code
+ * <thread cores="6" numaNode="0">
+ * @endcode
  *
  * Non-threaded mode allows you to eliminate the performance cost of running
  * a separate thread but the server can only respond to clients requests
@@ -81,6 +103,9 @@ class PelicanTCPBlobServer : public AbstractOutputStream
 
         quint16 serverPort() const;
 
+        /// Returns the Unix domain socket path listened on (if any).
+        QString localPath() const;
+
         /// Stop the server from accepting connections.
         void stop();
 
@@ -90,6 +115,9 @@ class PelicanTCPBlobServer : public AbstractOutputStream
         /// Return the number of clients listening to a specified stream.
         int clientsForStream(const QString& stream) const;
 
+        /// Returns the send queue statistics of each connected client.
+        QList<ClientSendQueue::Statistics> clientStatistics() const;
+
     protected:
         virtual void sendStream(const QString& streamName, const DataBlob* dataBlob);
 
@@ -34,19 +34,25 @@
  */
 
 #include <QtNetwork/QTcpServer>
+#include <QtCore/QAtomicInt>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QMutex>
 #include <QtCore/QList>
 #include <QtCore/QSet>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
 
 #include "utility/ConfigNode.h"
+#include "comms/BlobCompression.h"
+#include "output/ClientSendQueue.h"
+#include "utility/LockingCircularBuffer.hpp"
 
 namespace pelican {
 
 class AbstractProtocol;
 class DataBlob;
+class UnixSocketServer;
 
 /**
  * @ingroup c_output
@@ -56,7 +62,18 @@ class DataBlob;
  * @brief
  *   TCP Connection Management thread
  * @details
+ * Messages for each client are serialised into a bounded ClientSendQueue
+ * and written as the client reads them, so a slow client does not hold up
+ * the others. The policy applied when a client falls too far behind is set
+ * with setSendQueue().
  *
+ * A blob sent to several clients is serialised only once for each protocol
+ * version and compression setting in use, and the same (implicitly shared)
+ * bytes are queued for each of those clients.
+ *
+ * Other threads hand blobs to the manager with post(), through a bounded
+ * LockingCircularBuffer that the manager's thread drains, rather than
+ * through a queued signal for every blob.
  */
 
 class TCPConnectionManager : public QObject
@@ -72,6 +89,24 @@ class TCPConnectionManager : public QObject
         void stop();
         // start listening for new connections, after a stop()
         void listen();
+        /// Also listen for connections on a Unix domain socket at @p path
+        //  (until stop() is called; listen() resumes both).
+        bool listenLocal(const QString& path);
+        /// Returns the Unix domain socket path listened on (if any).
+        QString localPath() const;
+        /// Returns the statistics of the blobs sent compressed.
+        BlobCompression::Statistics compressionStatistics() const;
+        /// Sets the send queue policy and limits for clients connecting
+        //  from now on (maxBytes of 0 means no byte limit).
+        void setSendQueue(ClientSendQueue::Policy policy, int maxMessages,
+                qint64 maxBytes = 0);
+        /// Returns the send queue statistics of each connected client.
+        QList<ClientSendQueue::Statistics> clientStatistics() const;
+        /// Returns the number of blob serialisations performed by send().
+        quint64 serialisations() const;
+        /// Hands a blob to the thread of the manager to be sent (blocks
+        //  while the handoff ring is full).
+        void post(const QString& streamName, const DataBlob* incoming);
 
     protected:
         virtual void run();
@@ -79,27 +114,61 @@ class TCPConnectionManager : public QObject
         const QSet<QString>& types() const;
         void _sendNewDataTypes();
         bool _processIncomming(QTcpSocket*);
+        bool _processRequest(QTcpSocket*);
+        AbstractProtocol* _protocolFor(QTcpSocket*);
+        void _acceptClient(QTcpSocket*);
+        bool _queue(QTcpSocket*, const QByteArray&);
 
     public slots:
         void send(const QString& streamName, const DataBlob* incoming);
 
+    private:
+        /// A blob posted to be sent from the thread of the manager.
+        struct Outgoing {
+            Outgoing() : blob(0) {}
+            QString stream;
+            const DataBlob* blob;
+        };
+
     private:
         typedef QList<QTcpSocket*> clients_t;
         quint16 _port;
         QMap<QString, clients_t > _clients;
         QTcpServer* _tcpServer;
+        UnixSocketServer* _localServer;
+        QString _localPath;
         QMutex _mutex;     // controls access to _clients
         QMutex _sendMutex; // controls access to send method
         AbstractProtocol* _protocol;
         // Record of what types have been seen (via send() )
         QSet<QString> _seenTypes;
+        // Protocol (version) used by each client
+        QHash<QTcpSocket*, AbstractProtocol*> _clientProtocol;
+        // Compression codecs requested by each client for each stream
+        QHash<QTcpSocket*, QHash<QString, BlobCompression> > _compression;
+        // Statistics shared by all codecs (updated under _sendMutex)
+        BlobCompression::Statistics _compressionStats;
+        // Outbound message queue of each client
+        QHash<QTcpSocket*, ClientSendQueue*> _queues;
+        // Settings for new send queues
+        ClientSendQueue::Policy _queuePolicy;
+        int _queueMessages;
+        qint64 _queueBytes;
+        // Number of blob serialisations (updated under _sendMutex)
+        quint64 _serialisations;
         // The name of the subscription stream for data support requests
         const QString _dataSupportStream;
+        // Blobs posted from other threads, and whether a drain is pending
+        LockingCircularBuffer<Outgoing> _outgoing;
+        QAtomicInt _drainPosted;
 
     private slots:
         void connectionError(QAbstractSocket::SocketError socketError);
         void acceptClientConnection();
+        void acceptLocalConnection(int socketDescriptor);
         void _incomingFromClient();
+        void _drainClient();
+        void _sendPosted();
 
     signals:
         void sent(const DataBlob*);
@@ -40,6 +40,9 @@
 #include <QtCore/QWaitCondition>
 #include <boost/shared_ptr.hpp>
 
+#include "output/ClientSendQueue.h"
+#include "utility/ThreadPlacement.h"
+
 namespace pelican {
 class DataBlob;
 class TCPConnectionManager;
@@ -61,9 +64,15 @@ class ThreadedBlobServer : public QThread
 
     public:
         ThreadedBlobServer( quint16 port, QObject* parent=0 );
+        /// also listen on the Unix domain socket at localPath
+        ThreadedBlobServer( quint16 port, const QString& localPath,
+                const ThreadPlacement& placement, QObject* parent=0 );
+        ThreadedBlobServer( quint16 port, const QString& localPath,
+                QObject* parent=0 );
         ~ThreadedBlobServer();
 
-        /// send in a seperate background
+        /// send in a seperate background thread (blocks while the handoff
+        //  to the thread is full)
         void send(const QString& streamName, const DataBlob* incoming);
 
         /// send and block until sent
@@ -72,9 +81,19 @@ class ThreadedBlobServer : public QThread
         /// return the port on which the server is listening
         quint16 serverPort() const;
 
+        /// return the Unix domain socket path listened on (if any)
+        QString localPath() const;
+
         /// returns the number of clients listening for the specified stream
         int clientsForStream(const QString&) const;
 
+        /// set the send queue policy and limits for new clients
+        void setSendQueue(ClientSendQueue::Policy policy, int maxMessages,
+                qint64 maxBytes = 0);
+
+        /// return the send queue statistics of each connected client
+        QList<ClientSendQueue::Statistics> clientStatistics() const;
+
         /// stop the server from accepting new connections
         void stop();
 
@@ -84,17 +103,16 @@ class ThreadedBlobServer : public QThread
     protected:
         void run();
 
-    signals:
-        /// private signal to communicate internally
-        void sending( const QString& , const DataBlob*);
-
     private slots:
         void sent(const DataBlob*);
 
     private:
         boost::shared_ptr<TCPConnectionManager> _manager;
         quint16 _port;
-        QMap<const DataBlob*, QWaitCondition*> _waiting;
+        QString _localPath;
+        ThreadPlacement _placement;
+        QMap<const DataBlob*, bool> _waiting; // blobs blocked on, and if sent
+        QWaitCondition _sentCondition;
         QMutex _mutex;
 
 };
@@ -37,6 +37,7 @@
 #include "comms/DataSupportRequest.h"
 #include "comms/DataSupportResponse.h"
 #include "comms/DataBlobResponse.h"
+#include "comms/UnixSocket.h"
 
 namespace pelican {
 
@@ -45,7 +46,8 @@ namespace pelican {
  * @details Constructs a AbstractDataBlobClient object.
  */
 AbstractDataBlobClient::AbstractDataBlobClient(QObject* parent)
-    : QObject(parent), _verbose(0), _protocol(0), _destructor(false)
+    : QObject(parent), _verbose(0), _protocol(0), _destructor(false),
+      _compressionPending(false), _compressionSupported(true)
 {
     _tcpSocket = new QTcpSocket;
     connect(_tcpSocket, SIGNAL( readyRead()),
@@ -80,6 +82,11 @@ quint16 AbstractDataBlobClient::port() const
 }
 
 
+void AbstractDataBlobClient::setSocketPath(const QString& path)
+{
+    _path = path;
+}
+
 void AbstractDataBlobClient::setHost(const QString& ipaddress)
 {
     _server = ipaddress;
@@ -108,9 +115,13 @@ void AbstractDataBlobClient::subscribe(const QSet<QString>& streams)
         }
         if( require != _currentSubscription )
         {
+            // Subscribe before asking for compression, so that servers that
+            // do not support compression still serve the streams.
             req.addDataOption(require);
             sendRequest(&req);
             _subscriptions.unite(streams);
+            if( ! _compression.isEmpty() )
+                _requestCompression(_compression);
         }
     }
 
@@ -123,6 +134,36 @@ void AbstractDataBlobClient::subscribe(const QString& stream)
     subscribe(set);
 }
 
+void AbstractDataBlobClient::setCompression(const QString& stream, int level,
+        int shuffle)
+{
+    _compression.setCompression(stream, level, shuffle);
+    if( _subscriptions.contains(stream) ) {
+        CompressionRequest req;
+        req.setCompression(stream, level, shuffle);
+        _requestCompression(req);
+    }
+}
+
+/**
+ * @details
+ * Sends a compression request, unless the server has already failed to
+ * acknowledge one. The server acknowledges the request, or returns an
+ * error (and may close the connection) if it does not support compression,
+ * in which case the streams continue to be received uncompressed.
+ */
+void AbstractDataBlobClient::_requestCompression(const CompressionRequest& req)
+{
+    if( ! _compressionSupported ) return;
+    _compressionPending = true;
+    sendRequest(&req);
+}
+
+const BlobCompression::Statistics* AbstractDataBlobClient::compressionStatistics() const
+{
+    return _protocol ? _protocol->compressionStatistics() : 0;
+}
+
 bool AbstractDataBlobClient::sendRequest( const ServerRequest* req )
 {
     // construct request and connect to the port
@@ -174,8 +215,18 @@ void AbstractDataBlobClient::_response()
     // Check what type of response we have
     // and call the appropriate handling method
     switch( r -> type() ) {
+        case ServerResponse::Acknowledge:
+            verbose("ServerResponse: acknowledgement");
+            _compressionPending = false;
+            break;
         case ServerResponse::Error:  // Error occurred!!
             verbose("ServerResponse: error");
+            if( _compressionPending ) {
+                _compressionPending = false;
+                _compressionSupported = false;
+                verbose("Compression not supported by server:"
+                        " receiving uncompressed data");
+            }
             serverError( r.get() );
             break;
         case ServerResponse::DataSupport:
@@ -196,6 +247,13 @@ void AbstractDataBlobClient::_response()
 bool AbstractDataBlobClient::_connect()
 {
     while (_tcpSocket->state() == QAbstractSocket::UnconnectedState) {
+       if( ! _path.isEmpty() ) {
+           if( ! UnixSocket::connectToPath( *_tcpSocket, _path ) ) {
+               std::cerr << "Client could not connect to server socket:" << _path.toStdString() << std::endl;
+               sleep(2);
+           }
+           continue;
+       }
        _tcpSocket->connectToHost( _server, _port );
        if (!_tcpSocket->waitForConnected(5000)
            || _tcpSocket->state() == QAbstractSocket::UnconnectedState) {
@@ -211,6 +269,14 @@ void AbstractDataBlobClient::_reconnect()
 {
     if( ! _destructor ) {
         verbose( "DataBlobClient: Connection lost - reconnecting()", 1);
+        // A server that closes the connection rather than acknowledge a
+        // compression request does not support compression.
+        if( _compressionPending ) {
+            _compressionPending = false;
+            _compressionSupported = false;
+            verbose("Compression not supported by server:"
+                    " receiving uncompressed data");
+        }
         _currentSubscription.clear();
         subscribe( _subscriptions );
         onReconnect();
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "output/ClientSendQueue.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QMutexLocker>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a send queue for @p device. The device high water mark
+ * defaults to 64 kiB.
+ */
+ClientSendQueue::ClientSendQueue(QIODevice* device, Policy policy,
+        int maxMessages, qint64 maxBytes)
+    : _device(device), _policy(policy), _maxMessages(qMax(maxMessages, 1)),
+      _maxBytes(maxBytes), _highWater(65536), _bytes(0)
+{
+}
+
+/**
+ * @details
+ * An empty queue always accepts a message, however large.
+ */
+bool ClientSendQueue::isFull(qint64 size) const
+{
+    QMutexLocker locker(&_mutex);
+    return _isFull(size);
+}
+
+bool ClientSendQueue::isEmpty() const
+{
+    QMutexLocker locker(&_mutex);
+    return _messages.isEmpty();
+}
+
+void ClientSendQueue::setName(const QString& name)
+{
+    QMutexLocker locker(&_mutex);
+    _stats.client = name;
+}
+
+bool ClientSendQueue::_isFull(qint64 size) const
+{
+    if (_messages.isEmpty())
+        return false;
+    return _messages.size() >= _maxMessages
+            || (_maxBytes > 0 && _bytes + size > _maxBytes);
+}
+
+/**
+ * @details
+ * Queues @p message and passes as much of the queue to the device as it will
+ * take. If the queue is full, the policy is applied first: with Block, the
+ * method waits for the device to write queued data (returning false if it
+ * fails), with DropOldest the oldest queued messages are discarded, and with
+ * Disconnect the message is rejected.
+ *
+ * The mutex is not held while waiting for the device, so statistics() is
+ * not blocked by a slow client.
+ */
+bool ClientSendQueue::push(const QByteArray& message)
+{
+    QMutexLocker locker(&_mutex);
+    _drain();
+    switch (_policy) {
+        case Block:
+            while (_isFull(message.size())) {
+                locker.unlock();
+                if (!_device->waitForBytesWritten(-1))
+                    return false;
+                locker.relock();
+                _drain();
+            }
+            break;
+        case DropOldest:
+            while (_isFull(message.size())) {
+                _takeFirst();
+                ++_stats.dropped;
+            }
+            break;
+        case Disconnect:
+            if (_isFull(message.size()))
+                return false;
+            break;
+    }
+    Message m;
+    m.data = message;
+    m.queued.start();
+    _messages.append(m);
+    _bytes += message.size();
+    _drain();
+    return true;
+}
+
+/**
+ * @details
+ * Writes whole messages to the device while it holds fewer than highWater()
+ * bytes still to be written. This is called on each push() and should be
+ * called whenever the device reports that data has been written.
+ */
+void ClientSendQueue::drain()
+{
+    QMutexLocker locker(&_mutex);
+    _drain();
+}
+
+void ClientSendQueue::_drain()
+{
+    while (!_messages.isEmpty() && _device->bytesToWrite() < _highWater) {
+        int lag = _messages.first().queued.elapsed();
+        QByteArray data = _takeFirst();
+        if (_device->write(data) < 0)
+            throw QString("ClientSendQueue: Unable to write.");
+        ++_stats.sent;
+        _stats.maxLag = qMax(_stats.maxLag, lag);
+    }
+}
+
+ClientSendQueue::Statistics ClientSendQueue::statistics() const
+{
+    QMutexLocker locker(&_mutex);
+    Statistics stats = _stats;
+    stats.messages = _messages.size();
+    stats.bytes = _bytes;
+    stats.lag = _messages.isEmpty() ? 0 : _messages.first().queued.elapsed();
+    stats.maxLag = qMax(stats.maxLag, stats.lag);
+    return stats;
+}
+
+ClientSendQueue::Policy ClientSendQueue::policy(const QString& name)
+{
+    QString p = name.toLower();
+    if (p.isEmpty() || p == "block")
+        return Block;
+    if (p == "dropoldest")
+        return DropOldest;
+    if (p == "disconnect")
+        return Disconnect;
+    throw QString("ClientSendQueue: Unknown policy \"%1\".").arg(name);
+}
+
+QByteArray ClientSendQueue::_takeFirst()
+{
+    QByteArray data = _messages.takeFirst().data;
+    _bytes -= data.size();
+    return data;
+}
+
+void ClientSendQueue::Statistics::report(std::ostream& stream) const
+{
+    stream << "Client " << client.toStdString() << ": "
+           << sent << " messages sent, " << dropped << " dropped, "
+           << messages << " queued (" << bytes << " bytes), lag "
+           << lag << " ms (max " << maxLag << " ms)." << std::endl;
+}
+
+} // namespace pelican
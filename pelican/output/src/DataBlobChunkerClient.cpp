@@ -71,16 +71,16 @@ void DataBlobChunkerClient::dataReceived( DataBlobResponse* res ) {
         QDataStream dataStream( &_byteArray, QIODevice::WriteOnly );
         dataStream.setVersion(QDataStream::Qt_4_0);
         res->serialise( dataStream );
-        while (_tcpSocket->bytesAvailable() < (qint64)res->dataSize())
-            _tcpSocket -> waitForReadyRead(-1);
         // -- write out the actual DataBlob
-        _tcpSocket->read( (char*)writableData.ptr() + hSize , res->dataSize() );
+        res->readData( (char*)writableData.ptr() + hSize, *_tcpSocket );
     }
     else {
         // discard the data
-        while (_tcpSocket->bytesAvailable() < (qint64)res->dataSize())
-            _tcpSocket -> waitForReadyRead(-1);
-        _tcpSocket->read( res->dataSize() );
+        if( ! res->hasData() ) {
+            while (_tcpSocket->bytesAvailable() < (qint64)res->dataSize())
+                _tcpSocket -> waitForReadyRead(-1);
+            _tcpSocket->read( res->dataSize() );
+        }
         std::cout << "DataBlobChunkerClient: discarding data for stream: "
                   << stream.toStdString() << std::endl;
     }
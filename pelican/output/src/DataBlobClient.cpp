@@ -33,6 +33,7 @@
 #include "output/Stream.h"
 #include "data/DataBlob.h"
 #include "data/DataBlobFactory.h"
+#include "utility/FactoryPool.h"
 #include "utility/ConfigNode.h"
 #include "comms/PelicanClientProtocol.h"
 #include "data/DataRequirements.h"
@@ -54,11 +55,20 @@ DataBlobClient::DataBlobClient( const ConfigNode& configNode, QObject* parent )
 {
     setProtocol( new PelicanClientProtocol );
     _blobFactory = new DataBlobFactory;
+    _blobPool = new FactoryPool<DataBlob>(_blobFactory);
 
     if( configNode.hasAttribute("verbose") )
         _verbose = 1;
     setHost(configNode.getOption("connection", "host"));
     setPort(configNode.getOption("connection", "port").toUInt());
+    setSocketPath(configNode.getOption("connection", "path"));
+
+    // configured compression (must precede the subscriptions)
+    foreach( const ConfigNode& node, configNode.getNodes("compress") ) {
+        setCompression( node.getAttribute("stream"),
+                        node.hasAttribute("level") ? node.getAttribute("level").toInt() : 1,
+                        node.hasAttribute("shuffle") ? node.getAttribute("shuffle").toInt() : 1 );
+    }
 
     // configured subsciptions
     QSet<QString> subs = QSet<QString>::fromList(configNode.getOptionList("subscribe","stream") );
@@ -70,6 +80,11 @@ DataBlobClient::DataBlobClient( const ConfigNode& configNode, QObject* parent )
  */
 DataBlobClient::~DataBlobClient()
 {
+    const BlobCompression::Statistics* stats = compressionStatistics();
+    if( _verbose && stats && stats->blobs > 0 )
+        stats->report(std::cout);
+    delete _blobPool;
+    delete _blobFactory;
 }
 
 QSet<QString> DataBlobClient::streams()
@@ -109,22 +124,29 @@ void DataBlobClient::dataSupport( DataSupportResponse* res ) {
 }
 
 void DataBlobClient::dataReceived( DataBlobResponse* res ) {
-    while (_tcpSocket->bytesAvailable() < (qint64)res->dataSize())
-        _tcpSocket -> waitForReadyRead(-1);
     const QString& stream = res->dataName();
 
     // configure the appropriate Stream Object ready for sending
     Stream* s = _streamMap[stream];
     s->setData(_blob( res->blobClass(), res->dataName() ) );
-    s->data()->deserialise(*_tcpSocket, res->byteOrder());
+    res->readBlob(*s->data(), *_tcpSocket);
 
     emit newData(*s);
 }
 
+/**
+ * @details
+ * Returns a blob from the pool. Blobs are recycled once the Stream (and any
+ * listeners) have released them: the base class state is reset here, and
+ * deserialise() must overwrite the rest (see DataBlob::deserialise()).
+ */
 boost::shared_ptr<DataBlob> DataBlobClient::_blob(const QString& type, const QString& /*stream*/)
 {
-    // TODO speedup with circular Blob buffers etc?
-    return boost::shared_ptr<DataBlob>( _blobFactory->create(type) );
+    boost::shared_ptr<DataBlob> blob = _blobPool->create(type);
+    blob->setVersion(QString());
+    blob->setTimestamp(0);
+    blob->setLostPackets(0);
+    return blob;
 }
 
 } // namespace pelican
@@ -32,6 +32,9 @@
 #include "OutputStreamManager.h"
 #include "utility/Config.h"
 #include "utility/ConfigNode.h"
+#include "utility/LatencyMonitor.h"
+#include "utility/Tracer.h"
+#include "data/DataBlob.h"
 
 namespace pelican {
 
@@ -39,7 +42,7 @@ namespace pelican {
  *@details OutputStreamManager
  */
 OutputStreamManager::OutputStreamManager( const Config* config , const Config::TreeAddress& base )
-    : _factory(0)
+    : _factory(0), _latencyMonitor(0)
 {
     if( config )
     {
@@ -136,12 +139,31 @@ void OutputStreamManager::connectToStream(AbstractOutputStream* streamer, const
     _streamers[stream].append(streamer);
 }
 
-void OutputStreamManager::send( const DataBlob* data, const QString& stream )
+/**
+ * @details
+ * Sends the data to each streamer connected to the stream.
+ *
+ * If a latency monitor is set, the age of the data once it has been passed
+ * to all the streamers is recorded against "<stream>:sent". @p ingestTime
+ * defaults to the ingest timestamp of the data blob, and identifies the
+ * flow of the data in event traces.
+ */
+void OutputStreamManager::send( const DataBlob* data, const QString& stream,
+                                qint64 ingestTime )
 {
+    static const int traceName = Tracer::intern("AbstractOutputStream::send");
     if( _streamers.contains(stream) ) {
+        if( ingestTime == 0 ) ingestTime = data->timestamp();
         foreach( AbstractOutputStream* out, _streamers[stream]) {
+            Tracer::Scope trace(traceName);
+            trace.flow(ingestTime);
             out->send(stream, data);
         }
+        if( _latencyMonitor ) {
+            _latencyMonitor->record(
+                    ( stream.isEmpty() ? data->type() : stream ) + ":sent",
+                    ingestTime );
+        }
     }
 }
 
@@ -42,6 +42,7 @@ PelicanTCPBlobServer::PelicanTCPBlobServer(const ConfigNode& configNode )
 {
     // Initialise connection manager thread
     int port = configNode.getOption("connection", "port").toInt();
+    QString path = configNode.getOption("connection", "path");
 
     // Decide to run in threaded/ or non-threaded mode
     bool threaded = true;
@@ -50,10 +51,22 @@ PelicanTCPBlobServer::PelicanTCPBlobServer(const ConfigNode& configNode )
                 "false",  Qt::CaseInsensitive);
     }
 
-    if (threaded)
-        _server = new ThreadedBlobServer(port);
+    // Send queue settings
+    ClientSendQueue::Policy policy = ClientSendQueue::policy(
+            configNode.getOption("sendQueue", "policy", "block"));
+    int maxMessages = configNode.getOption("sendQueue", "maxMessages", "16").toInt();
+    qint64 maxBytes = configNode.getOption("sendQueue", "maxBytes", "0").toLongLong();
+
+    if (threaded) {
+        _server = new ThreadedBlobServer(port, path,
+                ThreadPlacement(configNode));
+        _server->setSendQueue(policy, maxMessages, maxBytes);
+    }
     else {
         _connectionManager = new TCPConnectionManager;
+        _connectionManager->setSendQueue(policy, maxMessages, maxBytes);
+        if (!path.isEmpty())
+            _connectionManager->listenLocal(path);
     }
 }
 
@@ -82,6 +95,20 @@ int PelicanTCPBlobServer::clientsForStream(const QString& stream) const
     }
 }
 
+/**
+ * @details
+ * Returns the send queue statistics (messages sent, dropped and queued, and
+ * the lag) of each connected client.
+ */
+QList<ClientSendQueue::Statistics> PelicanTCPBlobServer::clientStatistics() const
+{
+    if (_server)
+        return _server->clientStatistics();
+    else {
+        return _connectionManager->clientStatistics();
+    }
+}
+
 /**
  * @details
  * Send datablob to connected clients
@@ -119,6 +146,20 @@ void PelicanTCPBlobServer::listen()
     }
 }
 
+/**
+ * @details
+ * Return the Unix domain socket path the server listens on, if
+ * <connection path="..."/> is configured.
+ */
+QString PelicanTCPBlobServer::localPath() const
+{
+    if (_server)
+        return _server->localPath();
+    else {
+        return _connectionManager->localPath();
+    }
+}
+
 /**
  * @details
  * Return the port bound to the server
@@ -30,9 +30,11 @@
 
 #include "output/TCPConnectionManager.h"
 #include "comms/StreamDataRequest.h"
+#include "comms/CompressionRequest.h"
 #include "comms/DataSupportResponse.h"
 #include "comms/PelicanProtocol.h"
 #include "comms/ServerRequest.h"
+#include "comms/UnixSocketServer.h"
 #include "utility/ConfigNode.h"
 #include "comms/StreamData.h"
 #include "data/DataBlob.h"
@@ -41,6 +43,8 @@
 #include <QtCore/QMutexLocker>
 #include <QtNetwork/QTcpSocket>
 
+#include <unistd.h>
+
 namespace pelican {
 
 /**
@@ -48,10 +52,13 @@ namespace pelican {
  * TCPConnectionManager constructor
  */
 TCPConnectionManager::TCPConnectionManager(quint16 port, QObject *parent)
-: QObject(parent), _port(port), _dataSupportStream("__streamInfo__")
+: QObject(parent), _port(port), _queuePolicy(ClientSendQueue::Block),
+  _queueMessages(16), _queueBytes(0), _serialisations(0),
+  _dataSupportStream("__streamInfo__"), _outgoing(64), _drainPosted(0)
 {
     _protocol = new PelicanProtocol; // TODO - make configurable
     _tcpServer = new QTcpServer;
+    _localServer = 0;
     run();
 }
 
@@ -61,9 +68,50 @@ TCPConnectionManager::TCPConnectionManager(quint16 port, QObject *parent)
  */
 TCPConnectionManager::~TCPConnectionManager()
 {
+    if (_compressionStats.blobs > 0)
+        _compressionStats.report(std::cout);
+    foreach (ClientSendQueue* queue, _queues) {
+        if (queue->statistics().dropped > 0)
+            queue->statistics().report(std::cout);
+        delete queue;
+    }
     delete _tcpServer;
+    delete _localServer;
+}
+
+
+/**
+ * @details
+ * Hands a blob to be sent to the thread of the manager. The blob is placed
+ * on a bounded ring, blocking while the ring is full, and the manager's
+ * thread is woken to drain it only if it has not already been woken. The
+ * blob must remain valid until it is sent (see the sent() signal).
+ */
+void TCPConnectionManager::post(const QString& streamName,
+        const DataBlob* incoming)
+{
+    Outgoing item;
+    item.stream = streamName;
+    item.blob = incoming;
+    _outgoing.push(item);
+    if (_drainPosted.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(this, "_sendPosted", Qt::QueuedConnection);
 }
 
+/**
+ * @details
+ * Sends the blobs posted with post(). At most one ring's worth of blobs is
+ * sent before returning to the event loop; blobs posted after the pending
+ * flag is cleared have woken the thread again.
+ */
+void TCPConnectionManager::_sendPosted()
+{
+    _drainPosted.fetchAndStoreOrdered(0);
+    Outgoing item;
+    for (unsigned int i = 0; i < _outgoing.capacity()
+            && _outgoing.tryPop(item); ++i)
+        send(item.stream, item.blob);
+}
 
 /**
  * @details
@@ -81,8 +129,38 @@ quint16 TCPConnectionManager::serverPort() const
 void TCPConnectionManager::acceptClientConnection()
 {
     // Get new client connection
-    QTcpSocket *client = _tcpServer->nextPendingConnection();
+    _acceptClient(_tcpServer->nextPendingConnection());
+}
 
+/**
+ * @details
+ * Accept client connections on the Unix domain socket. The connection is
+ * wrapped in a QTcpSocket and handled exactly as a TCP connection.
+ */
+void TCPConnectionManager::acceptLocalConnection(int socketDescriptor)
+{
+    QTcpSocket* client = new QTcpSocket;
+    if (!client->setSocketDescriptor(socketDescriptor)) {
+        std::cerr << "TCPConnectionManager: Unable to accept local connection: "
+                  << client->errorString().toStdString() << std::endl;
+        ::close(socketDescriptor);
+        delete client;
+        return;
+    }
+    _acceptClient(client);
+}
+
+void TCPConnectionManager::_acceptClient(QTcpSocket* client)
+{
+    {
+        QMutexLocker locker(&_mutex);
+        ClientSendQueue* queue = new ClientSendQueue(client, _queuePolicy,
+                _queueMessages, _queueBytes);
+        queue->setName(client->peerAddress().isNull() ? QString("local")
+                : QString("%1:%2").arg(client->peerAddress().toString())
+                .arg(client->peerPort()));
+        _queues.insert(client, queue);
+    }
     if (_processIncomming(client))
     {
         // Connect socket error() signals
@@ -91,8 +169,12 @@ void TCPConnectionManager::acceptClientConnection()
             Qt::DirectConnection);
         connect(client, SIGNAL(readyRead()), this, SLOT(_incomingFromClient()),
             Qt::DirectConnection);
+        connect(client, SIGNAL(bytesWritten(qint64)), this,
+            SLOT(_drainClient()), Qt::DirectConnection);
     }
     else {
+        QMutexLocker locker(&_mutex);
+        delete _queues.take(client);
         // Closes the I/O device for the socket,
         // disconnects the socket's connection with the host,
         // closes the socket, and resets the name, address,
@@ -107,19 +189,86 @@ void TCPConnectionManager::_incomingFromClient()
     _processIncomming(static_cast<QTcpSocket*>( sender() ) );
 }
 
+/**
+ * @details
+ * Passes more of the client's send queue to the socket as the socket
+ * writes data.
+ */
+void TCPConnectionManager::_drainClient()
+{
+    QTcpSocket* client = static_cast<QTcpSocket*>( sender() );
+    ClientSendQueue* queue = 0;
+    {
+        QMutexLocker locker(&_mutex);
+        queue = _queues.value(client, 0);
+    }
+    try {
+        if (queue)
+            queue->drain();
+    }
+    catch ( ... )
+    {
+        std::cerr <<  "TCPConnectionManager: failed to send data to client" << std::endl;
+        _killClient(client);
+    }
+}
+
+/**
+ * @details
+ * Appends a serialised message to the send queue of the client, applying
+ * the queue policy if the client has fallen behind. Returns false if the
+ * client should be disconnected.
+ */
+bool TCPConnectionManager::_queue(QTcpSocket* client, const QByteArray& message)
+{
+    ClientSendQueue* queue = 0;
+    {
+        QMutexLocker locker(&_mutex);
+        queue = _queues.value(client, 0);
+    }
+    if (!queue || !queue->push(message))
+        return false;
+    client->flush();
+    return true;
+}
+
+/**
+ * @details
+ * Processes all the requests waiting on the client socket (requests sent
+ * back to back may arrive together).
+ */
 bool TCPConnectionManager::_processIncomming(QTcpSocket *client)
+{
+    bool ok = _processRequest(client);
+    while (ok && client->bytesAvailable() > 0)
+        ok = _processRequest(client);
+    return ok;
+}
+
+bool TCPConnectionManager::_processRequest(QTcpSocket *client)
 {
     Q_ASSERT(client->state() == QAbstractSocket::ConnectedState);
 
     // Wait for client to send in request type
     boost::shared_ptr<ServerRequest> request = _protocol->request(*client);
 
+    // Respond in the protocol version used by the client
+    AbstractProtocol* protocol = _protocol->protocolFor(*request);
+    {
+        QMutexLocker locker(&_mutex);
+        _clientProtocol[client] = protocol;
+    }
+
     switch (request->type())
     {
         case ServerRequest::DataSupport:
         {
             DataSupportResponse res( types() );
-            _protocol->send(*client, res);
+            QBuffer buffer;
+            buffer.open(QBuffer::WriteOnly);
+            protocol->send(buffer, res);
+            if (!_queue(client, buffer.buffer()))
+                return false;
             // Add the client to the stream update channel
             if (!_clients[_dataSupportStream].contains(client)) {
                 _clients[_dataSupportStream].push_back(client);
@@ -150,6 +299,29 @@ bool TCPConnectionManager::_processIncomming(QTcpSocket *client)
             }
             break;
         }
+        case ServerRequest::Compression:
+        {
+            CompressionRequest& req = static_cast<CompressionRequest&>(*request);
+            {
+                QMutexLocker locker(&_mutex);
+                QHash<QString, BlobCompression>& codecs = _compression[client];
+                foreach(const QString& stream, req.streams() ) {
+                    if (req.level(stream) > 0)
+                        codecs.insert(stream, BlobCompression(req.level(stream),
+                                req.shuffle(stream), &_compressionStats));
+                    else
+                        codecs.remove(stream);
+                }
+            }
+            // Acknowledge the setting so the client knows compression is
+            // supported.
+            QBuffer buffer;
+            buffer.open(QBuffer::WriteOnly);
+            protocol->send(buffer, QString("Compression"));
+            if (!_queue(client, buffer.buffer()))
+                return false;
+            break;
+        }
         default:
         {
             std::cerr << "TCPConnectionManager: Invalid client request" << std::endl;
@@ -168,6 +340,7 @@ bool TCPConnectionManager::_processIncomming(QTcpSocket *client)
 void TCPConnectionManager::_sendNewDataTypes()
 {
     DataSupportResponse res( types() );
+    QHash<AbstractProtocol*, QByteArray> messages;
 
     clients_t clientListCopy;
     {
@@ -185,8 +358,17 @@ void TCPConnectionManager::_sendNewDataTypes()
         try {
             //std::cout << "Sending to:" << client->peerName().toStdString() << std::endl;
             Q_ASSERT( client->state() == QAbstractSocket::ConnectedState );
-            _protocol->send(*client, res);
-            client->flush();
+            AbstractProtocol* protocol = _protocolFor(client);
+            if (!messages.contains(protocol)) {
+                QBuffer buffer;
+                buffer.open(QBuffer::WriteOnly);
+                protocol->send(buffer, res);
+                messages.insert(protocol, buffer.buffer());
+            }
+            if (!_queue(client, messages[protocol])) {
+                std::cerr << "TCPConnectionManager: client has fallen behind" << std::endl;
+                _killClient(client);
+            }
             //std::cerr <<  "TCPConnectionManager: sending newdata types to client" << std::endl;
         }
         catch ( ... )
@@ -217,14 +399,44 @@ void TCPConnectionManager::send(const QString& streamName, const DataBlob* blob)
             clientListCopy = _clients[streamName];
         }
 
+        // The blob is serialised once for each distinct protocol and
+        // compression setting, and the (shared) bytes queued for every
+        // client that uses it.
+        QHash<QString, QByteArray> messages;
+
         for(int i = 0; i < clientListCopy.size(); ++i )
         {
             QTcpSocket* client =  clientListCopy[i];
-            // Send data to client
+            BlobCompression codec;
+            bool compress = false;
+            AbstractProtocol* protocol = _protocolFor(client);
+            {
+                QMutexLocker locker(&_mutex);
+                if (_compression.contains(client)
+                        && _compression[client].contains(streamName)) {
+                    codec = _compression[client][streamName];
+                    compress = true;
+                }
+            }
+            QString key = QString("%1:%2:%3").arg((quintptr)protocol)
+                    .arg(compress ? codec.level() : 0).arg(codec.shuffle());
+            // Queue data for the client
             try {
                 Q_ASSERT( client->state() == QAbstractSocket::ConnectedState );
-                _protocol->send(*client, streamName, *blob);
-                client->flush();
+                if (!messages.contains(key)) {
+                    QBuffer buffer;
+                    buffer.open(QBuffer::WriteOnly);
+                    if (compress)
+                        protocol->send(buffer, streamName, *blob, codec);
+                    else
+                        protocol->send(buffer, streamName, *blob);
+                    messages.insert(key, buffer.buffer());
+                    ++_serialisations;
+                }
+                if (!_queue(client, messages[key])) {
+                    std::cerr << "TCPConnectionManager: client has fallen behind" << std::endl;
+                    _killClient(client);
+                }
             }
             catch ( ... )
             {
@@ -235,7 +447,7 @@ void TCPConnectionManager::send(const QString& streamName, const DataBlob* blob)
         }
     }
     emit sent(blob); // let any blocked sends continue
-    // now the blob is sent.
+    // now the blob is serialised into the client queues.
 
     // Ensure we track the data streams and inform any interested
     // clients of updates.
@@ -246,6 +458,70 @@ void TCPConnectionManager::send(const QString& streamName, const DataBlob* blob)
     }
 }
 
+/**
+ * @details
+ * Returns the accumulated statistics of the blobs sent compressed to all
+ * clients.
+ */
+BlobCompression::Statistics TCPConnectionManager::compressionStatistics() const
+{
+    QMutexLocker locker(const_cast<QMutex*>(&_sendMutex));
+    return _compressionStats;
+}
+
+/**
+ * @details
+ * Sets the policy applied when a client falls behind, and the number of
+ * messages (and optionally bytes) that may be queued for each client, for
+ * clients connecting after the call.
+ */
+void TCPConnectionManager::setSendQueue(ClientSendQueue::Policy policy,
+        int maxMessages, qint64 maxBytes)
+{
+    QMutexLocker locker(&_mutex);
+    _queuePolicy = policy;
+    _queueMessages = maxMessages;
+    _queueBytes = maxBytes;
+}
+
+/**
+ * @details
+ * Returns the send queue statistics (messages sent, dropped and queued, and
+ * the lag) of each connected client. This may be called from any thread:
+ * the queues are removed under the client mutex, and each queue guards its
+ * own messages and counters.
+ */
+QList<ClientSendQueue::Statistics> TCPConnectionManager::clientStatistics() const
+{
+    QMutexLocker locker(const_cast<QMutex*>(&_mutex));
+    QList<ClientSendQueue::Statistics> stats;
+    foreach (const ClientSendQueue* queue, _queues)
+        stats.append(queue->statistics());
+    return stats;
+}
+
+/**
+ * @details
+ * Returns the number of times a blob has been serialised by send(). Each
+ * blob is serialised once for each combination of protocol version and
+ * compression setting used by its subscribers, however many there are.
+ */
+quint64 TCPConnectionManager::serialisations() const
+{
+    QMutexLocker locker(const_cast<QMutex*>(&_sendMutex));
+    return _serialisations;
+}
+
+/**
+ * @details
+ * Returns the protocol (version) to use for sending to the client.
+ */
+AbstractProtocol* TCPConnectionManager::_protocolFor(QTcpSocket* client)
+{
+    QMutexLocker locker(&_mutex);
+    return _clientProtocol.value(client, _protocol);
+}
+
 const QSet<QString>& TCPConnectionManager::types() const {
     return _seenTypes;
 }
@@ -260,6 +536,13 @@ void TCPConnectionManager::_killClient(QTcpSocket* client)
     foreach(const QString& stream, _clients.keys() ) {
         _clients[stream].removeAll(client);
     }
+    _compression.remove(client);
+    _clientProtocol.remove(client);
+    if (ClientSendQueue* queue = _queues.take(client)) {
+        if (queue->statistics().dropped > 0)
+            queue->statistics().report(std::cout);
+        delete queue;
+    }
     client->disconnect();
     client->deleteLater();
 }
@@ -294,12 +577,42 @@ void TCPConnectionManager::run()
 void TCPConnectionManager::stop()
 {
     _tcpServer->close();
+    if (_localServer)
+        _localServer->close();
 }
 
 void TCPConnectionManager::listen()
 {
     if (!_tcpServer -> listen( QHostAddress::Any, _port))
         std::cerr << QString("Unable to start QTcpServer: %1").arg( _tcpServer -> errorString()).toStdString();
+    if (_localServer && !_localServer->isListening())
+        listenLocal(_localPath);
+}
+
+/**
+ * @details
+ * Listen for clients on the Unix domain socket at @p path, in addition to
+ * the TCP port. Must be called from the thread running the manager.
+ */
+bool TCPConnectionManager::listenLocal(const QString& path)
+{
+    if (!_localServer) {
+        _localServer = new UnixSocketServer;
+        connect(_localServer, SIGNAL(incomingDescriptor(int)), this,
+                SLOT(acceptLocalConnection(int)), Qt::DirectConnection);
+    }
+    _localPath = path;
+    if (!_localServer->listen(path)) {
+        std::cerr << QString("Unable to listen on %1: %2").arg(path)
+                .arg(_localServer->errorString()).toStdString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+QString TCPConnectionManager::localPath() const
+{
+    return _localPath;
 }
 
 /**
@@ -46,6 +46,27 @@ ThreadedBlobServer::ThreadedBlobServer( quint16 port, QObject* parent )
     while( _manager.get() == 0 ) { wait(1); }
 }
 
+ThreadedBlobServer::ThreadedBlobServer( quint16 port, const QString& localPath,
+        QObject* parent )
+    : QThread( parent ), _port(port), _localPath(localPath)
+{
+    start();
+    while( _manager.get() == 0 ) { wait(1); }
+}
+
+/**
+ *@details
+ * The server thread is placed (see ThreadPlacement) as it starts.
+ */
+ThreadedBlobServer::ThreadedBlobServer( quint16 port, const QString& localPath,
+        const ThreadPlacement& placement, QObject* parent )
+    : QThread( parent ), _port(port), _localPath(localPath),
+      _placement(placement)
+{
+    start();
+    while( _manager.get() == 0 ) { wait(1); }
+}
+
 /**
  *@details
  * ensures the thread is stopped before we delete the object
@@ -59,6 +80,11 @@ quint16 ThreadedBlobServer::serverPort() const
     return _manager->serverPort();
 }
 
+QString ThreadedBlobServer::localPath() const
+{
+    return _manager->localPath();
+}
+
 /**
  * @details
  * method to tell if there are any clients listening for data
@@ -68,26 +94,42 @@ int ThreadedBlobServer::clientsForStream(const QString& stream) const
     return _manager->clientsForStream(stream);
 }
 
+void ThreadedBlobServer::setSendQueue(ClientSendQueue::Policy policy,
+        int maxMessages, qint64 maxBytes)
+{
+    _manager->setSendQueue(policy, maxMessages, maxBytes);
+}
+
+QList<ClientSendQueue::Statistics> ThreadedBlobServer::clientStatistics() const
+{
+    return _manager->clientStatistics();
+}
+
 void ThreadedBlobServer::run()
 {
+    _placement.apply( QString("ThreadedBlobServer (port %1)").arg(_port) );
+
     // Create a connection manager in the thread and run it inside the event loop
     // using a boost shared_ptr will ensure it gets deleted when we leave the scope
-    _manager.reset( new TCPConnectionManager(_port) );
-    bool res = connect( this, SIGNAL( sending(const QString&, const DataBlob*) ),
-             _manager.get(), SLOT( send( const QString&, const DataBlob* )));
-    Q_ASSERT( res );
-    res = connect( _manager.get(), SIGNAL( sent(const DataBlob*) ),
+    // The local socket server must also be created in this thread, before
+    // the constructor returns.
+    TCPConnectionManager* manager = new TCPConnectionManager(_port);
+    if( ! _localPath.isEmpty() )
+        manager->listenLocal(_localPath);
+    _manager.reset( manager );
+    bool res = connect( _manager.get(), SIGNAL( sent(const DataBlob*) ),
             this , SLOT( sent( const DataBlob* )), Qt::DirectConnection);
+    Q_ASSERT( res );
     exec();
 }
 
 /*
  * @details
- * emit a signal to the connection manager in the thread
+ * hand the blob to the connection manager in the thread
  */
 void ThreadedBlobServer::send(const QString& streamName, const DataBlob* blob)
 {
-    emit sending(streamName, blob);
+    _manager->post(streamName, blob);
 }
 
 /**
@@ -96,11 +138,17 @@ void ThreadedBlobServer::send(const QString& streamName, const DataBlob* blob)
  */
 void ThreadedBlobServer::blockingSend(const QString& streamName, const DataBlob* incoming)
 {
+    {
+        QMutexLocker locker(&_mutex);
+        _waiting[incoming] = false; // ensure we are waiting before we send
+    }
+    // Tell the threaded blob server to send data (not holding the mutex, as
+    // the handoff may block until the server thread has drained it).
+    send(streamName, incoming );
     QMutexLocker locker(&_mutex);
-    _waiting[incoming] = new QWaitCondition; // ensure waiting object is created before we send
-    send(streamName, incoming ); // Tell the threaded blob server to send data
-    _waiting[incoming]->wait(&_mutex); // go to sleep until send() has completed
-    delete _waiting.take(incoming);
+    while( ! _waiting[incoming] )
+        _sentCondition.wait(&_mutex); // go to sleep until send() has completed
+    _waiting.remove(incoming);
 }
 
 /**
@@ -112,10 +160,11 @@ void ThreadedBlobServer::blockingSend(const QString& streamName, const DataBlob*
 void ThreadedBlobServer::sent(const DataBlob* blob)
 {
     Q_ASSERT( currentThread() == this );
+    QMutexLocker locker(&_mutex);
     if( _waiting.contains(blob) )
     {
-        QMutexLocker locker(&_mutex);
-        _waiting[blob]->wakeAll();
+        _waiting[blob] = true;
+        _sentCondition.wakeAll();
     }
 }
 
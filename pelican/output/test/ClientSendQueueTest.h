@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CLIENTSENDQUEUETEST_H
+#define CLIENTSENDQUEUETEST_H
+
+/**
+ * @file ClientSendQueueTest.h
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace pelican {
+
+/**
+ * @ingroup t_output
+ *
+ * @class ClientSendQueueTest
+ *
+ * @brief
+ * Unit test for the ClientSendQueue
+ *
+ * @details
+ */
+
+class ClientSendQueueTest : public CppUnit::TestFixture
+{
+    public:
+        CPPUNIT_TEST_SUITE( ClientSendQueueTest );
+        CPPUNIT_TEST( test_drain );
+        CPPUNIT_TEST( test_dropOldest );
+        CPPUNIT_TEST( test_disconnect );
+        CPPUNIT_TEST( test_policy );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {}
+        void tearDown() {}
+
+        // Test Methods
+        void test_drain();
+        void test_dropOldest();
+        void test_disconnect();
+        void test_policy();
+
+    public:
+        ClientSendQueueTest();
+        ~ClientSendQueueTest();
+};
+
+} // namespace pelican
+#endif // CLIENTSENDQUEUETEST_H
@@ -57,6 +57,7 @@ class TCPConnectionManagerTest : public CppUnit::TestFixture
     public:
         CPPUNIT_TEST_SUITE( TCPConnectionManagerTest );
         CPPUNIT_TEST( test_send );
+        CPPUNIT_TEST( test_sendMany );
         CPPUNIT_TEST( test_brokenConnection );
         CPPUNIT_TEST( test_dataSupportedRequest );
         CPPUNIT_TEST_SUITE_END();
@@ -67,6 +68,7 @@ class TCPConnectionManagerTest : public CppUnit::TestFixture
 
         // Test Methods
         void test_send();
+        void test_sendMany();
         void test_brokenConnection();
         void test_dataSupportedRequest();
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "output/test/ClientSendQueueTest.h"
+#include "output/ClientSendQueue.h"
+
+#include <QtCore/QBuffer>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ClientSendQueueTest );
+
+ClientSendQueueTest::ClientSendQueueTest()
+: CppUnit::TestFixture()
+{
+}
+
+ClientSendQueueTest::~ClientSendQueueTest()
+{
+}
+
+void ClientSendQueueTest::test_drain()
+{
+    // Use Case:
+    // Queue messages while the device is above the high water mark
+    // (a QBuffer never has bytes to write, so a mark of 0 holds them back).
+    // Expect them to be queued, then written in order once drained.
+    QBuffer device;
+    device.open(QBuffer::WriteOnly);
+    ClientSendQueue queue(&device, ClientSendQueue::Block, 4);
+    queue.setHighWater(0);
+    CPPUNIT_ASSERT( queue.push("one") );
+    CPPUNIT_ASSERT( queue.push("two") );
+    CPPUNIT_ASSERT_EQUAL( 0, device.buffer().size() );
+    ClientSendQueue::Statistics stats = queue.statistics();
+    CPPUNIT_ASSERT_EQUAL( 2, stats.messages );
+    CPPUNIT_ASSERT_EQUAL( (qint64)6, stats.bytes );
+    CPPUNIT_ASSERT_EQUAL( (quint64)0, stats.sent );
+
+    queue.setHighWater(1);
+    queue.drain();
+    CPPUNIT_ASSERT( queue.isEmpty() );
+    CPPUNIT_ASSERT( device.buffer() == QByteArray("onetwo") );
+    stats = queue.statistics();
+    CPPUNIT_ASSERT_EQUAL( 0, stats.messages );
+    CPPUNIT_ASSERT_EQUAL( (qint64)0, stats.bytes );
+    CPPUNIT_ASSERT_EQUAL( (quint64)2, stats.sent );
+
+    // Use Case:
+    // Push below the high water mark.
+    // Expect the message to be written immediately.
+    CPPUNIT_ASSERT( queue.push("three") );
+    CPPUNIT_ASSERT( device.buffer() == QByteArray("onetwothree") );
+}
+
+void ClientSendQueueTest::test_dropOldest()
+{
+    // Use Case:
+    // Fill a queue limited to 2 messages with the DropOldest policy.
+    // Expect the oldest messages to be discarded and counted.
+    QBuffer device;
+    device.open(QBuffer::WriteOnly);
+    ClientSendQueue queue(&device, ClientSendQueue::DropOldest, 2);
+    queue.setHighWater(0);
+    for (int i = 0; i < 5; ++i)
+        CPPUNIT_ASSERT( queue.push(QByteArray(1, char('a' + i))) );
+    ClientSendQueue::Statistics stats = queue.statistics();
+    CPPUNIT_ASSERT_EQUAL( 2, stats.messages );
+    CPPUNIT_ASSERT_EQUAL( (quint64)3, stats.dropped );
+
+    queue.setHighWater(1);
+    queue.drain();
+    CPPUNIT_ASSERT( device.buffer() == QByteArray("de") );
+
+    // Use Case:
+    // Limit the queue by size.
+    // Expect messages to be dropped to make room, but a message larger
+    // than the limit to be accepted into an empty queue.
+    ClientSendQueue bytes(&device, ClientSendQueue::DropOldest, 100, 4);
+    bytes.setHighWater(0);
+    CPPUNIT_ASSERT( bytes.push("ab") );
+    CPPUNIT_ASSERT( bytes.push("cd") );
+    CPPUNIT_ASSERT( bytes.isFull(1) );
+    CPPUNIT_ASSERT( bytes.push("efg") );
+    CPPUNIT_ASSERT_EQUAL( 1, bytes.statistics().messages );
+    CPPUNIT_ASSERT( bytes.push("0123456789") );
+    CPPUNIT_ASSERT_EQUAL( 1, bytes.statistics().messages );
+    CPPUNIT_ASSERT_EQUAL( (qint64)10, bytes.statistics().bytes );
+    CPPUNIT_ASSERT_EQUAL( (quint64)3, bytes.statistics().dropped );
+}
+
+void ClientSendQueueTest::test_disconnect()
+{
+    // Use Case:
+    // Overfill a queue with the Disconnect policy.
+    // Expect the push to fail, leaving the queue unchanged.
+    QBuffer device;
+    device.open(QBuffer::WriteOnly);
+    ClientSendQueue queue(&device, ClientSendQueue::Disconnect, 2);
+    queue.setHighWater(0);
+    CPPUNIT_ASSERT( queue.push("a") );
+    CPPUNIT_ASSERT( queue.push("b") );
+    CPPUNIT_ASSERT( ! queue.push("c") );
+    CPPUNIT_ASSERT_EQUAL( 2, queue.statistics().messages );
+    CPPUNIT_ASSERT_EQUAL( (quint64)0, queue.statistics().dropped );
+}
+
+void ClientSendQueueTest::test_policy()
+{
+    CPPUNIT_ASSERT_EQUAL( ClientSendQueue::Block, ClientSendQueue::policy("") );
+    CPPUNIT_ASSERT_EQUAL( ClientSendQueue::Block, ClientSendQueue::policy("block") );
+    CPPUNIT_ASSERT_EQUAL( ClientSendQueue::DropOldest,
+            ClientSendQueue::policy("dropOldest") );
+    CPPUNIT_ASSERT_EQUAL( ClientSendQueue::Disconnect,
+            ClientSendQueue::policy("Disconnect") );
+    CPPUNIT_ASSERT_THROW( ClientSendQueue::policy("wait"), QString );
+}
+
+} // namespace pelican
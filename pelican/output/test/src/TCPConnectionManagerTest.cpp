@@ -109,6 +109,41 @@ void TCPConnectionManagerTest::test_send()
     CPPUNIT_ASSERT(recvBlob == blob);
 }
 
+void TCPConnectionManagerTest::test_sendMany()
+{
+    QString streamName = "testData";
+
+    // Use Case:
+    //   Several clients subscribe to the same stream.
+    // Expect:
+    //   Every client to receive the blob, serialised only once.
+    StreamDataRequest request;
+    DataSpec dataSpec;
+    dataSpec.addStreamData(streamName);
+    request.addDataOption(dataSpec);
+
+    QList<QTcpSocket*> clients;
+    for (int i = 0; i < 3; ++i) {
+        clients.append(_createClient());
+        _sendRequest(clients.last(), request);
+    }
+    CPPUNIT_ASSERT_EQUAL(3, _server->clientsForStream(streamName));
+
+    TestDataBlob blob;
+    blob.setData("sometestData");
+    _server->send(streamName, &blob);
+    CPPUNIT_ASSERT_EQUAL((quint64)1, _server->serialisations());
+
+    foreach (QTcpSocket* client, clients) {
+        boost::shared_ptr<ServerResponse> r = _clientProtocol->receive(*client);
+        CPPUNIT_ASSERT( r->type() == ServerResponse::Blob );
+        DataBlobResponse* res = static_cast<DataBlobResponse*>(r.get());
+        TestDataBlob recvBlob;
+        recvBlob.deserialise(*client, res->byteOrder());
+        CPPUNIT_ASSERT(recvBlob == blob);
+    }
+}
+
 void TCPConnectionManagerTest::test_brokenConnection()
 {
     QTcpSocket* client = 0;
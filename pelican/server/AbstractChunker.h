@@ -36,6 +36,7 @@
 #include "server/DataManager.h"
 #include "server/WritableData.h"
 #include "utility/FactoryRegistrar.h"
+#include "utility/ThreadPlacement.h"
 
 #include <QtNetwork/QUdpSocket>
 #include <QtCore/QList>
@@ -70,7 +71,7 @@ class AbstractChunker
 
         /// Constructs a new AbstractChunker (used in testing).
         AbstractChunker() : _host(""), _port(0), _dataManager(0),
-        _active(false)
+        _active(false), _receiverType("qt")
         {}
 
         /// Destroys the AbstractChunker.
@@ -135,6 +136,28 @@ class AbstractChunker
         /// Gets the name of the chunker (related to XML)
         const QString& name() const { return _name; }
 
+        /// Returns the receiver backend used to drive the chunker
+        /// ("qt" or "uring").
+        const QString& receiverType() const { return _receiverType; }
+
+        /// Sets the receiver backend used to drive the chunker.
+        void setReceiverType(const QString& type);
+
+        /// Returns the name of the receive ring (and its thread) used by
+        /// the "uring" receiver.
+        const QString& ring() const { return _ring; }
+
+        /// Returns the placement of the thread receiving data for the chunker.
+        const ThreadPlacement& threadPlacement() const { return _placement; }
+
+        /// Sets the placement of the thread receiving data for the chunker.
+        void setThreadPlacement(const ThreadPlacement& placement)
+        { _placement = placement; }
+
+        /// Returns the file descriptor that signals when data is waiting on
+        /// a device made by newDevice(), or -1 if there is none.
+        virtual int deviceDescriptor(QIODevice* device) const;
+
     protected:
         /// Access to memory to store data is through this interface.
         /// The WritableData object should always be checked with its
@@ -227,6 +250,10 @@ class AbstractChunker
         QHash< QString, QString > _adapterTypes;
 
         QString _name; // NOTE this may not be respected everywhere yet.
+
+        QString _receiverType; ///< Receiver backend ("qt" or "uring").
+        QString _ring;         ///< Name of the receive ring.
+        ThreadPlacement _placement; ///< Receiver thread placement.
 };
 
 } // namespace pelican
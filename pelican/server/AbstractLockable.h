@@ -101,6 +101,10 @@ class AbstractLockable : public QObject
 
         /// Signal emitted when the write lock count reaches zero.
         void unlockedWrite();
+
+        /// Signal emitted when the write lock count reaches zero, carrying
+        /// the object that was unlocked.
+        void unlockedWrite(AbstractLockable* data);
 };
 
 } // namespace pelican
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ABSTRACTUDPCHUNKER_H
+#define ABSTRACTUDPCHUNKER_H
+
+/**
+ * @file AbstractUdpChunker.h
+ */
+
+#include "server/AbstractChunker.h"
+
+#include <QtCore/QBitArray>
+#include <QtCore/QByteArray>
+#include <QtCore/QSysInfo>
+#include <QtCore/QVector>
+
+#include <iostream>
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+namespace pelican {
+
+class ConfigNode;
+class DataChunk;
+
+/**
+ * @ingroup c_server
+ *
+ * @class AbstractUdpChunker
+ *
+ * @brief
+ * Base class for chunkers receiving fixed-size UDP packets.
+ *
+ * @details
+ * The chunker owns a native UDP socket with a large receive buffer, and
+ * reads datagrams in batches (with recvmmsg() on Linux) directly into
+ * consecutive packet slots of the chunk memory, with no intermediate copy
+ * and one system call per batch rather than per packet.
+ *
+ * Derived classes describe the packets with setPacketSize() (normally in
+ * their constructor) and may reimplement checkPacket() to validate the
+ * packet header. Each chunk holds packetsPerChunk() packets, headers
+ * included, in the order they were received. Datagrams of the wrong size,
+ * and those rejected by checkPacket(), are dropped. If the chunker is
+ * stopped before a chunk is full, the remaining slots are zero-filled and
+ * counted as lost packets (see DataChunk::lostPackets()).
+ *
+ * Options, in addition to the connection and data tags read by
+ * AbstractChunker:
+ * @code
+ * <chunk packets="128"/>
+ * <socket receiveBuffer="33554432" batch="64"/>
+ * @endcode
+ * where @c packets is the number of packets in a chunk, @c receiveBuffer
+ * the socket receive buffer size in bytes (limited by the system, e.g. by
+ * net.core.rmem_max on Linux) and @c batch the maximum number of datagrams
+ * read with one system call.
+ *
+ * If the packets carry a sequence number (or a timestamp that advances by a
+ * fixed step from one packet to the next), the chunker can place each packet
+ * at its own offset in the chunk, so that a lost or reordered packet does
+ * not shift the packets that follow it:
+ * @code
+ * <sequence offset="0" bytes="8" byteOrder="big" step="1" reorder="16" fill="zero"/>
+ * @endcode
+ * The sequence number is read from the @c bytes (1 to 8) bytes at @c offset
+ * in the packet header (see also setSequenceField() and packetSequence()),
+ * and counters narrower than 64 bits may wrap around. The first packet
+ * received starts the first chunk. A chunk is complete once all its packets
+ * have arrived, or once a packet arrives more than @c reorder packets beyond
+ * its end. Packets belonging to the next chunk that arrive before this are
+ * held back for it. Missing packets are zero-filled (unless @c fill is
+ * @c none), and their number is recorded in the chunk (see
+ * DataChunk::lostPackets()) and in the statistics. A jump of more than a
+ * chunk in the sequence (for example, a restarted source) starts a new
+ * chunk at the new sequence number.
+ */
+class AbstractUdpChunker : public AbstractChunker
+{
+    public:
+        /// Receive statistics.
+        struct Statistics
+        {
+            Statistics() : chunks(0), packets(0), reads(0), invalid(0),
+                    discarded(0), lost(0), reordered(0), duplicates(0),
+                    late(0), resyncs(0) {}
+
+            /// Returns the mean number of packets per read (system call).
+            double packetsPerRead() const
+            { return reads ? double(packets) / reads : 0.0; }
+
+            /// Prints a summary of the statistics.
+            void report(std::ostream& stream) const;
+
+            quint64 chunks;    ///< Chunks written.
+            quint64 packets;   ///< Packets written to chunks.
+            quint64 reads;     ///< Batched reads returning data.
+            quint64 invalid;   ///< Packets dropped by size or checkPacket().
+            quint64 discarded; ///< Packets dropped for lack of buffer space.
+            quint64 lost;      ///< Packets missing from chunks.
+            quint64 reordered; ///< Packets moved to their place (sequenced).
+            quint64 duplicates;///< Repeated packets dropped (sequenced).
+            quint64 late;      ///< Packets for completed chunks (sequenced).
+            quint64 resyncs;   ///< Jumps in the sequence (sequenced).
+        };
+
+    public:
+        /// Constructs the chunker from its configuration node.
+        AbstractUdpChunker(const ConfigNode& config);
+
+        /// Destroys the chunker.
+        virtual ~AbstractUdpChunker();
+
+        /// Creates the UDP socket bound to the host and port.
+        virtual QIODevice* newDevice();
+
+        /// Fills the next chunk with packets from the socket.
+        virtual void next(QIODevice* device);
+
+        /// Returns the size of each packet, in bytes (including the header).
+        size_t packetSize() const { return _packetSize; }
+
+        /// Returns the size of the packet header, in bytes.
+        size_t headerSize() const { return _headerSize; }
+
+        /// Returns the number of packets in each chunk.
+        int packetsPerChunk() const { return _packetsPerChunk; }
+
+        /// Returns the size of each chunk, in bytes.
+        size_t chunkSize() const { return _packetSize * _packetsPerChunk; }
+
+        /// Returns the receive statistics.
+        const Statistics& statistics() const { return _stats; }
+
+        /// Returns the socket descriptor of the device.
+        int deviceDescriptor(QIODevice* device) const;
+
+        /// Returns true if packets are placed by their sequence number.
+        bool isSequenced() const { return _seqBytes > 0; }
+
+    protected:
+        /// Sets the size of each packet and of its header, in bytes.
+        void setPacketSize(size_t size, size_t headerSize = 0);
+
+        /// Sets the number of packets in each chunk.
+        void setPacketsPerChunk(int packets);
+
+        /// Returns true if the packet is to be kept in the chunk. The default
+        /// accepts all packets of the correct size.
+        virtual bool checkPacket(const char* packet) const;
+
+        /// Places packets by the sequence number held in the @p bytes bytes
+        /// at @p offset in the header, in the given byte order. The number
+        /// advances by @p step from one packet to the next.
+        void setSequenceField(size_t offset, int bytes,
+                QSysInfo::Endian order = QSysInfo::BigEndian,
+                quint64 step = 1);
+
+        /// Sets the number of packets beyond the end of a chunk to wait for
+        /// its missing packets.
+        void setReorderWindow(int packets) { _reorder = qMax(packets, 0); }
+
+        /// Returns the sequence number of the packet. The default reads the
+        /// field set with setSequenceField().
+        virtual quint64 packetSequence(const char* packet) const;
+
+    private:
+        /// Reads up to @p count datagrams into consecutive packet slots
+        /// starting at @p slots, returning the number read or -1 if none.
+        int _read(int socket, char* slots, int count);
+
+        /// As _read(), but returns the number of valid packets, moved to
+        /// the start of the slots.
+        int _receive(int socket, char* slots, int count);
+
+        /// Returns true if the @p i-th packet read is valid.
+        bool _isValid(const char* packet, int i) const
+        { return _lengths[i] == (int)_packetSize && checkPacket(packet); }
+
+        /// Fills the chunk at @p chunk with packets placed by sequence.
+        void _nextSequenced(int socket, char* chunk, DataChunk* data);
+
+        /// Copies the packet with index @p index to its slot in the chunk,
+        /// or holds it back for the next chunk.
+        void _place(const char* packet, quint64 index, char* chunk);
+
+        /// Returns the packet index of the packet, unwrapping narrow
+        /// sequence counters.
+        quint64 _index(const char* packet);
+
+        /// Starts the next chunk (from the held-back packets).
+        void _startChunk(char* chunk);
+
+        /// Waits up to @p msec milliseconds for the socket to be readable.
+        static bool _wait(int socket, int msec);
+
+    private:
+        size_t _packetSize;
+        size_t _headerSize;
+        int _packetsPerChunk;
+        int _batch;
+        int _receiveBuffer;
+        QVector<int> _lengths;
+        QVector<quint64> _indices;
+
+        // Sequence tracking.
+        size_t _seqOffset;
+        int _seqBytes;
+        QSysInfo::Endian _seqOrder;
+        quint64 _seqStep;
+        int _reorder;
+        bool _zeroFill;
+        bool _started;
+        quint64 _lastSeq;   // Last (unwrapped) sequence number.
+        quint64 _base;      // Packet index of the first slot of the chunk.
+        quint64 _nextBase;  // Packet index of the first slot of the next.
+        int _filledCount;   // Packets placed in the current chunk.
+        int _highest;       // Highest slot filled in the current chunk.
+        bool _complete;     // Current chunk complete.
+        QBitArray _filled;
+        QBitArray _pendingFilled;
+        QByteArray _pending;
+#if defined(__linux__)
+        QVector<struct mmsghdr> _messages;
+        QVector<struct iovec> _iovecs;
+#endif
+        QByteArray _scratch;
+        Statistics _stats;
+};
+
+} // namespace pelican
+#endif // ABSTRACTUDPCHUNKER_H
@@ -43,6 +43,7 @@
 
 #include "utility/FactoryConfig.h"
 #include "server/DataReceiver.h"
+#include "server/UringReceiver.h"
 #include "utility/Config.h"
 
 
@@ -108,6 +109,7 @@ class ChunkerManager
         QSet<QString> _streamDataTypes;
         QSet<QString> _serviceDataTypes;
         QHash<AbstractChunker*, DataReceiver*> _dataReceivers;
+        QHash<AbstractChunker*, UringReceiver*> _uringReceivers;
 };
 
 } // namespace pelican
@@ -35,6 +35,10 @@
 
 #include <QtCore/QString>
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+
+#include <climits>
 
 #include "server/WritableData.h"
 #include "server/LockedData.h"
@@ -48,6 +52,7 @@ class StreamData;
 class LockableStreamData;
 class ServiceDataBuffer;
 class StreamDataBuffer;
+class SharedMemorySegment;
 
 /**
  * @ingroup c_server
@@ -92,6 +97,17 @@ class DataManager
         /// Associate service data
         void associateServiceData(LockableStreamData* data);
 
+        /// Indicate that a chunk in a stream buffer has become active.
+        /// To be called by the stream buffer only.
+        void activatedData(StreamDataBuffer* buffer);
+
+        /// Returns the number of stream chunks activated so far.
+        quint64 activationCount() const;
+
+        /// Blocks until a stream chunk is activated after @p count, or until
+        /// @p timeout milliseconds have elapsed.
+        bool waitForData(quint64 count, unsigned long timeout = ULONG_MAX);
+
         /// Returns the data types handled by this manager.
         const DataSpec& dataSpec() const { return _specs; }
 
@@ -122,6 +138,10 @@ class DataManager
         /// Set up a stream buffer for the specified type.
         StreamDataBuffer* getStreamBuffer(const QString& type);
 
+        /// Returns the shared memory segment of the specified stream buffer
+        /// (or 0 if the buffer is not in shared memory).
+        const SharedMemorySegment* sharedMemory(const QString& type) const;
+
         /// Return a WritableData object that represents a space in the buffer
         /// of a minimum size specified. An invalid Writable object will be
         /// returned if the space is not available.
@@ -219,6 +239,11 @@ class DataManager
         QHash<QString, StreamDataBuffer*> _streams;
         QHash<QString, ServiceDataBuffer*> _service;
         int _verboseLevel;
+
+        // Stream chunk activation notification.
+        mutable QMutex _activationMutex;
+        QWaitCondition _activated;
+        quint64 _activationCount;
 };
 
 } // namespace pelican
@@ -31,6 +31,7 @@
 
 
 #include <QtNetwork/QTcpServer>
+#include "utility/ThreadPlacement.h"
 
 /**
  * @file PelicanPortServer.h
@@ -39,6 +40,7 @@
 namespace pelican {
 class AbstractProtocol;
 class DataManager;
+class UnixSocketServer;
 
 /**
  * @ingroup c_server
@@ -65,14 +67,36 @@ class PelicanPortServer : public QTcpServer
 
         void setVerbosity(int level) { _verboseLevel=level; };
 
+        /// Sets the placement of the session threads.
+        void setThreadPlacement(const ThreadPlacement& placement)
+        { _placement = placement; }
+
+        /// Sets the time sessions wait for clients to release data served
+        /// from shared memory, in milliseconds.
+        void setReleaseTimeout(int msec) { _releaseTimeout = msec; }
+
+        /// Listens for connections on a Unix domain socket at @p path as
+        /// well as (or instead of) the TCP port.
+        bool listenLocal(const QString& path);
+
+        /// Returns the Unix domain socket path listened on (if any).
+        QString localPath() const;
+
     protected:
         /// Reimplemented from QTcpServer.
         void incomingConnection(int socketDescriptor);
 
+    private slots:
+        /// Starts a session for a Unix domain socket connection.
+        void _incomingLocal(int socketDescriptor);
+
     private:
         AbstractProtocol* _proto;
         DataManager* _data;
         int _verboseLevel;
+        UnixSocketServer* _local;
+        ThreadPlacement _placement;
+        int _releaseTimeout;
 };
 
 } // namespace pelican
@@ -41,6 +41,7 @@
 #include <QtCore/QThread>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
+#include "utility/ThreadPlacement.h"
 
 namespace pelican {
 
@@ -79,6 +80,11 @@ class PelicanServer : public QThread
         /// Ownership of AbstractProtocol is transferred to this class.
         void addProtocol(AbstractProtocol*, quint16 port);
 
+        /// Associate a Unix domain socket path with a particular protocol,
+        /// for clients on the same host.
+        /// Ownership of AbstractProtocol is transferred to this class.
+        void addProtocol(AbstractProtocol*, const QString& path);
+
         /// Adds a stream chunker.
         void addStreamChunker(QString type, QString name = QString());
 
@@ -98,11 +104,15 @@ class PelicanServer : public QThread
 
     private:
         QMap<quint16,AbstractProtocol*> _protocolPortMap;
+        QMap<QString,AbstractProtocol*> _protocolPathMap;
         QMutex _mutex;
         ChunkerManager* _chunkerManager;
         bool _ready;
         const Config* _config;
         int _verboseLevel;
+        ThreadPlacement _placement; // Server and session threads.
+        bool _tracing; // True if the server started event tracing.
+        int _releaseTimeout; // Shared memory release timeout, in ms.
 };
 
 } // namespace pelican
@@ -32,6 +32,7 @@
 #include <QtCore/QThread>
 #include <QtCore/QList>
 #include <QtNetwork/QTcpSocket>
+#include "utility/ThreadPlacement.h"
 #include <string>
 
 /**
@@ -82,12 +83,23 @@ class Session : public QThread
         // set the verbosity level ( 0 = off )
         void setVerbosity(int level);
 
+        /// Sets the placement applied to the session thread when it starts.
+        void setThreadPlacement(const ThreadPlacement& placement)
+        { _placement = placement; }
+
+        /// Sets the time to wait for a client to release data served from
+        /// shared memory, in milliseconds (-1 = wait indefinitely).
+        void setReleaseTimeout(int msec) { _releaseTimeout = msec; }
+
     protected:
         /// Returns the first valid stream data with associated service data.
         QList<LockedData> processStreamDataRequest(const StreamDataRequest& req,
                 unsigned timeout = 0);
 
         QList<LockedData> processServiceDataRequest(const ServiceDataRequest& req);
+
+        /// Waits for the client to release data served from shared memory.
+        bool waitForRelease(QTcpSocket& socket);
         void verbose( const QString& msg, int verboseLevel = 1 );
 
     signals:
@@ -99,6 +111,8 @@ class Session : public QThread
         AbstractProtocol* _protocol;
         int _verboseLevel;
         std::string _clientInfo;
+        ThreadPlacement _placement;
+        int _releaseTimeout; // Shared memory release timeout, in ms.
         friend class SessionTest; // unit test
 };
 
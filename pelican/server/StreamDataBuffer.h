@@ -44,10 +44,12 @@
 
 namespace pelican {
 
+class AbstractLockable;
 class LockableStreamData;
 class DataChunk;
 class DataManager;
 class LockedData;
+class SharedMemorySegment;
 
 
 /**
@@ -154,6 +156,13 @@ class StreamDataBuffer : public AbstractDataBuffer
         /// Set the data manager to use.
         void setDataManager(DataManager* manager) { _dataManager = manager; }
 
+        /// Allocates the chunks of the buffer in a shared memory segment.
+        /// Must be called before the first chunk is allocated.
+        void setSharedMemory(bool enabled);
+
+        /// Returns the shared memory segment holding the chunks, or 0.
+        const SharedMemorySegment* sharedMemory() const { return _segment; }
+
         /// Returns the maximum size of the buffer, in bytes.
         // DEPRECATED in buffer status function re-write
         size_t maxSize() const { return _max; }
@@ -204,8 +213,8 @@ class StreamDataBuffer : public AbstractDataBuffer
         int numUsableChunks(size_t chunkSize);
 
     protected slots:
-        /// Places the data chunk that emitted the signal on the serve queue.
-        void activateData();
+        /// Places the given data chunk on the serve queue.
+        void activateData(AbstractLockable*);
 
         /// Places the data chunk that emitted the signal on the empty queue.
         void deactivateData();
@@ -228,6 +237,9 @@ class StreamDataBuffer : public AbstractDataBuffer
         size_t _maxChunkSize;  // Maximum allowed chunk size, in bytes.
         size_t _space;         // Current free (unallocated) space, in bytes.
 
+        SharedMemorySegment* _segment; // Chunk memory if shared (or 0).
+        size_t _segmentUsed;           // Bytes of the segment allocated.
+
         QList<LockableStreamData*>  _allChunks;  // All allocated memory blocks.
         QQueue<LockableStreamData*> _serveQueue; // Blocks waiting to be served.
         QList<LockableStreamData*>  _emptyQueue; // Blocks ready for reuse.
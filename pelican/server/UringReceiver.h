@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef URINGRECEIVER_H
+#define URINGRECEIVER_H
+
+/**
+ * @file UringReceiver.h
+ */
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+class QIODevice;
+
+namespace pelican {
+
+class AbstractChunker;
+class DataReceiver;
+
+/**
+ * @ingroup c_server
+ *
+ * @class UringReceiver
+ *
+ * @brief
+ * Drives a chunker from an io_uring submission ring.
+ *
+ * @details
+ * A DataReceiver runs a Qt event loop for each chunker, and so pays for an
+ * event dispatch on every read. The UringReceiver instead arms a multishot
+ * poll request on the descriptor of the chunker device (see
+ * AbstractChunker::deviceDescriptor()) and calls AbstractChunker::next()
+ * directly from the completion loop, until no more data is waiting on the
+ * device.
+ *
+ * As next() blocks until it has filled a chunk, each ring drives a single
+ * chunker: chunkers sharing a ring thread would stall each other. Chunkers
+ * select this receiver in their configuration, the ring name naming the
+ * receiver thread (see ChunkerManager):
+ * @code
+ * <receiver type="uring" ring="udp"/>
+ * @endcode
+ *
+ * Chunkers whose device has no descriptor (for example the FileChunker,
+ * which depends on Qt file system notifications), and all chunkers if the
+ * kernel does not support io_uring, are handed to their own DataReceiver.
+ */
+class UringReceiver : public QThread
+{
+    private:
+        struct Ring;
+
+    public:
+        /// Constructs a receiver for the named ring.
+        UringReceiver(const QString& name = QString());
+
+        /// Stops the receiver and waits for its thread to finish.
+        ~UringReceiver();
+
+        /// Sets the chunker to be driven by the ring (before start()).
+        void addChunker(AbstractChunker* chunker);
+
+        /// Returns the chunker driven by the receiver (as a list).
+        const QList<AbstractChunker*>& chunkers() const { return _chunkers; }
+
+        /// Returns the name of the ring.
+        const QString& name() const { return _name; }
+
+        /// Returns true if the running thread has set up the ring.
+        bool usingRing() const { return _usingRing; }
+
+        /// Returns the current device of the chunker (0 if unknown).
+        QIODevice* currentDevice(AbstractChunker* chunker) const;
+
+        /// Returns true if io_uring is available on this system.
+        static bool isSupported();
+
+    protected:
+        /// Runs the completion loop.
+        void run();
+
+    private:
+        /// Hands the chunker to its own DataReceiver.
+        void _fallback(int i);
+
+        /// Creates the device of the chunker and arms a poll for it.
+        void _setupDevice(Ring& ring, int i);
+
+        /// Calls next() on the chunker while data is waiting.
+        void _read(Ring& ring, int i);
+
+        /// Replaces the device of a disconnected socket.
+        void _reconnect(Ring& ring, int i);
+
+        /// Wakes the thread from its wait for completions.
+        void _wake();
+
+    private:
+        QString _name;
+        volatile bool _active;
+        bool _usingRing;
+        int _wakeFd;
+        QList<AbstractChunker*> _chunkers;
+        QVector<QIODevice*> _devices;
+        QVector<int> _descriptors;
+        QVector<quint32> _generations;
+        QHash<AbstractChunker*, DataReceiver*> _fallbacks;
+        mutable QMutex _mutex; // Guards _devices and _fallbacks.
+};
+
+} // namespace pelican
+
+#endif // URINGRECEIVER_H
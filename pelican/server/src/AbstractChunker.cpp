@@ -31,6 +31,8 @@
 #include "server/StreamDataBuffer.h"
 #include "server/ServiceDataBuffer.h"
 
+#include <QtNetwork/QAbstractSocket>
+
 #include <iostream>
 
 namespace pelican {
@@ -47,6 +49,13 @@ namespace pelican {
  *
  * To set a default adapter for the specific stream
  *   <data type="streamName" adapter="AdapterType" />
+ *
+ * To drive the chunker from an io_uring receive ring instead of its own Qt
+ * event loop (see UringReceiver)
+ *   <receiver type="uring" ring="ringName" />
+ *
+ * To place the receiver thread (see ThreadPlacement)
+ *   <thread cores="2,3" priority="50" numaNode="1" />
  */
 AbstractChunker::AbstractChunker(const ConfigNode& config)
 {
@@ -60,6 +69,9 @@ AbstractChunker::AbstractChunker(const ConfigNode& config)
     // happens for file chunkers.
     _host = config.getOption("connection", "host", "");
     _port = (quint16)config.getOption("connection", "port", "0").toUInt();
+    setReceiverType(config.getOption("receiver", "type", "qt"));
+    _ring = config.getOption("receiver", "ring", "");
+    _placement = ThreadPlacement(config);
 
     _active = true; // XXX is this right?
 }
@@ -74,6 +86,32 @@ AbstractChunker::~AbstractChunker()
     stop();
 }
 
+/**
+ * @details
+ * Sets the receiver backend: "qt" (the default) for a DataReceiver thread
+ * calling next() on readyRead(), or "uring" for a UringReceiver.
+ */
+void AbstractChunker::setReceiverType(const QString& type)
+{
+    QString t = type.toLower();
+    if (t != "qt" && t != "uring")
+        throw QString("AbstractChunker: Unknown receiver type '%1'.").arg(type);
+    _receiverType = t;
+}
+
+/**
+ * @details
+ * Returns the descriptor of socket devices. Reimplement this for devices
+ * that wrap a descriptor in some other way, so that they can be driven by a
+ * UringReceiver.
+ */
+int AbstractChunker::deviceDescriptor(QIODevice* device) const
+{
+    if (QAbstractSocket* socket = dynamic_cast<QAbstractSocket*>(device))
+        return socket->socketDescriptor();
+    return -1;
+}
+
 void AbstractChunker::setDataManager(DataManager* dataManager)
 {
     _dataManager = dataManager;
@@ -32,15 +32,21 @@ namespace pelican {
 
 /**
  * @details
- * Decreases the write lock counter, and emits the unlockedWrite signal when
+ * Decreases the write lock counter, and emits the unlockedWrite signals when
  * count returns to 0.
+ *
+ * The unlockedWrite(AbstractLockable*) signal passes the object explicitly,
+ * as sender() cannot be used by slots directly connected from another
+ * thread.
  */
 void AbstractLockable::writeUnlock()
 {
     QMutexLocker locker(&_mutex);
     --_wlock;
-    if ( ! _wlock )
+    if ( ! _wlock ) {
         emit unlockedWrite();
+        emit unlockedWrite(this);
+    }
 }
 
 /**
@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "server/AbstractUdpChunker.h"
+#include "utility/ConfigNode.h"
+
+#include <QtCore/QSocketNotifier>
+#include <QtNetwork/QHostAddress>
+
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace pelican {
+
+namespace {
+
+// A read-only device around a native UDP socket. readyRead() is emitted
+// whenever datagrams are waiting, but datagrams are left on the socket for
+// the chunker to read in batches.
+class UdpSocketDevice : public QIODevice
+{
+    public:
+        UdpSocketDevice(int socket) : QIODevice(), _socket(socket)
+        {
+            QSocketNotifier* notifier = new QSocketNotifier(socket,
+                    QSocketNotifier::Read, this);
+            connect(notifier, SIGNAL(activated(int)), SIGNAL(readyRead()));
+            open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        }
+        ~UdpSocketDevice() { close(); ::close(_socket); }
+
+        int socketDescriptor() const { return _socket; }
+        bool isSequential() const { return true; }
+        qint64 bytesAvailable() const
+        {
+            int bytes = 0;
+            if (::ioctl(_socket, FIONREAD, &bytes) < 0)
+                bytes = 0;
+            return bytes + QIODevice::bytesAvailable();
+        }
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize)
+        {
+            ssize_t n = ::recv(_socket, data, maxSize, MSG_DONTWAIT);
+            if (n < 0)
+                return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+            return n;
+        }
+        qint64 writeData(const char*, qint64) { return -1; }
+
+    private:
+        int _socket;
+};
+
+} // namespace
+
+
+/**
+ * @details
+ * Reads the chunk and socket options. The packet size must be set by the
+ * derived class with setPacketSize().
+ */
+AbstractUdpChunker::AbstractUdpChunker(const ConfigNode& config)
+    : AbstractChunker(config), _packetSize(0), _headerSize(0),
+      _seqOffset(0), _seqBytes(0), _seqOrder(QSysInfo::BigEndian), _seqStep(1),
+      _started(false), _lastSeq(0), _base(0), _nextBase(0), _filledCount(0),
+      _highest(-1), _complete(false)
+{
+    _packetsPerChunk = config.getOption("chunk", "packets", "128").toInt();
+    _batch = config.getOption("socket", "batch", "64").toInt();
+    _receiveBuffer = config.getOption("socket", "receiveBuffer",
+            "33554432").toInt();
+    if (_packetsPerChunk < 1)
+        throw QString("AbstractUdpChunker: Invalid number of packets per chunk.");
+
+    // Sequence tracking.
+    int bytes = config.getOption("sequence", "bytes", "0").toInt();
+    if (bytes > 0) {
+        QString order = config.getOption("sequence", "byteOrder", "big");
+        setSequenceField(config.getOption("sequence", "offset", "0").toUInt(),
+                bytes, order.toLower() == "little" ? QSysInfo::LittleEndian
+                : QSysInfo::BigEndian,
+                config.getOption("sequence", "step", "1").toULongLong());
+    }
+    _reorder = config.getOption("sequence", "reorder", "16").toInt();
+    _zeroFill = config.getOption("sequence", "fill", "zero").toLower() != "none";
+    _batch = qBound(1, _batch, 1024);
+    _lengths.resize(_batch);
+    _indices.resize(_batch);
+#if defined(__linux__)
+    _messages.resize(_batch);
+    _iovecs.resize(_batch);
+#endif
+}
+
+
+AbstractUdpChunker::~AbstractUdpChunker()
+{
+}
+
+
+/**
+ * @details
+ * Sets the size in bytes of each packet (@p size, including the header) and
+ * of the packet header (@p headerSize).
+ */
+void AbstractUdpChunker::setPacketSize(size_t size, size_t headerSize)
+{
+    if (size == 0 || headerSize > size)
+        throw QString("AbstractUdpChunker: Invalid packet size.");
+    _packetSize = size;
+    _headerSize = headerSize;
+    _scratch.resize(_batch * _packetSize);
+}
+
+
+void AbstractUdpChunker::setPacketsPerChunk(int packets)
+{
+    if (packets < 1)
+        throw QString("AbstractUdpChunker: Invalid number of packets per chunk.");
+    _packetsPerChunk = packets;
+}
+
+
+/**
+ * @details
+ * Called for each datagram of the correct size, as it lies in the chunk.
+ * Reimplement this to check the packet header; return false to drop the
+ * packet.
+ */
+bool AbstractUdpChunker::checkPacket(const char*) const
+{
+    return true;
+}
+
+
+/**
+ * @details
+ * Enables placement of packets by sequence number. The number is held in
+ * the @p bytes (1 to 8) bytes at @p offset in the packet, in byte order
+ * @p order, and advances by @p step from one packet to the next.
+ */
+void AbstractUdpChunker::setSequenceField(size_t offset, int bytes,
+        QSysInfo::Endian order, quint64 step)
+{
+    if (bytes < 1 || bytes > 8 || step == 0)
+        throw QString("AbstractUdpChunker: Invalid sequence field.");
+    _seqOffset = offset;
+    _seqBytes = bytes;
+    _seqOrder = order;
+    _seqStep = step;
+}
+
+
+/**
+ * @details
+ * Reads the sequence field of the packet. Reimplement this if the sequence
+ * number has to be derived from the header in some other way.
+ */
+quint64 AbstractUdpChunker::packetSequence(const char* packet) const
+{
+    const uchar* p = (const uchar*)packet + _seqOffset;
+    quint64 value = 0;
+    if (_seqOrder == QSysInfo::BigEndian) {
+        for (int i = 0; i < _seqBytes; ++i)
+            value = (value << 8) | p[i];
+    }
+    else {
+        for (int i = _seqBytes - 1; i >= 0; --i)
+            value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+
+/**
+ * @details
+ * Creates a UDP socket bound to the configured host and port, with the
+ * receive buffer size requested in the configuration. A warning is printed
+ * if the system limits the buffer to less than requested.
+ */
+QIODevice* AbstractUdpChunker::newDevice()
+{
+    if (_packetSize == 0)
+        throw QString("AbstractUdpChunker: Packet size not set.");
+    if (isSequenced() && _seqOffset + _seqBytes > _packetSize)
+        throw QString("AbstractUdpChunker: Sequence field outside packet.");
+
+    int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket < 0)
+        throw QString("AbstractUdpChunker: Unable to create socket: %1")
+                .arg(strerror(errno));
+
+    if (_receiveBuffer > 0) {
+        ::setsockopt(socket, SOL_SOCKET, SO_RCVBUF, &_receiveBuffer,
+                sizeof(_receiveBuffer));
+        int size = 0;
+        socklen_t length = sizeof(size);
+        ::getsockopt(socket, SOL_SOCKET, SO_RCVBUF, &size, &length);
+        // Linux reports double the requested size (for book-keeping).
+        if (size < _receiveBuffer)
+            std::cerr << "AbstractUdpChunker: Receive buffer limited to "
+                      << size << " bytes (requested " << _receiveBuffer
+                      << ")." << std::endl;
+    }
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port());
+    QHostAddress hostAddress(host());
+    address.sin_addr.s_addr = hostAddress.isNull() ? htonl(INADDR_ANY)
+            : htonl(hostAddress.toIPv4Address());
+    if (::bind(socket, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        QString error(strerror(errno));
+        ::close(socket);
+        throw QString("AbstractUdpChunker: Unable to bind to %1:%2: %3")
+                .arg(host()).arg(port()).arg(error);
+    }
+
+    return new UdpSocketDevice(socket);
+}
+
+
+/**
+ * @details
+ * Returns the descriptor of the socket made by newDevice().
+ */
+int AbstractUdpChunker::deviceDescriptor(QIODevice* device) const
+{
+    if (UdpSocketDevice* udp = dynamic_cast<UdpSocketDevice*>(device))
+        return udp->socketDescriptor();
+    return AbstractChunker::deviceDescriptor(device);
+}
+
+
+/**
+ * @details
+ * Gets a chunk of chunkSize() bytes from the data manager and fills it with
+ * packetsPerChunk() packets, read in batches straight into the chunk (and
+ * placed by sequence number, if enabled).
+ * If no chunk is available, one batch of waiting datagrams is discarded.
+ */
+void AbstractUdpChunker::next(QIODevice* device)
+{
+    int socket = deviceDescriptor(device);
+    if (socket < 0)
+        throw QString("AbstractUdpChunker: Invalid device.");
+
+    WritableData writableData = getDataStorage(chunkSize());
+    if (!writableData.isValid()) {
+        if (!isActive())
+            return;
+        int discarded = _receive(socket, _scratch.data(), _batch);
+        if (discarded > 0)
+            _stats.discarded += discarded;
+        return;
+    }
+
+    char* ptr = (char*)writableData.ptr();
+    if (isSequenced()) {
+        _nextSequenced(socket, ptr, writableData.data()->dataChunk().get());
+        return;
+    }
+
+    int packets = 0;
+    while (isActive() && packets < _packetsPerChunk) {
+        int count = qMin(_batch, _packetsPerChunk - packets);
+        int n = _receive(socket, ptr + packets * _packetSize, count);
+        if (n < 0)
+            _wait(socket, 100);
+        else
+            packets += n;
+    }
+
+    // Fill the slots left empty if the chunker was stopped mid-chunk.
+    int lost = _packetsPerChunk - packets;
+    if (lost > 0 && _zeroFill)
+        memset(ptr + packets * _packetSize, 0, lost * _packetSize);
+    writableData.data()->dataChunk()->setLostPackets(lost);
+    _stats.lost += lost;
+    _stats.packets += packets;
+    ++_stats.chunks;
+}
+
+
+/**
+ * @details
+ * Fills the chunk with packets placed by their sequence numbers.
+ *
+ * Batches are read straight into the slots following the highest slot
+ * filled so far, which in the usual case of packets arriving in order is
+ * where they belong. Packets that do not belong there are staged in the
+ * scratch buffer and copied to their own slot, or held back for the next
+ * chunk. Once the chunk is complete, missing packets are zero-filled and
+ * counted in the chunk meta-data.
+ */
+void AbstractUdpChunker::_nextSequenced(int socket, char* chunk,
+        DataChunk* data)
+{
+    _startChunk(chunk);
+    while (isActive() && !_complete) {
+        int first = _highest + 1;
+        int count = qMin(_batch, _packetsPerChunk - first);
+        bool direct = count > 0;
+        char* slots = direct ? chunk + first * _packetSize : _scratch.data();
+        int n = _read(socket, slots, direct ? count : _batch);
+        if (n < 0) {
+            _wait(socket, 100);
+            continue;
+        }
+
+        // Keep packets that were read into their own slot.
+        bool staged = false;
+        for (int i = 0; i < n; ++i) {
+            const char* packet = slots + i * _packetSize;
+            if (!_isValid(packet, i)) {
+                ++_stats.invalid;
+                _lengths[i] = -1;
+                continue;
+            }
+            _indices[i] = _index(packet);
+            if (!_started) {
+                _started = true;
+                _base = _indices[i];
+                _nextBase = _base + _packetsPerChunk;
+            }
+            int slot = first + i;
+            if (direct && _indices[i] == _base + slot && !_filled.testBit(slot)) {
+                _filled.setBit(slot);
+                ++_filledCount;
+                _highest = qMax(_highest, slot);
+                _lengths[i] = -1;
+            }
+            else if (direct) {
+                memcpy(_scratch.data() + i * _packetSize, packet, _packetSize);
+                staged = true;
+            }
+        }
+
+        // Place the others.
+        if (staged || !direct) {
+            for (int i = 0; i < n; ++i) {
+                if (_lengths[i] >= 0)
+                    _place(_scratch.data() + i * _packetSize, _indices[i], chunk);
+            }
+        }
+        if (_filledCount == _packetsPerChunk)
+            _complete = true;
+    }
+
+    // Fill the gaps.
+    int lost = _packetsPerChunk - _filledCount;
+    if (lost > 0 && _zeroFill) {
+        for (int i = 0; i < _packetsPerChunk; ++i) {
+            if (!_filled.testBit(i))
+                memset(chunk + i * _packetSize, 0, _packetSize);
+        }
+    }
+    data->setLostPackets(lost);
+    _stats.lost += lost;
+    _stats.packets += _filledCount;
+    ++_stats.chunks;
+}
+
+
+/**
+ * @details
+ * Starts a new chunk, moving the packets held back for it into place.
+ */
+void AbstractUdpChunker::_startChunk(char* chunk)
+{
+    int n = _packetsPerChunk;
+    if (_started) {
+        _base = _nextBase;
+        _nextBase = _base + n;
+    }
+    if (_pending.size() != (int)chunkSize()) {
+        _pending.resize(chunkSize());
+        _pendingFilled.fill(false, n);
+    }
+    _filled.fill(false, n);
+    _filledCount = 0;
+    _highest = -1;
+    for (int i = 0; i < n; ++i) {
+        if (_pendingFilled.testBit(i)) {
+            memcpy(chunk + i * _packetSize, _pending.constData() + i * _packetSize,
+                    _packetSize);
+            _filled.setBit(i);
+            ++_filledCount;
+            _highest = i;
+        }
+    }
+    _pendingFilled.fill(false);
+    _complete = (_filledCount == n);
+}
+
+
+/**
+ * @details
+ * Copies a packet that was not read into its own slot to where it belongs:
+ * - a slot of the current chunk;
+ * - a slot of the next chunk, held back until the next chunk starts. A
+ *   packet more than the reorder window beyond the end of the current
+ *   chunk completes it;
+ * - nowhere, if its chunk is already complete (a late packet);
+ * - the first slot of the next chunk, if it is more than a chunk away from
+ *   the current or next chunk (the sequence has jumped).
+ */
+void AbstractUdpChunker::_place(const char* packet, quint64 index, char* chunk)
+{
+    int n = _packetsPerChunk;
+    qint64 slot = (qint64)(index - _base);
+    qint64 ahead = (qint64)(index - _nextBase);
+    if (slot >= 0 && slot < n) {
+        if (_filled.testBit(slot)) {
+            ++_stats.duplicates;
+            return;
+        }
+        memcpy(chunk + slot * _packetSize, packet, _packetSize);
+        _filled.setBit(slot);
+        ++_filledCount;
+        _highest = qMax(_highest, (int)slot);
+        ++_stats.reordered;
+    }
+    else if (ahead >= 0 && ahead < n) {
+        if (_pendingFilled.testBit(ahead)) {
+            ++_stats.duplicates;
+            return;
+        }
+        memcpy(_pending.data() + ahead * _packetSize, packet, _packetSize);
+        _pendingFilled.setBit(ahead);
+        ++_stats.reordered;
+        if (slot >= n + qMin(_reorder, n - 1))
+            _complete = true;
+    }
+    else if (slot < 0 && slot >= -2 * n) {
+        ++_stats.late;
+    }
+    else {
+        ++_stats.resyncs;
+        _complete = true;
+        _nextBase = index;
+        _pendingFilled.fill(false);
+        memcpy(_pending.data(), packet, _packetSize);
+        _pendingFilled.setBit(0);
+    }
+}
+
+
+/**
+ * @details
+ * Returns the packet index (sequence number divided by the step). Counters
+ * narrower than 64 bits are unwrapped relative to the latest sequence
+ * number seen.
+ */
+quint64 AbstractUdpChunker::_index(const char* packet)
+{
+    quint64 sequence = packetSequence(packet);
+    if (_seqBytes < 8) {
+        quint64 range = Q_UINT64_C(1) << (8 * _seqBytes);
+        sequence &= range - 1;
+        if (_started) {
+            quint64 delta = (sequence - _lastSeq) & (range - 1);
+            if (delta < range / 2)
+                sequence = _lastSeq + delta;
+            else if (_lastSeq >= range - delta)
+                sequence = _lastSeq - (range - delta);
+        }
+    }
+    if (!_started || sequence > _lastSeq)
+        _lastSeq = sequence;
+    return sequence / _seqStep;
+}
+
+
+/**
+ * @details
+ * Reads up to @p count datagrams without blocking, recording their lengths
+ * (-1 if truncated). Returns the number read, or -1 if no datagrams were
+ * waiting.
+ */
+int AbstractUdpChunker::_read(int socket, char* slots, int count)
+{
+    int received = 0;
+#if defined(__linux__)
+    struct mmsghdr* messages = _messages.data();
+    struct iovec* iovecs = _iovecs.data();
+    memset(messages, 0, count * sizeof(struct mmsghdr));
+    for (int i = 0; i < count; ++i) {
+        iovecs[i].iov_base = slots + i * _packetSize;
+        iovecs[i].iov_len = _packetSize;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    received = ::recvmmsg(socket, messages, count, MSG_DONTWAIT, 0);
+    if (received <= 0)
+        return -1;
+    for (int i = 0; i < received; ++i) {
+        _lengths[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1
+                : (int)messages[i].msg_len;
+    }
+#else
+    for (; received < count; ++received) {
+        ssize_t n = ::recv(socket, slots + received * _packetSize,
+                _packetSize, MSG_DONTWAIT | MSG_TRUNC);
+        if (n < 0)
+            break;
+        _lengths[received] = (int)n;
+    }
+    if (received == 0)
+        return -1;
+#endif
+    ++_stats.reads;
+    return received;
+}
+
+
+/**
+ * @details
+ * Reads up to @p count datagrams without blocking. Valid packets are left
+ * in consecutive slots; invalid ones are overwritten by the packets
+ * following them. Returns the number of valid packets, or -1 if no
+ * datagrams were waiting.
+ */
+int AbstractUdpChunker::_receive(int socket, char* slots, int count)
+{
+    int received = _read(socket, slots, count);
+    if (received < 0)
+        return -1;
+
+    int valid = 0;
+    for (int i = 0; i < received; ++i) {
+        char* packet = slots + i * _packetSize;
+        if (!_isValid(packet, i)) {
+            ++_stats.invalid;
+            continue;
+        }
+        if (valid != i)
+            memmove(slots + valid * _packetSize, packet, _packetSize);
+        ++valid;
+    }
+    return valid;
+}
+
+
+bool AbstractUdpChunker::_wait(int socket, int msec)
+{
+    struct pollfd fd;
+    fd.fd = socket;
+    fd.events = POLLIN;
+    fd.revents = 0;
+    return ::poll(&fd, 1, msec) > 0;
+}
+
+
+void AbstractUdpChunker::Statistics::report(std::ostream& stream) const
+{
+    stream << "AbstractUdpChunker: " << chunks << " chunks, " << packets
+           << " packets (" << packetsPerRead() << " per read), "
+           << invalid << " invalid, " << discarded << " discarded";
+    if (lost || reordered || duplicates || late || resyncs)
+        stream << ", " << lost << " lost, " << reordered << " reordered, "
+               << duplicates << " duplicates, " << late << " late, "
+               << resyncs << " resyncs";
+    stream << "." << std::endl;
+}
+
+} // namespace pelican
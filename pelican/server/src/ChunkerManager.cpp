@@ -75,6 +75,9 @@ ChunkerManager::~ChunkerManager()
     foreach (DataReceiver* receiver, _dataReceivers) {
         delete receiver;
     }
+    foreach (UringReceiver* receiver, _uringReceivers) {
+        delete receiver;
+    }
 
     // Delete the chunker factory.
     delete _factory;
@@ -83,7 +86,8 @@ ChunkerManager::~ChunkerManager()
 /**
  * @details
  * Initialises the registered chunkers and calls the start() method on each
- * data receiver.
+ * data receiver. Chunkers configured with the "uring" receiver type are
+ * each driven by a UringReceiver of their own.
  */
 bool ChunkerManager::init(DataManager& dataManager)
 {
@@ -100,6 +104,12 @@ bool ChunkerManager::init(DataManager& dataManager)
     try {
         foreach (AbstractChunker* chunker, _chunkers) {
             chunker->setDataManager(&dataManager);
+            if (chunker->receiverType() == "uring") {
+                UringReceiver* receiver = new UringReceiver(chunker->ring());
+                _uringReceivers.insert(chunker, receiver);
+                receiver->addChunker(chunker);
+                continue;
+            }
             DataReceiver* receiver = new DataReceiver(chunker);
             _dataReceivers.insert(chunker, receiver);
             receiver->start();
@@ -107,6 +117,9 @@ bool ChunkerManager::init(DataManager& dataManager)
             while (!receiver->isRunning()) { sleep(1); }
 #endif
         }
+        foreach (UringReceiver* receiver, _uringReceivers) {
+            receiver->start();
+        }
     }
     catch (const QString& msg)
     {
@@ -118,13 +131,17 @@ bool ChunkerManager::init(DataManager& dataManager)
 
 bool ChunkerManager::isRunning() const
 {
-    if (_dataReceivers.size() == 0)
+    if (_dataReceivers.size() == 0 && _uringReceivers.size() == 0)
         return false;
 
     bool rv = true;
     foreach (DataReceiver* dr, _dataReceivers.values()) {
          rv &= dr->isRunning();
     }
+    foreach (UringReceiver* ur, _uringReceivers.values()) {
+         // A ring that fell back to DataReceivers finishes immediately.
+         rv &= ( ur->isRunning() || ur->isFinished() );
+    }
     return rv;
 }
 
@@ -205,6 +222,9 @@ QIODevice* ChunkerManager::getCurrentDevice( AbstractChunker* chunker ) const
    if( _dataReceivers.contains( chunker ) ) {
        return _dataReceivers[chunker]->currentDevice();
    }
+   if( _uringReceivers.contains( chunker ) ) {
+       return _uringReceivers[chunker]->currentDevice(chunker);
+   }
    return 0;
 }
 
@@ -50,7 +50,7 @@ namespace pelican {
  * Constructor
  */
 DataManager::DataManager(const Config* config, const QString section)
-: _config(config), _verboseLevel(0)
+: _config(config), _verboseLevel(0), _activationCount(0)
 {
     _bufferConfigBaseAddress << Config::NodeId(section, "");
     _bufferConfigBaseAddress << Config::NodeId("buffers", "");
@@ -62,7 +62,7 @@ DataManager::DataManager(const Config* config, const QString section)
  * Constructor
  */
 DataManager::DataManager(const Config* config, const Config::TreeAddress& base)
-: _config(config), _verboseLevel(0)
+: _config(config), _verboseLevel(0), _activationCount(0)
 {
     _bufferConfigBaseAddress = base;
 }
@@ -111,6 +111,53 @@ void DataManager::associateServiceData(LockableStreamData* data)
     }
 }
 
+/**
+ * @details
+ * Records that a chunk in the specified stream buffer has been placed on the
+ * serve queue, and wakes any threads blocked in waitForData().
+ *
+ * This is called from the thread that released the write lock on the chunk
+ * (usually a chunker thread).
+ */
+void DataManager::activatedData(StreamDataBuffer* /*buffer*/)
+{
+    QMutexLocker locker(&_activationMutex);
+    ++_activationCount;
+    _activated.wakeAll();
+}
+
+
+/**
+ * @details
+ * Returns the number of stream chunks activated so far. Read this before
+ * querying the buffers and pass it to waitForData() so that no activation
+ * occurring between the query and the wait is missed.
+ */
+quint64 DataManager::activationCount() const
+{
+    QMutexLocker locker(&_activationMutex);
+    return _activationCount;
+}
+
+
+/**
+ * @details
+ * Blocks the calling thread until a stream chunk has been activated since
+ * the activation count @p count was obtained, or until @p timeout
+ * milliseconds have elapsed.
+ *
+ * @return True if a chunk was activated, false on time out.
+ */
+bool DataManager::waitForData(quint64 count, unsigned long timeout)
+{
+    QMutexLocker locker(&_activationMutex);
+    while (_activationCount == count) {
+        if (!_activated.wait(&_activationMutex, timeout))
+            return _activationCount != count;
+    }
+    return true;
+}
+
 /**
  * @details
  * Marks the specified stream for deactivation. If still streaming we wait
@@ -307,13 +354,30 @@ StreamDataBuffer* DataManager::getStreamBuffer(const QString& type)
                 _bufferMaxChunkSizes[type]=_bufferMaxSizes[type];
             }
         }
-        setStreamDataBuffer(type, new StreamDataBuffer(type,
-                _bufferMaxSizes[type], _bufferMaxChunkSizes[type]));
+        StreamDataBuffer* buffer = new StreamDataBuffer(type,
+                _bufferMaxSizes[type], _bufferMaxChunkSizes[type]);
+        if (config.getOption("buffer", "sharedMemory").toLower() == "true")
+            buffer->setSharedMemory(true);
+        setStreamDataBuffer(type, buffer);
     }
     return _streams[type];
 }
 
 
+/**
+ * @details
+ * Returns the shared memory segment holding the chunks of the specified
+ * stream, or 0 if the stream is unknown or its buffer is not shared.
+ *
+ * @param[in] type The stream data type.
+ */
+const SharedMemorySegment* DataManager::sharedMemory(const QString& type) const
+{
+    StreamDataBuffer* buffer = _streams.value(type);
+    return buffer ? buffer->sharedMemory() : 0;
+}
+
+
 /**
  * @details
  */
@@ -28,6 +28,7 @@
 
 #include "server/DataReceiver.h"
 #include "utility/pelicanTimer.h"
+#include "utility/Tracer.h"
 #include <QtCore/QIODevice>
 #include <QtCore/QTimer>
 #include <QtCore/QFile>
@@ -79,6 +80,12 @@ void DataReceiver::run()
 {
     _active = true;
 
+    // Place the thread (and the buffer memory it allocates).
+    QString name = _chunker->name();
+    if (name.isEmpty())
+        name = _chunker->chunkTypes().value(0);
+    _chunker->threadPlacement().apply("DataReceiver " + name);
+
     // Open up the device to use.
     // N.B. must be done in this thread (i.e. in run())
     _setupDevice();
@@ -116,6 +123,8 @@ void DataReceiver::run()
         }
 
         if (_device && _device->bytesAvailable() > 0) {
+            static const int traceName = Tracer::intern("AbstractChunker::next");
+            Tracer::Scope trace(traceName);
             _chunker->next(_device);
         }
 
@@ -143,7 +152,11 @@ void DataReceiver::run()
 //
 void DataReceiver::_processIncomingData()
 {
-    _chunker->next(_device);
+    {
+        static const int traceName = Tracer::intern("AbstractChunker::next");
+        Tracer::Scope trace(traceName);
+        _chunker->next(_device);
+    }
     if (_device && _device->bytesAvailable() > 0) {
         emit dataRemaining();
     }
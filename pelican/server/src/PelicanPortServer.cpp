@@ -29,6 +29,7 @@
 #include "server/PelicanPortServer.h"
 #include "server/Session.h"
 #include "comms/AbstractProtocol.h"
+#include "comms/UnixSocketServer.h"
 
 #include <QtNetwork/QTcpSocket>
 
@@ -36,7 +37,8 @@ namespace pelican {
 
 // class PelicanPortServer
 PelicanPortServer::PelicanPortServer(AbstractProtocol* proto, DataManager* data, QObject* parent)
-    : QTcpServer(parent), _proto(proto), _data(data), _verboseLevel(0)
+    : QTcpServer(parent), _proto(proto), _data(data), _verboseLevel(0), _local(0),
+      _releaseTimeout(10000)
 {
 }
 
@@ -44,10 +46,37 @@ PelicanPortServer::~PelicanPortServer()
 {
 }
 
+/**
+ * @details
+ * Connections accepted on the Unix domain socket are served by the same
+ * Session objects as TCP connections.
+ */
+bool PelicanPortServer::listenLocal(const QString& path)
+{
+    if (!_local) {
+        _local = new UnixSocketServer(this);
+        connect(_local, SIGNAL(incomingDescriptor(int)),
+                SLOT(_incomingLocal(int)), Qt::DirectConnection);
+    }
+    return _local->listen(path);
+}
+
+QString PelicanPortServer::localPath() const
+{
+    return _local ? _local->fullServerName() : QString();
+}
+
+void PelicanPortServer::_incomingLocal(int socketDescriptor)
+{
+    incomingConnection(socketDescriptor);
+}
+
 void PelicanPortServer::incomingConnection(int socketDescriptor)
 {
     Session *thread = new Session(socketDescriptor, _proto, _data, this);
     thread->setVerbosity(_verboseLevel);
+    thread->setThreadPlacement(_placement);
+    thread->setReleaseTimeout(_releaseTimeout);
     connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
     thread->start();
 }
@@ -36,6 +36,7 @@
 #include "comms/PelicanProtocol.h"
 #include "server/PelicanPortServer.h"
 #include "utility/Config.h"
+#include "utility/Tracer.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -52,13 +53,29 @@ namespace pelican {
  * Creates a new Pelican server, which in turn creates a chunker manager.
  */
 PelicanServer::PelicanServer(const Config* config, QObject* parent) :
-    QThread(parent), _verboseLevel(0)
+    QThread(parent), _verboseLevel(0), _tracing(false),
+    _releaseTimeout(10000)
 {
     _config = config;
     _ready = false;
 
     // Create the chunker manager.
     _chunkerManager = new ChunkerManager(config);
+
+    // Read the placement of the server and session threads from
+    // <server><thread .../></server>, and start event tracing if enabled
+    // by <server><trace enabled="true" .../></server>. The time sessions
+    // wait for clients to release shared memory data is set by
+    // <server><sharedMemory releaseTimeout="[ms]"/></server>.
+    if (config) {
+        Config::TreeAddress address;
+        address << Config::NodeId("server", "");
+        ConfigNode node = config->get(address);
+        _placement = ThreadPlacement(node);
+        _tracing = Tracer::configure(node, "server.trace.json");
+        _releaseTimeout = (int)node.getOptionInt("sharedMemory",
+                "releaseTimeout", _releaseTimeout);
+    }
 }
 
 /**
@@ -76,6 +93,11 @@ PelicanServer::~PelicanServer()
     // Delete the protocols.
     foreach (AbstractProtocol* protocol, _protocolPortMap)
         delete protocol;
+    foreach (AbstractProtocol* protocol, _protocolPathMap)
+        delete protocol;
+
+    // Write out any remaining trace events.
+    if (_tracing) Tracer::stop();
 }
 
 /**
@@ -95,6 +117,24 @@ void PelicanServer::addProtocol(AbstractProtocol* protocol, quint16 port)
     _protocolPortMap[port] = protocol;
 }
 
+/**
+ * @details
+ * Adds the given \p protocol to the Unix domain socket at \p path. Any
+ * stale socket file at the path is replaced when the server starts.
+ * The class takes ownership of \p protocol.
+ *
+ * @param proto A pointer to the allocated protocol.
+ * @param path  The path of the socket to listen on.
+ */
+void PelicanServer::addProtocol(AbstractProtocol* protocol, const QString& path)
+{
+    if ( _protocolPathMap.contains(path) ) {
+        delete protocol;
+        throw QString("Cannot map multiple protocols to socket %1").arg(path);
+    }
+    _protocolPathMap[path] = protocol;
+}
+
 /**
  * @details
  * Adds a stream chunker of the given \p type and \p name.
@@ -135,6 +175,7 @@ void PelicanServer::addServiceChunker(QString type, QString name)
 void PelicanServer::run()
 {
     try {
+        _placement.apply("PelicanServer");
         QVector<boost::shared_ptr<PelicanPortServer> > servers;
 
         // Set up the data manager.
@@ -148,11 +189,25 @@ void PelicanServer::run()
             boost::shared_ptr<PelicanPortServer> server(
                     new PelicanPortServer(_protocolPortMap[ports[i]], &dataManager) );
             server->setVerbosity(_verboseLevel);
+            server->setThreadPlacement(_placement);
+            server->setReleaseTimeout(_releaseTimeout);
             servers.append(server);
             if ( !server->listen(QHostAddress::Any, ports[i]) )
                 throw QString("Cannot run PelicanServer on port %1").arg(ports[i]);
             verbose( QString("PelicanServer: listening on port %1").arg(ports[i]), 1 );
         }
+        QList<QString> paths = _protocolPathMap.keys();
+        for (int i = 0; i < paths.size(); ++i) {
+            boost::shared_ptr<PelicanPortServer> server(
+                    new PelicanPortServer(_protocolPathMap[paths[i]], &dataManager) );
+            server->setVerbosity(_verboseLevel);
+            server->setThreadPlacement(_placement);
+            server->setReleaseTimeout(_releaseTimeout);
+            servers.append(server);
+            if ( !server->listenLocal(paths[i]) )
+                throw QString("Cannot run PelicanServer on socket %1").arg(paths[i]);
+            verbose( QString("PelicanServer: listening on socket %1").arg(paths[i]), 1 );
+        }
 
         // Set ready flag.
         _mutex.lock();
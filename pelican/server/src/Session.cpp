@@ -38,6 +38,7 @@
 #include "comms/ServerRequest.h"
 #include "comms/StreamDataRequest.h"
 #include "comms/ServiceDataRequest.h"
+#include "utility/Tracer.h"
 
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QHostAddress>
@@ -63,7 +64,8 @@ namespace pelican {
  */
 Session::Session(int socketDescriptor, AbstractProtocol* proto,
         DataManager* data, QObject* parent)
-: QThread(parent), _dataManager(data), _verboseLevel(0)
+: QThread(parent), _dataManager(data), _verboseLevel(0),
+  _releaseTimeout(10000)
 {
     _protocol = proto;
     _socketDescriptor = socketDescriptor;
@@ -93,6 +95,9 @@ void Session::verbose( const QString& msg, int verboseLevel )
  */
 void Session::run()
 {
+    // Sessions start with each connection, so are placed without a report.
+    _placement.apply("Session", false);
+
     QTcpSocket socket;
     if (!socket.setSocketDescriptor(_socketDescriptor)) {
         emit error(socket.error());
@@ -116,12 +121,18 @@ void Session::run()
 void Session::processRequest(const ServerRequest& req, QIODevice& out,
         const unsigned timeout)
 {
+    static const int traceName = Tracer::intern("Session::processRequest");
+    static const int sendTraceName = Tracer::intern("AbstractProtocol::send");
+    Tracer::Scope trace(traceName);
+
+    // Respond in the protocol version the request was made with.
+    AbstractProtocol* protocol = _protocol->protocolFor(req);
     try {
         switch(req.type())
         {
             case ServerRequest::Acknowledge:
             {
-                _protocol->send(out,"ACK");
+                protocol->send(out,"ACK");
                 verbose("Sent acknowledgement");
                 break;
             }
@@ -130,7 +141,7 @@ void Session::processRequest(const ServerRequest& req, QIODevice& out,
             {
                 verbose("DataSupport request received");
                 DataSupportResponse r( _dataManager->dataSpec() );
-                _protocol->send(out, r);
+                protocol->send(out, r);
                 break;
             }
             case ServerRequest::StreamData:
@@ -141,17 +152,38 @@ void Session::processRequest(const ServerRequest& req, QIODevice& out,
 
                 if (dataList.size() > 0)
                 {
+                    const StreamDataRequest& sr =
+                            static_cast<const StreamDataRequest&>(req);
                     AbstractProtocol::StreamData_t data;
+                    AbstractProtocol::Segments_t segments;
                     for (int i = 0; i < dataList.size(); ++i) {
                         LockableStreamData* lockedData =
                                 static_cast<LockableStreamData*>(dataList[i].object());
                         data.append(static_cast<StreamData*>(lockedData->streamData()));
+                        trace.flow(data.last()->timestamp());
+                        if (sr.sharedMemory())
+                            segments.append(_dataManager->sharedMemory(data.last()->name()));
+                    }
+
+                    // Send only the location of the data if the client can
+                    // read it in place, holding the locks until it is done.
+                    bool served = true;
+                    Tracer::Scope sendTrace(sendTraceName);
+                    QTcpSocket* socket = qobject_cast<QTcpSocket*>(&out);
+                    if (socket && sr.sharedMemory() && !segments.contains(0)
+                            && protocol->sendShared(out, data, segments)) {
+                        verbose("Sent shared memory locations");
+                        served = waitForRelease(*socket);
+                    }
+                    else {
+                        protocol->send(out, data);
                     }
-                    _protocol->send(out, data);
 
                     // Mark as data as being served so it can be de-activated.
-                    foreach (LockedData d, dataList) {
-                        static_cast<LockableStreamData*>(d.object())->served() = true;
+                    if (served) {
+                        foreach (LockedData d, dataList) {
+                            static_cast<LockableStreamData*>(d.object())->served() = true;
+                        }
                     }
                 }
                 break;
@@ -170,24 +202,52 @@ void Session::processRequest(const ServerRequest& req, QIODevice& out,
                                 static_cast<LockableServiceData*>(d[i].object());
                         data.append(lockedData->dataChunk().get());
                     }
-                    _protocol->send(out, data);
+                    protocol->send(out, data);
                 }
                 break;
             }
             default:
                 verbose("protocol error: " + req.message());
-                _protocol->sendError(out, req.message());
+                protocol->sendError(out, req.message());
                 break;
         }
     }
     catch (const QString& e)
     {
         verbose("caught error: " + e );
-        _protocol->sendError(out, e);
+        protocol->sendError(out, e);
     }
 }
 
 
+/**
+ * @details
+ * Waits for a client reading stream data in place from shared memory to
+ * signal that it has finished with it, by sending an acknowledgement request
+ * on the connection.
+ *
+ * Returns false if the connection is closed, the release timeout expires or
+ * the client sends anything other than an acknowledgement. The data is then
+ * left unserved, and is returned to the serve queue when its lock is
+ * released.
+ */
+bool Session::waitForRelease(QTcpSocket& socket)
+{
+    if (socket.bytesAvailable() == 0
+            && !socket.waitForReadyRead(_releaseTimeout)) {
+        verbose("shared memory data not released: " + socket.errorString());
+        return false;
+    }
+    boost::shared_ptr<ServerRequest> req = _protocol->request(socket);
+    if (req->type() != ServerRequest::Acknowledge) {
+        verbose("shared memory data not released: unexpected request");
+        return false;
+    }
+    verbose("shared memory data released");
+    return true;
+}
+
+
 /**
  * @details
  * Iterates over the list of data options (requirements) provided in the request
@@ -216,6 +276,9 @@ void Session::processRequest(const ServerRequest& req, QIODevice& out,
 QList<LockedData> Session::processStreamDataRequest(const StreamDataRequest& req,
         const unsigned timeout)
 {
+    static const int traceName = Tracer::intern("Session::processStreamDataRequest");
+    Tracer::Scope trace(traceName);
+
     // Return an empty list if there are no data requirements in the request.
     QList<LockedData> dataList;
     if (req.isEmpty()) {
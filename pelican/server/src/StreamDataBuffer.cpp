@@ -31,7 +31,10 @@
 #include "server/LockableStreamData.h"
 #include "server/LockedData.h"
 #include "server/WritableData.h"
+#include "comms/SharedMemorySegment.h"
 #include "comms/StreamData.h"
+#include "utility/LatencyMonitor.h"
+#include "utility/Tracer.h"
 
 #include <QtCore/QMutexLocker>
 #include <stdlib.h>
@@ -50,7 +53,7 @@ namespace pelican {
 StreamDataBuffer::StreamDataBuffer(const QString& type, size_t max,
         size_t maxChunkSize, QObject* parent)
 : AbstractDataBuffer(type, parent), _max(max), _maxChunkSize(maxChunkSize),
-  _space(max), _dataManager(0)
+  _space(max), _segment(0), _segmentUsed(0), _dataManager(0)
 {
     Q_ASSERT(max > 0);
 
@@ -68,9 +71,36 @@ StreamDataBuffer::~StreamDataBuffer()
 {
     foreach (LockableStreamData* lockedData, _allChunks) {
         // Must use free() as allocated with calloc()
-        free(lockedData->dataChunk()->data());
+        if (!_segment)
+            free(lockedData->dataChunk()->data());
         delete lockedData;
     }
+    delete _segment;
+}
+
+
+/**
+ * @details
+ * Places the chunks of the buffer in a shared memory segment of the
+ * maximum buffer size, so that clients on the same host can read served
+ * chunks in place (see Session). Chunks are carved from the segment in
+ * order as they are first allocated, and are reused in the same way as
+ * heap allocated chunks.
+ */
+void StreamDataBuffer::setSharedMemory(bool enabled)
+{
+    QMutexLocker locker(&_writeMutex);
+    if (enabled == (_segment != 0))
+        return;
+    if (!_allChunks.isEmpty())
+        throw QString("StreamDataBuffer::setSharedMemory(): Buffer for %1"
+                " already in use.").arg(_type);
+    delete _segment;
+    _segment = 0;
+    _segmentUsed = 0;
+    if (enabled)
+        _segment = new SharedMemorySegment(
+                SharedMemorySegment::uniqueName(_type), _max);
 }
 
 
@@ -103,13 +133,20 @@ void StreamDataBuffer::getNext(LockedData& lockedData)
  */
 WritableData StreamDataBuffer::getWritable(size_t requestedSize)
 {
+    static const int traceName = Tracer::intern("StreamDataBuffer::getWritable");
+    Tracer::Scope trace(traceName);
     QMutexLocker locker(&_writeMutex);
     LockableStreamData* lockableStreamData = _getWritable(requestedSize);
 
-    // Prepare the object for use by adding Service Data info.
+    // Prepare the object for use by adding Service Data info, and stamp
+    // it with the ingest time for latency monitoring.
     if (lockableStreamData)
     {
         lockableStreamData->reset(requestedSize);
+        qint64 timestamp = LatencyMonitor::now();
+        lockableStreamData->streamData()->setTimestamp(timestamp);
+        lockableStreamData->streamData()->setLostPackets(0);
+        trace.flow(timestamp, Tracer::FlowStart);
         if (!_dataManager)
             throw QString("StreamDataBuffer::getWritable(): No data manager.");
         _dataManager->associateServiceData(lockableStreamData);
@@ -148,7 +185,22 @@ LockableStreamData* StreamDataBuffer::_getWritable(size_t requestedSize)
     if (requestedSize <= _space && requestedSize <= _maxChunkSize)
     {
         // Note: Memory for the chunk is released in destructor.
-        void* memory = calloc(requestedSize, sizeof(char));
+        void* memory = 0;
+        if (_segment) {
+            // Keep chunks 16-byte aligned, as calloc() would, unless the
+            // padding would leave no room for the chunk.
+            size_t offset = (_segmentUsed + 15) & ~(size_t)15;
+            if (offset > _segment->size()
+                    || requestedSize > _segment->size() - offset)
+                offset = _segmentUsed;
+            if (requestedSize <= _segment->size() - offset) {
+                memory = _segment->data() + offset;
+                _segmentUsed = offset + requestedSize;
+            }
+        }
+        else {
+            memory = calloc(requestedSize, sizeof(char));
+        }
         if (memory)
         {
             _space -= requestedSize;
@@ -159,7 +211,15 @@ LockableStreamData* StreamDataBuffer::_getWritable(size_t requestedSize)
             _allChunks.append(lockableData);
 
             // Connect signals to the created data chunk.
-            connect(lockableData, SIGNAL(unlockedWrite()), SLOT(activateData()));
+            // Note: Activation uses a direct connection so that the chunk is
+            // placed on the serve queue (and waiting consumers are notified)
+            // in the writing thread, rather than waiting for the event loop
+            // of the thread owning the buffer to process a queued signal.
+            // The chunk is passed with the signal, as sender() is not valid
+            // in a slot directly connected from another thread.
+            connect(lockableData, SIGNAL(unlockedWrite(AbstractLockable*)),
+                    SLOT(activateData(AbstractLockable*)),
+                    Qt::DirectConnection);
             connect(lockableData, SIGNAL(unlocked()), SLOT(deactivateData()));
 
             return lockableData;
@@ -188,13 +248,13 @@ LockableStreamData* StreamDataBuffer::_getWritable(size_t requestedSize)
 
 /**
  * @details
- * This protected slot is called when the lockable data object
- * emits the unlockedWrite() signal. It calls the method to activate the data
- * chunk that emitted the signal, putting it onto the serve queue.
+ * This protected slot is called, in the writing thread, when the lockable
+ * data object emits the unlockedWrite(AbstractLockable*) signal. It calls the
+ * method to activate the given data chunk, putting it onto the serve queue.
  */
-void StreamDataBuffer::activateData()
+void StreamDataBuffer::activateData(AbstractLockable* data)
 {
-    activateData(static_cast<LockableStreamData*>(sender()));
+    activateData(static_cast<LockableStreamData*>(data));
 }
 
 
@@ -246,11 +306,19 @@ void StreamDataBuffer::deactivateData(LockableStreamData* data)
  */
 void StreamDataBuffer::activateData(LockableStreamData* data)
 {
+    static const int traceName = Tracer::intern("StreamDataBuffer::activate");
+    Tracer::Scope trace(traceName);
+
     // If the data is valid place it on the serve queue.
     if (data->isValid()) {
+        trace.flow(data->streamData()->timestamp());
         verbose("activating data", 2);
-        QMutexLocker locker(&_mutex);
-        _serveQueue.enqueue(data);
+        {
+            QMutexLocker locker(&_mutex);
+            _serveQueue.enqueue(data);
+        }
+        if (_dataManager)
+            _dataManager->activatedData(this);
     }
     // Otherwise place it on the empty queue
     // FIXME is this else action the correct behaviour?
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "server/UringReceiver.h"
+#include "server/AbstractChunker.h"
+#include "server/DataReceiver.h"
+#include "utility/Tracer.h"
+
+#include <QtCore/QIODevice>
+#include <QtCore/QMutexLocker>
+#include <QtNetwork/QAbstractSocket>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define PELICAN_IO_URING
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#ifndef IORING_POLL_ADD_MULTI
+#define IORING_POLL_ADD_MULTI (1U << 0)
+#endif
+#ifndef IORING_CQE_F_MORE
+#define IORING_CQE_F_MORE (1U << 1)
+#endif
+#endif
+
+namespace pelican {
+
+namespace {
+// Tags (user data) of requests not made for a chunker.
+const quint64 wakeTag = ~Q_UINT64_C(0);
+const quint64 cancelTag = ~Q_UINT64_C(0) - 1;
+} // namespace
+
+#if defined(PELICAN_IO_URING)
+
+/*
+ * The submission and completion queues of an io_uring instance, used
+ * through the system calls directly as liburing is not a dependency.
+ */
+struct UringReceiver::Ring
+{
+    Ring() : fd(-1), entries(0), tail(0), multishot(true), sq(MAP_FAILED),
+            cq(MAP_FAILED), sqes(MAP_FAILED) {}
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED) ::munmap(sqes, sqeLength);
+        if (cq != MAP_FAILED) ::munmap(cq, cqLength);
+        if (sq != MAP_FAILED) ::munmap(sq, sqLength);
+        if (fd >= 0) ::close(fd);
+    }
+
+    // Creates the ring with (at least) the given number of entries.
+    bool setup(unsigned size)
+    {
+        struct io_uring_params p;
+        memset(&p, 0, sizeof(p));
+        fd = (int)::syscall(__NR_io_uring_setup, size, &p);
+        if (fd < 0)
+            return false;
+
+        entries = p.sq_entries;
+        sqLength = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqLength = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        sqeLength = p.sq_entries * sizeof(struct io_uring_sqe);
+        int prot = PROT_READ | PROT_WRITE;
+        int flags = MAP_SHARED | MAP_POPULATE;
+        sq = ::mmap(0, sqLength, prot, flags, fd, IORING_OFF_SQ_RING);
+        cq = ::mmap(0, cqLength, prot, flags, fd, IORING_OFF_CQ_RING);
+        sqes = ::mmap(0, sqeLength, prot, flags, fd, IORING_OFF_SQES);
+        if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED)
+            return false;
+
+        char* s = (char*)sq;
+        sqHead = (unsigned*)(s + p.sq_off.head);
+        sqTail = (unsigned*)(s + p.sq_off.tail);
+        sqMask = *(unsigned*)(s + p.sq_off.ring_mask);
+        sqArray = (unsigned*)(s + p.sq_off.array);
+        char* c = (char*)cq;
+        cqHead = (unsigned*)(c + p.cq_off.head);
+        cqTail = (unsigned*)(c + p.cq_off.tail);
+        cqMask = *(unsigned*)(c + p.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe*)(c + p.cq_off.cqes);
+        tail = *sqTail;
+        return true;
+    }
+
+    // Returns a cleared submission entry, submitting the queue if full.
+    struct io_uring_sqe* entry()
+    {
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= entries)
+            submit(0);
+        unsigned i = tail & sqMask;
+        struct io_uring_sqe* e = (struct io_uring_sqe*)sqes + i;
+        memset(e, 0, sizeof(*e));
+        sqArray[i] = i;
+        ++tail;
+        return e;
+    }
+
+    // Submits the queued entries and waits for @p wait completions.
+    int submit(unsigned wait)
+    {
+        int n;
+        do {
+            unsigned count = tail - *sqTail;
+            __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+            n = (int)::syscall(__NR_io_uring_enter, fd, count, wait,
+                    wait ? IORING_ENTER_GETEVENTS : 0, 0, 0);
+        } while (n < 0 && errno == EINTR);
+        return n;
+    }
+
+    // Returns the next completion, or 0 if there is none.
+    struct io_uring_cqe* completion()
+    {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+            return 0;
+        return cqes + (head & cqMask);
+    }
+
+    // Releases the completion returned by completion().
+    void pop() { __atomic_store_n(cqHead, *cqHead + 1, __ATOMIC_RELEASE); }
+
+    // Queues a poll for input on the descriptor.
+    void poll(int descriptor, quint64 tag)
+    {
+        struct io_uring_sqe* e = entry();
+        e->opcode = IORING_OP_POLL_ADD;
+        e->fd = descriptor;
+        e->poll_events = POLLIN;
+        e->len = multishot ? IORING_POLL_ADD_MULTI : 0;
+        e->user_data = tag;
+    }
+
+    // Queues the removal of the poll with the given tag.
+    void cancel(quint64 tag)
+    {
+        struct io_uring_sqe* e = entry();
+        e->opcode = IORING_OP_POLL_REMOVE;
+        e->fd = -1;
+        e->addr = tag;
+        e->user_data = cancelTag;
+    }
+
+    int fd;
+    unsigned entries;
+    unsigned tail;    // Local submission queue tail.
+    bool multishot;   // False if the kernel rejects multishot polls.
+    void* sq;
+    void* cq;
+    void* sqes;
+    size_t sqLength, cqLength, sqeLength;
+    unsigned *sqHead, *sqTail, *sqArray, sqMask;
+    unsigned *cqHead, *cqTail, cqMask;
+    struct io_uring_cqe* cqes;
+};
+
+#else
+
+struct UringReceiver::Ring
+{
+    bool setup(unsigned) { errno = ENOSYS; return false; }
+    void poll(int, quint64) {}
+    void cancel(quint64) {}
+};
+
+#endif
+
+
+/**
+ * @details
+ * Constructs a receiver for the named ring. Add the chunkers with
+ * addChunker() before calling start().
+ */
+UringReceiver::UringReceiver(const QString& name)
+: QThread(), _name(name), _active(true), _usingRing(false), _wakeFd(-1)
+{
+#if defined(PELICAN_IO_URING)
+    _wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+/**
+ * @details
+ * Stops the chunkers and waits for the receiver thread (and any fall-back
+ * DataReceiver threads) to finish.
+ */
+UringReceiver::~UringReceiver()
+{
+    _active = false;
+    foreach (AbstractChunker* chunker, _chunkers)
+        chunker->stop();
+    _wake();
+    wait();
+    foreach (DataReceiver* receiver, _fallbacks)
+        delete receiver;
+    if (_wakeFd >= 0)
+        ::close(_wakeFd);
+}
+
+/**
+ * @details
+ * Sets the chunker driven by the receiver. This must be called before
+ * start(), and only once: AbstractChunker::next() blocks until it has
+ * filled a chunk, so a ring cannot be shared between chunkers.
+ */
+void UringReceiver::addChunker(AbstractChunker* chunker)
+{
+    if (!chunker)
+        throw QString("UringReceiver: Invalid chunker.");
+    if (isRunning())
+        throw QString("UringReceiver: Cannot add a chunker to a running ring.");
+    if (!_chunkers.isEmpty())
+        throw QString("UringReceiver: Ring '%1' already drives a chunker.")
+                .arg(_name);
+    _chunkers.append(chunker);
+    _devices.append(0);
+    _descriptors.append(-1);
+    _generations.append(0);
+}
+
+/**
+ * @details
+ * Returns the current device of the chunker, whether driven by the ring or
+ * by a fall-back DataReceiver.
+ */
+QIODevice* UringReceiver::currentDevice(AbstractChunker* chunker) const
+{
+    QMutexLocker locker(&_mutex);
+    if (_fallbacks.contains(chunker))
+        return _fallbacks.value(chunker)->currentDevice();
+    int i = _chunkers.indexOf(chunker);
+    return i < 0 ? 0 : _devices[i];
+}
+
+/**
+ * @details
+ * Returns true if an io_uring instance can be created (the system call may
+ * be missing, or disabled for example by a container seccomp profile).
+ */
+bool UringReceiver::isSupported()
+{
+    Ring ring;
+    return ring.setup(2);
+}
+
+/**
+ * @details
+ * Creates the ring and the chunker devices (in this thread), then loops
+ * waiting for poll completions and calling next() on the chunkers whose
+ * devices are readable.
+ */
+void UringReceiver::run()
+{
+    // The ring thread takes the first placement given by its chunkers.
+    foreach (AbstractChunker* chunker, _chunkers) {
+        if (!chunker->threadPlacement().isEmpty()) {
+            chunker->threadPlacement().apply("UringReceiver " + _name);
+            break;
+        }
+    }
+
+    Ring ring;
+    if (!ring.setup(qMax(8, 4 * _chunkers.size())) || _wakeFd < 0) {
+        std::cerr << "UringReceiver: io_uring unavailable ("
+                  << strerror(errno) << "), using DataReceivers." << std::endl;
+        for (int i = 0; i < _chunkers.size(); ++i)
+            _fallback(i);
+        return;
+    }
+    _usingRing = true;
+
+#if defined(PELICAN_IO_URING)
+    ring.poll(_wakeFd, wakeTag);
+    for (int i = 0; i < _chunkers.size(); ++i)
+        _setupDevice(ring, i);
+
+    // Process any data already buffered on the devices.
+    for (int i = 0; i < _chunkers.size(); ++i) {
+        if (_devices[i] && _devices[i]->bytesAvailable() > 0)
+            _read(ring, i);
+    }
+
+    while (_active) {
+        if (ring.submit(1) < 0 && errno != EBUSY && errno != EAGAIN) {
+            std::cerr << "UringReceiver: io_uring_enter failed ("
+                      << strerror(errno) << ")." << std::endl;
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while (_active && (cqe = ring.completion()) != 0) {
+            quint64 tag = cqe->user_data;
+            int result = cqe->res;
+            bool more = cqe->flags & IORING_CQE_F_MORE;
+            ring.pop();
+            if (tag == cancelTag)
+                continue;
+
+            // Retry as a single-shot poll on kernels without multishot.
+            bool retry = (result == -EINVAL && ring.multishot);
+            if (retry)
+                ring.multishot = false;
+
+            if (tag == wakeTag) {
+                quint64 count;
+                if (::read(_wakeFd, &count, sizeof(count)) < 0) {}
+                if (!more)
+                    ring.poll(_wakeFd, wakeTag);
+                continue;
+            }
+
+            int i = int(tag & 0xffffffff);
+            quint32 generation = quint32(tag >> 32);
+            if (i >= _chunkers.size() || generation != _generations[i]
+                    || !_devices[i])
+                continue; // Completion for a replaced device.
+
+            if (result < 0 && !retry) {
+                std::cerr << "UringReceiver: poll failed ("
+                          << strerror(-result) << ")." << std::endl;
+                _reconnect(ring, i);
+                continue;
+            }
+            if (!retry)
+                _read(ring, i);
+            if (!more && _devices[i] && generation == _generations[i])
+                ring.poll(_descriptors[i], tag);
+        }
+    }
+
+    QMutexLocker locker(&_mutex);
+    for (int i = 0; i < _devices.size(); ++i) {
+        delete _devices[i];
+        _devices[i] = 0;
+    }
+#endif
+}
+
+/**
+ * @details
+ * Creates the device of the @p i-th chunker and polls its descriptor.
+ * Chunkers without a device descriptor are handed to a DataReceiver.
+ */
+void UringReceiver::_setupDevice(Ring& ring, int i)
+{
+    AbstractChunker* chunker = _chunkers[i];
+    QIODevice* device = chunker->newDevice();
+    chunker->activate();
+    if (!device)
+        return;
+
+    int descriptor = chunker->deviceDescriptor(device);
+    if (descriptor < 0) {
+        std::cerr << "UringReceiver: Chunker '" << chunker->name().toStdString()
+                  << "' has no device descriptor, using a DataReceiver."
+                  << std::endl;
+        delete device;
+        _fallback(i);
+        return;
+    }
+    {
+        QMutexLocker locker(&_mutex);
+        _devices[i] = device;
+    }
+    _descriptors[i] = descriptor;
+    ++_generations[i];
+    ring.poll(descriptor, (quint64(_generations[i]) << 32) | quint32(i));
+}
+
+/**
+ * @details
+ * Calls next() on the @p i-th chunker until no data is left on its device
+ * (as a multishot poll only completes again when more data arrives).
+ */
+void UringReceiver::_read(Ring& ring, int i)
+{
+    AbstractChunker* chunker = _chunkers[i];
+    QIODevice* device = _devices[i];
+    QAbstractSocket* socket = dynamic_cast<QAbstractSocket*>(device);
+
+    // Buffered sockets only read from their descriptor when asked to.
+    if (socket && socket->socketType() == QAbstractSocket::TcpSocket)
+        socket->waitForReadyRead(0);
+
+    static const int traceName = Tracer::intern("AbstractChunker::next");
+    while (_active && device->bytesAvailable() > 0) {
+        Tracer::Scope trace(traceName);
+        chunker->next(device);
+    }
+
+    if (socket && socket->state() == QAbstractSocket::UnconnectedState)
+        _reconnect(ring, i);
+}
+
+/**
+ * @details
+ * Cancels the poll on the device of the @p i-th chunker and replaces the
+ * device with a new one.
+ */
+void UringReceiver::_reconnect(Ring& ring, int i)
+{
+    std::cerr << "UringReceiver: Attempting to reconnect." << std::endl;
+    ring.cancel((quint64(_generations[i]) << 32) | quint32(i));
+    _chunkers[i]->stop();
+    {
+        QMutexLocker locker(&_mutex);
+        delete _devices[i];
+        _devices[i] = 0;
+    }
+    _descriptors[i] = -1;
+    ++_generations[i];
+    if (_active)
+        _setupDevice(ring, i);
+}
+
+/**
+ * @details
+ * Hands the @p i-th chunker to a DataReceiver thread of its own.
+ */
+void UringReceiver::_fallback(int i)
+{
+    DataReceiver* receiver = new DataReceiver(_chunkers[i]);
+    {
+        QMutexLocker locker(&_mutex);
+        _fallbacks.insert(_chunkers[i], receiver);
+    }
+    receiver->start();
+}
+
+/**
+ * @details
+ * Wakes the receiver thread if it is waiting for completions.
+ */
+void UringReceiver::_wake()
+{
+    if (_wakeFd >= 0) {
+        quint64 one = 1;
+        if (::write(_wakeFd, &one, sizeof(one)) < 0) {}
+    }
+}
+
+} // namespace pelican
@@ -0,0 +1,44 @@
+#ifndef ABSTRACTUDPCHUNKERTEST_H
+#define ABSTRACTUDPCHUNKERTEST_H
+
+/**
+ * @file AbstractUdpChunkerTest.h
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace pelican {
+
+/**
+ * @ingroup t_server
+ *
+ * @class AbstractUdpChunkerTest
+ *
+ * @brief
+ * Unit test for the AbstractUdpChunker class
+ *
+ * @details
+ */
+
+class AbstractUdpChunkerTest : public CppUnit::TestFixture
+{
+    public:
+        CPPUNIT_TEST_SUITE( AbstractUdpChunkerTest );
+        CPPUNIT_TEST( test_configuration );
+        CPPUNIT_TEST( test_next );
+        CPPUNIT_TEST( test_sequence );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        // Test Methods
+        void test_configuration();
+        void test_next();
+        void test_sequence();
+
+    public:
+        AbstractUdpChunkerTest();
+        ~AbstractUdpChunkerTest();
+};
+
+} // namespace pelican
+#endif // ABSTRACTUDPCHUNKERTEST_H
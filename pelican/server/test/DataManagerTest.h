@@ -26,12 +26,14 @@ class DataManagerTest : public CppUnit::TestFixture
         CPPUNIT_TEST_SUITE(DataManagerTest);
         CPPUNIT_TEST(test_getWritable);
         CPPUNIT_TEST(test_bufferQueryAPI);
+        CPPUNIT_TEST(test_waitForData);
         CPPUNIT_TEST_SUITE_END();
 
     public:
         // Test Methods
         void test_getWritable();
         void test_bufferQueryAPI();
+        void test_waitForData();
 
     public:
         DataManagerTest();
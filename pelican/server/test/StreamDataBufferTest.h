@@ -30,6 +30,8 @@ class StreamDataBufferTest : public CppUnit::TestFixture
         CPPUNIT_TEST( test_getNext );
         CPPUNIT_TEST( test_getWritable );
         CPPUNIT_TEST( test_getWritableStreams );
+        CPPUNIT_TEST( test_sharedMemory );
+        CPPUNIT_TEST( test_writeFromThread );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +42,8 @@ class StreamDataBufferTest : public CppUnit::TestFixture
         void test_getNext();
         void test_getWritable();
         void test_getWritableStreams();
+        void test_sharedMemory();
+        void test_writeFromThread();
 
     public:
         StreamDataBufferTest();
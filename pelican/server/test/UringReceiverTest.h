@@ -0,0 +1,42 @@
+#ifndef URINGRECEIVERTEST_H
+#define URINGRECEIVERTEST_H
+
+/**
+ * @file UringReceiverTest.h
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace pelican {
+
+/**
+ * @ingroup t_server
+ *
+ * @class UringReceiverTest
+ *
+ * @brief
+ * Unit test for the UringReceiver class
+ *
+ * @details
+ */
+
+class UringReceiverTest : public CppUnit::TestFixture
+{
+    public:
+        CPPUNIT_TEST_SUITE( UringReceiverTest );
+        CPPUNIT_TEST( test_configuration );
+        CPPUNIT_TEST( test_receive );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        // Test Methods
+        void test_configuration();
+        void test_receive();
+
+    public:
+        UringReceiverTest();
+        ~UringReceiverTest();
+};
+
+} // namespace pelican
+#endif // URINGRECEIVERTEST_H
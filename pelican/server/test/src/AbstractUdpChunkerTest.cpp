@@ -0,0 +1,193 @@
+#include "server/test/AbstractUdpChunkerTest.h"
+#include "server/AbstractUdpChunker.h"
+#include "server/DataManager.h"
+#include "server/LockedData.h"
+#include "server/LockableStreamData.h"
+#include "utility/Config.h"
+#include "utility/ConfigNode.h"
+
+#include <QtNetwork/QUdpSocket>
+
+#include <cstring>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AbstractUdpChunkerTest);
+
+namespace {
+// Packets of 16 bytes with a 4 byte header, starting 'x' if bad.
+class BatchUdpChunker : public AbstractUdpChunker
+{
+    public:
+        BatchUdpChunker(const ConfigNode& config) : AbstractUdpChunker(config)
+        { setPacketSize(16, 4); }
+    protected:
+        bool checkPacket(const char* packet) const { return packet[0] != 'x'; }
+};
+
+// Returns a packet with a big-endian sequence number and a letter payload.
+QByteArray sequencedPacket(quint32 sequence, char c)
+{
+    QByteArray packet(16, c);
+    for (int i = 0; i < 4; ++i)
+        packet[i] = char((sequence >> (8 * (3 - i))) & 0xff);
+    return packet;
+}
+} // namespace
+
+AbstractUdpChunkerTest::AbstractUdpChunkerTest() : CppUnit::TestFixture()
+{
+}
+
+AbstractUdpChunkerTest::~AbstractUdpChunkerTest()
+{
+}
+
+void AbstractUdpChunkerTest::test_configuration()
+{
+    // Use Case:
+    // Construct with chunk and socket options.
+    // Expect the chunk size to follow from the packet size.
+    ConfigNode node(""
+            "<BatchUdpChunker>"
+            "   <connection host=\"127.0.0.1\" port=\"2003\"/>"
+            "   <data type=\"VisibilityData\"/>"
+            "   <chunk packets=\"8\"/>"
+            "</BatchUdpChunker>");
+    BatchUdpChunker chunker(node);
+    CPPUNIT_ASSERT_EQUAL( (size_t)16, chunker.packetSize() );
+    CPPUNIT_ASSERT_EQUAL( (size_t)4, chunker.headerSize() );
+    CPPUNIT_ASSERT_EQUAL( 8, chunker.packetsPerChunk() );
+    CPPUNIT_ASSERT_EQUAL( (size_t)128, chunker.chunkSize() );
+
+    // Use Case:
+    // Ask for an empty chunk.
+    // Expect an exception.
+    ConfigNode bad("<BatchUdpChunker><chunk packets=\"0\"/></BatchUdpChunker>");
+    CPPUNIT_ASSERT_THROW( BatchUdpChunker b(bad), QString );
+}
+
+void AbstractUdpChunkerTest::test_next()
+{
+    // Use Case:
+    // Send a mixture of good and bad datagrams to the chunker.
+    // Expect the good packets to be written, in order, into one chunk.
+    try {
+        Config config;
+        config.setFromString(""
+                "<buffers>"
+                "   <VisibilityData>"
+                "       <buffer maxSize=\"1024\" maxChunkSize=\"64\"/>"
+                "   </VisibilityData>"
+                "</buffers>");
+        DataManager dataManager(&config, "pipeline");
+        dataManager.getStreamBuffer("VisibilityData");
+
+        ConfigNode node(""
+                "<BatchUdpChunker>"
+                "   <connection host=\"127.0.0.1\" port=\"2003\"/>"
+                "   <data type=\"VisibilityData\"/>"
+                "   <chunk packets=\"4\"/>"
+                "   <socket batch=\"3\"/>"
+                "</BatchUdpChunker>");
+        BatchUdpChunker chunker(node);
+        chunker.setDataManager(&dataManager);
+        QIODevice* device = chunker.newDevice();
+
+        QUdpSocket sender;
+        const char* packets[] = { "aaaaaaaaaaaaaaaa", "xbbbbbbbbbbbbbbb",
+                "ccccccccccccccccc", "dddddddddddddddd", "eeee",
+                "ffffffffffffffff", "gggggggggggggggg" };
+        for (int i = 0; i < 7; ++i)
+            sender.writeDatagram(packets[i], strlen(packets[i]),
+                    QHostAddress("127.0.0.1"), 2003);
+
+        chunker.next(device);
+        CPPUNIT_ASSERT_EQUAL( (quint64)1, chunker.statistics().chunks );
+        CPPUNIT_ASSERT_EQUAL( (quint64)4, chunker.statistics().packets );
+        CPPUNIT_ASSERT_EQUAL( (quint64)3, chunker.statistics().invalid );
+
+        LockedData d = dataManager.getNext("VisibilityData");
+        CPPUNIT_ASSERT( d.isValid() );
+        LockableStreamData* data = static_cast<LockableStreamData*>(d.object());
+        const char* chunk = (const char*)data->dataChunk()->data();
+        CPPUNIT_ASSERT( std::string(chunk, 64) == std::string(
+                "aaaaaaaaaaaaaaaadddddddddddddddd"
+                "ffffffffffffffffgggggggggggggggg") );
+        delete device;
+    }
+    catch (const QString& e) {
+        CPPUNIT_FAIL("Unexpected exception: " + e.toStdString());
+    }
+}
+
+void AbstractUdpChunkerTest::test_sequence()
+{
+    // Use Case:
+    // Send sequenced packets out of order, with one missing.
+    // Expect each packet in its own slot, the gap zero-filled and counted,
+    // and early packets held back for the next chunk.
+    try {
+        Config config;
+        config.setFromString(""
+                "<buffers>"
+                "   <VisibilityData>"
+                "       <buffer maxSize=\"1024\" maxChunkSize=\"64\"/>"
+                "   </VisibilityData>"
+                "</buffers>");
+        DataManager dataManager(&config, "pipeline");
+        dataManager.getStreamBuffer("VisibilityData");
+
+        ConfigNode node(""
+                "<BatchUdpChunker>"
+                "   <connection host=\"127.0.0.1\" port=\"2004\"/>"
+                "   <data type=\"VisibilityData\"/>"
+                "   <chunk packets=\"4\"/>"
+                "   <socket batch=\"8\"/>"
+                "   <sequence offset=\"0\" bytes=\"4\" reorder=\"2\"/>"
+                "</BatchUdpChunker>");
+        BatchUdpChunker chunker(node);
+        CPPUNIT_ASSERT( chunker.isSequenced() );
+        chunker.setDataManager(&dataManager);
+        QIODevice* device = chunker.newDevice();
+
+        // Packet 13 is lost; 16 is beyond the reorder window of chunk 10-13.
+        QUdpSocket sender;
+        quint32 order[] = { 10, 12, 11, 14, 16, 15, 17 };
+        for (int i = 0; i < 7; ++i) {
+            QByteArray packet = sequencedPacket(order[i], 'a' + order[i] - 10);
+            sender.writeDatagram(packet, QHostAddress("127.0.0.1"), 2004);
+        }
+
+        chunker.next(device);
+        chunker.next(device);
+        CPPUNIT_ASSERT_EQUAL( (quint64)2, chunker.statistics().chunks );
+        CPPUNIT_ASSERT_EQUAL( (quint64)7, chunker.statistics().packets );
+        CPPUNIT_ASSERT_EQUAL( (quint64)1, chunker.statistics().lost );
+        CPPUNIT_ASSERT_EQUAL( (quint64)0, chunker.statistics().resyncs );
+
+        LockedData d = dataManager.getNext("VisibilityData");
+        CPPUNIT_ASSERT( d.isValid() );
+        LockableStreamData* data = static_cast<LockableStreamData*>(d.object());
+        CPPUNIT_ASSERT_EQUAL( (quint32)1, data->dataChunk()->lostPackets() );
+        QByteArray expected = sequencedPacket(10, 'a') + sequencedPacket(11, 'b')
+                + sequencedPacket(12, 'c') + QByteArray(16, 0);
+        CPPUNIT_ASSERT( QByteArray((const char*)data->dataChunk()->data(), 64)
+                == expected );
+
+        LockedData d2 = dataManager.getNext("VisibilityData");
+        CPPUNIT_ASSERT( d2.isValid() );
+        data = static_cast<LockableStreamData*>(d2.object());
+        CPPUNIT_ASSERT_EQUAL( (quint32)0, data->dataChunk()->lostPackets() );
+        expected = sequencedPacket(14, 'e') + sequencedPacket(15, 'f')
+                + sequencedPacket(16, 'g') + sequencedPacket(17, 'h');
+        CPPUNIT_ASSERT( QByteArray((const char*)data->dataChunk()->data(), 64)
+                == expected );
+        delete device;
+    }
+    catch (const QString& e) {
+        CPPUNIT_FAIL("Unexpected exception: " + e.toStdString());
+    }
+}
+
+} // namespace pelican
@@ -242,5 +242,27 @@ void DataManagerTest::test_bufferQueryAPI()
 }
 
 
+void DataManagerTest::test_waitForData()
+{
+    Config config;
+    DataManager dm(&config);
+    QString type = "DataType";
+    dm.getStreamBuffer(type);
+
+    // Nothing has been activated so the wait must time out.
+    quint64 count = dm.activationCount();
+    CPPUNIT_ASSERT_EQUAL(false, dm.waitForData(count, 10));
+
+    // Releasing a writable chunk activates it and notifies waiters.
+    {
+        WritableData chunk = dm.getWritableData(type, 100);
+        CPPUNIT_ASSERT(chunk.isValid());
+        CPPUNIT_ASSERT_EQUAL(count, dm.activationCount());
+    }
+    CPPUNIT_ASSERT_EQUAL(count + 1, dm.activationCount());
+    CPPUNIT_ASSERT_EQUAL(1, dm.numActiveChunks(type));
+    CPPUNIT_ASSERT_EQUAL(true, dm.waitForData(count, 10));
+}
+
 
 } // namespace pelican
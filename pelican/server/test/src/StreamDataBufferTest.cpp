@@ -1,6 +1,7 @@
 #include "server/test/StreamDataBufferTest.h"
 
 #include "server/DataManager.h"
+#include "comms/SharedMemorySegment.h"
 #include "comms/StreamData.h"
 #include "server/StreamDataBuffer.h"
 #include "server/ServiceDataBuffer.h"
@@ -10,9 +11,26 @@
 #include "utility/Config.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
 
 namespace pelican {
 
+namespace {
+class Writer : public QThread {
+    public:
+        Writer(StreamDataBuffer* b, int n) : _b(b), _n(n) {}
+        void run() {
+            for (int i = 1; i <= _n; ++i) {
+                WritableData data = _b->getWritable(sizeof(int));
+                data.write(&i, sizeof(int));
+            }
+        }
+    private:
+        StreamDataBuffer* _b;
+        int _n;
+};
+} // namespace
+
 CPPUNIT_TEST_SUITE_REGISTRATION( StreamDataBufferTest );
 // class StreamDataBufferTest
 StreamDataBufferTest::StreamDataBufferTest()
@@ -200,4 +218,69 @@ void StreamDataBufferTest::test_getWritableStreams()
         cout << endl;
 }
 
+void StreamDataBufferTest::test_sharedMemory()
+{
+    // Use case:
+    // Chunks allocated in a shared memory buffer.
+    // Expect aligned chunks carved from the segment, which are reused once
+    // they have been served.
+    StreamDataBuffer buffer("test", 100, 40);
+    buffer.setDataManager(_dataManager);
+    CPPUNIT_ASSERT( buffer.sharedMemory() == 0 );
+    buffer.setSharedMemory(true);
+    const SharedMemorySegment* segment = buffer.sharedMemory();
+    CPPUNIT_ASSERT( segment != 0 );
+    CPPUNIT_ASSERT_EQUAL( (size_t)100, segment->size() );
+
+    QList<void*> ptrs;
+    for (int i = 0; i < 3; ++i) {
+        WritableData data = buffer.getWritable(30);
+        CPPUNIT_ASSERT( data.isValid() );
+        char c = 'a' + i;
+        data.write(&c, 1, 0);
+        ptrs.append(data.data()->dataChunk()->ptr());
+    }
+    CPPUNIT_ASSERT_EQUAL( (quint64)0, segment->offset(ptrs[0]) );
+    CPPUNIT_ASSERT_EQUAL( (quint64)32, segment->offset(ptrs[1]) );
+    CPPUNIT_ASSERT_EQUAL( (quint64)64, segment->offset(ptrs[2]) );
+    CPPUNIT_ASSERT_EQUAL( 'b', segment->data()[32] );
+    CPPUNIT_ASSERT_EQUAL( (size_t)10, buffer.space() );
+    CPPUNIT_ASSERT_THROW( buffer.setSharedMemory(false), QString );
+
+    {
+        LockedData data("test");
+        buffer.getNext(data);
+        LockableStreamData* d = static_cast<LockableStreamData*>(data.object());
+        CPPUNIT_ASSERT( d->dataChunk()->ptr() == ptrs[0] );
+        d->served() = true;
+    }
+    WritableData data = buffer.getWritable(30);
+    CPPUNIT_ASSERT( data.data()->dataChunk()->ptr() == ptrs[0] );
+}
+
+void StreamDataBufferTest::test_writeFromThread()
+{
+    // Use case:
+    // Chunks written from a thread other than the one owning the buffer.
+    // Expect the chunks to be on the serve queue, in order, as soon as the
+    // writer has finished, without processing any events.
+    StreamDataBuffer buffer("test");
+    buffer.setDataManager(_dataManager);
+    Writer writer(&buffer, 3);
+    writer.start();
+    CPPUNIT_ASSERT( writer.wait(5000) );
+    CPPUNIT_ASSERT_EQUAL(3, buffer._serveQueue.size());
+    for (int i = 1; i <= 3; ++i) {
+        LockedData data("test");
+        buffer.getNext(data);
+        CPPUNIT_ASSERT( data.isValid() );
+        LockableStreamData* chunk =
+                static_cast<LockableStreamData*>(data.object());
+        CPPUNIT_ASSERT_EQUAL(i, *(int*)chunk->dataChunk()->ptr());
+        chunk->served() = true;
+    }
+    CPPUNIT_ASSERT_EQUAL(0, buffer._serveQueue.size());
+    CPPUNIT_ASSERT_EQUAL(3, buffer._emptyQueue.size());
+}
+
 } // namespace pelican
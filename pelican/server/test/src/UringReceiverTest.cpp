@@ -0,0 +1,148 @@
+#include "server/test/UringReceiverTest.h"
+#include "server/UringReceiver.h"
+#include "server/test/TestUdpChunker.h"
+#include "server/LockedData.h"
+#include "server/LockableStreamData.h"
+#include "server/StreamDataBuffer.h"
+#include "server/DataManager.h"
+#include "emulator/EmulatorDriver.h"
+#include "emulator/test/RealUdpEmulator.h"
+#include "utility/Config.h"
+#include "utility/ConfigNode.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QStringList>
+
+#include <cfloat>
+#include <unistd.h>
+
+namespace pelican {
+
+using test::TestUdpChunker;
+using test::RealUdpEmulator;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UringReceiverTest);
+
+UringReceiverTest::UringReceiverTest() : CppUnit::TestFixture()
+{
+}
+
+UringReceiverTest::~UringReceiverTest()
+{
+}
+
+void UringReceiverTest::test_configuration()
+{
+    // Use Case:
+    // Chunker with and without a receiver tag.
+    // Expect the Qt receiver by default, and the named ring if given.
+    ConfigNode plain(""
+            "<TestUdpChunker>"
+            "   <data type=\"VisibilityData\" chunkSize=\"512\"/>"
+            "</TestUdpChunker>");
+    TestUdpChunker qt(plain);
+    CPPUNIT_ASSERT( qt.receiverType() == "qt" );
+
+    ConfigNode ring(""
+            "<TestUdpChunker>"
+            "   <data type=\"VisibilityData\" chunkSize=\"512\"/>"
+            "   <receiver type=\"uring\" ring=\"udp\"/>"
+            "</TestUdpChunker>");
+    TestUdpChunker uring(ring);
+    CPPUNIT_ASSERT( uring.receiverType() == "uring" );
+    CPPUNIT_ASSERT( uring.ring() == "udp" );
+
+    // Use Case:
+    // Unknown receiver type.
+    // Expect an exception.
+    ConfigNode bad(""
+            "<TestUdpChunker>"
+            "   <data type=\"VisibilityData\" chunkSize=\"512\"/>"
+            "   <receiver type=\"epoll\"/>"
+            "</TestUdpChunker>");
+    CPPUNIT_ASSERT_THROW( TestUdpChunker c(bad), QString );
+}
+
+void UringReceiverTest::test_receive()
+{
+    // Use Case:
+    // Two UDP chunkers driven by a ring each, each fed by an emulator.
+    // Expect the chunks of both streams in their buffers (whether the rings
+    // are used or the system falls back to DataReceivers).
+    try {
+        Config config;
+        config.setFromString(""
+                "<buffers>"
+                "   <VisibilityData>"
+                "       <buffer maxSize=\"5120\" maxChunkSize=\"512\"/>"
+                "   </VisibilityData>"
+                "   <AntennaData>"
+                "       <buffer maxSize=\"5120\" maxChunkSize=\"512\"/>"
+                "   </AntennaData>"
+                "</buffers>");
+        DataManager dataManager(&config, "pipeline");
+        QStringList streams;
+        streams << "VisibilityData" << "AntennaData";
+        QList<StreamDataBuffer*> buffers;
+        foreach (const QString& stream, streams)
+            buffers.append(dataManager.getStreamBuffer(stream));
+
+        QList<TestUdpChunker*> chunkers;
+        QList<UringReceiver*> receivers;
+        for (int i = 0; i < 2; ++i) {
+            ConfigNode node(QString(""
+                    "<TestUdpChunker>"
+                    "   <connection host=\"127.0.0.1\" port=\"%1\"/>"
+                    "   <data type=\"%2\" chunkSize=\"512\"/>"
+                    "   <receiver type=\"uring\" ring=\"udp\"/>"
+                    "</TestUdpChunker>").arg(2005 + i).arg(streams[i]));
+            chunkers.append(new TestUdpChunker(node));
+            chunkers[i]->setDataManager(&dataManager);
+            receivers.append(new UringReceiver("udp"));
+            receivers[i]->addChunker(chunkers[i]);
+        }
+
+        // Use Case:
+        // A second chunker added to a ring.
+        // Expect an exception, as next() blocks the ring thread.
+        CPPUNIT_ASSERT_THROW( receivers[0]->addChunker(chunkers[1]), QString );
+        CPPUNIT_ASSERT_EQUAL( 1, receivers[0]->chunkers().size() );
+
+        foreach (UringReceiver* receiver, receivers)
+            receiver->start();
+        usleep(100000); // Wait for the sockets to be bound.
+
+        QList<EmulatorDriver*> emulators;
+        for (int i = 0; i < 2; ++i) {
+            ConfigNode emulatorConfig(QString(""
+                    "<RealUdpEmulator>"
+                    "    <connection host=\"127.0.0.1\" port=\"%1\"/>"
+                    "    <packet number=\"3\" size=\"512\" interval=\"1000\" initialValue=\"0.1\"/>"
+                    "</RealUdpEmulator>").arg(2005 + i));
+            emulators.append(new EmulatorDriver(new RealUdpEmulator(emulatorConfig)));
+        }
+        usleep(50000);
+        QCoreApplication::processEvents();
+
+        for (int i = 0; i < 2; ++i) {
+            CPPUNIT_ASSERT_EQUAL( 3, buffers[i]->numberOfActiveChunks() );
+            LockedData d = dataManager.getNext(streams[i]);
+            CPPUNIT_ASSERT( d.isValid() );
+            double* values = reinterpret_cast<double*>(
+                    static_cast<LockableStreamData*>(d.object())->dataChunk()->data());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.1, values[0], DBL_EPSILON );
+        }
+
+        foreach (EmulatorDriver* emulator, emulators)
+            delete emulator;
+        foreach (UringReceiver* receiver, receivers)
+            delete receiver; // Before the chunkers they drive.
+        foreach (TestUdpChunker* chunker, chunkers)
+            delete chunker;
+    }
+    catch (const QString& e) {
+        CPPUNIT_FAIL("Unexpected exception: " + e.toStdString());
+    }
+}
+
+} // namespace pelican
@@ -34,12 +34,14 @@
  */
 
 #include "utility/ConfigNode.h"
+#include "utility/ConfigTree.h"
 #include <QtXml/QDomDocument>
 #include <QtCore/QString>
 #include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QPair>
 #include <QtCore/QFile>
+#include <QtCore/QSharedPointer>
 
 namespace pelican {
 
@@ -60,6 +62,11 @@ namespace pelican {
  * address << Config::NodeId("module", "myModule");
  * ConfigNode node = config.get(address);
  * @endcode
+ *
+ * The document is compiled into a ConfigTree index whenever it is read or
+ * changed through this class, and lookups are made in the index rather than
+ * in the DOM. Changes made to the DOM by other means are not seen by the
+ * index.
  */
 
 class Config
@@ -84,9 +91,12 @@ class Config
         QString fileName() const { return _fileName; }
 
         /// Returns the configuration node at the specified address.
-        ConfigNode get(const TreeAddress &address) const {
-            return ConfigNode(_get(address, _document), this );
-        }
+        ConfigNode get(const TreeAddress &address) const;
+
+        /// Returns the configuration node with the tag and name below the
+        /// node at the base address.
+        ConfigNode get(const TreeAddress &base, const QString& tag,
+                const QString& name = QString()) const;
 
         /// returns true if a node at the specified address exists
         bool verifyAddress( const TreeAddress &address) const;
@@ -124,16 +134,14 @@ class Config
         void save(const QString& fileName) const;
 
         /// Creates and returns a configuration option at the specified address.
-        ConfigNode set(const TreeAddress &address) {
-            return ConfigNode(_set(address), this );
-        }
+        ConfigNode set(const TreeAddress &address);
 
         /// Sets a configuration option attribute at the specified address.
         void setAttribute(const TreeAddress &address, const QString &key,
                 const QString &value);
 
         /// Sets the document.
-        void setDocument(const QDomDocument& document) {_document = document;}
+        void setDocument(const QDomDocument& document);
 
         /// Sets the configuration from the QString text.
         /// Warning: This method is added for testing only and will destroy
@@ -168,10 +176,18 @@ class Config
         /// Creates and returns a configuration option at the specified address.
         QDomElement _set(const TreeAddress &address);
 
+        /// Compiles the lookup index of the document.
+        void _compile();
+
+        /// Returns the lookup index, or null if it is out of date.
+        const ConfigTree* _index() const
+        { return _tree && _tree->isValid() ? _tree.data() : 0; }
+
     private:
         QList<QString> _searchPaths; // prefix for the Qt resource search
         QString _fileName;
         QDomDocument _document;
+        QSharedPointer<ConfigTree> _tree;
 };
 
 } // namespace pelican
@@ -33,10 +33,12 @@
  * @file ConfigNode.h
  */
 
+#include "utility/ConfigTree.h"
 #include <QtXml/QDomElement>
 #include <QtCore/QString>
 #include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QSharedPointer>
 
 #include <vector>
 
@@ -53,6 +55,9 @@ class Config;
  * configuration file.
  *
  * @details
+ * Nodes returned by Config, and nodes set from a string, look up their
+ * options in the compiled ConfigTree of the document. Other nodes, and nodes
+ * of a document that has changed since, read the DOM directly.
  */
 
 class ConfigNode
@@ -60,19 +65,26 @@ class ConfigNode
     private:
         QDomElement _config;
         const Config* _configObject;
+        QSharedPointer<const ConfigTree> _tree;
+        int _index;
 
     public:
         /// Constructs an empty configuration node.
-        ConfigNode() : _configObject(0) {}
+        ConfigNode() : _configObject(0), _index(-1) {}
 
         /// Constructs the configuration node from the specified QDomElement.
         ConfigNode(const QDomElement& dom, const Config* config );
 
+        /// Constructs the configuration node from a node of a compiled tree.
+        ConfigNode(const QSharedPointer<const ConfigTree>& tree, int index,
+                const Config* config);
+
         /// Constructs the configuration node from the specified QDomElement list.
         ConfigNode(const QList<QDomElement>& config);
 
         /// Constructs the configuration node from the XML string.
-        ConfigNode(const QString& xmlString) { setFromString(xmlString); }
+        ConfigNode(const QString& xmlString) : _configObject(0), _index(-1)
+        { setFromString(xmlString); }
 
         /// Destroys the configuration object.
         ~ConfigNode() {}
@@ -82,7 +94,8 @@ class ConfigNode
         QString type() const { return _config.tagName(); }
 
         /// Returns the configuration node name.
-        QString name() const { return _config.attribute("name"); }
+        QString name() const
+        { return _compiled() ? _tree->node(_index).name : _config.attribute("name"); }
 
         /// Returns the name of the parent node.
         QString parentName() const
@@ -113,6 +126,16 @@ class ConfigNode
         QString getOptionText(const QString& tagName,
                 const QString& defValue = QString()) const;
 
+        /// Returns a configuration option as an integer, or @p defValue if
+        /// it is not set or is not an integer.
+        qlonglong getOptionInt(const QString& tagName,
+                const QString& attribute, qlonglong defValue = 0) const;
+
+        /// Returns a configuration option as a number, or @p defValue if it
+        /// is not set or is not a number.
+        double getOptionDouble(const QString& tagName,
+                const QString& attribute, double defValue = 0.0) const;
+
         /// Returns a hash of attribute pairs.
         QHash<QString, QString> getOptionHash(const QString& tagName,
                 const QString& attr1, const QString& attr2) const;
@@ -133,6 +156,15 @@ class ConfigNode
 
         /// search for the specifed file in the configuration search path
         QString searchFile( const QString& filename ) const;
+
+    private:
+        /// Returns true if lookups can be made in the compiled tree.
+        bool _compiled() const
+        { return _index >= 0 && _tree->isValid(); }
+
+        /// Returns the option in the compiled tree, or null if not set.
+        const ConfigTree::Value* _option(const QString& tagName,
+                const QString& attribute) const;
 };
 
 } // namespace pelican
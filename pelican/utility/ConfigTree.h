@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef CONFIGTREE_H
+#define CONFIGTREE_H
+
+/**
+ * @file ConfigTree.h
+ */
+
+#include <QtXml/QDomElement>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+namespace pelican {
+
+/**
+ * @ingroup c_utility
+ *
+ * @class ConfigTree
+ *
+ * @brief
+ * Immutable index of the elements of an XML configuration tree.
+ *
+ * @details
+ * The tree is compiled once from a QDomElement and its descendants, which
+ * are stored in document order. Tag and attribute names are interned to
+ * integer keys, the children of each element are indexed by tag and by tag
+ * and name, and attribute values are parsed as numbers when the tree is
+ * built, so that looking up a node or an option is a few hash lookups
+ * rather than a scan of the DOM with string comparisons.
+ *
+ * The index describes the DOM as it was when compiled. The owner of the
+ * document calls invalidate() when the document changes, after which the
+ * holders of a shared pointer to the tree should use the DOM instead.
+ */
+class ConfigTree
+{
+    public:
+        /// An attribute value, with its numeric forms if it has any.
+        struct Value {
+            QString text;
+            bool isInteger;
+            bool isNumber;
+            qlonglong integer;
+            double number;
+        };
+
+        /// An element of the tree.
+        struct Node {
+            QDomElement element;
+            int tag;                ///< Interned tag name.
+            int parent;             ///< Index of the parent, or -1.
+            int end;                ///< One past the last descendant.
+            QString name;           ///< Value of the name attribute.
+            QString text;           ///< Concatenated child text nodes.
+            QHash<int, Value> attributes;
+            QVector<int> children;
+            QHash<int, int> first;  ///< First child with each tag.
+            QHash<QPair<int, QString>, int> named; ///< Last child with each tag and name.
+        };
+
+    public:
+        /// Compiles the tree rooted at @p root.
+        ConfigTree(const QDomElement& root);
+
+        /// Returns true until the tree is invalidated.
+        bool isValid() const { return _valid == 1; }
+
+        /// Marks the tree as no longer describing its document.
+        void invalidate() const { _valid = 0; }
+
+        /// Returns the interned key of @p string, or -1 if it is not used.
+        int key(const QString& string) const { return _keys.value(string, -1); }
+
+        /// Returns the node at @p index.
+        const Node& node(int index) const { return _nodes[index]; }
+
+        /// Returns the last child of @p parent with the given tag and name.
+        int child(int parent, const QString& tag, const QString& name) const;
+
+        /// Returns the first child of @p parent with the given tag.
+        int firstChild(int parent, const QString& tag) const;
+
+        /// Returns the node at @p address below the root, or -1.
+        int find(const QList<QPair<QString, QString> >& address) const;
+
+        /// Returns the descendants of @p parent with the given tag.
+        QVector<int> elements(int parent, const QString& tag) const;
+
+        /// Returns the attribute of @p index with the given name, or null.
+        const Value* attribute(int index, const QString& name) const;
+
+    private:
+        int _intern(const QString& string);
+        void _compile(const QDomElement& element, int parent);
+
+    private:
+        QVector<Node> _nodes;
+        QHash<QString, int> _keys;
+        QHash<int, QVector<int> > _tags; ///< Nodes with each tag, in order.
+        mutable QAtomicInt _valid;
+};
+
+} // namespace pelican
+
+#endif // CONFIGTREE_H
@@ -28,60 +28,167 @@
 
 #ifndef CONTIGUOUSMEMORY_H
 #define CONTIGUOUSMEMORY_H
-#include <memory>
-#include <QtCore/QList>
-#include <QtCore/QString>
 
 /**
- * @file ContiguousMemory.h
+ * @file ContiguousMemory.hpp
  */
 
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
 namespace pelican {
 
 /**
+ * @ingroup c_utility
+ *
  * @class ContiguousMemory
  *
  * @brief
- *    A C++ interface to the std::get_temporary_buffer
+ *    An aligned slab holding a fixed number of objects back to back.
+ *
  * @details
+ *    The slab is a single allocation divided into slots of equal size, each
+ *    aligned to a cache line (ContiguousMemory::Alignment bytes). The slot
+ *    size defaults to sizeof(T) but can be set larger, so that a slab of
+ *    base class pointers can hold objects of a derived type whose size is
+ *    only known at run time (see FactoryGeneric::objectSize()).
+ *
+ *    Objects can be constructed in the slab through a factory with
+ *    construct(), and destroyed with destroy(); any objects still
+ *    constructed when the slab is destroyed are destroyed with it.
+ *    Alternatively, raw slots can be taken with nextFree() and returned
+ *    with free(). Free slots are reused most recently freed first, so
+ *    recently used (cache-warm) memory is handed out again.
+ *
+ *    For example, to construct 8 DataBlobs of a registered type:
+ *
+ *    @code
+ *    ContiguousMemory<DataBlob> slab(8, factory.objectSize("MyBlob"));
+ *    for (unsigned i = 0; i < 8; ++i)
+ *        blobs.append(slab.construct(factory, "MyBlob"));
+ *    @endcode
  *
+ *    The class is not thread safe.
  */
-
 template<typename T>
 class ContiguousMemory
 {
-    private:
-        T* _buf;
-        QList<unsigned int> _free;
-        unsigned long _size;
+    public:
+        enum { Alignment = 64 };
 
     public:
-        // reserve a contiguous memory buffer for the specified number
-        // of objects
-        ContiguousMemory( unsigned long num ) : _size(num) {
-            // allocate the memory
-            std::pair<T*,unsigned long> r = std::get_temporary_buffer<T>(num);
-            if( r.second != num ) throw(QString("ContiguousMemory: unable to allocate num objects"));
-            _buf = r.first;
-            // mark all slots as free
-            for(unsigned int i=0; i<_size; ++i ) {
-                _free.append(i);
+        /// Reserves an aligned slab for @p num objects of @p objectSize bytes.
+        ContiguousMemory(unsigned long num, size_t objectSize = sizeof(T))
+        : _buf(0), _size(num),
+          _stride((objectSize + Alignment - 1) & ~size_t(Alignment - 1)),
+          _constructed(num, false)
+        {
+            void* memory = 0;
+            if (num > 0 && posix_memalign(&memory, Alignment, num * _stride) != 0)
+                throw QString("ContiguousMemory: Unable to allocate %1 objects.")
+                        .arg(num);
+            _buf = static_cast<char*>(memory);
+
+            // Mark all slots as free, lowest address at the top of the stack.
+            _free.reserve(num);
+            for (unsigned long i = num; i > 0; --i)
+                _free.push_back(i - 1);
+        }
+
+        /// Destroys any objects still constructed and frees the slab.
+        ~ContiguousMemory()
+        {
+            for (unsigned long i = 0; i < _size; ++i)
+                if (_constructed[i]) _slot(i)->~T();
+            std::free(_buf);
+        }
+
+        /// Returns a pointer to a free (raw) memory slot, or NULL if full.
+        T* nextFree()
+        {
+            if (_free.empty()) return NULL;
+            unsigned long i = _free.back();
+            _free.pop_back();
+            return _slot(i);
+        }
+
+        /// Returns the slot of the specified object to the free list.
+        /// The object is not destroyed (see destroy()).
+        void free(T* object)
+        {
+            unsigned long i = _index(object);
+            _constructed[i] = false;
+            _free.push_back(i);
+        }
+
+        /// Constructs an object of type @p id in a free slot using the factory.
+        /// Returns NULL if the slab is full.
+        template<class Factory>
+        T* construct(Factory& factory, const QString& id)
+        {
+            if (factory.objectSize(id) > _stride)
+                throw QString("ContiguousMemory: Object '%1' is too large "
+                        "for the slot size.").arg(id);
+            T* memory = nextFree();
+            if (!memory) return NULL;
+            T* object = 0;
+            try {
+                object = factory.construct(memory, id);
             }
-        };
-        ~ContiguousMemory() { std::return_temporary_buffer<T>(_buf); }
+            catch (...) {
+                free(memory);
+                throw;
+            }
+            _constructed[_index(object)] = true;
+            return object;
+        }
 
-        // get a pointer to a free memory slot - or NULL if no memory available
-        T* nextFree() {
-           if(_free.size() == 0) return NULL;
-           return &_buf[_free.takeFirst()];
+        /// Destroys an object constructed with construct() and frees its slot.
+        void destroy(T* object)
+        {
+            object->~T();
+            free(object);
         }
 
-        /// recover memory in the buffer for the specified object
-        void free( T* object ) {
-            Q_ASSERT( object >= _buf && object <= _buf+(_size*sizeof(T)));
-            _free.append( object - _buf );
+        /// Returns true if the object lies within the slab.
+        bool contains(const T* object) const
+        {
+            const char* p = reinterpret_cast<const char*>(object);
+            return _buf && p >= _buf && p < _buf + _size * _stride;
         }
 
+        /// Returns the number of slots in the slab.
+        unsigned long size() const { return _size; }
+
+        /// Returns the number of free slots.
+        unsigned long available() const { return _free.size(); }
+
+        /// Returns the size of each slot, in bytes.
+        size_t stride() const { return _stride; }
+
+    private:
+        ContiguousMemory(const ContiguousMemory&);
+        ContiguousMemory& operator=(const ContiguousMemory&);
+
+        T* _slot(unsigned long i) const
+        { return reinterpret_cast<T*>(_buf + i * _stride); }
+
+        unsigned long _index(const T* object) const
+        {
+            Q_ASSERT(contains(object));
+            return (reinterpret_cast<const char*>(object) - _buf) / _stride;
+        }
+
+    private:
+        char* _buf;
+        unsigned long _size;
+        size_t _stride;
+        std::vector<unsigned long> _free;
+        std::vector<bool> _constructed;
 };
 
 } // namespace pelican
@@ -99,9 +99,7 @@ template<class B> class FactoryBase
         /// Return the configuration node for a type (named type if supplied).
         ConfigNode conf(const QString& type, const QString& name="") const {
             if (!_config) throw QString("Factory configuration not set");
-            Config::TreeAddress address(_base);
-            address << Config::NodeId(type, name);
-            return _config->get(address);
+            return _config->get(_base, type, name);
         }
 
         /// Returns the type of the allocated object.
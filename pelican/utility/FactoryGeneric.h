@@ -105,6 +105,12 @@ public: \
         return RegBase<B, n>::types()[id]->construct( memory BOOST_PP_COMMA_IF(n) \
                 BOOST_PP_ENUM_PARAMS(n, P)); \
     } \
+\
+    /* Returns the size in bytes of an object with a registered ID */ \
+    size_t objectSize(const QString& id) { \
+        RegBase<B, n>::check(id); \
+        return RegBase<B, n>::types()[id]->objectSize(); \
+    } \
 \
     /* Checks if the ID has been registered */ \
     bool exists(const QString& id) {return RegBase<B, n>::exists(id);} \
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FACTORYPOOL_H
+#define FACTORYPOOL_H
+
+/**
+ * @file FactoryPool.h
+ */
+
+#include "utility/FactoryGeneric.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <boost/shared_ptr.hpp>
+#include <new>
+
+namespace pelican {
+
+/**
+ * @ingroup c_utility
+ *
+ * @class FactoryPool
+ *
+ * @brief
+ *    Recycles objects created through a FactoryGeneric.
+ *
+ * @details
+ *    Objects are handed out through boost::shared_ptr. When the last
+ *    reference to an object is released, the object is returned to a free
+ *    list for its type rather than deleted, and the next call to create()
+ *    for that type hands it out again. This avoids a heap allocation (and
+ *    registration with the factory) for every object in code that creates
+ *    short-lived objects at a high rate, such as a DataBlob for each
+ *    received message.
+ *
+ *    Objects are constructed with the factory's construct() placement hook,
+ *    so only types with an empty constructor list
+ *    (PELICAN_CONSTRUCT_TYPES_EMPTY) can be pooled. The recycling policy is
+ *    chosen when the pool is constructed:
+ *
+ *    - FactoryPool::Reuse hands out a recycled object as it was released.
+ *      The caller must reset its contents (deserialise() does this for a
+ *      DataBlob), but any memory it has allocated is kept.
+ *    - FactoryPool::Reconstruct destroys a released object and constructs
+ *      it again in place, so that create() always returns a freshly
+ *      constructed object.
+ *
+ *    At most maxFree() objects of each type are kept; any more are deleted
+ *    when released. Objects may be released from any thread and may outlive
+ *    the pool, in which case they are simply deleted.
+ *
+ *    @code
+ *    FactoryPool<DataBlob> pool(&factory);
+ *    boost::shared_ptr<DataBlob> blob = pool.create("MyBlob");
+ *    @endcode
+ */
+template<class B>
+class FactoryPool
+{
+    public:
+        /// Treatment of objects returned to the pool.
+        enum Recycle { Reuse, Reconstruct };
+
+    private:
+        /// State shared between the pool and the objects it has handed out.
+        struct State
+        {
+            State(FactoryGeneric<B>* f, int max, Recycle r)
+            : factory(f), maxFree(max), recycle(r), closed(false) {}
+
+            ~State() { clear(); }
+
+            /// Returns an object to its free list, or deletes it.
+            void release(B* object, const QString& id)
+            {
+                {
+                    QMutexLocker lock(&mutex);
+                    if (!closed) {
+                        QList<B*>& list = free[id];
+                        if (list.size() < maxFree) {
+                            if (recycle == Reconstruct) {
+                                object->~B();
+                                factory->construct(object, id);
+                            }
+                            list.append(object);
+                            return;
+                        }
+                    }
+                }
+                destroy(object);
+            }
+
+            /// Deletes all objects in the free lists.
+            void clear()
+            {
+                typename QHash<QString, QList<B*> >::iterator it;
+                for (it = free.begin(); it != free.end(); ++it)
+                    foreach (B* object, it.value()) destroy(object);
+                free.clear();
+            }
+
+            /// Deletes an object constructed by the pool.
+            static void destroy(B* object)
+            {
+                object->~B();
+                ::operator delete(object);
+            }
+
+            QMutex mutex;
+            FactoryGeneric<B>* factory;
+            int maxFree;
+            Recycle recycle;
+            bool closed;
+            QHash<QString, QList<B*> > free;
+        };
+
+        /// shared_ptr deleter that returns the object to the pool.
+        struct Release
+        {
+            Release(const boost::shared_ptr<State>& s, const QString& i)
+            : state(s), id(i) {}
+            void operator()(B* object) { state->release(object, id); }
+            boost::shared_ptr<State> state;
+            QString id;
+        };
+
+    public:
+        /// Constructs a pool of objects created by @p factory, keeping up to
+        /// @p maxFree released objects of each type.
+        FactoryPool(FactoryGeneric<B>* factory, int maxFree = 16,
+                Recycle recycle = Reuse)
+        : _state(new State(factory, maxFree, recycle)) {}
+
+        /// Deletes the pooled objects. Objects still in use are deleted
+        /// when they are released.
+        ~FactoryPool()
+        {
+            QMutexLocker lock(&_state->mutex);
+            _state->closed = true;
+            _state->clear();
+        }
+
+        /// Returns an object of the registered type @p id, recycled from
+        /// the pool if one is available.
+        boost::shared_ptr<B> create(const QString& id)
+        {
+            B* object = 0;
+            {
+                QMutexLocker lock(&_state->mutex);
+                typename QHash<QString, QList<B*> >::iterator it =
+                        _state->free.find(id);
+                if (it != _state->free.end() && !it.value().isEmpty())
+                    object = it.value().takeLast();
+            }
+            if (!object) {
+                void* memory = ::operator new(_state->factory->objectSize(id));
+                try {
+                    object = _state->factory->construct(
+                            static_cast<B*>(memory), id);
+                }
+                catch (...) {
+                    ::operator delete(memory);
+                    throw;
+                }
+            }
+            return boost::shared_ptr<B>(object, Release(_state, id));
+        }
+
+        /// Returns the number of released objects of type @p id held.
+        int available(const QString& id) const
+        {
+            QMutexLocker lock(&_state->mutex);
+            return _state->free.value(id).size();
+        }
+
+        /// Returns the maximum number of released objects kept per type.
+        int maxFree() const { return _state->maxFree; }
+
+        /// Deletes all released objects held by the pool.
+        void clear()
+        {
+            QMutexLocker lock(&_state->mutex);
+            _state->clear();
+        }
+
+    private:
+        FactoryPool(const FactoryPool&);
+        FactoryPool& operator=(const FactoryPool&);
+
+    private:
+        boost::shared_ptr<State> _state;
+};
+
+} // namespace pelican
+
+#endif // FACTORYPOOL_H
@@ -43,6 +43,7 @@
 #include <boost/preprocessor/repetition/enum_params.hpp>
 
 #include <QtCore/QString>
+#include <cstddef>
 #include <map>
 
 #ifndef MAX_FACTORIES
@@ -110,6 +111,9 @@ template<class B> struct RegBase<B, n> { \
 \
     /* Interface to construct an object in pre-allocated memory */ \
     virtual B* construct(B* memory BOOST_PP_ENUM_TRAILING(n, PARAM, ~)) const = 0; \
+\
+    /* Interface to return the size of the object, in bytes */ \
+    virtual size_t objectSize() const = 0; \
 \
     /* Declares an object with the given ID */ \
     static void declare(const QString& id, RegBase<B, n>* reg) { \
@@ -152,6 +156,8 @@ struct FactoryRegistrar<B, T, n> : public RegBase<B, n> \
     B* construct(B* memory BOOST_PP_ENUM_TRAILING(n, PARAM, ~)) const { \
         return new (memory) T(BOOST_PP_ENUM_PARAMS(n, P)); \
     } \
+    /* Returns the size of the concrete object, in bytes */ \
+    size_t objectSize() const {return sizeof(T);} \
 };
 BOOST_PP_REPEAT(MAX_FACTORIES, FACTORYREGISTRAR, ~)
 #undef FACTORYREGISTRAR
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+/**
+ * @file LatencyMonitor.h
+ */
+
+#include "utility/TimingHistogram.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <iostream>
+
+namespace pelican {
+
+/**
+ * @ingroup c_utility
+ *
+ * @class LatencyMonitor
+ *
+ * @brief
+ * Records the end-to-end latency of data against a latency budget.
+ *
+ * @details
+ * Data chunks are stamped with their ingest time (see now()) when they are
+ * written into the server buffers. This time is carried with the chunk
+ * through the protocol and adapters onto the data blobs, and the latency
+ * monitor records the difference between the ingest time and the time of
+ * measurement into a TimingHistogram for each named stream.
+ *
+ * If an alarm threshold is set, each measurement exceeding it is counted as
+ * an alarm for the stream, and a warning is printed when a stream starts
+ * (and stops) lagging behind the budget.
+ *
+ * Ingest times are taken from the system real-time clock so that they can
+ * be compared between processes (and, given synchronised clocks, hosts).
+ * Measurements with no ingest time (zero) are ignored, and negative
+ * latencies due to clock skew are recorded as zero.
+ *
+ * All methods are thread safe.
+ */
+class LatencyMonitor
+{
+    public:
+        /// Constructs a latency monitor.
+        LatencyMonitor(const QString& name = QString(),
+                quint64 alarmThreshold = 0, int reportInterval = 0);
+
+        /// Destroys the latency monitor.
+        ~LatencyMonitor();
+
+        /// Returns the current real-time clock, in nanoseconds since the epoch.
+        static qint64 now();
+
+        /// Records the latency of data ingested at @p ingestTime on @p stream.
+        quint64 record(const QString& stream, qint64 ingestTime);
+
+        /// Sets the latency (ns) above which an alarm is raised (0 = never).
+        void setAlarmThreshold(quint64 ns);
+
+        /// Returns the alarm threshold in nanoseconds.
+        quint64 alarmThreshold() const;
+
+        /// Returns the number of measurements on @p stream above the threshold.
+        quint64 alarms(const QString& stream) const;
+
+        /// Returns true if the last measurement on @p stream raised an alarm.
+        bool lagging(const QString& stream) const;
+
+        /// Returns a copy of the latency histogram for @p stream.
+        TimingHistogram histogram(const QString& stream) const;
+
+        /// Returns the list of streams recorded.
+        QList<QString> streams() const;
+
+        /// Sets the number of calls to tick() between reports (0 = never).
+        void setReportInterval(int interval);
+
+        /// Marks the end of an iteration, reporting if the interval is reached.
+        void tick();
+
+        /// Prints a percentile summary for each stream.
+        void report(std::ostream& stream = std::cout) const;
+
+        /// Removes all recorded values.
+        void clear();
+
+    private:
+        LatencyMonitor(const LatencyMonitor&);
+        LatencyMonitor& operator=(const LatencyMonitor&);
+
+    private:
+        struct Stream {
+            Stream() : alarms(0), lagging(false) {}
+            TimingHistogram histogram;
+            quint64 alarms;
+            bool lagging;
+        };
+
+    private:
+        mutable QMutex _mutex;
+        QString _name;
+        quint64 _alarmThreshold;
+        int _reportInterval;
+        quint64 _iterations;
+        QHash<QString, Stream*> _streams;
+};
+
+} // namespace pelican
+
+#endif // LATENCYMONITOR_H
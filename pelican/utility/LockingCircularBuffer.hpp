@@ -28,75 +28,238 @@
 
 #ifndef LOCKINGCIRCULARBUFFER_H
 #define LOCKINGCIRCULARBUFFER_H
-#include "CircularBufferIterator.hpp"
-#include <QtCore/QList>
-#include <QtCore/QWaitCondition>
-#include <QtCore/QMutex>
-#include <QtCore/QMutexLocker>
-
 
 /**
- * @file LockingCircularBuffer.h
+ * @file LockingCircularBuffer.hpp
  */
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
+
+#include <climits>
+#include <vector>
+
 namespace pelican {
 
 /**
+ * @ingroup c_utility
+ *
  * @class LockingCircularBuffer
  *
  * @brief
- *   A convenience class to manage two pointers on the same circular buffer
- *   Two pointers are defined, lthe lock pointer and the current pointer.
- *   The current pointer will not be allowed to move past the position
- *   of the lock pointer.
+ *   A bounded multi-producer, multi-consumer ring buffer.
+ *
  * @details
+ *   Items are passed between threads (e.g. from a receiver to a pipeline,
+ *   or from a pipeline to an output thread) through a fixed size ring.
+ *   The capacity is rounded up to a power of two.
+ *
+ *   The fast path (tryPush() and tryPop()) is lock free: each slot carries
+ *   a sequence number telling producers and consumers whether it is ready
+ *   to be written or read, so producers and consumers only contend on the
+ *   atomic head and tail counters. The blocking push() and pop() fall back
+ *   to a mutex and wait condition only when the ring is full or empty, and
+ *   the other side only takes the mutex to wake them if a thread is
+ *   actually waiting.
+ *
+ *   The counters and sequence numbers are unsigned positions held in
+ *   QAtomicInt: they wrap around, and are only compared through their
+ *   (signed) difference, so the ring can run indefinitely.
  *
+ *   T must be default constructible and assignable. Items are copied into
+ *   and out of the ring, so pointers (e.g. to pre-allocated DataBlobs) are
+ *   the natural payload.
  */
-
 template<typename T>
 class LockingCircularBuffer
 {
     public:
-        LockingCircularBuffer( QList<T>* dataBuffer ) {
-             _lock = 0;
-             _current = new CircularBufferIterator<T>(dataBuffer);
+        /// Constructs a ring able to hold at least @p capacity items.
+        LockingCircularBuffer(unsigned int capacity)
+        {
+            unsigned int size = 2;
+            while (size < capacity) size <<= 1;
+            _mask = size - 1;
+            _cells = std::vector<Cell>(size);
+            for (unsigned int i = 0; i < size; ++i)
+                _cells[i].sequence = int(i);
+            _head = 0;
+            _tail = 0;
+            _waitingProducers = 0;
+            _waitingConsumers = 0;
         }
-        ~LockingCircularBuffer() { delete _lock; delete _current; };
-
-        /// return the next free item, this will BLOCK until there are free
-        //  elements.
-        T next() {
-             QMutexLocker lock(&_mutex);
-             const T& next = _current->peekNext();
-             while( _lock && *(*_lock) == next ) {
-                _waitCondition.wait(&_mutex);
-             }
-             return _current->next();
-        };
 
-        /// move the lock pointer to the next position
-        //  and return a CircularBufferIterator starting at the lock position
-        const CircularBufferIterator<T>& shiftLock() {
-             QMutexLocker lock(&_mutex);
-             if( ! _lock ) {
-                 _lock = new CircularBufferIterator<T>(_current->buffer());
-             }
-             _lock->next();
-             _waitCondition.wakeOne();
-             return *_lock;
+        ~LockingCircularBuffer() {}
+
+        /// Returns the maximum number of items held in the ring.
+        unsigned int capacity() const { return _mask + 1; }
+
+        /// Returns the (approximate, if in use) number of items in the ring.
+        unsigned int size() const
+        {
+            int n = _diff(_position(_tail), _position(_head));
+            return n > 0 ? (unsigned int)n : 0;
         }
 
-        /// return the value pointed to by the current lock
-        T& current() const { return *(*_current); }
+        /// Adds an item if there is space; returns false if the ring is full.
+        bool tryPush(const T& item)
+        {
+            unsigned int pos = _position(_tail);
+            for (;;) {
+                Cell& cell = _cells[pos & _mask];
+                int diff = _diff(_sequence(cell.sequence), pos);
+                if (diff == 0) {
+                    if (_tail.testAndSetRelaxed(int(pos), int(pos + 1))) {
+                        cell.data = item;
+                        cell.sequence.fetchAndStoreRelease(int(pos + 1));
+                        _wake(_waitingConsumers, _emptyMutex, _notEmpty);
+                        return true;
+                    }
+                    pos = _position(_tail);
+                }
+                else if (diff < 0) {
+                    return false; // full
+                }
+                else {
+                    pos = _position(_tail);
+                }
+            }
+        }
 
-        /// returns a pointer to the underlying data buffer
-        QList<T>* rawBuffer() { return _current->buffer(); }
+        /// Removes an item if one is available; returns false if empty.
+        bool tryPop(T& item)
+        {
+            unsigned int pos = _position(_head);
+            for (;;) {
+                Cell& cell = _cells[pos & _mask];
+                int diff = _diff(_sequence(cell.sequence), pos + 1);
+                if (diff == 0) {
+                    if (_head.testAndSetRelaxed(int(pos), int(pos + 1))) {
+                        item = cell.data;
+                        cell.sequence.fetchAndStoreRelease(int(pos + _mask + 1));
+                        _wake(_waitingProducers, _fullMutex, _notFull);
+                        return true;
+                    }
+                    pos = _position(_head);
+                }
+                else if (diff < 0) {
+                    return false; // empty
+                }
+                else {
+                    pos = _position(_head);
+                }
+            }
+        }
+
+        /// Adds an item, blocking while the ring is full.
+        void push(const T& item)
+        {
+            if (tryPush(item)) return;
+            _waitingProducers.fetchAndAddOrdered(1);
+            while (!tryPush(item)) {
+                QMutexLocker locker(&_fullMutex);
+                if (!_canPush()) _notFull.wait(&_fullMutex);
+            }
+            _waitingProducers.fetchAndAddOrdered(-1);
+        }
+
+        /// Removes an item, blocking while the ring is empty.
+        T pop()
+        {
+            T item;
+            pop(item);
+            return item;
+        }
+
+        /// Removes an item, blocking for up to @p timeout milliseconds while
+        /// the ring is empty. Returns false if the wait timed out.
+        bool pop(T& item, unsigned long timeout = ULONG_MAX)
+        {
+            if (tryPop(item)) return true;
+            _waitingConsumers.fetchAndAddOrdered(1);
+            bool ok = true;
+            while (!tryPop(item)) {
+                QMutexLocker locker(&_emptyMutex);
+                if (!_canPop() && !_notEmpty.wait(&_emptyMutex, timeout)) {
+                    locker.unlock();
+                    ok = tryPop(item);
+                    break;
+                }
+            }
+            _waitingConsumers.fetchAndAddOrdered(-1);
+            return ok;
+        }
 
     private:
-        QWaitCondition _waitCondition;
-        QMutex _mutex;
-        CircularBufferIterator<T>* _lock;
-        CircularBufferIterator<T>* _current;
+        LockingCircularBuffer(const LockingCircularBuffer&);
+        LockingCircularBuffer& operator=(const LockingCircularBuffer&);
+
+        /// Returns false if the slot at the tail is still full.
+        bool _canPush()
+        {
+            unsigned int pos = _position(_tail);
+            return _diff(_sequence(_cells[pos & _mask].sequence), pos) >= 0;
+        }
+
+        /// Returns false if the slot at the head is still empty.
+        bool _canPop()
+        {
+            unsigned int pos = _position(_head);
+            return _diff(_sequence(_cells[pos & _mask].sequence), pos + 1) >= 0;
+        }
+
+        /// Returns the position held by a counter.
+        static unsigned int _position(const QAtomicInt& counter)
+        { return (unsigned int)int(counter); }
+
+        /// Returns the sequence number of a cell (with acquire semantics).
+        static unsigned int _sequence(QAtomicInt& sequence)
+        { return (unsigned int)sequence.fetchAndAddAcquire(0); }
+
+        /// Returns the difference between two positions, allowing for
+        /// wrap-around.
+        static int _diff(unsigned int a, unsigned int b)
+        { return int(a - b); }
+
+        /// Wakes threads waiting on the condition, if there are any.
+        /// The waiters re-check the ring while holding the mutex before
+        /// waiting, so taking it here ensures no wake-up is missed.
+        void _wake(QAtomicInt& waiting, QMutex& mutex, QWaitCondition& condition)
+        {
+            if (waiting.fetchAndAddOrdered(0) > 0) {
+                QMutexLocker locker(&mutex);
+                condition.wakeAll();
+            }
+        }
+
+    private:
+        struct Cell {
+            Cell() : sequence(0), data() {}
+            Cell(const Cell& c) : sequence(int(c.sequence)), data(c.data) {}
+            Cell& operator=(const Cell& c)
+            { sequence = int(c.sequence); data = c.data; return *this; }
+            QAtomicInt sequence;
+            T data;
+        };
+
+        // Keep the counters on separate cache lines to avoid false sharing.
+        enum { CacheLine = 64 };
+        char _pad0[CacheLine];
+        QAtomicInt _tail;
+        char _pad1[CacheLine - sizeof(QAtomicInt)];
+        QAtomicInt _head;
+        char _pad2[CacheLine - sizeof(QAtomicInt)];
+        std::vector<Cell> _cells;
+        unsigned int _mask;
+
+        QMutex _fullMutex;
+        QMutex _emptyMutex;
+        QWaitCondition _notFull;
+        QWaitCondition _notEmpty;
+        QAtomicInt _waitingProducers;
+        QAtomicInt _waitingConsumers;
 };
 
 } // namespace pelican
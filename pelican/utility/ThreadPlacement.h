@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+/**
+ * @file ThreadPlacement.h
+ */
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+namespace pelican {
+
+class ConfigNode;
+
+/**
+ * @ingroup c_utility
+ *
+ * @class ThreadPlacement
+ *
+ * @brief
+ * CPU affinity, real-time priority and NUMA node of a thread.
+ *
+ * @details
+ * Placement is read from a tag in the configuration node of the component
+ * owning the thread (a chunker, the server, an emulator, a blob server or
+ * a pipeline):
+ * @code
+ * <thread cores="2,3,8-11" priority="50" numaNode="1"/>
+ * @endcode
+ * @c cores is a list of CPU numbers and ranges the thread may run on,
+ * @c priority a SCHED_FIFO priority (1 to 99; 0, the default, leaves the
+ * normal scheduler) and @c numaNode the node on which the thread should
+ * allocate its memory. If a NUMA node is given without cores, the thread is
+ * bound to the cores of that node.
+ *
+ * The memory policy applies to memory first touched by the thread after
+ * apply() is called, which includes the chunk memory of the server buffers
+ * allocated by a chunker in its receiver thread.
+ *
+ * apply() must be called from the thread to be placed. Settings that
+ * cannot be applied (for example a real-time priority without the
+ * CAP_SYS_NICE capability) are reported as warnings and otherwise ignored.
+ */
+class ThreadPlacement
+{
+    public:
+        /// Constructs an empty placement (leaving threads unchanged).
+        ThreadPlacement() : _priority(0), _numaNode(-1) {}
+
+        /// Reads the placement from the @p tag tag of the configuration.
+        ThreadPlacement(const ConfigNode& config,
+                const QString& tag = "thread");
+
+        /// Returns true if the placement leaves threads unchanged.
+        bool isEmpty() const
+        { return _cores.isEmpty() && _priority == 0 && _numaNode < 0; }
+
+        /// Returns the cores the thread may run on (empty for any).
+        const QList<int>& cores() const { return _cores; }
+
+        /// Sets the cores the thread may run on.
+        void setCores(const QList<int>& cores) { _cores = cores; }
+
+        /// Returns the SCHED_FIFO priority (0 for the normal scheduler).
+        int priority() const { return _priority; }
+
+        /// Sets the SCHED_FIFO priority (0 for the normal scheduler).
+        void setPriority(int priority);
+
+        /// Returns the NUMA node for the thread memory (-1 for any).
+        int numaNode() const { return _numaNode; }
+
+        /// Sets the NUMA node for the thread memory (-1 for any).
+        void setNumaNode(int node) { _numaNode = node; }
+
+        /// Applies the placement to the calling thread, reporting it (if
+        /// @p report is true) as the placement of @p name. Returns false if
+        /// any setting failed.
+        bool apply(const QString& name, bool report = true) const;
+
+        /// Returns a description of the placement.
+        QString toString() const;
+
+        /// Parses a CPU list such as "0-3,8".
+        static QList<int> parseCpuList(const QString& list);
+
+        /// Returns the cores of a NUMA node (empty if unknown).
+        static QList<int> numaCores(int node);
+
+    private:
+        QList<int> _cores;
+        int _priority;
+        int _numaNode;
+};
+
+} // namespace pelican
+
+#endif // THREADPLACEMENT_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TIMINGHISTOGRAM_H
+#define TIMINGHISTOGRAM_H
+
+/**
+ * @file TimingHistogram.h
+ */
+
+#include <QtCore/QtGlobal>
+#include <vector>
+
+namespace pelican {
+
+/**
+ * @ingroup c_utility
+ *
+ * @class TimingHistogram
+ *
+ * @brief
+ * Fixed-size log-linear histogram of time intervals, in nanoseconds.
+ *
+ * @details
+ * Values are binned into buckets whose width doubles with every power of
+ * two, each power of two being split into 16 linear sub-buckets. This gives
+ * a relative precision of better than 6.25% over the full 64-bit range using
+ * a fixed block of counters, so recording a value never allocates memory
+ * and costs a handful of integer operations.
+ *
+ * The histogram is not thread safe: each thread should record into its own
+ * histogram, and histograms can be combined for reporting using merge().
+ */
+class TimingHistogram
+{
+    public:
+        /// Constructs an empty histogram.
+        TimingHistogram();
+
+        /// Records the interval @p ns, in nanoseconds.
+        void add(quint64 ns);
+
+        /// Adds the counts held in @p other to this histogram.
+        void merge(const TimingHistogram& other);
+
+        /// Removes all recorded values.
+        void clear();
+
+        /// Returns the number of recorded values.
+        quint64 count() const { return _count; }
+
+        /// Returns the smallest recorded value.
+        quint64 min() const { return _count ? _min : 0; }
+
+        /// Returns the largest recorded value.
+        quint64 max() const { return _max; }
+
+        /// Returns the mean of the recorded values.
+        double mean() const { return _count ? double(_sum) / _count : 0.0; }
+
+        /// Returns the value below which @p percent of the recorded values lie.
+        quint64 percentile(double percent) const;
+
+    private:
+        static int _bucket(quint64 value);
+        static quint64 _lowerBound(int bucket);
+        static quint64 _upperBound(int bucket);
+
+    private:
+        enum { SubBucketBits = 4, SubBuckets = 1 << SubBucketBits };
+        enum { NumBuckets = (64 - SubBucketBits + 1) * SubBuckets };
+
+        std::vector<quint64> _counts;
+        quint64 _count;
+        quint64 _sum;
+        quint64 _min;
+        quint64 _max;
+};
+
+} // namespace pelican
+
+#endif // TIMINGHISTOGRAM_H
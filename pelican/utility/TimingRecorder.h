@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TIMINGRECORDER_H
+#define TIMINGRECORDER_H
+
+/**
+ * @file TimingRecorder.h
+ */
+
+#include "utility/TimingHistogram.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include <iostream>
+
+namespace pelican {
+
+/**
+ * @ingroup c_utility
+ *
+ * @class TimingRecorder
+ *
+ * @brief
+ * Records the duration of tagged code sections into histograms.
+ *
+ * @details
+ * Each tag has its own TimingHistogram, so memory use is fixed regardless of
+ * the number of measurements. Times are taken from a monotonic nanosecond
+ * clock. A summary of percentiles for each tag can be printed on demand with
+ * report(), or periodically by calling tick() at the end of each iteration
+ * of the code being timed.
+ *
+ * Recording is not synchronised: a recorder should be owned by, and only be
+ * written to from, a single thread (e.g. one per PipelineDriver).
+ *
+ * The Scope class provides a convenient way of timing a block of code, and
+ * costs a single pointer test when given a null recorder, so instrumentation
+ * can be left in place and disabled by not creating the recorder:
+ *
+ * @code
+ * static const QString tag("myModule");
+ * {
+ *     TimingRecorder::Scope timer(recorder, tag);
+ *     ... // code to time.
+ * }
+ * @endcode
+ */
+class TimingRecorder
+{
+    public:
+        /**
+         * @class Scope
+         *
+         * @brief
+         * Records the time spent between its construction and destruction.
+         *
+         * @details
+         * The tag string must outlive the scope object.
+         */
+        class Scope
+        {
+            public:
+                /// Starts timing if @p recorder is not null.
+                Scope(TimingRecorder* recorder, const QString& tag)
+                : _recorder(recorder), _tag(&tag),
+                  _start(recorder ? TimingRecorder::now() : 0) {}
+
+                /// Records the elapsed time against the tag.
+                ~Scope()
+                { if (_recorder) _recorder->add(*_tag, TimingRecorder::now() - _start); }
+
+            private:
+                Scope(const Scope&);
+                Scope& operator=(const Scope&);
+
+            private:
+                TimingRecorder* _recorder;
+                const QString* _tag;
+                quint64 _start;
+        };
+
+    public:
+        /// Constructs a timing recorder.
+        TimingRecorder(const QString& name = QString(), int reportInterval = 0);
+
+        /// Destroys the timing recorder.
+        ~TimingRecorder();
+
+        /// Returns the current time of the monotonic clock, in nanoseconds.
+        static quint64 now();
+
+        /// Records an interval of @p ns nanoseconds against @p tag.
+        void add(const QString& tag, quint64 ns);
+
+        /// Returns the histogram for @p tag, or null if nothing was recorded.
+        const TimingHistogram* histogram(const QString& tag) const;
+
+        /// Returns the list of tags recorded.
+        QList<QString> tags() const { return _histograms.keys(); }
+
+        /// Sets the number of calls to tick() between reports (0 = never).
+        void setReportInterval(int interval) { _reportInterval = interval; }
+
+        /// Marks the end of an iteration, reporting if the interval is reached.
+        void tick();
+
+        /// Prints a percentile summary for each tag.
+        void report(std::ostream& stream = std::cout) const;
+
+        /// Removes all recorded values.
+        void clear();
+
+    private:
+        TimingRecorder(const TimingRecorder&);
+        TimingRecorder& operator=(const TimingRecorder&);
+
+    private:
+        QString _name;
+        int _reportInterval;
+        quint64 _iterations;
+        QHash<QString, TimingHistogram*> _histograms;
+};
+
+} // namespace pelican
+
+#endif // TIMINGRECORDER_H
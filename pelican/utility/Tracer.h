@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef TRACER_H
+#define TRACER_H
+
+/**
+ * @file Tracer.h
+ */
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QString>
+
+namespace pelican {
+
+class ConfigNode;
+
+/**
+ * @ingroup c_utility
+ *
+ * @class Tracer
+ *
+ * @brief
+ * Records timed events along the data path as a Chrome trace.
+ *
+ * @details
+ * Events are written by each thread into its own fixed-size ring buffer,
+ * without locking, and a background thread periodically moves them to a
+ * trace file in the Chrome trace event (JSON) format, which can be viewed
+ * with chrome://tracing or the Perfetto UI. If a ring fills up before it is
+ * flushed, further events from that thread are dropped and counted.
+ *
+ * Spans are recorded with the Scope class. Chunks of stream data are
+ * followed through the system with flow events, identified by the ingest
+ * timestamp that the server stamps on each chunk (and that is carried on to
+ * the data blobs), so the trace shows the path of each chunk from the
+ * chunker to the output streams. Times are taken from the real-time clock,
+ * so traces of a server and its pipelines on the same host line up.
+ *
+ * Event names are interned once, outside the code being traced:
+ *
+ * @code
+ * static const int name = Tracer::intern("MyChunker::next");
+ * {
+ *     Tracer::Scope trace(name);
+ *     ... // code to trace.
+ *     trace.flow(chunkTimestamp);
+ * }
+ * @endcode
+ *
+ * When tracing is not running, a scope costs a single flag test.
+ */
+class Tracer
+{
+    public:
+        /// Flow event phases.
+        enum FlowPhase { FlowStart = 's', FlowStep = 't', FlowEnd = 'f' };
+
+        /**
+         * @class Scope
+         *
+         * @brief
+         * Records a span between its construction and destruction.
+         *
+         * @details
+         * Nothing is recorded if tracing is not running when the scope is
+         * created.
+         */
+        class Scope
+        {
+            public:
+                /// Starts the span if tracing is running.
+                Scope(int name)
+                : _name(name), _start(Tracer::isEnabled() ? Tracer::now() : 0) {}
+
+                /// Records the span.
+                ~Scope() { if (_start) Tracer::complete(_name, _start, Tracer::now()); }
+
+                /// Attaches the flow @p id (if not zero) to the span.
+                void flow(qint64 id, FlowPhase phase = FlowStep)
+                { if (_start && id) Tracer::flow(id, phase); }
+
+            private:
+                Scope(const Scope&);
+                Scope& operator=(const Scope&);
+
+            private:
+                int _name;
+                qint64 _start;
+        };
+
+    public:
+        /// Returns true if events are being recorded.
+        static bool isEnabled() { return _enabled != 0; }
+
+        /// Returns the current time of the real-time clock, in nanoseconds.
+        static qint64 now();
+
+        /// Returns the identifier of the event name @p name.
+        static int intern(const QString& name);
+
+        /// Records a span of the named event from @p start to @p end.
+        static void complete(int name, qint64 start, qint64 end);
+
+        /// Records a step of the flow @p id at the current time.
+        static void flow(qint64 id, FlowPhase phase = FlowStep);
+
+        /// Sets the name under which the calling thread is shown.
+        static void setThreadName(const QString& name);
+
+        /// Starts writing events to @p fileName.
+        static void start(const QString& fileName, int bufferSize = 65536,
+                int flushInterval = 100);
+
+        /// Starts tracing if it is enabled by the @p tag tag of @p config.
+        static bool configure(const ConfigNode& config,
+                const QString& defaultFile, const QString& tag = "trace");
+
+        /// Stops tracing once every call to start() has been matched.
+        static void stop();
+
+        /// Returns the number of events dropped because a buffer was full.
+        static quint64 dropped();
+
+    private:
+        Tracer();
+
+    private:
+        static QAtomicInt _enabled;
+};
+
+} // namespace pelican
+
+#endif // TRACER_H
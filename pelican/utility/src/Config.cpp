@@ -57,12 +57,43 @@ Config::Config(const QString& fileName)
 
     // read in the document
     _document = read(fileName);
+    _compile();
 }
 
 /*=============================================================================
  * PUBLIC MEMBERS
  *---------------------------------------------------------------------------*/
 
+/**
+ * @details
+ * Returns the configuration node at the specified address. The node is null
+ * if the address doesn't exist.
+ */
+ConfigNode Config::get(const TreeAddress &address) const
+{
+    if (const ConfigTree* tree = _index())
+        return ConfigNode(_tree, tree->find(address), this);
+    return ConfigNode(_get(address, _document), this);
+}
+
+/**
+ * @details
+ * Returns the configuration node with the tag \p tag and name attribute
+ * \p name below the node at the address \p base. This is equivalent to
+ * appending the node to a copy of the base address, without the copy.
+ */
+ConfigNode Config::get(const TreeAddress &base, const QString& tag,
+        const QString& name) const
+{
+    const ConfigTree* tree = _index();
+    if (!tree || base.isEmpty()) {
+        TreeAddress address(base);
+        address << NodeId(tag, name);
+        return get(address);
+    }
+    return ConfigNode(_tree, tree->child(tree->find(base), tag, name), this);
+}
+
 /**
  * @details
  * Returns the attribute at the address with the specified key. An empty string
@@ -70,6 +101,11 @@ Config::Config(const QString& fileName)
  */
 QString Config::getAttribute(const TreeAddress& address, const QString& key) const
 {
+    if (const ConfigTree* tree = _index()) {
+        const ConfigTree::Value* value = tree->attribute(tree->find(address), key);
+        return value ? value->text : QString();
+    }
+
     QDomElement e = _get(address, _document);
     if (e.isNull())
         return QString();
@@ -94,6 +130,8 @@ void Config::setSearchPaths( const QList<QString>& paths ) {
 
 bool Config::verifyAddress( const TreeAddress &address) const
 {
+    if (const ConfigTree* tree = _index())
+        return tree->find(address) >= 0;
     QDomElement e = _get(address, _document);
     return ! e.isNull();
 }
@@ -105,6 +143,11 @@ bool Config::verifyAddress( const TreeAddress &address) const
  */
 QString Config::getText(const TreeAddress& address) const
 {
+    if (const ConfigTree* tree = _index()) {
+        int index = tree->find(address);
+        return index < 0 ? QString() : tree->node(index).text;
+    }
+
     QDomElement e = _get(address, _document);
     QDomNodeList children = e.childNodes();
     QString text = QString();
@@ -288,6 +331,18 @@ void Config::save(const QString& fileName) const
     out << _document.toByteArray(4);
 }
 
+/**
+ * @details
+ * Creates the node at the specified address, if it doesn't exist, and
+ * returns it.
+ */
+ConfigNode Config::set(const TreeAddress &address)
+{
+    QDomElement e = _set(address);
+    _compile();
+    return ConfigNode(e, this);
+}
+
 /**
  * @details
  * Set the the attribute at the specified address to the key, value.
@@ -297,6 +352,18 @@ void Config::setAttribute(const TreeAddress &address, const QString &key,
 {
     QDomElement e = _set(address);
     e.setAttribute(key, value);
+    _compile();
+}
+
+/**
+ * @details
+ * Sets the document. The document is shared, not copied, so it should not
+ * be changed afterwards other than through this object.
+ */
+void Config::setDocument(const QDomDocument& document)
+{
+    _document = document;
+    _compile();
 }
 
 /**
@@ -320,6 +387,7 @@ void Config::setXML( const QString& xml )
                 arg(line).arg(column).arg(error).arg(xml);
     }
     preprocess(_document);
+    _compile();
 }
 
 /**
@@ -363,6 +431,7 @@ void Config::setText(const TreeAddress& address, const QString& text)
     QDomElement e = _set(address);
     QDomText t = _document.createTextNode(text);
     e.appendChild(t);
+    _compile();
 }
 
 /**
@@ -433,6 +502,18 @@ void Config::_createChildNode(QDomElement &parent, const QString& tag, const QSt
     parent.appendChild(e);
 }
 
+/**
+ * @details
+ * Replaces the lookup index with one compiled from the current document.
+ * Nodes returned from the old index fall back to the DOM.
+ */
+void Config::_compile()
+{
+    if (_tree) _tree->invalidate();
+    _tree = QSharedPointer<ConfigTree>(
+            new ConfigTree(_document.documentElement()));
+}
+
 /**
  * @details
  * Returns a QDomElement at the specified address in the given document.
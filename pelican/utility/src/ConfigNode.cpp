@@ -46,17 +46,32 @@ namespace pelican {
  * Creates a new configuration node.
  */
 ConfigNode::ConfigNode(const QDomElement& config, const Config* cfgObject )
-    : _configObject(cfgObject)
+    : _configObject(cfgObject), _index(-1)
 {
     _config = config;
 }
 
 
+/**
+ * @details
+ * Creates a configuration node for the node at \p index in the compiled
+ * \p tree. The node is null if \p index is negative.
+ */
+ConfigNode::ConfigNode(const QSharedPointer<const ConfigTree>& tree, int index,
+        const Config* cfgObject)
+    : _configObject(cfgObject), _tree(tree), _index(tree ? index : -1)
+{
+    if (_index >= 0)
+        _config = tree->node(_index).element;
+}
+
+
 /**
  * @details
  * Creates a new configuration node.
  */
 ConfigNode::ConfigNode(const QList<QDomElement>& config)
+    : _configObject(0), _index(-1)
 {
     // Do nothing if list is empty.
     if (config.size() == 0) return;
@@ -94,6 +109,8 @@ void ConfigNode::setFromString(const QString xmlString)
    }
 
    _config = doc.documentElement();
+   _tree = QSharedPointer<const ConfigTree>(new ConfigTree(_config));
+   _index = _config.isNull() ? -1 : 0;
 }
 
 
@@ -105,6 +122,8 @@ void ConfigNode::setFromString(const QString xmlString)
  */
 bool ConfigNode::hasAttribute(const QString& attribute) const
 {
+    if (_compiled())
+        return _tree->attribute(_index, attribute) != 0;
     return _config.hasAttribute(attribute);
 }
 
@@ -114,6 +133,10 @@ bool ConfigNode::hasAttribute(const QString& attribute) const
  */
 QString ConfigNode::getAttribute(const QString& attribute) const
 {
+    if (_compiled()) {
+        const ConfigTree::Value* value = _tree->attribute(_index, attribute);
+        return value ? value->text : QString();
+    }
     return _config.attribute(attribute);
 }
 
@@ -125,6 +148,10 @@ QString ConfigNode::getAttribute(const QString& attribute) const
 QString ConfigNode::getOption(const QString& tagName,
         const QString& attribute, const QString& defValue) const
 {
+    if (_compiled()) {
+        const ConfigTree::Value* value = _option(tagName, attribute);
+        return value ? value->text : defValue;
+    }
     return _config.namedItem(tagName).toElement().attribute(attribute,
             defValue);
 }
@@ -138,6 +165,20 @@ QString ConfigNode::getOption(const QString& tagName,
 QString ConfigNode::getNamedOption(const QString& tagName, const QString& name,
         const QString& attribute, const QString& defValue) const
 {
+    if (_compiled()) {
+        int node = _tree->firstChild(_index, tagName);
+        if (node < 0) return defValue;
+        int tag = _tree->node(node).tag;
+        foreach (int c, _tree->node(node).children) {
+            const ConfigTree::Node& child = _tree->node(c);
+            if (child.tag == tag && child.name == name) {
+                const ConfigTree::Value* value = _tree->attribute(c, attribute);
+                return value ? value->text : QString();
+            }
+        }
+        return defValue;
+    }
+
     QDomNode node = _config.namedItem(tagName);
     if (node.isNull()) return defValue;
 
@@ -162,6 +203,13 @@ QString ConfigNode::getNamedOption(const QString& tagName, const QString& name,
 QString ConfigNode::getOptionText(const QString& tagName,
         const QString& defValue) const
 {
+    if (_compiled()) {
+        int node = _tree->firstChild(_index, tagName);
+        if (node < 0) return defValue;
+        const QString& text = _tree->node(node).text;
+        return text.isEmpty() ? defValue : text;
+    }
+
     QDomNode node = _config.namedItem(tagName);
     if (node.isNull()) return defValue;
 
@@ -176,6 +224,43 @@ QString ConfigNode::getOptionText(const QString& tagName,
     return text.isEmpty() ? defValue : text;
 }
 
+/**
+ * @details
+ * Gets the configuration for the given \p tagName and \p attribute as an
+ * integer. If the option does not exist or is not an integer, \p defValue
+ * is returned. Values are parsed when the configuration is compiled, so this
+ * is cheap enough to call for every iteration of a module.
+ */
+qlonglong ConfigNode::getOptionInt(const QString& tagName,
+        const QString& attribute, qlonglong defValue) const
+{
+    if (_compiled()) {
+        const ConfigTree::Value* value = _option(tagName, attribute);
+        return value && value->isInteger ? value->integer : defValue;
+    }
+    bool ok = false;
+    qlonglong value = getOption(tagName, attribute).toLongLong(&ok);
+    return ok ? value : defValue;
+}
+
+/**
+ * @details
+ * Gets the configuration for the given \p tagName and \p attribute as a
+ * number. If the option does not exist or is not a number, \p defValue is
+ * returned.
+ */
+double ConfigNode::getOptionDouble(const QString& tagName,
+        const QString& attribute, double defValue) const
+{
+    if (_compiled()) {
+        const ConfigTree::Value* value = _option(tagName, attribute);
+        return value && value->isNumber ? value->number : defValue;
+    }
+    bool ok = false;
+    double value = getOption(tagName, attribute).toDouble(&ok);
+    return ok ? value : defValue;
+}
+
 /**
  * @details
  * Gets a hash of attribute pairs for a list of \p tagname items.
@@ -200,6 +285,16 @@ QHash<QString, QString> ConfigNode::getOptionHash(const QString& tagName,
         const QString& attr1, const QString& attr2) const
 {
     QHash<QString, QString> hash;
+    if (_compiled()) {
+        foreach (int i, _tree->elements(_index, tagName)) {
+            const ConfigTree::Value* key = _tree->attribute(i, attr1);
+            const ConfigTree::Value* value = _tree->attribute(i, attr2);
+            if (key && value)
+                hash.insert(key->text, value->text);
+        }
+        return hash;
+    }
+
     QDomNodeList list = _config.elementsByTagName(tagName);
     for (int i = 0; i < list.size(); ++i) {
         QDomElement element = list.at(i).toElement();
@@ -233,6 +328,15 @@ QList<QString> ConfigNode::getOptionList(const QString& tagName,
         const QString& attr) const
 {
     QList<QString> optionList;
+    if (_compiled()) {
+        foreach (int i, _tree->elements(_index, tagName)) {
+            const ConfigTree::Value* value = _tree->attribute(i, attr);
+            if (value)
+                optionList.append(value->text);
+        }
+        return optionList;
+    }
+
     QDomNodeList list = _config.elementsByTagName(tagName);
     for (int i = 0; i < list.size(); ++i) {
         QDomElement element = list.at(i).toElement();
@@ -299,6 +403,12 @@ std::vector<unsigned> ConfigNode::getUnsignedList(const QString& tagName) const
 QList<ConfigNode> ConfigNode::getNodes(const QString& tagName) const
 {
     QList<ConfigNode> list;
+    if (_compiled()) {
+        foreach (int i, _tree->elements(_index, tagName))
+            list.append( ConfigNode( _tree, i, _configObject) );
+        return list;
+    }
+
     QDomNodeList doms = _config.elementsByTagName(tagName);
     for (int i = 0; i < doms.size(); ++i) {
         QDomElement element = doms.at(i).toElement();
@@ -313,4 +423,15 @@ QString ConfigNode::searchFile( const QString& filename ) const
     return _configObject->searchFile( filename );
 }
 
+/**
+ * @details
+ * Returns the \p attribute of the first child with tag \p tagName in the
+ * compiled tree, or null if there is none.
+ */
+const ConfigTree::Value* ConfigNode::_option(const QString& tagName,
+        const QString& attribute) const
+{
+    return _tree->attribute(_tree->firstChild(_index, tagName), attribute);
+}
+
 } // namespace pelican
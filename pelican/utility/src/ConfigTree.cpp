@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "utility/ConfigTree.h"
+
+#include <QtXml/QDomNamedNodeMap>
+#include <QtXml/QDomNodeList>
+
+#include <algorithm>
+
+namespace pelican {
+
+/**
+ * @details
+ * Compiles the index of @p root and all the elements below it. The tree is
+ * empty if @p root is null.
+ */
+ConfigTree::ConfigTree(const QDomElement& root)
+    : _valid(1)
+{
+    if (!root.isNull())
+        _compile(root, -1);
+}
+
+/**
+ * @details
+ * Returns the index of the child of @p parent with tag @p tag and name
+ * attribute @p name, or -1 if there is none. As for the DOM lookup in
+ * Config, the last such child is returned if there are several.
+ */
+int ConfigTree::child(int parent, const QString& tag, const QString& name) const
+{
+    int t = key(tag);
+    if (parent < 0 || t < 0) return -1;
+    return _nodes[parent].named.value(qMakePair(t, name), -1);
+}
+
+/**
+ * @details
+ * Returns the index of the first child of @p parent with tag @p tag, or -1
+ * if there is none.
+ */
+int ConfigTree::firstChild(int parent, const QString& tag) const
+{
+    int t = key(tag);
+    if (parent < 0 || t < 0) return -1;
+    return _nodes[parent].first.value(t, -1);
+}
+
+/**
+ * @details
+ * Returns the index of the node at @p address, or -1 if it does not exist.
+ * As for Config::get(), the address may start either with the root element
+ * or with one of its children.
+ */
+int ConfigTree::find(const QList<QPair<QString, QString> >& address) const
+{
+    if (_nodes.isEmpty()) return -1;
+
+    int index = 0;
+    int a = 0;
+    if (!address.isEmpty() && key(address.at(0).first) == _nodes[0].tag)
+        ++a;
+
+    for (; a < address.size() && index >= 0; ++a)
+        index = child(index, address.at(a).first, address.at(a).second);
+    return index;
+}
+
+/**
+ * @details
+ * Returns the indices of all the elements with tag @p tag below @p parent
+ * (not including @p parent itself), in document order.
+ */
+QVector<int> ConfigTree::elements(int parent, const QString& tag) const
+{
+    QVector<int> found;
+    int t = key(tag);
+    if (parent < 0 || t < 0) return found;
+
+    // Descendants of a node are stored contiguously after it.
+    const QVector<int> all = _tags.value(t);
+    QVector<int>::const_iterator begin = std::upper_bound(all.begin(),
+            all.end(), parent);
+    QVector<int>::const_iterator end = std::lower_bound(begin, all.end(),
+            _nodes[parent].end);
+    for (; begin != end; ++begin)
+        found.append(*begin);
+    return found;
+}
+
+/**
+ * @details
+ * Returns the attribute @p name of the node at @p index, or null if the
+ * node does not have one.
+ */
+const ConfigTree::Value* ConfigTree::attribute(int index,
+        const QString& name) const
+{
+    int k = key(name);
+    if (index < 0 || k < 0) return 0;
+    const QHash<int, Value>& attributes = _nodes[index].attributes;
+    QHash<int, Value>::const_iterator it = attributes.find(k);
+    return it == attributes.end() ? 0 : &it.value();
+}
+
+/**
+ * @details
+ * Returns the key of @p string, adding it to the table if necessary.
+ */
+int ConfigTree::_intern(const QString& string)
+{
+    QHash<QString, int>::const_iterator it = _keys.find(string);
+    if (it != _keys.end()) return it.value();
+    int k = _keys.size();
+    _keys.insert(string, k);
+    return k;
+}
+
+/**
+ * @details
+ * Appends @p element and, recursively, its descendants to the tree.
+ */
+void ConfigTree::_compile(const QDomElement& element, int parent)
+{
+    int index = _nodes.size();
+    _nodes.resize(index + 1);
+    {
+        Node& node = _nodes[index];
+        node.element = element;
+        node.tag = _intern(element.tagName());
+        node.parent = parent;
+        node.name = element.attribute("name");
+
+        QDomNamedNodeMap attributes = element.attributes();
+        for (int i = 0; i < attributes.size(); ++i) {
+            QDomAttr attr = attributes.item(i).toAttr();
+            Value value;
+            value.text = attr.value();
+            value.integer = value.text.toLongLong(&value.isInteger);
+            value.number = value.text.toDouble(&value.isNumber);
+            node.attributes.insert(_intern(attr.name()), value);
+        }
+    }
+    _tags[_nodes[index].tag].append(index);
+
+    QDomNodeList children = element.childNodes();
+    for (int i = 0; i < children.size(); ++i) {
+        QDomNode child = children.at(i);
+        if (child.nodeType() == QDomNode::TextNode) {
+            _nodes[index].text += child.nodeValue();
+        }
+        else if (child.isElement()) {
+            int c = _nodes.size();
+            _compile(child.toElement(), index);
+
+            // The vector may have grown, so look the node up again.
+            Node& node = _nodes[index];
+            const Node& added = _nodes[c];
+            node.children.append(c);
+            if (!node.first.contains(added.tag))
+                node.first.insert(added.tag, c);
+            node.named.insert(qMakePair(added.tag, added.name), c);
+        }
+    }
+    _nodes[index].end = _nodes.size();
+}
+
+} // namespace pelican
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utility/LatencyMonitor.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QStringList>
+
+#include <ctime>
+#include <iomanip>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a latency monitor.
+ *
+ * @param[in] name           Name used to identify the monitor in reports.
+ * @param[in] alarmThreshold Latency budget in nanoseconds (0 = no alarms).
+ * @param[in] reportInterval Number of calls to tick() between reports.
+ */
+LatencyMonitor::LatencyMonitor(const QString& name, quint64 alarmThreshold,
+        int reportInterval)
+: _name(name), _alarmThreshold(alarmThreshold),
+  _reportInterval(reportInterval), _iterations(0)
+{
+}
+
+
+/**
+ * @details
+ * Destroys the latency monitor.
+ */
+LatencyMonitor::~LatencyMonitor()
+{
+    qDeleteAll(_streams);
+}
+
+
+/**
+ * @details
+ * Returns the current time of the real-time clock, in nanoseconds since the
+ * epoch. This is the clock used to stamp data on ingest.
+ */
+qint64 LatencyMonitor::now()
+{
+    timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    return qint64(t.tv_sec) * Q_INT64_C(1000000000) + qint64(t.tv_nsec);
+}
+
+
+/**
+ * @details
+ * Records the latency of data on @p stream that was ingested at
+ * @p ingestTime (as returned by now()).
+ *
+ * @return The latency in nanoseconds, or zero if @p ingestTime is not set.
+ */
+quint64 LatencyMonitor::record(const QString& stream, qint64 ingestTime)
+{
+    if (ingestTime <= 0)
+        return 0;
+
+    qint64 delta = now() - ingestTime;
+    quint64 latency = delta > 0 ? quint64(delta) : 0;
+
+    QMutexLocker locker(&_mutex);
+    Stream*& s = _streams[stream];
+    if (!s) s = new Stream;
+    s->histogram.add(latency);
+
+    if (_alarmThreshold == 0)
+        return latency;
+
+    bool lagging = latency > _alarmThreshold;
+    if (lagging) ++s->alarms;
+    if (lagging != s->lagging) {
+        std::cerr << "LatencyMonitor";
+        if (!_name.isEmpty()) std::cerr << " (" << _name.toStdString() << ")";
+        std::cerr << ": WARNING: stream \"" << stream.toStdString() << "\" "
+                  << (lagging ? "exceeded" : "is back within")
+                  << " the latency budget of " << _alarmThreshold / 1e6
+                  << " ms (latency " << latency / 1e6 << " ms)." << std::endl;
+        s->lagging = lagging;
+    }
+    return latency;
+}
+
+
+/**
+ * @details
+ * Sets the latency, in nanoseconds, above which a measurement raises an
+ * alarm. A value of zero disables alarms.
+ */
+void LatencyMonitor::setAlarmThreshold(quint64 ns)
+{
+    QMutexLocker locker(&_mutex);
+    _alarmThreshold = ns;
+}
+
+
+/**
+ * @details
+ * Returns the alarm threshold, in nanoseconds.
+ */
+quint64 LatencyMonitor::alarmThreshold() const
+{
+    QMutexLocker locker(&_mutex);
+    return _alarmThreshold;
+}
+
+
+/**
+ * @details
+ * Returns the number of measurements on @p stream that exceeded the alarm
+ * threshold.
+ */
+quint64 LatencyMonitor::alarms(const QString& stream) const
+{
+    QMutexLocker locker(&_mutex);
+    const Stream* s = _streams.value(stream, 0);
+    return s ? s->alarms : 0;
+}
+
+
+/**
+ * @details
+ * Returns true if the most recent measurement on @p stream exceeded the
+ * alarm threshold.
+ */
+bool LatencyMonitor::lagging(const QString& stream) const
+{
+    QMutexLocker locker(&_mutex);
+    const Stream* s = _streams.value(stream, 0);
+    return s ? s->lagging : false;
+}
+
+
+/**
+ * @details
+ * Returns a copy of the latency histogram for @p stream (empty if nothing
+ * has been recorded).
+ */
+TimingHistogram LatencyMonitor::histogram(const QString& stream) const
+{
+    QMutexLocker locker(&_mutex);
+    const Stream* s = _streams.value(stream, 0);
+    return s ? s->histogram : TimingHistogram();
+}
+
+
+/**
+ * @details
+ * Returns the list of streams for which latencies have been recorded.
+ */
+QList<QString> LatencyMonitor::streams() const
+{
+    QMutexLocker locker(&_mutex);
+    return _streams.keys();
+}
+
+
+/**
+ * @details
+ * Sets the number of calls to tick() between reports (0 = never).
+ */
+void LatencyMonitor::setReportInterval(int interval)
+{
+    QMutexLocker locker(&_mutex);
+    _reportInterval = interval;
+}
+
+
+/**
+ * @details
+ * Marks the end of an iteration, and prints a report if the report interval
+ * has been reached.
+ */
+void LatencyMonitor::tick()
+{
+    bool doReport = false;
+    {
+        QMutexLocker locker(&_mutex);
+        ++_iterations;
+        doReport = _reportInterval > 0 && _iterations % _reportInterval == 0;
+    }
+    if (doReport)
+        report();
+}
+
+
+/**
+ * @details
+ * Prints a summary of the recorded latencies for each stream, in
+ * milliseconds, with the number of alarms raised.
+ */
+void LatencyMonitor::report(std::ostream& stream) const
+{
+    QMutexLocker locker(&_mutex);
+    QStringList keys = _streams.keys();
+    keys.sort();
+
+    stream << "Latency report";
+    if (!_name.isEmpty()) stream << " (" << _name.toStdString() << ")";
+    stream << ": latencies in milliseconds";
+    if (_alarmThreshold > 0)
+        stream << ", budget " << _alarmThreshold / 1e6 << " ms";
+    stream << std::endl;
+
+    std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(3);
+    foreach (const QString& key, keys) {
+        const Stream* s = _streams.value(key);
+        const TimingHistogram& h = s->histogram;
+        stream << "    " << key.toStdString()
+               << ": count=" << h.count()
+               << " mean=" << h.mean() / 1e6
+               << " min=" << h.min() / 1e6
+               << " p50=" << h.percentile(50.0) / 1e6
+               << " p90=" << h.percentile(90.0) / 1e6
+               << " p99=" << h.percentile(99.0) / 1e6
+               << " p99.9=" << h.percentile(99.9) / 1e6
+               << " max=" << h.max() / 1e6
+               << " alarms=" << s->alarms
+               << std::endl;
+    }
+    stream.flags(flags);
+}
+
+
+/**
+ * @details
+ * Removes all recorded values.
+ */
+void LatencyMonitor::clear()
+{
+    QMutexLocker locker(&_mutex);
+    qDeleteAll(_streams);
+    _streams.clear();
+    _iterations = 0;
+}
+
+} // namespace pelican
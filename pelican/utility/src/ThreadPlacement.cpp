@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utility/ThreadPlacement.h"
+#include "utility/ConfigNode.h"
+#include "utility/Tracer.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pelican {
+
+/**
+ * @details
+ * Reads the @c cores, @c priority and @c numaNode attributes of the
+ * @p tag tag.
+ */
+ThreadPlacement::ThreadPlacement(const ConfigNode& config, const QString& tag)
+    : _priority(0), _numaNode(-1)
+{
+    _cores = parseCpuList(config.getOption(tag, "cores", ""));
+    setPriority(config.getOption(tag, "priority", "0").toInt());
+    _numaNode = config.getOption(tag, "numaNode", "-1").toInt();
+}
+
+
+void ThreadPlacement::setPriority(int priority)
+{
+    if (priority < 0 || priority > 99)
+        throw QString("ThreadPlacement: Invalid priority %1.").arg(priority);
+    _priority = priority;
+}
+
+
+/**
+ * @details
+ * Sets the memory policy, CPU affinity and scheduling of the calling thread.
+ * The placement is reported on std::cout, and failures as warnings on
+ * std::cerr. The thread is also shown as @p name in event traces.
+ */
+bool ThreadPlacement::apply(const QString& name, bool report) const
+{
+    Tracer::setThreadName(name);
+    if (isEmpty())
+        return true;
+
+    bool ok = true;
+    QString prefix = QString("ThreadPlacement: %1: ").arg(name);
+#if defined(__linux__)
+    QList<int> cores = _cores;
+    if (_numaNode >= 0) {
+        // Prefer the node for new memory, falling back to others if full.
+        unsigned long mask[16];
+        memset(mask, 0, sizeof(mask));
+        const int bits = 8 * sizeof(unsigned long);
+        if (_numaNode < 16 * bits) {
+            mask[_numaNode / bits] = 1UL << (_numaNode % bits);
+            if (::syscall(__NR_set_mempolicy, MPOL_PREFERRED, mask,
+                    (unsigned long)(16 * bits)) != 0) {
+                std::cerr << prefix.toStdString() << "WARNING: Unable to "
+                          << "set NUMA node " << _numaNode << " ("
+                          << strerror(errno) << ")." << std::endl;
+                ok = false;
+            }
+        }
+        else {
+            std::cerr << prefix.toStdString() << "WARNING: Invalid NUMA node "
+                      << _numaNode << "." << std::endl;
+            ok = false;
+        }
+        if (cores.isEmpty())
+            cores = numaCores(_numaNode);
+    }
+
+    if (!cores.isEmpty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        foreach (int core, cores) {
+            if (core >= 0 && core < CPU_SETSIZE)
+                CPU_SET(core, &set);
+        }
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            std::cerr << prefix.toStdString() << "WARNING: Unable to set "
+                      << "CPU affinity (" << strerror(err) << ")." << std::endl;
+            ok = false;
+        }
+    }
+
+    if (_priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = _priority;
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            std::cerr << prefix.toStdString() << "WARNING: Unable to set "
+                      << "SCHED_FIFO priority " << _priority << " ("
+                      << strerror(err) << ")." << std::endl;
+            ok = false;
+        }
+    }
+#else
+    std::cerr << prefix.toStdString() << "WARNING: Thread placement is not "
+              << "supported on this system." << std::endl;
+    ok = false;
+#endif
+
+    if (report)
+        std::cout << prefix.toStdString() << toString().toStdString()
+                  << std::endl;
+    return ok;
+}
+
+
+/**
+ * @details
+ * Returns a description such as "cores 2,3; SCHED_FIFO 50; NUMA node 1".
+ */
+QString ThreadPlacement::toString() const
+{
+    QStringList parts;
+    if (!_cores.isEmpty()) {
+        QStringList cores;
+        foreach (int core, _cores)
+            cores << QString::number(core);
+        parts << "cores " + cores.join(",");
+    }
+    if (_priority > 0)
+        parts << QString("SCHED_FIFO %1").arg(_priority);
+    if (_numaNode >= 0)
+        parts << QString("NUMA node %1").arg(_numaNode);
+    return parts.isEmpty() ? QString("default") : parts.join("; ");
+}
+
+
+/**
+ * @details
+ * Parses a list of CPU numbers and ranges, such as "0-3,8" (the format of
+ * the Linux cpulist files). Throws on a malformed list.
+ */
+QList<int> ThreadPlacement::parseCpuList(const QString& list)
+{
+    QList<int> cores;
+    foreach (const QString& item, list.split(",", QString::SkipEmptyParts)) {
+        QStringList range = item.trimmed().split("-");
+        bool ok1 = false, ok2 = false;
+        int first = range[0].toInt(&ok1);
+        int last = range.size() > 1 ? range[1].toInt(&ok2) : first;
+        if (range.size() == 1)
+            ok2 = true;
+        if (!ok1 || !ok2 || range.size() > 2 || first < 0 || last < first)
+            throw QString("ThreadPlacement: Invalid CPU list '%1'.").arg(list);
+        for (int core = first; core <= last; ++core) {
+            if (!cores.contains(core))
+                cores.append(core);
+        }
+    }
+    return cores;
+}
+
+
+/**
+ * @details
+ * Reads the cores of a NUMA node from sysfs.
+ */
+QList<int> ThreadPlacement::numaCores(int node)
+{
+    QFile file(QString("/sys/devices/system/node/node%1/cpulist").arg(node));
+    if (node < 0 || !file.open(QIODevice::ReadOnly))
+        return QList<int>();
+    try {
+        return parseCpuList(QString(file.readAll()).trimmed());
+    }
+    catch (const QString&) {
+        return QList<int>();
+    }
+}
+
+} // namespace pelican
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utility/TimingHistogram.h"
+
+#include <algorithm>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs an empty histogram.
+ */
+TimingHistogram::TimingHistogram()
+: _counts(NumBuckets, 0), _count(0), _sum(0), _min(0), _max(0)
+{
+}
+
+
+/**
+ * @details
+ * Records the interval @p ns, in nanoseconds.
+ */
+void TimingHistogram::add(quint64 ns)
+{
+    ++_counts[_bucket(ns)];
+    if (!_count || ns < _min) _min = ns;
+    if (ns > _max) _max = ns;
+    _sum += ns;
+    ++_count;
+}
+
+
+/**
+ * @details
+ * Adds the counts held in @p other to this histogram.
+ */
+void TimingHistogram::merge(const TimingHistogram& other)
+{
+    if (!other._count) return;
+    for (int i = 0; i < NumBuckets; ++i)
+        _counts[i] += other._counts[i];
+    if (!_count || other._min < _min) _min = other._min;
+    _max = std::max(_max, other._max);
+    _sum += other._sum;
+    _count += other._count;
+}
+
+
+/**
+ * @details
+ * Removes all recorded values.
+ */
+void TimingHistogram::clear()
+{
+    std::fill(_counts.begin(), _counts.end(), 0);
+    _count = _sum = _min = _max = 0;
+}
+
+
+/**
+ * @details
+ * Returns the value below which @p percent of the recorded values lie. The
+ * value returned is the upper edge of the bucket containing the percentile,
+ * clamped to the range of recorded values.
+ *
+ * @param[in] percent The percentile required, in the range 0 to 100.
+ */
+quint64 TimingHistogram::percentile(double percent) const
+{
+    if (!_count) return 0;
+    if (percent <= 0.0) return min();
+    if (percent >= 100.0) return max();
+
+    quint64 rank = quint64(percent / 100.0 * _count + 0.5);
+    if (rank < 1) rank = 1;
+    quint64 total = 0;
+    for (int i = 0; i < NumBuckets; ++i) {
+        total += _counts[i];
+        if (total >= rank)
+            return std::max(_min, std::min(_max, _upperBound(i)));
+    }
+    return max();
+}
+
+
+/**
+ * @details
+ * Returns the index of the bucket holding @p value.
+ */
+int TimingHistogram::_bucket(quint64 value)
+{
+    if (value < quint64(SubBuckets))
+        return int(value);
+
+    // Find the position of the most significant bit.
+#ifdef __GNUC__
+    int msb = 63 - __builtin_clzll(value);
+#else
+    int msb = 0;
+    for (quint64 v = value; v >>= 1;) ++msb;
+#endif
+    int shift = msb - SubBucketBits;
+    return (shift + 1) * SubBuckets + int((value >> shift) & (SubBuckets - 1));
+}
+
+
+/**
+ * @details
+ * Returns the smallest value held in @p bucket.
+ */
+quint64 TimingHistogram::_lowerBound(int bucket)
+{
+    if (bucket < SubBuckets)
+        return quint64(bucket);
+    int shift = bucket / SubBuckets - 1;
+    return quint64(SubBuckets + bucket % SubBuckets) << shift;
+}
+
+
+/**
+ * @details
+ * Returns the largest value held in @p bucket.
+ */
+quint64 TimingHistogram::_upperBound(int bucket)
+{
+    if (bucket + 1 >= NumBuckets)
+        return ~quint64(0);
+    return _lowerBound(bucket + 1) - 1;
+}
+
+} // namespace pelican
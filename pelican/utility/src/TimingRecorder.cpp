@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utility/TimingRecorder.h"
+
+#include <QtCore/QStringList>
+
+#include <ctime>
+#include <iomanip>
+
+namespace pelican {
+
+/**
+ * @details
+ * Constructs a timing recorder.
+ *
+ * @param[in] name           Name used to identify the recorder in reports.
+ * @param[in] reportInterval Number of calls to tick() between reports.
+ */
+TimingRecorder::TimingRecorder(const QString& name, int reportInterval)
+: _name(name), _reportInterval(reportInterval), _iterations(0)
+{
+}
+
+
+/**
+ * @details
+ * Destroys the timing recorder.
+ */
+TimingRecorder::~TimingRecorder()
+{
+    qDeleteAll(_histograms);
+}
+
+
+/**
+ * @details
+ * Returns the current time of the monotonic clock, in nanoseconds.
+ */
+quint64 TimingRecorder::now()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return quint64(t.tv_sec) * Q_UINT64_C(1000000000) + quint64(t.tv_nsec);
+}
+
+
+/**
+ * @details
+ * Records an interval of @p ns nanoseconds against @p tag.
+ */
+void TimingRecorder::add(const QString& tag, quint64 ns)
+{
+    TimingHistogram*& h = _histograms[tag];
+    if (!h) h = new TimingHistogram;
+    h->add(ns);
+}
+
+
+/**
+ * @details
+ * Returns the histogram for @p tag, or null if nothing has been recorded.
+ */
+const TimingHistogram* TimingRecorder::histogram(const QString& tag) const
+{
+    return _histograms.value(tag, 0);
+}
+
+
+/**
+ * @details
+ * Marks the end of an iteration of the code being timed, and prints a report
+ * if the report interval has been reached.
+ */
+void TimingRecorder::tick()
+{
+    ++_iterations;
+    if (_reportInterval > 0 && _iterations % _reportInterval == 0)
+        report();
+}
+
+
+/**
+ * @details
+ * Prints a summary of the recorded times for each tag, in microseconds.
+ */
+void TimingRecorder::report(std::ostream& stream) const
+{
+    QStringList keys = _histograms.keys();
+    keys.sort();
+
+    stream << "Timing report";
+    if (!_name.isEmpty()) stream << " (" << _name.toStdString() << ")";
+    stream << ": " << _iterations << " iterations, times in microseconds"
+           << std::endl;
+
+    std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(1);
+    foreach (const QString& tag, keys) {
+        const TimingHistogram* h = _histograms.value(tag);
+        stream << "    " << tag.toStdString()
+               << ": count=" << h->count()
+               << " mean=" << h->mean() / 1e3
+               << " min=" << h->min() / 1e3
+               << " p50=" << h->percentile(50.0) / 1e3
+               << " p90=" << h->percentile(90.0) / 1e3
+               << " p99=" << h->percentile(99.0) / 1e3
+               << " p99.9=" << h->percentile(99.9) / 1e3
+               << " max=" << h->max() / 1e3
+               << std::endl;
+    }
+    stream.flags(flags);
+}
+
+
+/**
+ * @details
+ * Removes all recorded values.
+ */
+void TimingRecorder::clear()
+{
+    qDeleteAll(_histograms);
+    _histograms.clear();
+    _iterations = 0;
+}
+
+} // namespace pelican
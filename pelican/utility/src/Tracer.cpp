@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "utility/Tracer.h"
+#include "utility/ConfigNode.h"
+#include "utility/LatencyMonitor.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QPair>
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+#include <cstdio>
+#include <iostream>
+
+namespace pelican {
+
+QAtomicInt Tracer::_enabled(0);
+
+namespace {
+
+/// A span ('X') or flow step ('s', 't', 'f').
+struct Event {
+    qint64 time;
+    qint64 value; ///< Duration of a span, or the flow id.
+    int name;
+    char phase;
+};
+
+/**
+ * Single-producer, single-consumer ring of events written by one thread and
+ * read by the flush thread.
+ */
+class ThreadBuffer
+{
+    public:
+        ThreadBuffer(int tid, int size)
+        : tid(tid), nameChanged(false), _events(size), _mask(size - 1),
+          _head(0), _tail(0), _closed(0), _write(0), _cachedTail(0) {}
+
+        /// Appends an event, returning false if the ring is full.
+        bool push(const Event& event)
+        {
+            if (_write - _cachedTail > _mask) {
+                _cachedTail = unsigned(_tail.fetchAndAddAcquire(0));
+                if (_write - _cachedTail > _mask)
+                    return false;
+            }
+            _events[_write & _mask] = event;
+            _head.fetchAndStoreRelease(int(++_write));
+            return true;
+        }
+
+        /// Calls @p write for each pending event, oldest first.
+        template <class F>
+        void drain(F& write)
+        {
+            unsigned head = unsigned(_head.fetchAndAddAcquire(0));
+            unsigned tail = unsigned(_tail.fetchAndAddAcquire(0));
+            for (; tail != head; ++tail)
+                write(tid, _events[tail & _mask]);
+            _tail.fetchAndStoreRelease(int(head));
+        }
+
+        /// Discards all pending events.
+        void clear() { _tail.fetchAndStoreRelease(_head.fetchAndAddAcquire(0)); }
+
+        /// Marks the buffer as belonging to a finished thread.
+        void close() { _closed.fetchAndStoreRelease(1); }
+
+        /// Returns true once the thread has finished.
+        bool isClosed() { return _closed.fetchAndAddAcquire(0) != 0; }
+
+    public:
+        const int tid;
+        QString name;     ///< Protected by the tracer mutex.
+        bool nameChanged; ///< Protected by the tracer mutex.
+
+    private:
+        QVector<Event> _events;
+        const unsigned _mask;
+        QAtomicInt _head;
+        QAtomicInt _tail;
+        QAtomicInt _closed;
+        unsigned _write;      ///< Producer copy of the head.
+        unsigned _cachedTail; ///< Producer copy of the tail.
+};
+
+/// Per-thread state, deleted when the thread finishes.
+struct ThreadHolder {
+    ThreadHolder() : buffer(0) {}
+    ~ThreadHolder() { if (buffer) buffer->close(); }
+    ThreadBuffer* buffer;
+    QString name;
+};
+
+class FlushThread;
+
+/// State shared by all threads.
+struct TraceState {
+    TraceState() : users(0), bufferSize(65536), nextTid(1), flusher(0),
+        dropped(0), first(true), pid(QCoreApplication::applicationPid()) {}
+    // Buffers are not deleted on exit as threads may still hold them.
+
+    QMutex mutex;
+    QHash<QString, int> ids;
+    QVector<QString> names;
+    QList<ThreadBuffer*> buffers;
+    QThreadStorage<ThreadHolder*> threads;
+    int users;
+    int bufferSize;
+    int nextTid;
+    FlushThread* flusher;
+    QAtomicInt dropped;
+
+    // Used only by the flush thread while tracing is running.
+    QFile file;
+    bool first;
+    qint64 pid;
+};
+
+Q_GLOBAL_STATIC(TraceState, traceState)
+
+/// Returns @p string as a quoted JSON string.
+QByteArray quote(const QString& string)
+{
+    QByteArray out("\"");
+    QByteArray utf8 = string.toUtf8();
+    for (int i = 0; i < utf8.size(); ++i) {
+        char c = utf8.at(i);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (uchar(c) < 0x20) {
+            char escaped[8];
+            std::sprintf(escaped, "\\u%04x", int(c));
+            out += escaped;
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+/// Formats a time in nanoseconds as microseconds.
+QByteArray micro(qint64 ns)
+{
+    char text[32];
+    std::sprintf(text, "%lld.%03d", (long long)(ns / 1000), int(ns % 1000));
+    return QByteArray(text);
+}
+
+/// Formats events as Chrome trace JSON into a block of text.
+class EventWriter
+{
+    public:
+        EventWriter(TraceState* state, const QVector<QString>& names)
+        : _state(state), _names(names) {}
+
+        /// Appends a thread or process name record.
+        void metadata(const char* type, int tid, const QString& name)
+        {
+            _begin();
+            _out += "{\"name\":\"";
+            _out += type;
+            _out += "\",\"ph\":\"M\",\"pid\":" + QByteArray::number(_state->pid)
+                 + ",\"tid\":" + QByteArray::number(tid)
+                 + ",\"args\":{\"name\":" + quote(name) + "}}";
+        }
+
+        /// Appends an event recorded by the thread @p tid.
+        void operator()(int tid, const Event& event)
+        {
+            _begin();
+            QByteArray ids = ",\"pid\":" + QByteArray::number(_state->pid)
+                    + ",\"tid\":" + QByteArray::number(tid);
+            if (event.phase == 'X') {
+                _out += "{\"name\":" + quote(_names.value(event.name))
+                     + ",\"cat\":\"pelican\",\"ph\":\"X\"" + ids
+                     + ",\"ts\":" + micro(event.time)
+                     + ",\"dur\":" + micro(event.value) + "}";
+            }
+            else {
+                _out += "{\"name\":\"chunk\",\"cat\":\"chunk\",\"ph\":\"";
+                _out += event.phase;
+                _out += "\",\"id\":\"0x" + QByteArray::number(event.value, 16)
+                     + "\"" + ids + ",\"ts\":" + micro(event.time)
+                     + ",\"bp\":\"e\"}";
+            }
+        }
+
+        /// Writes the text to the trace file.
+        void write()
+        {
+            if (!_out.isEmpty())
+                _state->file.write(_out);
+            _out.clear();
+        }
+
+    private:
+        void _begin()
+        {
+            if (!_state->first) _out += ",\n";
+            _state->first = false;
+        }
+
+    private:
+        TraceState* _state;
+        QVector<QString> _names;
+        QByteArray _out;
+};
+
+/// Moves the events of all the threads to the trace file.
+void drainAll(TraceState* state)
+{
+    QList<ThreadBuffer*> buffers;
+    QList<bool> closed;
+    QVector<QString> names;
+    QList<QPair<int, QString> > threadNames;
+    {
+        QMutexLocker locker(&state->mutex);
+        buffers = state->buffers;
+        names = state->names;
+        foreach (ThreadBuffer* buffer, buffers) {
+            // A closed buffer receives no more events, so it can be deleted
+            // once drained.
+            closed.append(buffer->isClosed());
+            if (buffer->nameChanged)
+                threadNames.append(qMakePair(buffer->tid, buffer->name));
+            buffer->nameChanged = false;
+        }
+    }
+
+    EventWriter writer(state, names);
+    for (int i = 0; i < threadNames.size(); ++i)
+        writer.metadata("thread_name", threadNames[i].first, threadNames[i].second);
+    for (int i = 0; i < buffers.size(); ++i)
+        buffers[i]->drain(writer);
+    writer.write();
+    state->file.flush();
+
+    QMutexLocker locker(&state->mutex);
+    for (int i = 0; i < buffers.size(); ++i) {
+        if (closed[i]) {
+            state->buffers.removeAll(buffers[i]);
+            delete buffers[i];
+        }
+    }
+}
+
+/// Periodically drains the thread buffers until stopped.
+class FlushThread : public QThread
+{
+    public:
+        FlushThread(TraceState* state, int interval)
+        : _state(state), _interval(interval), _stop(false) {}
+
+        void stop()
+        {
+            QMutexLocker locker(&_mutex);
+            _stop = true;
+            _wake.wakeAll();
+        }
+
+    protected:
+        void run()
+        {
+            for (;;) {
+                drainAll(_state);
+                QMutexLocker locker(&_mutex);
+                if (_stop) break;
+                _wake.wait(&_mutex, _interval);
+            }
+            drainAll(_state);
+        }
+
+    private:
+        TraceState* _state;
+        unsigned long _interval;
+        bool _stop;
+        QMutex _mutex;
+        QWaitCondition _wake;
+};
+
+/// Returns the calling thread's buffer, creating it if necessary.
+ThreadBuffer* threadBuffer(TraceState* state)
+{
+    ThreadHolder* holder = state->threads.localData();
+    if (!holder) {
+        holder = new ThreadHolder;
+        state->threads.setLocalData(holder);
+    }
+    if (!holder->buffer) {
+        QMutexLocker locker(&state->mutex);
+        holder->buffer = new ThreadBuffer(state->nextTid++, state->bufferSize);
+        holder->buffer->name = holder->name;
+        holder->buffer->nameChanged = !holder->name.isEmpty();
+        state->buffers.append(holder->buffer);
+    }
+    return holder->buffer;
+}
+
+/// Records an event from the calling thread.
+void record(const Event& event)
+{
+    TraceState* state = traceState();
+    if (!threadBuffer(state)->push(event))
+        state->dropped.fetchAndAddRelaxed(1);
+}
+
+} // namespace
+
+
+/**
+ * @details
+ * Returns the current time of the real-time clock, in nanoseconds since the
+ * epoch, as used to stamp chunks on ingest.
+ */
+qint64 Tracer::now()
+{
+    return LatencyMonitor::now();
+}
+
+/**
+ * @details
+ * Returns the identifier to record events named @p name with. Identifiers
+ * remain valid for the lifetime of the process, so should be looked up once
+ * (e.g. into a static variable) rather than for every event.
+ */
+int Tracer::intern(const QString& name)
+{
+    TraceState* state = traceState();
+    QMutexLocker locker(&state->mutex);
+    QHash<QString, int>::const_iterator it = state->ids.find(name);
+    if (it != state->ids.end()) return it.value();
+    int id = state->names.size();
+    state->names.append(name);
+    state->ids.insert(name, id);
+    return id;
+}
+
+/**
+ * @details
+ * Records a span of the event @p name from @p start to @p end (as returned
+ * by now()) on the calling thread.
+ */
+void Tracer::complete(int name, qint64 start, qint64 end)
+{
+    if (!isEnabled()) return;
+    Event event = { start, end - start, name, 'X' };
+    record(event);
+}
+
+/**
+ * @details
+ * Records a step of the flow @p id at the current time, which joins the
+ * spans containing the steps of the flow. The flow of a chunk is identified
+ * by its ingest timestamp.
+ */
+void Tracer::flow(qint64 id, FlowPhase phase)
+{
+    if (!isEnabled()) return;
+    Event event = { now(), id, -1, char(phase) };
+    record(event);
+}
+
+/**
+ * @details
+ * Sets the name under which the calling thread is shown in the trace. This
+ * is called for threads placed with ThreadPlacement::apply(), and may be
+ * called whether or not tracing is running.
+ */
+void Tracer::setThreadName(const QString& name)
+{
+    TraceState* state = traceState();
+    ThreadHolder* holder = state->threads.localData();
+    if (!holder) {
+        holder = new ThreadHolder;
+        state->threads.setLocalData(holder);
+    }
+    holder->name = name;
+    if (holder->buffer) {
+        QMutexLocker locker(&state->mutex);
+        holder->buffer->name = name;
+        holder->buffer->nameChanged = true;
+    }
+}
+
+/**
+ * @details
+ * Starts recording events, which are written to @p fileName every
+ * @p flushInterval milliseconds. Each thread buffers up to @p bufferSize
+ * events (rounded up to a power of two) between flushes.
+ *
+ * Calls to start() and stop() may be nested, e.g. by a server and a
+ * pipeline running in the same process; only the first call opens a file.
+ */
+void Tracer::start(const QString& fileName, int bufferSize, int flushInterval)
+{
+    TraceState* state = traceState();
+    QMutexLocker locker(&state->mutex);
+    if (state->users > 0) {
+        ++state->users;
+        return;
+    }
+
+    state->file.setFileName(fileName);
+    if (!state->file.open(QFile::WriteOnly | QFile::Truncate))
+        throw QString("Tracer: Unable to open trace file '%1'.").arg(fileName);
+    state->file.write("[\n");
+    state->first = true;
+
+    // Discard events left over from a previous trace.
+    foreach (ThreadBuffer* buffer, state->buffers) {
+        buffer->clear();
+        buffer->nameChanged = !buffer->name.isEmpty();
+    }
+
+    int size = 1024;
+    while (size < bufferSize && size < (1 << 24)) size <<= 1;
+    state->bufferSize = size;
+    state->dropped = 0;
+    ++state->users;
+
+    QString process = QCoreApplication::applicationName();
+    if (!process.isEmpty()) {
+        EventWriter writer(state, state->names);
+        writer.metadata("process_name", 0, process);
+        writer.write();
+    }
+
+    state->flusher = new FlushThread(state, qMax(flushInterval, 1));
+    state->flusher->start();
+    _enabled.fetchAndStoreRelease(1);
+}
+
+/**
+ * @details
+ * Starts tracing if the @p tag tag of @p config enables it, for example:
+ *
+ * @verbatim <trace enabled="true" file="server.json" buffer="65536" flushInterval="100"/> @endverbatim
+ *
+ * The trace is written to @p defaultFile unless a file is given.
+ *
+ * @return True if tracing was started, in which case stop() must be called
+ *         when done.
+ */
+bool Tracer::configure(const ConfigNode& config, const QString& defaultFile,
+        const QString& tag)
+{
+    if (config.getOption(tag, "enabled").toLower() != "true")
+        return false;
+    start(config.getOption(tag, "file", defaultFile),
+            int(config.getOptionInt(tag, "buffer", 65536)),
+            int(config.getOptionInt(tag, "flushInterval", 100)));
+    return true;
+}
+
+/**
+ * @details
+ * Stops recording once stop() has been called for every call to start(),
+ * writing any remaining events and closing the trace file.
+ */
+void Tracer::stop()
+{
+    TraceState* state = traceState();
+    FlushThread* flusher = 0;
+    {
+        QMutexLocker locker(&state->mutex);
+        if (state->users == 0 || --state->users > 0)
+            return;
+        _enabled.fetchAndStoreRelease(0);
+        flusher = state->flusher;
+        state->flusher = 0;
+    }
+
+    // The flush thread drains the buffers a final time before finishing.
+    flusher->stop();
+    flusher->wait();
+    delete flusher;
+
+    state->file.write("\n]\n");
+    state->file.close();
+    if (dropped() > 0)
+        std::cerr << "Tracer: WARNING: " << dropped() << " events dropped "
+                  << "(increase the buffer size)." << std::endl;
+}
+
+/**
+ * @details
+ * Returns the number of events dropped since tracing was started because
+ * the buffer of the recording thread was full.
+ */
+quint64 Tracer::dropped()
+{
+    return quint64(int(traceState()->dropped));
+}
+
+} // namespace pelican
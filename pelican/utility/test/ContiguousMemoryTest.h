@@ -51,6 +51,7 @@ class ContiguousMemoryTest : public CppUnit::TestFixture
     public:
         CPPUNIT_TEST_SUITE( ContiguousMemoryTest );
         CPPUNIT_TEST( test_method );
+        CPPUNIT_TEST( test_construct );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -59,6 +60,7 @@ class ContiguousMemoryTest : public CppUnit::TestFixture
 
         // Test Methods
         void test_method();
+        void test_construct();
 
     public:
         ContiguousMemoryTest(  );
@@ -51,6 +51,7 @@ class LockingCircularBufferTest : public CppUnit::TestFixture
     public:
         CPPUNIT_TEST_SUITE( LockingCircularBufferTest );
         CPPUNIT_TEST( test_method );
+        CPPUNIT_TEST( test_threads );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -59,6 +60,7 @@ class LockingCircularBufferTest : public CppUnit::TestFixture
 
         // Test Methods
         void test_method();
+        void test_threads();
 
     public:
         LockingCircularBufferTest(  );
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ConfigTreeTest.h"
+#include "ConfigTree.h"
+#include "Config.h"
+#include "ConfigNode.h"
+
+#include <QtXml/QDomDocument>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ConfigTreeTest );
+
+namespace {
+
+QDomElement parse(QDomDocument& document, const QString& xml)
+{
+    document.setContent(xml);
+    return document.documentElement();
+}
+
+} // namespace
+
+void ConfigTreeTest::test_find()
+{
+    QDomDocument document;
+    ConfigTree tree(parse(document,
+            "<configuration>"
+            "<pipeline>"
+            "<modules>"
+            "<Module name=\"a\"><param value=\"1\"/></Module>"
+            "<Module name=\"a\"><param value=\"2\"/></Module>"
+            "<Module><param value=\"3\"/></Module>"
+            "</modules>"
+            "</pipeline>"
+            "</configuration>"));
+
+    Config::TreeAddress address;
+    address << Config::NodeId("pipeline", "");
+    address << Config::NodeId("modules", "");
+    address << Config::NodeId("Module", "a");
+
+    // The last node with a repeated name is used, as for the DOM lookup.
+    int index = tree.find(address);
+    CPPUNIT_ASSERT(index > 0);
+    CPPUNIT_ASSERT(tree.attribute(tree.firstChild(index, "param"), "value")
+            ->text == "2");
+
+    // The address may also start at the root element.
+    address.prepend(Config::NodeId("configuration", ""));
+    CPPUNIT_ASSERT_EQUAL(index, tree.find(address));
+
+    int modules = tree.node(index).parent;
+    CPPUNIT_ASSERT(tree.child(modules, "Module", "") > index);
+    CPPUNIT_ASSERT_EQUAL(-1, tree.child(modules, "Module", "b"));
+    CPPUNIT_ASSERT_EQUAL(-1, tree.child(modules, "Unknown", ""));
+
+    address << Config::NodeId("missing", "");
+    CPPUNIT_ASSERT_EQUAL(-1, tree.find(address));
+
+    ConfigTree empty((QDomElement()));
+    CPPUNIT_ASSERT_EQUAL(-1, empty.find(address));
+}
+
+void ConfigTreeTest::test_elements()
+{
+    QDomDocument document;
+    ConfigTree tree(parse(document,
+            "<root>"
+            "<data type=\"a\"/>"
+            "<group><data type=\"b\"><data type=\"c\"/></data></group>"
+            "<other><data type=\"d\"/></other>"
+            "</root>"));
+
+    QVector<int> all = tree.elements(0, "data");
+    CPPUNIT_ASSERT_EQUAL(4, all.size());
+    CPPUNIT_ASSERT(tree.attribute(all[0], "type")->text == "a");
+    CPPUNIT_ASSERT(tree.attribute(all[3], "type")->text == "d");
+
+    // Only the descendants of the node are returned.
+    int group = tree.firstChild(0, "group");
+    QVector<int> inGroup = tree.elements(group, "data");
+    CPPUNIT_ASSERT_EQUAL(2, inGroup.size());
+    CPPUNIT_ASSERT(tree.attribute(inGroup[0], "type")->text == "b");
+    CPPUNIT_ASSERT(tree.attribute(inGroup[1], "type")->text == "c");
+    CPPUNIT_ASSERT_EQUAL(1, tree.elements(inGroup[0], "data").size());
+    CPPUNIT_ASSERT(tree.elements(0, "missing").isEmpty());
+}
+
+void ConfigTreeTest::test_values()
+{
+    QDomDocument document;
+    ConfigTree tree(parse(document,
+            "<root><option int=\"-42\" real=\"2.5\" text=\"abc\"/>"
+            "<text>one<!-- comment -->two</text></root>"));
+
+    int option = tree.firstChild(0, "option");
+    const ConfigTree::Value* value = tree.attribute(option, "int");
+    CPPUNIT_ASSERT(value->isInteger && value->isNumber);
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(-42), qint64(value->integer));
+    value = tree.attribute(option, "real");
+    CPPUNIT_ASSERT(!value->isInteger && value->isNumber);
+    CPPUNIT_ASSERT_EQUAL(2.5, value->number);
+    value = tree.attribute(option, "text");
+    CPPUNIT_ASSERT(!value->isInteger && !value->isNumber);
+    CPPUNIT_ASSERT(tree.attribute(option, "missing") == 0);
+
+    CPPUNIT_ASSERT(tree.node(tree.firstChild(0, "text")).text == "onetwo");
+}
+
+void ConfigTreeTest::test_configNode()
+{
+    ConfigNode node("<Module name=\"m\">"
+            "<size value=\"1024\"/>"
+            "<scale value=\"0.5\"/>"
+            "<label value=\"x\"/>"
+            "<data type=\"A\" file=\"a.dat\"/>"
+            "<data type=\"B\" file=\"b.dat\"/>"
+            "</Module>");
+
+    CPPUNIT_ASSERT(node.name() == "m");
+    CPPUNIT_ASSERT(node.getOption("size", "value") == "1024");
+    CPPUNIT_ASSERT(node.getOption("size", "missing", "d") == "d");
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(1024), qint64(node.getOptionInt("size", "value")));
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(7), qint64(node.getOptionInt("label", "value", 7)));
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(7), qint64(node.getOptionInt("scale", "value", 7)));
+    CPPUNIT_ASSERT_EQUAL(0.5, node.getOptionDouble("scale", "value"));
+    CPPUNIT_ASSERT_EQUAL(1.5, node.getOptionDouble("missing", "value", 1.5));
+
+    QHash<QString, QString> files = node.getOptionHash("data", "type", "file");
+    CPPUNIT_ASSERT_EQUAL(2, files.size());
+    CPPUNIT_ASSERT(files.value("B") == "b.dat");
+    CPPUNIT_ASSERT_EQUAL(2, node.getNodes("data").size());
+    CPPUNIT_ASSERT(node.getNodes("data")[1].getAttribute("file") == "b.dat");
+}
+
+void ConfigTreeTest::test_invalidate()
+{
+    Config config;
+    config.setFromString("<Module><size value=\"1\"/></Module>");
+
+    Config::TreeAddress address;
+    address << Config::NodeId("pipeline", "");
+    address << Config::NodeId("Module", "");
+    ConfigNode node = config.get(address);
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(1), qint64(node.getOptionInt("size", "value")));
+
+    // Changes made through the Config are seen by existing nodes, which fall
+    // back to the DOM, and by new ones.
+    Config::TreeAddress size(address);
+    size << Config::NodeId("size", "");
+    config.setAttribute(size, "value", "2");
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(2), qint64(node.getOptionInt("size", "value")));
+    CPPUNIT_ASSERT_EQUAL(Q_INT64_C(2),
+            qint64(config.get(address).getOptionInt("size", "value")));
+
+    Config::TreeAddress other(address);
+    other.last().first = "Other";
+    CPPUNIT_ASSERT(!config.verifyAddress(other));
+    config.setAttribute(other, "value", "3");
+    CPPUNIT_ASSERT(config.verifyAddress(other));
+    CPPUNIT_ASSERT(config.get(Config::TreeAddress() << Config::NodeId("pipeline", ""),
+            "Other").getAttribute("value") == "3");
+}
+
+} // namespace pelican
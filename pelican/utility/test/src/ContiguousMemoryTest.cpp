@@ -28,11 +28,31 @@
 
 #include "ContiguousMemoryTest.h"
 #include "ContiguousMemory.hpp"
+#include "FactoryGeneric.h"
 #include <QtCore/QString>
 
 
 namespace pelican {
 
+namespace {
+// A small class hierarchy to construct through the factory.
+class SlabBase {
+    public:
+        PELICAN_CONSTRUCT_TYPES_EMPTY
+        virtual ~SlabBase() {}
+        static int live;
+};
+int SlabBase::live = 0;
+
+class SlabObject : public SlabBase {
+    public:
+        SlabObject() { ++live; }
+        ~SlabObject() { --live; }
+        double values[10];
+};
+} // namespace
+PELICAN_DECLARE(SlabBase, SlabObject)
+
 CPPUNIT_TEST_SUITE_REGISTRATION( ContiguousMemoryTest );
 /**
  *@details ContiguousMemoryTest
@@ -76,4 +96,40 @@ void ContiguousMemoryTest::test_method()
      CPPUNIT_ASSERT_EQUAL( n2 , n3 );
 }
 
+void ContiguousMemoryTest::test_construct()
+{
+     FactoryGeneric<SlabBase> factory(false);
+     {
+         size_t size = factory.objectSize("SlabObject");
+         CPPUNIT_ASSERT_EQUAL( sizeof(SlabObject), size );
+         ContiguousMemory<SlabBase> slab(3, size);
+         CPPUNIT_ASSERT( slab.stride() >= size );
+         CPPUNIT_ASSERT_EQUAL( size_t(0), slab.stride() % ContiguousMemory<SlabBase>::Alignment );
+
+         // construct objects until full
+         SlabBase* objects[3];
+         for( int i = 0; i < 3; ++i ) {
+             objects[i] = slab.construct(factory, "SlabObject");
+             CPPUNIT_ASSERT( objects[i] != 0 );
+             CPPUNIT_ASSERT( slab.contains(objects[i]) );
+             CPPUNIT_ASSERT_EQUAL( size_t(0),
+                     size_t(objects[i]) % ContiguousMemory<SlabBase>::Alignment );
+         }
+         CPPUNIT_ASSERT( slab.construct(factory, "SlabObject") == 0 );
+         CPPUNIT_ASSERT_EQUAL( 3, SlabBase::live );
+
+         // destroy one and reuse the slot
+         slab.destroy(objects[1]);
+         CPPUNIT_ASSERT_EQUAL( 2, SlabBase::live );
+         CPPUNIT_ASSERT_EQUAL( 1UL, slab.available() );
+         CPPUNIT_ASSERT( slab.construct(factory, "SlabObject") == objects[1] );
+
+         // too small a slot
+         ContiguousMemory<SlabBase> small(1, 1);
+         CPPUNIT_ASSERT_THROW( small.construct(factory, "SlabObject"), QString );
+     }
+     // remaining objects destroyed with the slab
+     CPPUNIT_ASSERT_EQUAL( 0, SlabBase::live );
+}
+
 } // namespace pelican
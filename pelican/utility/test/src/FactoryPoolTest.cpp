@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "FactoryPoolTest.h"
+#include "FactoryPool.h"
+#include <QtCore/QString>
+
+
+namespace pelican {
+
+namespace {
+// A small class hierarchy to create through the pool.
+class PoolBase {
+    public:
+        PELICAN_CONSTRUCT_TYPES_EMPTY
+        PoolBase() : value(0) {}
+        virtual ~PoolBase() {}
+        int value;
+        static int live;
+};
+int PoolBase::live = 0;
+
+class PoolObject : public PoolBase {
+    public:
+        PoolObject() { ++live; }
+        ~PoolObject() { --live; }
+};
+} // namespace
+PELICAN_DECLARE(PoolBase, PoolObject)
+
+CPPUNIT_TEST_SUITE_REGISTRATION( FactoryPoolTest );
+/**
+ *@details FactoryPoolTest
+ */
+FactoryPoolTest::FactoryPoolTest()
+    : CppUnit::TestFixture()
+{
+}
+
+/**
+ *@details
+ */
+FactoryPoolTest::~FactoryPoolTest()
+{
+}
+
+void FactoryPoolTest::setUp()
+{
+}
+
+void FactoryPoolTest::tearDown()
+{
+}
+
+void FactoryPoolTest::test_reuse()
+{
+    // Use Case:
+    // Released objects are handed out again unchanged, up to maxFree.
+    FactoryGeneric<PoolBase> factory;
+    {
+        FactoryPool<PoolBase> pool(&factory, 1);
+        CPPUNIT_ASSERT_EQUAL( 0, pool.available("PoolObject") );
+        boost::shared_ptr<PoolBase> a = pool.create("PoolObject");
+        boost::shared_ptr<PoolBase> b = pool.create("PoolObject");
+        CPPUNIT_ASSERT( a.get() != b.get() );
+        CPPUNIT_ASSERT_EQUAL( 2, PoolBase::live );
+        a->value = 42;
+        PoolBase* p = a.get();
+        a.reset();
+        b.reset();
+        // Only one object is kept.
+        CPPUNIT_ASSERT_EQUAL( 1, pool.available("PoolObject") );
+        CPPUNIT_ASSERT_EQUAL( 1, PoolBase::live );
+        a = pool.create("PoolObject");
+        CPPUNIT_ASSERT( a.get() == p );
+        CPPUNIT_ASSERT_EQUAL( 42, a->value );
+        CPPUNIT_ASSERT_EQUAL( 0, pool.available("PoolObject") );
+
+        // Unknown types are rejected.
+        CPPUNIT_ASSERT_THROW( pool.create("Unknown"), QString );
+    }
+    CPPUNIT_ASSERT_EQUAL( 0, PoolBase::live );
+}
+
+void FactoryPoolTest::test_reconstruct()
+{
+    // Use Case:
+    // Released objects are reconstructed before being handed out again.
+    FactoryGeneric<PoolBase> factory;
+    {
+        FactoryPool<PoolBase> pool(&factory, 4,
+                FactoryPool<PoolBase>::Reconstruct);
+        boost::shared_ptr<PoolBase> a = pool.create("PoolObject");
+        a->value = 42;
+        PoolBase* p = a.get();
+        a.reset();
+        CPPUNIT_ASSERT_EQUAL( 1, PoolBase::live );
+        a = pool.create("PoolObject");
+        CPPUNIT_ASSERT( a.get() == p );
+        CPPUNIT_ASSERT_EQUAL( 0, a->value );
+        CPPUNIT_ASSERT( dynamic_cast<PoolObject*>(a.get()) );
+    }
+    CPPUNIT_ASSERT_EQUAL( 0, PoolBase::live );
+}
+
+void FactoryPoolTest::test_lifetime()
+{
+    // Use Case:
+    // Objects outliving the pool are deleted when released.
+    FactoryGeneric<PoolBase> factory;
+    boost::shared_ptr<PoolBase> a;
+    {
+        FactoryPool<PoolBase> pool(&factory);
+        a = pool.create("PoolObject");
+        boost::shared_ptr<PoolBase> b = pool.create("PoolObject");
+    }
+    CPPUNIT_ASSERT_EQUAL( 1, PoolBase::live );
+    a.reset();
+    CPPUNIT_ASSERT_EQUAL( 0, PoolBase::live );
+}
+
+} // namespace pelican
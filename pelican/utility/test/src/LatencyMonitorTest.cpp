@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "LatencyMonitorTest.h"
+#include "LatencyMonitor.h"
+
+#include <sstream>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( LatencyMonitorTest );
+
+void LatencyMonitorTest::test_record()
+{
+    LatencyMonitor monitor("test");
+
+    // Unstamped data is ignored.
+    CPPUNIT_ASSERT_EQUAL(quint64(0), monitor.record("a", 0));
+    CPPUNIT_ASSERT(monitor.streams().isEmpty());
+
+    // Data ingested 5 ms ago.
+    qint64 ingest = LatencyMonitor::now() - Q_INT64_C(5000000);
+    quint64 latency = monitor.record("a", ingest);
+    CPPUNIT_ASSERT(latency >= quint64(5000000));
+    CPPUNIT_ASSERT(latency < quint64(1000000000));
+
+    // Data stamped in the future (clock skew) is recorded as zero latency.
+    qint64 future = LatencyMonitor::now() + Q_INT64_C(1000000000);
+    CPPUNIT_ASSERT_EQUAL(quint64(0), monitor.record("b", future));
+
+    CPPUNIT_ASSERT_EQUAL(2, monitor.streams().size());
+    CPPUNIT_ASSERT_EQUAL(quint64(1), monitor.histogram("a").count());
+    CPPUNIT_ASSERT_EQUAL(quint64(0), monitor.histogram("b").max());
+    CPPUNIT_ASSERT_EQUAL(quint64(0), monitor.histogram("c").count());
+
+    std::ostringstream out;
+    monitor.report(out);
+    CPPUNIT_ASSERT(out.str().find("a: count=1") != std::string::npos);
+
+    monitor.clear();
+    CPPUNIT_ASSERT(monitor.streams().isEmpty());
+}
+
+void LatencyMonitorTest::test_alarms()
+{
+    // 100 ms budget.
+    LatencyMonitor monitor("test", Q_UINT64_C(100000000));
+    CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(100000000), monitor.alarmThreshold());
+
+    monitor.record("a", LatencyMonitor::now());
+    CPPUNIT_ASSERT_EQUAL(quint64(0), monitor.alarms("a"));
+    CPPUNIT_ASSERT(!monitor.lagging("a"));
+
+    // Two late chunks.
+    monitor.record("a", LatencyMonitor::now() - Q_INT64_C(200000000));
+    monitor.record("a", LatencyMonitor::now() - Q_INT64_C(300000000));
+    CPPUNIT_ASSERT_EQUAL(quint64(2), monitor.alarms("a"));
+    CPPUNIT_ASSERT(monitor.lagging("a"));
+    CPPUNIT_ASSERT(!monitor.lagging("b"));
+
+    // Back within budget.
+    monitor.record("a", LatencyMonitor::now());
+    CPPUNIT_ASSERT_EQUAL(quint64(2), monitor.alarms("a"));
+    CPPUNIT_ASSERT(!monitor.lagging("a"));
+
+    // Disabling alarms.
+    monitor.setAlarmThreshold(0);
+    monitor.record("a", LatencyMonitor::now() - Q_INT64_C(300000000));
+    CPPUNIT_ASSERT_EQUAL(quint64(2), monitor.alarms("a"));
+}
+
+} // namespace pelican
@@ -28,6 +28,8 @@
 
 #include "LockingCircularBufferTest.h"
 #include "LockingCircularBuffer.hpp"
+#include <QtCore/QList>
+#include <QtCore/QThread>
 
 
 namespace pelican {
@@ -58,15 +60,80 @@ void LockingCircularBufferTest::tearDown()
 
 void LockingCircularBufferTest::test_method()
 {
-     QList<int> buf; buf << 1 << 2 << 3 << 4;
-     LockingCircularBuffer<int> buffer(&buf);
-     CPPUNIT_ASSERT_EQUAL(1, buffer.next());
-     CPPUNIT_ASSERT_EQUAL(2, buffer.next());
-     CPPUNIT_ASSERT_EQUAL(3, buffer.next());
-     CircularBufferIterator<int> it = buffer.shiftLock();
-     CPPUNIT_ASSERT_EQUAL(1, *it);
-     CPPUNIT_ASSERT_EQUAL(4, buffer.next());
+     // capacity is rounded up to a power of two
+     LockingCircularBuffer<int> buffer(3);
+     CPPUNIT_ASSERT_EQUAL(4U, buffer.capacity());
 
+     // items come out in order, and push fails when full
+     for (int i = 1; i <= 4; ++i) CPPUNIT_ASSERT(buffer.tryPush(i));
+     CPPUNIT_ASSERT(!buffer.tryPush(5));
+     CPPUNIT_ASSERT_EQUAL(4U, buffer.size());
+     int value = 0;
+     for (int i = 1; i <= 4; ++i) {
+         CPPUNIT_ASSERT(buffer.tryPop(value));
+         CPPUNIT_ASSERT_EQUAL(i, value);
+     }
+     CPPUNIT_ASSERT(!buffer.tryPop(value));
+
+     // the ring wraps around
+     for (int i = 0; i < 10; ++i) {
+         buffer.push(i);
+         CPPUNIT_ASSERT_EQUAL(i, buffer.pop());
+     }
+
+     // timed pop on an empty ring
+     CPPUNIT_ASSERT(!buffer.pop(value, 10));
+}
+
+namespace {
+class Producer : public QThread {
+    public:
+        Producer(LockingCircularBuffer<long>* b, long n) : _b(b), _n(n) {}
+        void run() { for (long i = 1; i <= _n; ++i) _b->push(i); }
+    private:
+        LockingCircularBuffer<long>* _b;
+        long _n;
+};
+
+class Consumer : public QThread {
+    public:
+        Consumer(LockingCircularBuffer<long>* b, long n)
+        : sum(0), _b(b), _n(n) {}
+        void run() { for (long i = 0; i < _n; ++i) sum += _b->pop(); }
+        long sum;
+    private:
+        LockingCircularBuffer<long>* _b;
+        long _n;
+};
+} // namespace
+
+void LockingCircularBufferTest::test_threads()
+{
+     // several producers and consumers through a small ring, so that both
+     // the lock free and the blocking paths are exercised
+     const int threads = 3;
+     const long n = 20000;
+     LockingCircularBuffer<long> buffer(8);
+     QList<Producer*> producers;
+     QList<Consumer*> consumers;
+     for (int i = 0; i < threads; ++i) {
+         producers.append(new Producer(&buffer, n));
+         consumers.append(new Consumer(&buffer, n));
+     }
+     for (int i = 0; i < threads; ++i) {
+         consumers[i]->start();
+         producers[i]->start();
+     }
+     long sum = 0;
+     for (int i = 0; i < threads; ++i) {
+         producers[i]->wait();
+         consumers[i]->wait();
+         sum += consumers[i]->sum;
+     }
+     CPPUNIT_ASSERT_EQUAL(threads * n * (n + 1) / 2, sum);
+     CPPUNIT_ASSERT_EQUAL(0U, buffer.size());
+     qDeleteAll(producers);
+     qDeleteAll(consumers);
 }
 
 } // namespace pelican
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ThreadPlacementTest.h"
+#include "ThreadPlacement.h"
+#include "ConfigNode.h"
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ThreadPlacementTest );
+
+void ThreadPlacementTest::test_parseCpuList()
+{
+    QList<int> cores = ThreadPlacement::parseCpuList("0-3, 8,2");
+    CPPUNIT_ASSERT_EQUAL(5, cores.size());
+    CPPUNIT_ASSERT_EQUAL(0, cores[0]);
+    CPPUNIT_ASSERT_EQUAL(3, cores[3]);
+    CPPUNIT_ASSERT_EQUAL(8, cores[4]);
+    CPPUNIT_ASSERT(ThreadPlacement::parseCpuList("").isEmpty());
+
+    CPPUNIT_ASSERT_THROW(ThreadPlacement::parseCpuList("3-1"), QString);
+    CPPUNIT_ASSERT_THROW(ThreadPlacement::parseCpuList("a"), QString);
+    CPPUNIT_ASSERT_THROW(ThreadPlacement::parseCpuList("1-2-3"), QString);
+}
+
+void ThreadPlacementTest::test_configuration()
+{
+    {
+        // No thread tag: threads are left unchanged.
+        ThreadPlacement placement(ConfigNode("<Chunker/>"));
+        CPPUNIT_ASSERT(placement.isEmpty());
+        CPPUNIT_ASSERT_EQUAL(std::string("default"),
+                placement.toString().toStdString());
+    }
+    {
+        ConfigNode node("<Chunker>"
+                "<thread cores=\"1,4-5\" priority=\"50\" numaNode=\"1\"/>"
+                "</Chunker>");
+        ThreadPlacement placement(node);
+        CPPUNIT_ASSERT(!placement.isEmpty());
+        CPPUNIT_ASSERT_EQUAL(3, placement.cores().size());
+        CPPUNIT_ASSERT_EQUAL(50, placement.priority());
+        CPPUNIT_ASSERT_EQUAL(1, placement.numaNode());
+        CPPUNIT_ASSERT_EQUAL(std::string("cores 1,4,5; SCHED_FIFO 50; NUMA node 1"),
+                placement.toString().toStdString());
+    }
+    {
+        // Alternative tag name.
+        ConfigNode node("<Server><receiverThread numaNode=\"0\"/></Server>");
+        ThreadPlacement placement(node, "receiverThread");
+        CPPUNIT_ASSERT(placement.cores().isEmpty());
+        CPPUNIT_ASSERT_EQUAL(0, placement.numaNode());
+    }
+
+    ConfigNode bad("<Chunker><thread priority=\"100\"/></Chunker>");
+    CPPUNIT_ASSERT_THROW(ThreadPlacement placement(bad), QString);
+    ThreadPlacement placement;
+    CPPUNIT_ASSERT_THROW(placement.setPriority(-1), QString);
+}
+
+void ThreadPlacementTest::test_apply()
+{
+    // An empty placement is always applied.
+    CPPUNIT_ASSERT(ThreadPlacement().apply("test", false));
+}
+
+} // namespace pelican
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TimingHistogramTest.h"
+#include "TimingHistogram.h"
+#include "TimingRecorder.h"
+
+#include <sstream>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TimingHistogramTest );
+
+void TimingHistogramTest::test_percentiles()
+{
+    TimingHistogram h;
+    CPPUNIT_ASSERT_EQUAL(quint64(0), h.percentile(50.0));
+
+    for (quint64 i = 1; i <= 100000; ++i)
+        h.add(i * 1000);
+
+    CPPUNIT_ASSERT_EQUAL(quint64(100000), h.count());
+    CPPUNIT_ASSERT_EQUAL(quint64(1000), h.min());
+    CPPUNIT_ASSERT_EQUAL(quint64(100000000), h.max());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50000500.0, h.mean(), 1e-6);
+
+    // Percentiles are accurate to within the bucket width (6.25%).
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50e6, double(h.percentile(50.0)), 50e6 * 0.0625);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(99e6, double(h.percentile(99.0)), 99e6 * 0.0625);
+    CPPUNIT_ASSERT(h.percentile(99.0) <= h.max());
+
+    // Small values are held exactly.
+    h.clear();
+    h.add(3); h.add(3); h.add(7);
+    CPPUNIT_ASSERT_EQUAL(quint64(3), h.percentile(50.0));
+    CPPUNIT_ASSERT_EQUAL(quint64(7), h.percentile(100.0));
+}
+
+void TimingHistogramTest::test_merge()
+{
+    TimingHistogram a, b;
+    a.add(10);
+    b.add(5);
+    b.add(1000);
+    a.merge(b);
+    CPPUNIT_ASSERT_EQUAL(quint64(3), a.count());
+    CPPUNIT_ASSERT_EQUAL(quint64(5), a.min());
+    CPPUNIT_ASSERT_EQUAL(quint64(1000), a.max());
+}
+
+void TimingHistogramTest::test_recorder()
+{
+    QString tag("test");
+
+    // A null recorder must be accepted by the scope.
+    { TimingRecorder::Scope scope(0, tag); }
+
+    TimingRecorder recorder("recorder");
+    CPPUNIT_ASSERT(recorder.histogram(tag) == 0);
+    for (int i = 0; i < 10; ++i) {
+        TimingRecorder::Scope scope(&recorder, tag);
+    }
+    CPPUNIT_ASSERT(recorder.histogram(tag) != 0);
+    CPPUNIT_ASSERT_EQUAL(quint64(10), recorder.histogram(tag)->count());
+
+    std::ostringstream report;
+    recorder.report(report);
+    CPPUNIT_ASSERT(report.str().find("test: count=10") != std::string::npos);
+
+    recorder.clear();
+    CPPUNIT_ASSERT(recorder.histogram(tag) == 0);
+}
+
+} // namespace pelican
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2013, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "TracerTest.h"
+#include "Tracer.h"
+#include "ConfigNode.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+
+namespace pelican {
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TracerTest );
+
+namespace {
+
+/// Records spans from a named thread.
+class TracedThread : public QThread
+{
+    public:
+        TracedThread(int name) : _name(name) {}
+
+    protected:
+        void run()
+        {
+            Tracer::setThreadName("worker \"1\"");
+            for (int i = 0; i < 10; ++i) {
+                Tracer::Scope trace(_name);
+                trace.flow(1000 + i);
+            }
+        }
+
+    private:
+        int _name;
+};
+
+QString readFile(const QString& fileName)
+{
+    QFile file(fileName);
+    file.open(QFile::ReadOnly);
+    return QString::fromUtf8(file.readAll());
+}
+
+} // namespace
+
+void TracerTest::setUp()
+{
+    _file = QDir::temp().absoluteFilePath("TracerTest.json");
+}
+
+void TracerTest::tearDown()
+{
+    QFile::remove(_file);
+}
+
+void TracerTest::test_disabled()
+{
+    CPPUNIT_ASSERT(!Tracer::isEnabled());
+    static const int name = Tracer::intern("TracerTest::disabled");
+    CPPUNIT_ASSERT_EQUAL(name, Tracer::intern("TracerTest::disabled"));
+    {
+        // Nothing is recorded while tracing is stopped.
+        Tracer::Scope trace(name);
+        trace.flow(1);
+    }
+
+    // Tracing is only started if enabled in the configuration.
+    CPPUNIT_ASSERT(!Tracer::configure(ConfigNode("<Server/>"), _file));
+    CPPUNIT_ASSERT(!Tracer::configure(
+            ConfigNode("<Server><trace enabled=\"false\"/></Server>"), _file));
+    CPPUNIT_ASSERT(!Tracer::isEnabled());
+
+    QString xml = "<Server><trace enabled=\"true\" file=\"" + _file
+            + "\" flushInterval=\"10\"/></Server>";
+    CPPUNIT_ASSERT(Tracer::configure(ConfigNode(xml), "unused.json"));
+    CPPUNIT_ASSERT(Tracer::isEnabled());
+    Tracer::stop();
+    CPPUNIT_ASSERT(!Tracer::isEnabled());
+
+    QString trace = readFile(_file);
+    CPPUNIT_ASSERT(trace.startsWith("["));
+    CPPUNIT_ASSERT(trace.trimmed().endsWith("]"));
+    CPPUNIT_ASSERT(!trace.contains("TracerTest::disabled"));
+}
+
+void TracerTest::test_trace()
+{
+    static const int name = Tracer::intern("TracerTest::trace");
+    static const int threadName = Tracer::intern("TracerTest::thread");
+    Tracer::start(_file, 1024, 10);
+    {
+        Tracer::Scope trace(name);
+        trace.flow(0x1234, Tracer::FlowStart);
+        trace.flow(0); // No flow.
+    }
+    TracedThread thread(threadName);
+    thread.start();
+    thread.wait();
+    Tracer::stop();
+
+    QString trace = readFile(_file);
+    CPPUNIT_ASSERT(trace.contains("\"name\":\"TracerTest::trace\",\"cat\":\"pelican\",\"ph\":\"X\""));
+    CPPUNIT_ASSERT_EQUAL(10, trace.count("\"name\":\"TracerTest::thread\""));
+    CPPUNIT_ASSERT(trace.contains("\"ph\":\"s\",\"id\":\"0x1234\""));
+    CPPUNIT_ASSERT_EQUAL(11, trace.count("\"cat\":\"chunk\""));
+    CPPUNIT_ASSERT(trace.contains("\"name\":\"thread_name\""));
+    CPPUNIT_ASSERT(trace.contains("\"args\":{\"name\":\"worker \\\"1\\\"\"}"));
+    CPPUNIT_ASSERT_EQUAL(Q_UINT64_C(0), Tracer::dropped());
+}
+
+void TracerTest::test_nested()
+{
+    static const int name = Tracer::intern("TracerTest::nested");
+    Tracer::start(_file, 1024, 10);
+    Tracer::start("ignored.json");
+    Tracer::stop();
+    CPPUNIT_ASSERT(Tracer::isEnabled());
+    {
+        Tracer::Scope trace(name);
+    }
+    Tracer::stop();
+    CPPUNIT_ASSERT(!Tracer::isEnabled());
+    Tracer::stop(); // Unmatched calls are ignored.
+
+    CPPUNIT_ASSERT(!QFile::exists("ignored.json"));
+    CPPUNIT_ASSERT_EQUAL(1, readFile(_file).count("TracerTest::nested"));
+}
+
+void TracerTest::test_dropped()
+{
+    static const int name = Tracer::intern("TracerTest::dropped");
+
+    // The buffer is flushed at most once (on starting) before it fills up.
+    Tracer::start(_file, 1024, 100000);
+    for (int i = 0; i < 5000; ++i) {
+        Tracer::Scope trace(name);
+    }
+    Tracer::stop();
+
+    CPPUNIT_ASSERT(Tracer::dropped() >= Q_UINT64_C(2952));
+    CPPUNIT_ASSERT_EQUAL(int(5000 - Tracer::dropped()),
+            readFile(_file).count("TracerTest::dropped"));
+}
+
+} // namespace pelican